@@ -55,13 +55,47 @@ public:
     std::string
     GetURI() override;
 
+    bool
+    InterruptRead() override;
+
     lldb::ConnectionStatus
     Open (bool create, const char *name, size_t size, Error *error_ptr);
 
+    //------------------------------------------------------------------
+    /// Remove the name this side created.  The mapping stays valid for
+    /// everyone who already opened it, and the memory goes away with the
+    /// last of them, even if this process dies.
+    //------------------------------------------------------------------
+    void
+    Unlink ();
+
+    //------------------------------------------------------------------
+    /// @return
+    ///     The start of the shared mapping, or NULL if it isn't open.
+    //------------------------------------------------------------------
+    uint8_t *
+    GetBytes ()
+    {
+        return m_mmap.GetBytes();
+    }
+
+    size_t
+    GetByteSize () const
+    {
+        return m_mmap.GetByteSize();
+    }
+
+    const std::string &
+    GetName () const
+    {
+        return m_name;
+    }
+
 protected:
 
     std::string m_name;
     int m_fd;    // One buffer that contains all we need
+    bool m_created;    // True if Open() created the name, which Unlink() or Disconnect() then removes
     DataBufferMemoryMap m_mmap;
 
 private:
@@ -0,0 +1,112 @@
+//===-- InstructionBranchMap.h ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_InstructionBranchMap_h_
+#define liblldb_InstructionBranchMap_h_
+
+// C Includes
+#include <stdint.h>
+
+// C++ Includes
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Core/AddressRange.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class InstructionBranchMap InstructionBranchMap.h "lldb/Core/InstructionBranchMap.h"
+/// @brief The instruction boundaries and branches of one function.
+///
+/// Stepping over a source line only needs to know where the instructions
+/// in the line start and which of them may branch.  This class records
+/// just that for a whole function, in file addresses, so it can be
+/// computed once with the disassembler and shared by every step plan on
+/// every thread (see Module::GetInstructionBranchMap).
+//----------------------------------------------------------------------
+class InstructionBranchMap
+{
+public:
+    //------------------------------------------------------------------
+    /// Disassemble \a function_range and build its branch map.
+    ///
+    /// @return
+    ///     A valid shared pointer if the range could be disassembled.
+    //------------------------------------------------------------------
+    static lldb::InstructionBranchMapSP
+    Create (const ArchSpec &arch,
+            const ExecutionContext &exe_ctx,
+            const AddressRange &function_range);
+
+    InstructionBranchMap (const AddressRange &function_range);
+
+    ~InstructionBranchMap ();
+
+    const AddressRange &
+    GetFunctionRange () const
+    {
+        return m_function_range;
+    }
+
+    size_t
+    GetSize () const
+    {
+        return m_insn_offsets.size();
+    }
+
+    //------------------------------------------------------------------
+    /// Find the index of the instruction that starts at \a file_addr.
+    ///
+    /// The end address of the function maps to GetSize() so that step
+    /// ranges ending at the last instruction can be looked up too.
+    ///
+    /// @return
+    ///     The instruction index, or UINT32_MAX if \a file_addr is not
+    ///     an instruction boundary in this function.
+    //------------------------------------------------------------------
+    uint32_t
+    GetIndexOfInstructionAtFileAddress (lldb::addr_t file_addr) const;
+
+    //------------------------------------------------------------------
+    /// @return
+    ///     The index of the first instruction at or after \a start that
+    ///     may branch, or UINT32_MAX if there is none.
+    //------------------------------------------------------------------
+    uint32_t
+    GetIndexOfNextBranchInstruction (uint32_t start) const;
+
+    //------------------------------------------------------------------
+    /// @return
+    ///     The file address of the instruction at \a index, where
+    ///     GetSize() gives the end of the function.
+    //------------------------------------------------------------------
+    lldb::addr_t
+    GetFileAddressAtIndex (uint32_t index) const;
+
+protected:
+    void
+    AppendInstruction (lldb::addr_t file_addr, bool does_branch);
+
+    void
+    Finalize ();
+
+    AddressRange m_function_range;
+    std::vector<uint32_t> m_insn_offsets;   // Offset of each instruction from the start of the function
+    std::vector<uint32_t> m_next_branch;    // Index of the next branching instruction at or after each instruction
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (InstructionBranchMap);
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_InstructionBranchMap_h_
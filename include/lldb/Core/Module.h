@@ -13,6 +13,7 @@
 // C Includes
 // C++ Includes
 #include <atomic>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -1071,6 +1072,28 @@ public:
     void
     ClearModuleDependentCaches ();
 
+    //------------------------------------------------------------------
+    /// Get the instruction branch map for a function in this module.
+    ///
+    /// Branch maps are computed once per function with the disassembler
+    /// and shared by every thread plan that steps through the function.
+    ///
+    /// @param[in] exe_ctx
+    ///     The execution context to use if the function's bytes need to
+    ///     be read to disassemble it.
+    ///
+    /// @param[in] function_range
+    ///     The address range of the whole function, which must be in
+    ///     this module.
+    ///
+    /// @return
+    ///     The branch map, or an empty shared pointer if the function
+    ///     could not be disassembled.
+    //------------------------------------------------------------------
+    lldb::InstructionBranchMapSP
+    GetInstructionBranchMap (const ExecutionContext &exe_ctx,
+                             const AddressRange &function_range);
+
     void
     SetTypeSystemMap (const TypeSystemMap &type_system_map)
     {
@@ -1181,12 +1204,14 @@ protected:
     uint64_t                    m_object_offset;
     TimeValue                   m_object_mod_time;
     lldb::ObjectFileSP          m_objfile_sp;   ///< A shared pointer to the object file parser for this module as it may or may not be shared with the SymbolFile
+    lldb::DataBufferSP          m_data_sp;      ///< The object file contents if they didn't come from m_file (see ModuleSpec::GetData())
     lldb::SymbolVendorUP        m_symfile_ap;   ///< A pointer to the symbol vendor for this module.
     std::vector<lldb::SymbolVendorUP> m_old_symfiles; ///< If anyone calls Module::SetSymbolFileFileSpec() and changes the symbol file,
                                                       ///< we need to keep all old symbol files around in case anyone has type references to them
     TypeSystemMap               m_type_system_map;    ///< A map of any type systems associated with this module
     PathMappingList             m_source_mappings; ///< Module specific source remappings for when you have debug info for a module that doesn't match where the sources currently are
     lldb::SectionListUP         m_sections_ap; ///< Unified section list for module that is used by the ObjectFile and and ObjectFile instances for the debug info
+    std::map<lldb::addr_t, lldb::InstructionBranchMapSP> m_branch_maps; ///< Instruction branch maps for stepping, keyed by function start file address
 
     std::atomic<bool>           m_did_load_objfile;
     std::atomic<bool>           m_did_load_symbol_vendor;
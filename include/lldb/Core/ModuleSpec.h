@@ -38,7 +38,8 @@ public:
         m_object_offset (0),
         m_object_size (0),
         m_object_mod_time (),
-        m_source_mappings ()
+        m_source_mappings (),
+        m_data_sp ()
     {
     }
 
@@ -52,7 +53,8 @@ public:
         m_object_offset (0),
         m_object_size (file_spec.GetByteSize ()),
         m_object_mod_time (),
-        m_source_mappings ()
+        m_source_mappings (),
+        m_data_sp ()
     {
     }
 
@@ -66,7 +68,8 @@ public:
         m_object_offset (0),
         m_object_size (file_spec.GetByteSize ()),
         m_object_mod_time (),
-        m_source_mappings ()
+        m_source_mappings (),
+        m_data_sp ()
     {
     }
     
@@ -80,7 +83,8 @@ public:
         m_object_offset (rhs.m_object_offset),
         m_object_size (rhs.m_object_size),
         m_object_mod_time (rhs.m_object_mod_time),
-        m_source_mappings (rhs.m_source_mappings)
+        m_source_mappings (rhs.m_source_mappings),
+        m_data_sp (rhs.m_data_sp)
     {
     }
 
@@ -99,6 +103,7 @@ public:
             m_object_size = rhs.m_object_size;
             m_object_mod_time = rhs.m_object_mod_time;
             m_source_mappings = rhs.m_source_mappings;
+            m_data_sp = rhs.m_data_sp;
         }
         return *this;
     }
@@ -277,6 +282,24 @@ public:
         return m_source_mappings;
     }
 
+    //------------------------------------------------------------------
+    /// The contents of the object file, for modules whose file can't be
+    /// mapped as is, e.g. because it is compressed.  When set, a Module
+    /// created from this spec parses its object file from this buffer
+    /// and only uses the file spec to name itself.
+    //------------------------------------------------------------------
+    const lldb::DataBufferSP &
+    GetData () const
+    {
+        return m_data_sp;
+    }
+
+    void
+    SetData (const lldb::DataBufferSP &data_sp)
+    {
+        m_data_sp = data_sp;
+    }
+
     void
     Clear ()
     {
@@ -290,6 +313,7 @@ public:
         m_object_size = 0;
         m_source_mappings.Clear(false);
         m_object_mod_time.Clear();
+        m_data_sp.reset();
     }
 
     explicit operator bool () const
@@ -442,6 +466,7 @@ protected:
     uint64_t m_object_size;
     TimeValue m_object_mod_time;
     mutable PathMappingList m_source_mappings;
+    lldb::DataBufferSP m_data_sp;
 };
 
 class ModuleSpecList
@@ -1034,12 +1034,34 @@ public:
 protected:
     typedef ClusterManager<ValueObject> ValueObjectManager;
     
+    //------------------------------------------------------------------
+    // Children that are owned by this value's cluster are stored as plain
+    // pointers; children that live in a cluster of their own (e.g. the
+    // ones synthetic front ends create) are handed in as shared pointers
+    // and kept alive here.
+    //
+    // Without a window size, children are kept in maps keyed by child
+    // index, so asking for a single child far into a large container
+    // costs one node rather than a slot for every index before it.
+    //
+    // With a window size set, only that many consecutive indexes are
+    // kept, in vectors indexed from the start of the window: storing a
+    // child outside the window slides the window to be centered on it,
+    // and the shared pointers that fall out of it are released.  Plain
+    // pointers that fall out are just forgotten, their objects belong to
+    // the cluster.
+    //------------------------------------------------------------------
     class ChildrenManager
     {
     public:
         ChildrenManager() :
             m_mutex(Mutex::eMutexTypeRecursive),
+            m_children_map(),
+            m_owned_children_map(),
             m_children(),
+            m_owned_children(),
+            m_first_index(0),
+            m_window_size(0),
             m_children_count(0)
         {}
         
@@ -1047,23 +1069,32 @@ protected:
         HasChildAtIndex (size_t idx)
         {
             Mutex::Locker locker(m_mutex);
-            return (m_children.find(idx) != m_children.end());
+            return FindChild(idx) != nullptr;
         }
         
         ValueObject*
         GetChildAtIndex (size_t idx)
         {
             Mutex::Locker locker(m_mutex);
-            const auto iter = m_children.find(idx);
-            return ((iter == m_children.end()) ? nullptr : iter->second);
+            return FindChild(idx);
         }
+
+        // Use this instead of GetChildAtIndex when children are stored as
+        // shared pointers and a window is set, since another thread may
+        // release a child as soon as the lock is dropped.
+        lldb::ValueObjectSP
+        GetChildSPAtIndex (size_t idx);
         
         void
         SetChildAtIndex (size_t idx, ValueObject* valobj)
         {
-            ChildrenPair pair(idx,valobj); // we do not need to be mutex-protected to make a pair
-            Mutex::Locker locker(m_mutex);
-            m_children.insert(pair);
+            SetChild(idx, valobj, lldb::ValueObjectSP());
+        }
+
+        void
+        SetChildAtIndex (size_t idx, const lldb::ValueObjectSP &valobj_sp)
+        {
+            SetChild(idx, valobj_sp.get(), valobj_sp);
         }
         
         void
@@ -1077,21 +1108,57 @@ protected:
         {
             return m_children_count;
         }
-        
+
+        // Changing the window size drops all the cached children.
         void
-        Clear(size_t new_count = 0)
+        SetWindowSize (size_t window_size);
+
+        size_t
+        GetWindowSize () const
         {
-            Mutex::Locker locker(m_mutex);
-            m_children_count = new_count;
-            m_children.clear();
+            return m_window_size;
         }
         
+        void
+        Clear(size_t new_count = 0);
+        
     private:
         typedef std::map<size_t, ValueObject*> ChildrenMap;
-        typedef ChildrenMap::iterator ChildrenIterator;
-        typedef ChildrenMap::value_type ChildrenPair;
+        typedef std::map<size_t, lldb::ValueObjectSP> OwnedChildrenMap;
+        typedef std::vector<ValueObject*> ChildrenVector;
+        typedef std::vector<lldb::ValueObjectSP> OwnedChildrenVector;
+
+        ValueObject *
+        FindChild (size_t idx)
+        {
+            if (m_window_size == 0)
+            {
+                ChildrenMap::const_iterator pos = m_children_map.find(idx);
+                return pos != m_children_map.end() ? pos->second : nullptr;
+            }
+            if (idx < m_first_index)
+                return nullptr;
+            const size_t slot = idx - m_first_index;
+            return slot < m_children.size() ? m_children[slot] : nullptr;
+        }
+
+        void
+        SetChild (size_t idx, ValueObject *valobj, const lldb::ValueObjectSP &valobj_sp);
+
+        // Make sure idx has a slot in the window, moving the window if
+        // needed.  Owned children that drop out of it are moved to evicted.
+        void
+        MakeSlotForIndex (size_t idx, OwnedChildrenVector &evicted);
+
         Mutex m_mutex;
-        ChildrenMap m_children;
+        // Used when no window is set.
+        ChildrenMap m_children_map;
+        OwnedChildrenMap m_owned_children_map;
+        // Used when a window is set, never grow past m_window_size.
+        ChildrenVector m_children;             // The children from m_first_index on, nullptr where not created yet
+        OwnedChildrenVector m_owned_children;  // Empty, or parallel to m_children once an owned child was stored
+        size_t m_first_index;
+        size_t m_window_size;                  // Zero to keep every child
         size_t m_children_count;
     };
 
@@ -17,7 +17,6 @@
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/ThreadSafeSTLMap.h"
-#include "lldb/Core/ThreadSafeSTLVector.h"
 #include "lldb/Core/ValueObject.h"
 
 namespace lldb_private {
@@ -204,17 +203,17 @@ protected:
     lldb::SyntheticChildrenSP m_synth_sp;
     std::unique_ptr<SyntheticChildrenFrontEnd> m_synth_filter_ap;
     
-    typedef ThreadSafeSTLMap<uint32_t, ValueObject*> ByIndexMap;
     typedef ThreadSafeSTLMap<const char*, uint32_t> NameToIndexMap;
-    typedef ThreadSafeSTLVector<lldb::ValueObjectSP> SyntheticChildrenCache;
     
-    typedef ByIndexMap::iterator ByIndexIterator;
     typedef NameToIndexMap::iterator NameToIndexIterator;
 
-    ByIndexMap      m_children_byindex;
+    // Children the front end generated are owned here, the others belong
+    // to the cluster of the value they came from.  Bounded by
+    // target.max-cached-synthetic-children, which can only free the
+    // children the front end doesn't also keep in a cache of its own.
+    ChildrenManager m_children_byindex;
     NameToIndexMap  m_name_toindex;
     uint32_t        m_synthetic_children_count; // FIXME use the ValueObject's ChildrenManager instead of a special purpose solution
-    SyntheticChildrenCache m_synthetic_children_cache;
     
     ConstString     m_parent_type_name;
 
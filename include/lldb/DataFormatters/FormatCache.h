@@ -12,7 +12,8 @@
 
 // C Includes
 // C++ Includes
-#include <map>
+#include <atomic>
+#include <unordered_map>
 
 // Other libraries and framework includes
 // Project includes
@@ -80,15 +81,44 @@ private:
         void
         SetValidator (lldb::TypeValidatorImplSP);
     };
-    typedef std::map<ConstString,Entry> CacheMap;
-    CacheMap m_map;
-    Mutex m_mutex;
-    
-    uint64_t m_cache_hits;
-    uint64_t m_cache_misses;
-    
-    Entry&
-    GetEntry (const ConstString& type);
+    typedef std::unordered_map<const char *, Entry> CacheMap;
+
+    // Lookups happen for every value that gets printed, often from several
+    // threads at once, so the cache is split in shards that each have
+    // their own lock.  Entries are keyed by the ConstString's unique
+    // pointer, which doubles as its hash.
+    struct Shard
+    {
+        Shard ();
+
+        Mutex m_mutex;
+        CacheMap m_map;
+        uint32_t m_generation; // The cache generation m_map was filled in
+    };
+
+    static const size_t kNumShards = 16;
+
+    Shard m_shards[kNumShards];
+
+    // Clear() just bumps the generation, shards from an older generation
+    // are treated as empty and are emptied the next time they are written.
+    std::atomic<uint32_t> m_generation;
+
+    std::atomic<uint64_t> m_cache_hits;
+    std::atomic<uint64_t> m_cache_misses;
+
+    Shard &
+    GetShard (const ConstString& type);
+
+    // Returns the entry for type in shard, or nullptr.  Call with the
+    // shard's mutex held.
+    Entry *
+    FindEntry (Shard &shard, const ConstString& type);
+
+    // Like FindEntry but creates the entry if needed.  Call with the
+    // shard's mutex held.
+    Entry &
+    GetEntry (Shard &shard, const ConstString& type);
     
 public:
     FormatCache ();
@@ -123,13 +153,13 @@ public:
     uint64_t
     GetCacheHits ()
     {
-        return m_cache_hits;
+        return m_cache_hits.load(std::memory_order_relaxed);
     }
     
     uint64_t
     GetCacheMisses ()
     {
-        return m_cache_misses;
+        return m_cache_misses.load(std::memory_order_relaxed);
     }
 };
 } // namespace lldb_private
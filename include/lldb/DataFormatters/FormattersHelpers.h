@@ -84,7 +84,104 @@ namespace lldb_private {
 
         time_t
         GetOSXEpoch ();
+
+        //----------------------------------------------------------------------
+        /// @class ChunkedElementReader FormattersHelpers.h "lldb/DataFormatters/FormattersHelpers.h"
+        /// @brief Reads a contiguous array in the inferior a chunk at a time.
+        ///
+        /// Synthetic child providers for large containers would otherwise
+        /// issue one memory read per element.  This reads up to
+        /// \a chunk_elements elements at once (callers pass
+        /// target.max-children-count) and hands out the data for each
+        /// element as a slice of the shared chunk buffer.
+        //----------------------------------------------------------------------
+        class ChunkedElementReader
+        {
+        public:
+            ChunkedElementReader ();
+
+            void
+            Reset (const lldb::ProcessSP &process_sp,
+                   lldb::addr_t base_addr,
+                   size_t element_stride,
+                   size_t element_count,
+                   size_t chunk_elements);
+
+            //------------------------------------------------------------------
+            /// Point \a data at the first \a byte_size bytes of element
+            /// \a idx, reading the chunk that contains it if needed.
+            ///
+            /// @return
+            ///     False if the element could not be read.
+            //------------------------------------------------------------------
+            bool
+            GetElementData (size_t idx, size_t byte_size, DataExtractor &data);
+
+            //------------------------------------------------------------------
+            /// Copy the first \a byte_size bytes of element \a idx to
+            /// \a dst.
+            //------------------------------------------------------------------
+            bool
+            CopyElementData (size_t idx, size_t byte_size, void *dst);
+
+        protected:
+            bool
+            ReadChunkContainingIndex (size_t idx);
+
+            lldb::ProcessWP m_process_wp;
+            lldb::addr_t m_base_addr;
+            size_t m_element_stride;
+            size_t m_element_count;
+            size_t m_chunk_elements;
+            lldb::DataBufferSP m_chunk_sp;  // Elements [m_chunk_start, m_chunk_start + m_chunk_count)
+            size_t m_chunk_start;
+            size_t m_chunk_count;
+        };
         
+        //----------------------------------------------------------------------
+        /// Read [\a addr, \a addr + \a byte_size) in one go so that it lands
+        /// in the process memory cache.  The reads that follow for the
+        /// individual children can then be served without a round trip.
+        ///
+        /// @return
+        ///     True if anything was read.
+        //----------------------------------------------------------------------
+        bool
+        PrefetchMemory (Process &process, lldb::addr_t addr, size_t byte_size);
+
+        //----------------------------------------------------------------------
+        /// @class NodePrefetcher FormattersHelpers.h "lldb/DataFormatters/FormattersHelpers.h"
+        /// @brief Prefetches the nodes of linked containers.
+        ///
+        /// The next node of a list or tree isn't known until the current one
+        /// has been read, but nodes that were allocated together usually sit
+        /// next to each other in memory.  Before each node is read this
+        /// prefetches a window of nodes starting at it.  The window doubles
+        /// (up to \a max_nodes) while the following nodes keep landing in it,
+        /// and shrinks when they don't, so scattered nodes don't pay for
+        /// memory they don't use.
+        //----------------------------------------------------------------------
+        class NodePrefetcher
+        {
+        public:
+            NodePrefetcher ();
+
+            void
+            Reset (const lldb::ProcessSP &process_sp, size_t node_size, size_t max_nodes);
+
+            void
+            WillReadNode (lldb::addr_t node_addr);
+
+        protected:
+            lldb::ProcessWP m_process_wp;
+            size_t m_node_size;
+            size_t m_max_nodes;
+            size_t m_window_nodes;
+            size_t m_window_hits;       // Nodes found in the current window
+            lldb::addr_t m_window_start;
+            lldb::addr_t m_window_end;
+        };
+
         struct InferiorSizedWord {
             
             InferiorSizedWord(const InferiorSizedWord& word) : ptr_size(word.ptr_size)
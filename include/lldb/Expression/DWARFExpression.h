@@ -15,7 +15,10 @@
 #include "lldb/Core/Error.h"
 #include "lldb/Core/Scalar.h"
 #include "lldb/lldb-private.h"
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <vector>
 
 class DWARFCompileUnit;
 
@@ -78,6 +81,9 @@ public:
     //------------------------------------------------------------------
     DWARFExpression(const DWARFExpression& rhs);
 
+    const DWARFExpression&
+    operator= (const DWARFExpression& rhs);
+
     //------------------------------------------------------------------
     /// Destructor
     //------------------------------------------------------------------
@@ -476,6 +482,75 @@ protected:
                                      lldb::addr_t& low_pc,
                                      lldb::addr_t& high_pc);
 
+    //------------------------------------------------------------------
+    /// One location of the expression, decoded: a location list entry, or
+    /// the whole expression if this isn't a location list.  The common
+    /// single opcode locations are recognized so that evaluating them
+    /// doesn't need the opcode interpreter.
+    //------------------------------------------------------------------
+    struct CompiledLocation
+    {
+        enum Kind
+        {
+            eKindGeneric,           // Evaluated by the opcode interpreter
+            eKindRegister,          // DW_OP_regN or DW_OP_regx
+            eKindRegisterOffset,    // DW_OP_bregN or DW_OP_bregx
+            eKindFrameBaseOffset    // DW_OP_fbreg
+        };
+
+        lldb::addr_t lo_pc;         // Location list entry range, before it is slid
+        lldb::addr_t hi_pc;
+        lldb::offset_t offset;      // The opcodes for this location in m_data
+        lldb::offset_t length;
+        Kind kind;
+        uint32_t reg_num;
+        int64_t reg_offset;         // Register or frame base offset
+    };
+
+    //------------------------------------------------------------------
+    /// The decoded form of a whole expression, built the first time the
+    /// expression is evaluated and kept until its data changes.
+    //------------------------------------------------------------------
+    struct CompiledExpression
+    {
+        CompiledExpression () :
+            locations (),
+            sorted (false),
+            last_index (0)
+        {
+        }
+
+        std::vector<CompiledLocation> locations;
+        bool sorted;                        // Location list ranges are sorted and don't overlap
+        std::atomic<uint32_t> last_index;   // The location the last lookup found, tried first
+    };
+
+    typedef std::shared_ptr<CompiledExpression> CompiledExpressionSP;
+
+    CompiledExpressionSP
+    GetCompiledExpression () const;
+
+    void
+    InvalidateCompiledExpression ();
+
+    static void
+    ClassifyLocation (const DataExtractor& opcodes, CompiledLocation &location);
+
+    static const CompiledLocation *
+    FindLocationForAddress (CompiledExpression &compiled, lldb::addr_t file_addr);
+
+    bool
+    EvaluateLocation (const CompiledLocation &location,
+                      ExecutionContext *exe_ctx,
+                      ClangExpressionVariableList *expr_locals,
+                      ClangExpressionDeclMap *decl_map,
+                      RegisterContext *reg_ctx,
+                      const lldb::ModuleSP &module_sp,
+                      const Value* initial_value_ptr,
+                      const Value* object_address_ptr,
+                      Value& result,
+                      Error *error_ptr) const;
+
     //------------------------------------------------------------------
     /// Classes that inherit from DWARFExpression can see and modify these
     //------------------------------------------------------------------
@@ -489,6 +564,8 @@ protected:
     lldb::addr_t m_loclist_slide;               ///< A value used to slide the location list offsets so that 
                                                 ///< they are relative to the object that owns the location list
                                                 ///< (the function for frame base and variable location lists)
+    mutable CompiledExpressionSP m_compiled_sp; ///< Built lazily by GetCompiledExpression(), only accessed
+                                                ///< with the std::atomic_* shared_ptr functions
 };
 
 } // namespace lldb_private
@@ -40,12 +40,37 @@ class IRMemoryMap;
 class IRInterpreter
 {
 public:
+    //------------------------------------------------------------------
+    /// Check whether every instruction in \a function can be interpreted.
+    ///
+    /// @param[in] support_function_calls
+    ///     True if the process's ABI can call functions described by their
+    ///     IR prototype (see ThreadPlanCallFunctionUsingABI).
+    ///
+    /// @param[in] support_trivial_function_calls
+    ///     True if functions taking and returning only integers and
+    ///     pointers can be called with ThreadPlanCallFunction.
+    ///
+    /// @param[out] error
+    ///     If the function can't be interpreted, says which instruction
+    ///     or operand stopped it.
+    //------------------------------------------------------------------
     static bool
     CanInterpret (llvm::Module &module,
                   llvm::Function &function,
                   lldb_private::Error &error,
-                  const bool support_function_calls);
+                  const bool support_function_calls,
+                  const bool support_trivial_function_calls);
     
+    //------------------------------------------------------------------
+    /// Interpret \a function.
+    ///
+    /// @param[in] options
+    ///     The options the expression is being evaluated with.  Functions
+    ///     the expression calls are run with them, so unwinding, breakpoints,
+    ///     the timeout and other threads are handled as if the expression
+    ///     had been JIT'ed.
+    //------------------------------------------------------------------
     static bool
     Interpret (llvm::Module &module,
                llvm::Function &function,
@@ -54,7 +79,8 @@ public:
                lldb_private::Error &error,
                lldb::addr_t stack_frame_bottom,
                lldb::addr_t stack_frame_top,
-               lldb_private::ExecutionContext &exe_ctx);
+               lldb_private::ExecutionContext &exe_ctx,
+               const lldb_private::EvaluateExpressionOptions &options);
     
 private:   
     static bool
@@ -0,0 +1,188 @@
+//===-- UserExpressionCache.h -----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_UserExpressionCache_h_
+#define liblldb_UserExpressionCache_h_
+
+// C Includes
+#include <stdint.h>
+
+// C++ Includes
+#include <list>
+#include <map>
+#include <string>
+#include <tuple>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Expression/Expression.h"
+#include "lldb/Host/Mutex.h"
+
+namespace lldb_private {
+
+class EvaluateExpressionOptions;
+
+//----------------------------------------------------------------------
+/// @class UserExpressionCache UserExpressionCache.h "lldb/Expression/UserExpressionCache.h"
+/// @brief Parsed user expressions kept around for re-evaluation.
+///
+/// Breakpoint scripts tend to evaluate the same few expressions over and
+/// over at the same code address.  UserExpression::Evaluate stores each
+/// expression it parsed and ran successfully here, keyed by the
+/// expression text, the parse options and the frame code address, so
+/// the next evaluation can skip straight to Execute and reuse the JIT'ed
+/// code or the interpretable IR.
+///
+/// An expression is taken out of the cache while it runs, so nested or
+/// concurrent evaluations of the same text just parse their own copy.
+/// When the cache is full, the expression that was least recently put
+/// back is dropped.
+/// The target clears the cache whenever the set of loaded modules, the
+/// process or the scratch type systems change.
+//----------------------------------------------------------------------
+class UserExpressionCache
+{
+public:
+    // Everything that changes how the expression parses is part of the
+    // key, so a parse is never reused under different options.
+    struct Key
+    {
+        std::string expr_text;
+        std::string expr_prefix;        // The settings prefix plus the options' prefix
+        std::string option_prefix;      // The prefix from the options alone
+        lldb::LanguageType language;    // The language the expression is parsed in
+        lldb::LanguageType option_language;
+        Expression::ResultType desired_type;
+        ExecutionPolicy execution_policy;
+        bool coerce_to_id;
+        bool auto_apply_fixits;
+        bool repl;
+        bool playground;
+        bool generate_debug_info;
+        lldb::DynamicValueType use_dynamic;
+        std::string pound_line_file;
+        uint32_t pound_line_line;
+        lldb::user_id_t process_id;
+        lldb::addr_t frame_pc;
+
+        Key () :
+            expr_text (),
+            expr_prefix (),
+            option_prefix (),
+            language (lldb::eLanguageTypeUnknown),
+            option_language (lldb::eLanguageTypeUnknown),
+            desired_type (Expression::eResultTypeAny),
+            execution_policy (eExecutionPolicyOnlyWhenNeeded),
+            coerce_to_id (false),
+            auto_apply_fixits (true),
+            repl (false),
+            playground (false),
+            generate_debug_info (false),
+            use_dynamic (lldb::eNoDynamicValues),
+            pound_line_file (),
+            pound_line_line (0),
+            process_id (LLDB_INVALID_UID),
+            frame_pc (LLDB_INVALID_ADDRESS)
+        {
+        }
+
+        bool
+        operator < (const Key &rhs) const;
+    };
+
+    UserExpressionCache ();
+
+    ~UserExpressionCache ();
+
+    //------------------------------------------------------------------
+    /// Fill in \a key for evaluating \a expr_cstr in \a exe_ctx.
+    ///
+    /// @return
+    ///     False if the expression must not be cached, e.g. because it
+    ///     refers to persistent variables, runs in the REPL or a
+    ///     playground, defines top level code or wants debug info.
+    //------------------------------------------------------------------
+    static bool
+    MakeKey (ExecutionContext &exe_ctx,
+             const char *expr_cstr,
+             const char *expr_prefix,
+             lldb::LanguageType language,
+             Expression::ResultType desired_type,
+             ExecutionPolicy execution_policy,
+             const EvaluateExpressionOptions &options,
+             Key &key);
+
+    //------------------------------------------------------------------
+    /// Remove and return the expression cached for \a key, if it still
+    /// matches \a exe_ctx.  The caller hands it back with Insert once it
+    /// has run successfully.
+    //------------------------------------------------------------------
+    lldb::UserExpressionSP
+    Take (const Key &key, ExecutionContext &exe_ctx);
+
+    void
+    Insert (const Key &key, const lldb::UserExpressionSP &expr_sp);
+
+    //------------------------------------------------------------------
+    /// Drop every cached expression.  \a reason is only used for
+    /// logging.
+    //------------------------------------------------------------------
+    void
+    Clear (const char *reason);
+
+    size_t
+    GetSize () const;
+
+    void
+    Dump (Stream &s) const;
+
+    uint64_t
+    GetHitCount () const
+    {
+        return m_hits;
+    }
+
+    uint64_t
+    GetMissCount () const
+    {
+        return m_misses;
+    }
+
+protected:
+    // Most recently inserted first.
+    typedef std::list<Key> recency_list;
+
+    struct Entry
+    {
+        lldb::UserExpressionSP expr_sp;
+        recency_list::iterator recency_pos;
+    };
+
+    typedef std::map<Key, Entry> collection;
+
+    // Enough for the handful of expressions a breakpoint script evaluates
+    // in each of its stops, without holding on to a lot of JIT memory.
+    static const size_t kMaxEntries = 128;
+
+    mutable Mutex m_mutex;
+    collection m_expressions;
+    recency_list m_recency;
+    uint64_t m_hits;
+    uint64_t m_misses;
+    uint64_t m_inserts;
+    uint64_t m_invalidations;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (UserExpressionCache);
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_UserExpressionCache_h_
@@ -88,6 +88,17 @@ namespace lldb_private
         virtual Error
         GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegionInfo &range_info);
 
+        //------------------------------------------------------------------
+        /// Get every mapped region of the process, sorted by address.
+        ///
+        /// @param[out] generation
+        ///     A number that changes whenever the regions do, so that a
+        ///     client holding the regions of one generation can tell
+        ///     whether they are still current.
+        //------------------------------------------------------------------
+        virtual Error
+        GetMemoryRegions (std::vector<MemoryRegionInfo> &regions, uint32_t &generation);
+
         virtual Error
         ReadMemory(lldb::addr_t addr, void *buf, size_t size, size_t &bytes_read) = 0;
 
@@ -230,6 +241,30 @@ namespace lldb_private
         uint32_t
         GetStopID () const;
 
+        //----------------------------------------------------------------------
+        // Non-stop mode interface
+        //----------------------------------------------------------------------
+
+        //------------------------------------------------------------------
+        /// Enable or disable non-stop mode.
+        ///
+        /// In non-stop mode a thread that stops is reported on its own
+        /// through NativeDelegate::ThreadStopped and the other threads keep
+        /// running. Threads that are not mentioned in a Resume() action
+        /// list are left in whatever state they are in.
+        ///
+        /// @return
+        ///     An error if the process does not support non-stop mode.
+        //------------------------------------------------------------------
+        virtual Error
+        SetNonStopMode (bool enable);
+
+        bool
+        GetNonStopMode () const
+        {
+            return m_non_stop_mode;
+        }
+
         // ---------------------------------------------------------------------
         // Callbacks for low-level process state changes
         // ---------------------------------------------------------------------
@@ -247,6 +282,11 @@ namespace lldb_private
 
             virtual void
             DidExec (NativeProcessProtocol *process) = 0;
+
+            // Only called in non-stop mode, when thread \a tid stopped
+            // while the rest of the process may still be running.
+            virtual void
+            ThreadStopped (NativeProcessProtocol *process, lldb::tid_t tid) = 0;
         };
 
         //------------------------------------------------------------------
@@ -291,6 +331,17 @@ namespace lldb_private
         virtual Error
         GetFileLoadAddress(const llvm::StringRef& file_name, lldb::addr_t& load_addr) = 0;
 
+        //------------------------------------------------------------------
+        /// Write a core file of the stopped process to \a core_path on
+        /// this host.
+        ///
+        /// @param[in] skip_file_backed
+        ///     Leave the contents of read-only file mappings out of the
+        ///     core.  That memory reads as zeros when the core is loaded.
+        //------------------------------------------------------------------
+        virtual Error
+        SaveCore (const std::string &core_path, bool skip_file_backed);
+
         //------------------------------------------------------------------
         /// Launch a process for debugging. This method will create an concrete
         /// instance of NativeProcessProtocol, based on the host platform.
@@ -378,6 +429,7 @@ namespace lldb_private
         NativeWatchpointList m_watchpoint_list;
         int m_terminal_fd;
         uint32_t m_stop_id;
+        bool m_non_stop_mode;
 
         // -----------------------------------------------------------
         // Internal interface for state handling
@@ -412,6 +464,13 @@ namespace lldb_private
         void
         NotifyDidExec ();
 
+        // -----------------------------------------------------------
+        /// Notify the delegate that a single thread stopped while in
+        /// non-stop mode.
+        // -----------------------------------------------------------
+        void
+        NotifyThreadStopped (lldb::tid_t tid);
+
         NativeThreadProtocolSP
         GetThreadByIDUnlocked (lldb::tid_t tid);
 
@@ -36,11 +36,18 @@ public:
     // void
     // InvalidateIfNeeded (bool force);
 
+    //------------------------------------------------------------------
+    // Drop any register values cached since the thread last stopped.
+    // Called whenever the thread resumes or stops.
+    //------------------------------------------------------------------
+    virtual void
+    InvalidateAllRegisters ()
+    {
+    }
+
     //------------------------------------------------------------------
     // Subclasses must override these functions
     //------------------------------------------------------------------
-    // virtual void
-    // InvalidateAllRegisters () = 0;
 
     virtual uint32_t
     GetRegisterCount () const = 0;
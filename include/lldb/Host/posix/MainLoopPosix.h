@@ -12,6 +12,8 @@
 
 #include "lldb/Host/MainLoopBase.h"
 
+#include <vector>
+
 #include "llvm/ADT/DenseMap.h"
 
 namespace lldb_private {
@@ -20,6 +22,10 @@ namespace lldb_private {
 // readability using pselect. In addition to the common base, this class provides the ability to
 // invoke a given handler when a signal is received.
 //
+// On Linux, epoll and a signalfd are used instead of pselect, so that waking up costs the same
+// no matter how many file descriptors are monitored and there is no FD_SETSIZE limit. This lets
+// lldb-server in platform mode serve thousands of connections from one loop.
+//
 // Since this class is primarily intended to be used for single-threaded processing, it does not
 // attempt to perform any internal synchronisation and any concurrent accesses must be protected
 // externally. However, it is perfectly legitimate to have more than one instance of this class
@@ -34,6 +40,8 @@ private:
 public:
     typedef std::unique_ptr<SignalHandle> SignalHandleUP;
 
+    MainLoopPosix();
+
     ~MainLoopPosix() override;
 
     ReadHandleUP
@@ -66,6 +74,16 @@ protected:
     UnregisterSignal(int signo);
 
 private:
+#if defined(__linux__)
+    // Sets the signalfd's mask to the signals in m_signals, creating it the first time.
+    Error
+    UpdateSignalFD();
+
+    // Reads the pending signals out of the signalfd and flags them for Run().
+    void
+    ReadSignalFD();
+#endif
+
     class SignalHandle
     {
     public:
@@ -90,6 +108,12 @@ private:
 
     llvm::DenseMap<IOObject::WaitableHandle, Callback> m_read_fds;
     llvm::DenseMap<int, SignalInfo> m_signals;
+#if defined(__linux__)
+    int m_epoll_fd;
+    int m_signal_fd;
+    // epoll refuses regular files, which are always readable anyway.
+    std::vector<IOObject::WaitableHandle> m_always_ready_fds;
+#endif
     bool m_terminate_request : 1;
 };
 
@@ -116,6 +116,24 @@ private:
     // an offset into an individual Module.
     typedef RangeDataVector<lldb::addr_t, uint32_t, dw_offset_t> FDEEntryMap;
 
+    // The binary search table from an ELF .eh_frame_hdr section.  When it is
+    // present we can find the FDE for an address without scanning the whole
+    // eh_frame section.
+    struct EHFrameHdr
+    {
+        DataExtractor   data;
+        lldb::addr_t    file_addr;      // File address of the .eh_frame_hdr section (the datarel base)
+        lldb::offset_t  table_offset;   // Offset of the first table entry in data
+        uint32_t        fde_count;
+        uint8_t         table_enc;      // DW_EH_PE encoding of both fields of a table entry
+        uint32_t        field_size;     // Size in bytes of one field of a table entry
+
+        EHFrameHdr() : data(), file_addr (LLDB_INVALID_ADDRESS), table_offset (0),
+                       fde_count (0), table_enc (DW_EH_PE_omit), field_size (0)
+        {
+        }
+    };
+
     bool
     IsEHFrame() const;
 
@@ -125,6 +143,29 @@ private:
     void
     GetFDEIndex ();
 
+    // Decode the address range of the FDE at fde_offset.  offset points just
+    // past the FDE's CIE pointer.  Only reads m_cfi_data so it is safe to call
+    // from several threads at once.
+    bool
+    DecodeFDEAddressRange (lldb::offset_t offset,
+                           dw_offset_t fde_offset,
+                           const CIE &cie,
+                           bool clear_address_zeroth_bit,
+                           FDEEntryMap::Entry &fde_entry) const;
+
+    // Parse the header of the FDE at fde_offset and decode its address range.
+    bool
+    ParseFDEEntry (dw_offset_t fde_offset, FDEEntryMap::Entry &fde_entry);
+
+    bool
+    GetClearAddressZerothBit ();
+
+    bool
+    GetEHFrameHdr ();
+
+    bool
+    GetFDEEntryFromEHFrameHdr (lldb::addr_t file_addr, FDEEntryMap::Entry &fde_entry);
+
     bool
     FDEToUnwindPlan (uint32_t offset, Address startaddr, UnwindPlan& unwind_plan);
 
@@ -153,10 +194,16 @@ private:
     DataExtractor               m_cfi_data;
     bool                        m_cfi_data_initialized;   // only copy the section into the DE once
 
+    Mutex                       m_cie_map_mutex;          // protects m_cie_map, CIEs are parsed lazily
+
     FDEEntryMap                 m_fde_index;
     bool                        m_fde_index_initialized;  // only scan the section for FDEs once
     Mutex                       m_fde_index_mutex;        // and isolate the thread that does it
 
+    EHFrameHdr                  m_eh_frame_hdr;
+    bool                        m_eh_frame_hdr_initialized; // only look for .eh_frame_hdr once
+    bool                        m_eh_frame_hdr_valid;
+
     bool                        m_is_eh_frame;
 
     CIESP
@@ -110,6 +110,12 @@ public:
     bool
     GetWarningsOptimization () const;
 
+    uint64_t
+    GetUnwindStackSnapshotSize () const;
+
+    bool
+    GetSaveCoreSkipFileBacked () const;
+
 protected:
     static void
     OptionValueChangedCallback (void *baton, OptionValue *option_value);
@@ -2159,6 +2165,65 @@ public:
                 size_t size,
                 Error &error);
 
+    //------------------------------------------------------------------
+    /// Get a view of process memory without copying it.
+    ///
+    /// Processes whose memory is already mapped into the debugger, like
+    /// core files, can point \a data straight at the backing storage
+    /// instead of copying the bytes into a new buffer.  The view shares
+    /// ownership of that storage and must be treated as read only.
+    ///
+    /// @param[in] vm_addr
+    ///     The virtual load address of the first byte.
+    ///
+    /// @param[in] size
+    ///     The number of bytes the view must cover.
+    ///
+    /// @param[out] data
+    ///     Set to the view, with the target's byte order and address
+    ///     size, if this returns true.  Left untouched otherwise.
+    ///
+    /// @return
+    ///     True if all \a size bytes are available as a view.  False
+    ///     means the caller should fall back to ReadMemory, which is
+    ///     what happens for all processes that don't override this.
+    //------------------------------------------------------------------
+    virtual bool
+    GetMemoryData (lldb::addr_t vm_addr,
+                   size_t size,
+                   DataExtractor &data);
+
+    //------------------------------------------------------------------
+    /// Find the first occurrence of a byte pattern in process memory.
+    ///
+    /// The default implementation reads the range in large chunks (or
+    /// views it directly through GetMemoryData) and scans each chunk
+    /// with a vectorized search.  Unreadable regions reported by
+    /// GetMemoryRegionInfo are skipped.  Subclasses that can search
+    /// where the memory lives, like a remote stub, may override this.
+    ///
+    /// @param[in] low
+    ///     The lowest address a match may start at.
+    ///
+    /// @param[in] high
+    ///     One past the highest address a match may start at.
+    ///
+    /// @param[in] buf
+    ///     The bytes to look for.
+    ///
+    /// @param[in] size
+    ///     The number of bytes in \a buf.
+    ///
+    /// @return
+    ///     The address of the first match, or LLDB_INVALID_ADDRESS if
+    ///     there is none or memory before it couldn't be read.
+    //------------------------------------------------------------------
+    virtual lldb::addr_t
+    FindInMemory (lldb::addr_t low,
+                  lldb::addr_t high,
+                  const uint8_t *buf,
+                  size_t size);
+
     //------------------------------------------------------------------
     /// Read a NULL terminated string from memory
     ///
@@ -2561,6 +2626,19 @@ public:
     //------------------------------------------------------------------
     void SetCanRunCode (bool can_run_code);
 
+    //------------------------------------------------------------------
+    /// Determines whether code may run in this process at all.  Unlike
+    /// CanJIT(), this doesn't try to allocate memory in the process.
+    ///
+    /// @return
+    ///     False if code was explicitly disallowed with SetCanRunCode()
+    ///     or SetCanJIT(); true otherwise.
+    //------------------------------------------------------------------
+    bool CanRunCode () const
+    {
+        return m_can_jit != eCanJITNo;
+    }
+
     //------------------------------------------------------------------
     /// Actually deallocate memory in the process.
     ///
@@ -3172,6 +3250,31 @@ public:
         return Error("Not supported");
     }
 
+    //------------------------------------------------------------------
+    /// Let the process plug-in write a core file of this process
+    /// itself, before the object file plug-ins get to try.
+    ///
+    /// Remote stubs that can write a core on the target read the
+    /// inferior's memory locally, which is much faster than pulling it
+    /// across the connection one packet at a time.
+    ///
+    /// @param[in] outfile
+    ///     Where the core file should end up on the local host.
+    ///
+    /// @param[out] error
+    ///     The result of writing the core, if this returns true.
+    ///
+    /// @return
+    ///     \b true if this process handled the request, successfully or
+    ///     not, \b false if the object file plug-ins should write the
+    ///     core instead.
+    //------------------------------------------------------------------
+    virtual bool
+    SaveCore(const FileSpec &outfile, Error &error)
+    {
+        return false;
+    }
+
     size_t
     AddImageToken(lldb::addr_t image_ptr);
 
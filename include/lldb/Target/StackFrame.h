@@ -450,6 +450,23 @@ public:
     lldb::ValueObjectSP
     GetValueObjectForFrameVariable (const lldb::VariableSP &variable_sp, lldb::DynamicValueType use_dynamic);
 
+    //------------------------------------------------------------------
+    /// Read the memory that the arguments and locals in \a variable_list
+    /// live in, so that the ValueObjects made for them are updated from
+    /// the process memory cache instead of reading one by one.
+    ///
+    /// The location of each variable is evaluated, the ranges they cover
+    /// are coalesced and each coalesced range is read with a single
+    /// memory read.  This is done once per stop and can be turned off
+    /// with target.prefetch-frame-variables.
+    ///
+    /// @params [in] variable_list
+    ///   The variables that are about to be displayed, usually from
+    ///   GetVariableList or GetInScopeVariableList.
+    //------------------------------------------------------------------
+    void
+    PrefetchVariableMemory (VariableList &variable_list);
+
     //------------------------------------------------------------------
     /// Add an arbitrary Variable object (e.g. one that specifics a global or static)
     /// to a StackFrame's list of ValueObjects.
@@ -536,6 +553,7 @@ private:
     bool m_is_history_frame;
     lldb::VariableListSP m_variable_list_sp;
     ValueObjectList m_variable_list_value_objects;  // Value objects for each variable in m_variable_list_sp
+    uint32_t m_variables_prefetch_stop_id;          // The process stop ID PrefetchVariableMemory last ran at
     StreamString m_disassembly;
     Mutex m_mutex;
 
@@ -15,6 +15,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <unordered_set>
@@ -29,6 +30,7 @@
 #include "lldb/Core/Disassembler.h"
 #include "lldb/Core/ModuleList.h"
 #include "lldb/Core/UserSettingsController.h"
+#include "lldb/Host/HostThread.h"
 #include "Plugins/ExpressionParser/Clang/ClangModulesDeclVendor.h"
 #include "Plugins/ExpressionParser/Clang/ClangPersistentVariables.h"
 #include "lldb/Interpreter/Args.h"
@@ -39,6 +41,7 @@
 #include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Target/ABI.h"
 #include "lldb/Expression/Expression.h"
+#include "lldb/Expression/UserExpressionCache.h"
 #include "lldb/Symbol/TypeSystem.h"
 #include "lldb/Target/ExecutionContextScope.h"
 #include "lldb/Target/PathMappingList.h"
@@ -172,6 +175,12 @@ public:
 
     FileSpec &
     GetModuleCachePath ();
+
+    bool
+    GetSwiftPersistentModuleCache () const;
+
+    bool
+    GetSwiftWarmUpModules () const;
     
     bool
     GetEnableAutoImportClangModules () const;
@@ -184,12 +193,21 @@ public:
     
     bool
     GetEnableNotifyAboutFixIts () const;
+
+    bool
+    GetEnableExpressionCache () const;
+
+    bool
+    GetPrefetchFrameVariables () const;
     
     bool
     GetEnableSyntheticValue () const;
     
     uint32_t
     GetMaximumNumberOfChildrenToDisplay() const;
+
+    uint32_t
+    GetMaximumNumberOfCachedSyntheticChildren() const;
     
     uint32_t
     GetMaximumSizeOfStringSummary() const;
@@ -1407,6 +1425,16 @@ public:
                                  Expression::ResultType desired_type,
                                  const EvaluateExpressionOptions &options,
                                  Error &error);
+
+    //------------------------------------------------------------------
+    /// Parsed expressions that UserExpression::Evaluate can run again
+    /// without re-parsing, see UserExpressionCache.
+    //------------------------------------------------------------------
+    UserExpressionCache &
+    GetUserExpressionCache ()
+    {
+        return m_expression_cache;
+    }
     
     // Creates a FunctionCaller for the given language, the rest of the parameters have the
     // same meaning as for the FunctionCaller constructor.  Since a FunctionCaller can't be
@@ -1469,6 +1497,16 @@ public:
     GetScratchSwiftASTContext(Error &error, bool create_on_demand=true, const char *extra_options = nullptr);
 #endif
 
+    //------------------------------------------------------------------
+    /// Create the scratch Swift context, and load the Swift standard
+    /// library into it, on a background thread so that the first
+    /// expression doesn't have to.  Anything that asks for the scratch
+    /// Swift context, or clears or walks the scratch type systems,
+    /// meanwhile waits for it to be done.
+    //------------------------------------------------------------------
+    void
+    StartSwiftWarmUp ();
+
 
     //----------------------------------------------------------------------
     // Install any files through the platform that need be to installed
@@ -1730,6 +1768,15 @@ protected:
     void
     WillClearList(const ModuleList& module_list) override;
 
+    void
+    WaitForSwiftWarmUp ();
+
+    void
+    WarmUpSwiftASTContext ();
+
+    static lldb::thread_result_t
+    SwiftWarmUpThread (lldb::thread_arg_t arg);
+
     //------------------------------------------------------------------
     // Member variables.
     //------------------------------------------------------------------
@@ -1752,6 +1799,9 @@ protected:
     PathMappingList m_image_search_paths;
     TypeSystemMap m_scratch_type_system_map;
     std::map<lldb::LanguageType, bool> m_cant_make_scratch_type_system;
+    UserExpressionCache m_expression_cache;
+    std::mutex m_swift_warm_up_mutex;
+    HostThread m_swift_warm_up_thread;             ///< Runs StartSwiftWarmUp()'s work, joined by WaitForSwiftWarmUp()
     
     typedef std::map<lldb::LanguageType, lldb::REPLSP> REPLMap;
     REPLMap m_repl_map;
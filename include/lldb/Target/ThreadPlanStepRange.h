@@ -59,6 +59,13 @@ protected:
 
     InstructionList *
     GetInstructionsForAddress(lldb::addr_t addr, size_t &range_index, size_t &insn_offset);
+
+    // Uses the module's shared branch map for the function containing our range to find where
+    // to run to from addr.  Returns false if there is no branch map to use and the range has to
+    // be disassembled instead, otherwise run_to_address is set (or left invalid if we should
+    // just single step).
+    bool
+    GetRunToAddressFromBranchMap (lldb::addr_t addr, Address &run_to_address);
     
     // Pushes a plan to proceed through the next section of instructions in the range - usually just a RunToAddress
     // plan to run to the next branch.  Returns true if it pushed such a plan.  If there was no available 'quick run'
@@ -85,7 +92,16 @@ protected:
     bool                      m_given_ranges_only;
 
 private:
+    struct BranchMapSlot
+    {
+        BranchMapSlot () : resolved (false), branch_map_sp () { }
+
+        bool resolved;                              // We looked for the branch map for this range
+        lldb::InstructionBranchMapSP branch_map_sp; // Shared with every other plan stepping in this function
+    };
+
     std::vector<lldb::DisassemblerSP> m_instruction_ranges;
+    std::vector<BranchMapSlot> m_branch_maps;
 
     DISALLOW_COPY_AND_ASSIGN (ThreadPlanStepRange);
 };
@@ -0,0 +1,108 @@
+//===-- MemorySearch.h ------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_MemorySearch_h_
+#define liblldb_MemorySearch_h_
+
+// C Includes
+#include <stddef.h>
+#include <stdint.h>
+
+// C++ Includes
+#include <functional>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-types.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class MemorySearcher MemorySearch.h "lldb/Utility/MemorySearch.h"
+/// @brief Finds a byte pattern in a block of memory.
+///
+/// The pattern is preprocessed once into a Boyer-Moore-Horspool skip
+/// table so the same searcher can be used on many consecutive blocks
+/// of a large range.  When SSE2 is available, candidate positions are
+/// found 16 bytes at a time by matching the first and last byte of the
+/// pattern, and only those candidates are compared in full.
+//----------------------------------------------------------------------
+class MemorySearcher
+{
+public:
+    static const size_t npos = SIZE_MAX;
+
+    MemorySearcher (const uint8_t *pattern, size_t pattern_size);
+
+    //------------------------------------------------------------------
+    /// Find the first occurrence of the pattern in \a data.
+    ///
+    /// @return
+    ///     The offset of the first match that lies entirely within
+    ///     \a data, or npos if there is none.  An empty pattern
+    ///     matches at offset zero.
+    //------------------------------------------------------------------
+    size_t
+    Find (const uint8_t *data, size_t data_size) const;
+
+    //------------------------------------------------------------------
+    /// Reads up to \a size bytes at \a addr, sets \a bytes_read to the
+    /// number of bytes that could be read and returns where they are.
+    //------------------------------------------------------------------
+    typedef std::function<const uint8_t *(lldb::addr_t addr, size_t size, size_t &bytes_read)> ReadCallback;
+
+    //------------------------------------------------------------------
+    /// Called with the first address a read stopped at.  Sets
+    /// \a next_addr to the first address after it worth reading and
+    /// returns true, or returns false to give up.
+    //------------------------------------------------------------------
+    typedef std::function<bool (lldb::addr_t bad_addr, lldb::addr_t &next_addr)> SkipCallback;
+
+    //------------------------------------------------------------------
+    /// Find the first occurrence of the pattern in [\a start, \a end),
+    /// reading it \a chunk_size bytes at a time with \a read.
+    ///
+    /// Consecutive chunks overlap by one byte less than the pattern, so
+    /// a match that straddles two chunks is found.  When a read stops
+    /// short, the search goes on where \a skip_unreadable says.
+    ///
+    /// @param[out] found_addr
+    ///     The address of the first match that lies entirely within
+    ///     the range, or LLDB_INVALID_ADDRESS if there is none.
+    ///
+    /// @return
+    ///     False if the search gave up on memory it couldn't read
+    ///     before finding a match, true otherwise.
+    //------------------------------------------------------------------
+    bool
+    FindInRange (lldb::addr_t start,
+                 lldb::addr_t end,
+                 size_t chunk_size,
+                 const ReadCallback &read,
+                 const SkipCallback &skip_unreadable,
+                 lldb::addr_t &found_addr) const;
+
+    size_t
+    GetPatternSize () const
+    {
+        return m_pattern.size();
+    }
+
+private:
+    size_t
+    FindHorspool (const uint8_t *data, size_t data_size, size_t start) const;
+
+    std::vector<uint8_t> m_pattern;
+    size_t m_skip[256];
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_MemorySearch_h_
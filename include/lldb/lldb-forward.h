@@ -112,6 +112,7 @@ class   Function;
 class   FunctionInfo;
 class   InlineFunctionInfo;
 class   Instruction;
+class   InstructionBranchMap;
 class   InstructionList;
 class   InstrumentationRuntime;
 class   IOHandler;
@@ -345,6 +346,7 @@ namespace lldb {
     typedef std::unique_ptr<lldb_private::GoASTContext> GoASTContextUP;
     typedef std::shared_ptr<lldb_private::InlineFunctionInfo> InlineFunctionInfoSP;
     typedef std::shared_ptr<lldb_private::Instruction> InstructionSP;
+    typedef std::shared_ptr<lldb_private::InstructionBranchMap> InstructionBranchMapSP;
     typedef std::shared_ptr<lldb_private::InstrumentationRuntime> InstrumentationRuntimeSP;
     typedef std::shared_ptr<lldb_private::IOHandler> IOHandlerSP;
     typedef std::shared_ptr<lldb_private::IOObject> IOObjectSP;
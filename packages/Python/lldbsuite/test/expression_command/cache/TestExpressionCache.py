@@ -0,0 +1,138 @@
+"""
+Test that re-evaluated expressions are reused from the target's expression
+cache, and only when that is safe
+"""
+
+from __future__ import print_function
+
+
+
+import os
+import re
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class ExpressionCacheTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # UserExpressionCache::kMaxEntries
+    MAX_ENTRIES = 128
+
+    def setUp(self):
+        TestBase.setUp(self)
+        self.main_source_spec = lldb.SBFileSpec("main.c")
+        self.log_file = os.path.join(os.getcwd(), "expression-cache-%s.log" % self.testMethodName)
+        self.log_offset = 0
+
+    def tearDown(self):
+        self.runCmd("log disable lldb expr", check=False)
+        if os.path.exists(self.log_file):
+            os.remove(self.log_file)
+        TestBase.tearDown(self)
+
+    def launch_to_func(self):
+        self.build()
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.target = self.dbg.CreateTarget(exe)
+        self.assertTrue(self.target, VALID_TARGET)
+        self.breakpoint = self.target.BreakpointCreateBySourceRegex("Break in func", self.main_source_spec)
+        self.assertTrue(self.breakpoint.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        if os.path.exists(self.log_file):
+            os.remove(self.log_file)
+        self.runCmd("log enable -f %s lldb expr" % self.log_file)
+
+        self.process = self.target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(self.process, PROCESS_IS_VALID)
+        return self.stopped_frame()
+
+    def stopped_frame(self):
+        threads = lldbutil.get_threads_stopped_at_breakpoint(self.process, self.breakpoint)
+        self.assertEqual(len(threads), 1)
+        return threads[0].GetFrameAtIndex(0)
+
+    def continue_to_func(self):
+        self.process.Continue()
+        return self.stopped_frame()
+
+    def read_log(self):
+        """Return the log lines written since the last call."""
+        with open(self.log_file) as f:
+            f.seek(self.log_offset)
+            contents = f.read()
+            self.log_offset = f.tell()
+        return contents.splitlines()
+
+    def evaluate(self, frame, expr, expected_value, expected_lookup):
+        """Evaluate expr and check its value and whether the cache had it ("hit") or not ("miss")."""
+        self.read_log()
+        value = frame.EvaluateExpression(expr)
+        self.assertTrue(value.GetError().Success(), "%s failed: %s" % (expr, value.GetError().GetCString()))
+        self.assertEqual(value.GetValueAsSigned(), expected_value, "value of " + expr)
+
+        lookups = []
+        for line in self.read_log():
+            match = re.search(r'UserExpressionCache::Take\(\) (hit|miss) for "(.*)" at', line)
+            if match and match.group(2) == expr:
+                lookups.append(match.group(1))
+        self.assertEqual(lookups, [expected_lookup], "cache lookups for " + expr)
+
+    @skipIfWindows
+    def test_hit(self):
+        """Test that an expression is reused when evaluated again at the same address"""
+        frame = self.launch_to_func()
+        self.evaluate(frame, "arg + g_value", 11, "miss")
+        self.evaluate(frame, "arg + g_value", 11, "hit")
+        # An identical expression with different options is parsed again.
+        options = lldb.SBExpressionOptions()
+        options.SetFetchDynamicValue(lldb.eDynamicCanRunTarget)
+        self.read_log()
+        self.assertTrue(frame.EvaluateExpression("arg + g_value", options).GetError().Success())
+        self.assertTrue(any('miss for "arg + g_value"' in line for line in self.read_log()))
+
+        # The reused code reads the new frame's variables.
+        frame = self.continue_to_func()
+        self.evaluate(frame, "arg + g_value", 12, "hit")
+
+    @skipIfWindows
+    def test_invalidation(self):
+        """Test that a cached expression isn't used in another context or after modules change"""
+        frame = self.launch_to_func()
+        self.evaluate(frame, "arg * g_value", 10, "miss")
+
+        # A different frame address is a different context.
+        parent = frame.GetThread().GetFrameAtIndex(1)
+        self.evaluate(parent, "g_value * 2", 20, "miss")
+        self.evaluate(frame, "g_value * 2", 20, "miss")
+
+        # Loading a module drops everything cached so far.
+        frame = self.continue_to_func()
+        self.evaluate(frame, "arg * g_value", 20, "hit")
+        frame = self.continue_to_func()
+        self.evaluate(frame, "arg * g_value", 30, "miss")
+
+        # And so does a new process.
+        self.process.Kill()
+        self.process = self.target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(self.process, PROCESS_IS_VALID)
+        frame = self.stopped_frame()
+        self.evaluate(frame, "arg * g_value", 10, "miss")
+
+    @skipIfWindows
+    def test_eviction_order(self):
+        """Test that a full cache drops the least recently used expression"""
+        frame = self.launch_to_func()
+        for i in range(self.MAX_ENTRIES):
+            self.evaluate(frame, "arg + %d" % i, 1 + i, "miss")
+
+        # Using the oldest expression makes it the most recent one.
+        self.evaluate(frame, "arg + 0", 1, "hit")
+
+        # So the next new expression pushes out the second oldest.
+        self.evaluate(frame, "arg + %d" % self.MAX_ENTRIES, 1 + self.MAX_ENTRIES, "miss")
+        self.evaluate(frame, "arg + 0", 1, "hit")
+        self.evaluate(frame, "arg + 2", 3, "hit")
+        self.evaluate(frame, "arg + 1", 2, "miss")
@@ -0,0 +1,28 @@
+#include <dlfcn.h>
+#include <stdio.h>
+
+int g_value = 10;
+
+static int
+func (int arg)
+{
+    return arg + g_value; // Break in func
+}
+
+int
+main (int argc, char const *argv[])
+{
+    int result = func (1);
+    result += func (2);
+
+    // Loads a module between two stops at the same address.
+#if defined(__APPLE__)
+    void *handle = dlopen ("libz.dylib", RTLD_NOW);
+#else
+    void *handle = dlopen ("libm.so.6", RTLD_NOW);
+#endif
+    result += func (3);
+
+    printf ("%d %p\n", result, handle);
+    return 0;
+}
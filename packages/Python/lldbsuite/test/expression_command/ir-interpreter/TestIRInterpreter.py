@@ -27,6 +27,31 @@ class IRInterpreterTestCase(TestBase):
         self.runCmd("settings set auto-confirm true")
         self.addTearDownHook(lambda: self.runCmd("settings clear auto-confirm"))
 
+    # Calls to variadic functions can't be interpreted, so this sends
+    # whatever follows it to the JIT.
+    jit_prefix = "(int)printf(\"\"); "
+
+    def jit_expression(self, expression):
+        return self.jit_prefix + expression
+
+    def evaluate_and_check_interpreted(self, expression, options, interpreted):
+        """Evaluate expression and check from the expression log whether the IR interpreter ran it."""
+        logfile = os.path.join(os.getcwd(), "ir-interpreter-" + self.getArchitecture() + ".txt")
+        if os.path.exists(logfile):
+            os.unlink(logfile)
+        self.runCmd("log enable -f %s lldb expr" % (logfile))
+        value = self.frame().EvaluateExpression(expression, options)
+        self.runCmd("log disable lldb expr")
+
+        with open(logfile) as f:
+            log = f.read()
+        os.unlink(logfile)
+
+        was_jitted = "it will be JIT'ed" in log
+        self.assertEqual(not was_jitted, interpreted,
+                         "%s should %sbe interpreted" % (expression, "" if interpreted else "not "))
+        return value, log
+
     def build_and_run(self):
         """Test the IR interpreter"""
         self.build()
@@ -61,10 +86,118 @@ class IRInterpreterTestCase(TestBase):
 
         for expression in expressions:
             interp_expression   = expression
-            jit_expression      = "(int)getpid(); " + expression
+            jit_expression      = self.jit_expression(expression)
 
             interp_result       = self.frame().EvaluateExpression(interp_expression, options).GetValueAsSigned()
             jit_result          = self.frame().EvaluateExpression(jit_expression, options).GetValueAsSigned()
 
             self.assertEqual(interp_result, jit_result, "While evaluating " + expression)
 
+    def compare_with_jit(self, options, set_up_expressions, expressions):
+        for expression in set_up_expressions:
+            self.frame().EvaluateExpression(expression, options)
+
+        for expression in expressions:
+            interp_value, log = self.evaluate_and_check_interpreted(expression, options, True)
+            jit_value = self.frame().EvaluateExpression(self.jit_expression(expression), options)
+
+            self.assertTrue(interp_value.GetError().Success(), "While interpreting " + expression)
+            self.assertTrue(jit_value.GetError().Success(), "While JIT'ing " + expression)
+            self.assertEqual(interp_value.GetValue(), jit_value.GetValue(), "While evaluating " + expression)
+
+    @add_test_categories(['pyapi'])
+    def test_ir_interpreter_floating_point(self):
+        self.build_and_run()
+
+        options = lldb.SBExpressionOptions()
+        options.SetLanguage(lldb.eLanguageTypeC_plus_plus)
+
+        set_up_expressions = ["double $d = 7.25", "float $f = 2.5f", "int $n = -3", "unsigned $u = 4"]
+
+        expressions = ["$d + $f",
+                       "$d - $f",
+                       "$d * $f",
+                       "$d / $f",
+                       "$f * $f",
+                       "$d < $f",
+                       "$d >= $f",
+                       "$d == 7.25",
+                       "$f != 2.5f",
+                       "(double)$f",
+                       "(float)$d",
+                       "(int)-$d",
+                       "(unsigned)$d",
+                       "(double)$n",
+                       "(float)$u"]
+
+        self.compare_with_jit(options, set_up_expressions, expressions)
+
+    @add_test_categories(['pyapi'])
+    def test_ir_interpreter_select_and_phi(self):
+        self.build_and_run()
+
+        options = lldb.SBExpressionOptions()
+        options.SetLanguage(lldb.eLanguageTypeC_plus_plus)
+
+        set_up_expressions = ["int $i = 9", "int $j = 3", "int $k = 5"]
+
+        # Clang emits PHI nodes for && and ||, and select or PHI for ?:.
+        expressions = ["$i > $j && $j > 0",
+                       "$i < $j || $k == 5",
+                       "$i < $j || $k == 4",
+                       "$i > $j && $j > $k",
+                       "$i > $j ? $i : $k",
+                       "$i < $j ? $i : $k",
+                       "($i > $j && $k > $j) ? $i + $k : $j"]
+
+        self.compare_with_jit(options, set_up_expressions, expressions)
+
+    @add_test_categories(['pyapi'])
+    def test_ir_interpreter_calls(self):
+        self.build_and_run()
+
+        options = lldb.SBExpressionOptions()
+        options.SetLanguage(lldb.eLanguageTypeC_plus_plus)
+
+        self.compare_with_jit(options,
+                              ["int $i = 9", "int $j = 3", "int $k = 5"],
+                              ["add_three($i, $j, $k)", "add_three(1, -2, 3)"])
+
+        # A pointer read out of a variable can be passed by the interpreter.
+        self.frame().EvaluateExpression("int *$p = &g_value", options)
+        value, log = self.evaluate_and_check_interpreted("set_through($p, 4)", options, True)
+        self.assertEqual(value.GetValueAsSigned(), 4)
+        self.assertEqual(self.frame().EvaluateExpression("g_value", options).GetValueAsSigned(), 4)
+
+        # The address of a persistent variable may be memory only the
+        # debugger has, so that call has to be JIT'ed.
+        self.frame().EvaluateExpression("int $v = 1", options)
+        value, log = self.evaluate_and_check_interpreted("set_through(&$v, 7)", options, False)
+        self.assertTrue("memory only the debugger has" in log)
+        self.assertEqual(value.GetValueAsSigned(), 7)
+        self.assertEqual(self.frame().EvaluateExpression("$v", options).GetValueAsSigned(), 7)
+
+    @add_test_categories(['pyapi'])
+    def test_ir_interpreter_call_options(self):
+        self.build_and_run()
+
+        callee_line = line_number('main.c', '// Set callee breakpoint here')
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", callee_line, num_expected_locations=1, loc_exact=False)
+
+        options = lldb.SBExpressionOptions()
+        options.SetLanguage(lldb.eLanguageTypeC_plus_plus)
+
+        # Interpreted calls are run with the expression's options, so the
+        # breakpoint in the callee can be ignored...
+        options.SetIgnoreBreakpoints(True)
+        value, log = self.evaluate_and_check_interpreted("stop_in_callee(1)", options, True)
+        self.assertTrue(value.GetError().Success())
+        self.assertEqual(value.GetValueAsSigned(), 2)
+
+        # ...or stop the call, without unwinding.
+        options.SetIgnoreBreakpoints(False)
+        options.SetUnwindOnError(False)
+        value, log = self.evaluate_and_check_interpreted("stop_in_callee(1)", options, True)
+        self.assertFalse(value.GetError().Success())
+        self.assertEqual(self.thread().GetFrameAtIndex(0).GetFunctionName(), "stop_in_callee")
+        self.runCmd("thread return -x")
@@ -1,7 +1,25 @@
 #include <stdio.h>
 
+int g_value = 10;
+
+int add_three(int a, int b, int c)
+{
+    return a + b + c;
+}
+
+int set_through(int *p, int v)
+{
+    *p = v;
+    return v;
+}
+
+int stop_in_callee(int v)
+{
+    return v + 1; // Set callee breakpoint here
+}
+
 int main()
 {
     printf("This is a dummy\n"); // Set breakpoint here   
-    return 0;
+    return add_three(0, 0, 0) + set_through(&g_value, g_value) + stop_in_callee(-1) - 10;
 }
@@ -0,0 +1,110 @@
+"""
+Test that the libc++ formatters' prefetching gives the same children and
+saves memory reads.
+"""
+
+from __future__ import print_function
+
+
+
+import os, re
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class LibcxxPrefetchDataFormatterTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # The formatters prefetch up to target.max-children-count elements or
+    # nodes at a time.
+    WINDOW = 16
+
+    def setUp(self):
+        TestBase.setUp(self)
+        self.log_file = os.path.join(os.getcwd(), "libcxx-prefetch-packets.log")
+        self.log_offset = 0
+
+    def tearDown(self):
+        self.runCmd("log disable gdb-remote packets", check=False)
+        self.runCmd("settings clear target.max-children-count", check=False)
+        if os.path.exists(self.log_file):
+            os.remove(self.log_file)
+        TestBase.tearDown(self)
+
+    def count_memory_read_packets(self):
+        """Return how many memory read packets were sent since the last call."""
+        with open(self.log_file) as f:
+            f.seek(self.log_offset)
+            contents = f.read()
+            self.log_offset = f.tell()
+        return len(re.findall(r"send packet: \$(?:x|m|qSharedMemoryRead:)[0-9a-fA-F]+,", contents))
+
+    def get_children(self, name):
+        value = self.frame().FindVariable(name)
+        self.assertTrue(value.IsValid(), "no variable " + name)
+        return [value.GetChildAtIndex(i) for i in range(value.GetNumChildren())]
+
+    @skipIf(compiler="gcc")
+    @skipIfWindows # libc++ not ported to Windows yet
+    @skipIfRemote
+    def test_prefetched_children(self):
+        """Test every child of libc++ containers larger than the prefetch window."""
+        self.build()
+        self.runCmd("file a.out", CURRENT_EXECUTABLE_SET)
+
+        lldbutil.skip_if_library_missing(self, self.target(), lldbutil.PrintableRegex("libc\+\+"))
+
+        lldbutil.run_break_set_by_source_regexp (self, "break here")
+        self.runCmd("settings set target.max-children-count %d" % self.WINDOW)
+        self.runCmd("run", RUN_SUCCEEDED)
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'stop reason = breakpoint'])
+        self.runCmd("log enable -f %s gdb-remote packets" % self.log_file)
+
+        children = self.get_children("numbers")
+        self.assertEqual(len(children), 1000)
+        for i, child in enumerate(children):
+            self.assertEqual(child.GetValueAsSigned(), i * 3, "numbers[%d]" % i)
+        # A window of elements per read, not one read per element.
+        self.assertTrue(self.count_memory_read_packets() < 1000 / 4,
+                        "vector elements were read one at a time")
+
+        children = self.get_children("list")
+        self.assertEqual(len(children), 200)
+        for i, child in enumerate(children):
+            self.assertEqual(child.GetValueAsSigned(), i * 7, "list[%d]" % i)
+        # The nodes were allocated one after the other, so most of them come
+        # from a prefetched window.
+        self.assertTrue(self.count_memory_read_packets() < 200,
+                        "list nodes were read one at a time")
+
+        children = self.get_children("map")
+        self.assertEqual(len(children), 200)
+        for i, child in enumerate(children):
+            self.assertEqual(child.GetChildMemberWithName("first").GetValueAsSigned(), i)
+            self.assertEqual(child.GetChildMemberWithName("second").GetValueAsSigned(), i * 2 + 1)
+
+        children = self.get_children("unordered")
+        self.assertEqual(len(children), 200)
+        pairs = {}
+        for child in children:
+            key = child.GetChildMemberWithName("first").GetValueAsSigned()
+            self.assertFalse(key in pairs, "key %d listed twice" % key)
+            pairs[key] = child.GetChildMemberWithName("second").GetValueAsSigned()
+        self.assertEqual(pairs, dict((i, i * 4) for i in range(200)))
+
+        # Children that lie outside the current window are still right.
+        numbers = self.frame().FindVariable("numbers")
+        self.assertEqual(numbers.GetChildAtIndex(999).GetValueAsSigned(), 2997)
+        self.assertEqual(numbers.GetChildAtIndex(0).GetValueAsSigned(), 0)
+        # Prefetched children keep their addresses, so they can be written.
+        child = numbers.GetChildAtIndex(500)
+        self.assertTrue(child.SetValueFromCString("42"))
+        error = lldb.SBError()
+        process = self.dbg.GetSelectedTarget().GetProcess()
+        value = process.ReadUnsignedFromMemory(child.GetLoadAddress(), 4, error)
+        self.assertTrue(error.Success(), error.GetCString())
+        self.assertEqual(value, 42)
@@ -0,0 +1,21 @@
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+int main()
+{
+    std::vector<int> numbers;
+    std::list<int> list;
+    std::map<int, int> map;
+    std::unordered_map<int, int> unordered;
+    for (int i = 0; i < 1000; i++)
+        numbers.push_back(i * 3);
+    for (int i = 0; i < 200; i++)
+    {
+        list.push_back(i * 7);
+        map[i] = i * 2 + 1;
+        unordered[i] = i * 4;
+    }
+    return numbers.size() + list.size() + map.size() + unordered.size(); // break here
+}
@@ -0,0 +1,60 @@
+# coding=utf8
+"""
+Test that long UTF8, UTF16 and UTF32 string summaries, which are read and
+printed a chunk at a time, come out right where a chunk boundary splits a
+character.
+"""
+
+from __future__ import print_function
+
+
+
+import os
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class StringPrinterChunksTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    REPEAT = 600
+    PATTERN = u"a€\U0001F600é"
+
+    def setUp(self):
+        TestBase.setUp(self)
+        self.line = line_number('main.cpp', '// Set break point at this line.')
+
+    def get_summary(self, name):
+        value = self.frame().FindVariable(name)
+        self.assertTrue(value.IsValid(), "no variable " + name)
+        summary = value.GetSummary()
+        self.assertIsNotNone(summary, "no summary for " + name)
+        if not isinstance(summary, type(u"")):
+            summary = summary.decode("utf-8")
+        return summary
+
+    @skipIfWindows
+    def test_split_characters(self):
+        """Test string summaries that span many chunks."""
+        self.build()
+        self.runCmd("file a.out", CURRENT_EXECUTABLE_SET)
+        lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.line, num_expected_locations=1, loc_exact=True)
+        self.runCmd("run", RUN_SUCCEEDED)
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'stop reason = breakpoint'])
+
+        # Long enough for the whole strings.
+        self.runCmd("settings set target.max-string-summary-length 65536")
+        self.addTearDownHook(lambda: self.runCmd("settings clear target.max-string-summary-length", check=False))
+
+        expected = self.PATTERN * self.REPEAT
+        self.assertEqual(self.get_summary("utf16"), u'u"' + expected + u'"')
+        self.assertEqual(self.get_summary("utf32"), u'U"' + expected + u'"')
+        self.assertEqual(self.get_summary("utf8"), u'"' + expected + u'"')
+
+        # A summary cut short ends with an ellipsis.
+        self.runCmd("settings set target.max-string-summary-length 1000")
+        self.assertEqual(self.get_summary("utf8"), u'"' + self.PATTERN * 100 + u'"...')
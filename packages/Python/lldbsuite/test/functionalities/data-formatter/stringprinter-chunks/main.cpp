@@ -0,0 +1,32 @@
+#include <string>
+
+// Mixes 1, 2, 3 and 4 byte UTF8 sequences and UTF16 surrogate pairs, so
+// that wherever the summary's chunk boundaries fall, some of them split a
+// character.
+#define REPEAT 600
+
+char16_t g_utf16[REPEAT * 5 + 1];
+char32_t g_utf32[REPEAT * 4 + 1];
+
+int main()
+{
+    std::string utf8;
+    for (int i = 0; i < REPEAT; i++)
+    {
+        utf8 += "a\xe2\x82\xac\xf0\x9f\x98\x80\xc3\xa9";
+
+        g_utf16[i * 5] = u'a';
+        g_utf16[i * 5 + 1] = 0x20ac;
+        g_utf16[i * 5 + 2] = 0xd83d;
+        g_utf16[i * 5 + 3] = 0xde00;
+        g_utf16[i * 5 + 4] = 0xe9;
+
+        g_utf32[i * 4] = U'a';
+        g_utf32[i * 4 + 1] = 0x20ac;
+        g_utf32[i * 4 + 2] = 0x1f600;
+        g_utf32[i * 4 + 3] = 0xe9;
+    }
+    const char16_t *utf16 = g_utf16;
+    const char32_t *utf32 = g_utf32;
+    return utf8.size() + utf16[0] + utf32[0]; // Set break point at this line.
+}
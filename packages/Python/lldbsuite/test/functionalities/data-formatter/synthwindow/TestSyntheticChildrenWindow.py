@@ -0,0 +1,99 @@
+"""
+Test that target.max-cached-synthetic-children bounds the synthetic
+children a value keeps, and that evicted children come back unchanged
+"""
+
+from __future__ import print_function
+
+
+
+import os
+import sys
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class SyntheticChildrenWindowTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    WINDOW_SIZE = 10
+
+    def setUp(self):
+        TestBase.setUp(self)
+        self.line = line_number('main.cpp', '// Set break point at this line.')
+
+    def get_numbers(self, window_size):
+        """Stop in main with the given window size and return the synthetic value of numbers."""
+        self.build()
+        self.runCmd("file a.out", CURRENT_EXECUTABLE_SET)
+        lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.line, num_expected_locations=1, loc_exact=True)
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        def cleanup():
+            self.runCmd('type synth clear', check=False)
+            self.runCmd("settings clear target.max-cached-synthetic-children", check=False)
+        self.addTearDownHook(cleanup)
+
+        self.runCmd("settings set target.max-cached-synthetic-children %d" % window_size)
+        self.runCmd("script from windowSynthProvider import *")
+        self.runCmd("type synth add -l numbersSynthProvider Numbers")
+        self.provider_module = sys.modules['windowSynthProvider']
+        self.provider_module.calls.clear()
+
+        frame = self.dbg.GetSelectedTarget().GetProcess().GetSelectedThread().GetSelectedFrame()
+        numbers = frame.FindVariable("numbers")
+        self.assertTrue(numbers.IsValid())
+        self.assertTrue(numbers.IsSynthetic())
+        self.assertEqual(numbers.GetNumChildren(), 1000)
+        return numbers
+
+    def check_child(self, numbers, index):
+        child = numbers.GetChildAtIndex(index)
+        self.assertTrue(child.IsValid())
+        self.assertEqual(child.GetName(), "[%d]" % index)
+        self.assertEqual(child.GetValueAsSigned(), index * 3)
+
+    def calls(self, index):
+        return self.provider_module.calls.get(index, 0)
+
+    def test_without_window(self):
+        """Test that every synthetic child is kept when no window is set"""
+        numbers = self.get_numbers(0)
+        self.check_child(numbers, 0)
+        self.check_child(numbers, 500)
+        self.check_child(numbers, 999)
+        self.check_child(numbers, 0)
+        self.assertEqual(self.calls(0), 1)
+        self.assertEqual(self.calls(500), 1)
+
+    def test_window_keeps_nearby_children(self):
+        """Test that children within the window aren't created again"""
+        numbers = self.get_numbers(self.WINDOW_SIZE)
+        for index in range(self.WINDOW_SIZE):
+            self.check_child(numbers, index)
+        for index in range(self.WINDOW_SIZE):
+            self.check_child(numbers, index)
+            self.assertEqual(self.calls(index), 1, "child %d was created again" % index)
+
+    def test_window_evicts_far_children(self):
+        """Test that children that fall out of the window are released and created again with the same value"""
+        numbers = self.get_numbers(self.WINDOW_SIZE)
+        self.check_child(numbers, 0)
+        self.assertEqual(self.calls(0), 1)
+
+        # Moves the window away from the start.
+        self.check_child(numbers, 500)
+        self.check_child(numbers, 0)
+        self.assertEqual(self.calls(0), 2)
+        # And back again.
+        self.check_child(numbers, 500)
+        self.assertEqual(self.calls(500), 2)
+
+        # Printing the whole value pages through every child, and still
+        # gets every value right.
+        self.runCmd("settings set target.max-children-count 1000")
+        self.addTearDownHook(lambda: self.runCmd("settings clear target.max-children-count", check=False))
+        self.expect("frame variable numbers",
+                    substrs = ['[0] = 0', '[499] = 1497', '[999] = 2997'])
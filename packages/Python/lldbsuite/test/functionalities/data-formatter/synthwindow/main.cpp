@@ -0,0 +1,16 @@
+struct Numbers
+{
+    int count;
+    int *data;
+};
+
+int g_data[1000];
+
+int
+main (int argc, char const *argv[])
+{
+    for (int i = 0; i < 1000; i++)
+        g_data[i] = i * 3;
+    Numbers numbers = { 1000, g_data };
+    return numbers.data[0]; // Set break point at this line.
+}
@@ -0,0 +1,24 @@
+import lldb
+
+# How many times each child was asked for, across all providers.
+calls = {}
+
+class numbersSynthProvider:
+    def __init__(self, valobj, dict):
+        self.valobj = valobj
+        self.int_type = valobj.GetType().GetBasicType(lldb.eBasicTypeInt)
+    def num_children(self):
+        return self.valobj.GetChildMemberWithName('count').GetValueAsUnsigned()
+    def get_child_index(self, name):
+        try:
+            return int(name.lstrip('[').rstrip(']'))
+        except:
+            return -1
+    def get_child_at_index(self, index):
+        calls[index] = calls.get(index, 0) + 1
+        # Keeps no reference to the child, so it is freed once the
+        # synthetic value lets go of it.
+        address = self.valobj.GetChildMemberWithName('data').GetValueAsUnsigned() + index * self.int_type.GetByteSize()
+        child = self.valobj.CreateValueFromAddress('[%d]' % index, address, self.int_type)
+        child.SetSyntheticChildrenGenerated(True)
+        return child
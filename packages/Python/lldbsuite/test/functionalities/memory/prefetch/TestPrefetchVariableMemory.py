@@ -0,0 +1,95 @@
+"""
+Test that listing a frame's variables reads their memory up front, so
+that getting their values doesn't send any more memory read packets
+"""
+
+from __future__ import print_function
+
+
+
+import os
+import re
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class PrefetchVariableMemoryTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        TestBase.setUp(self)
+        self.main_source_spec = lldb.SBFileSpec("main.c")
+        self.log_file = os.path.join(os.getcwd(), "prefetch-packets-%s.log" % self.testMethodName)
+        self.log_offset = 0
+
+    def tearDown(self):
+        self.runCmd("log disable gdb-remote packets", check=False)
+        self.runCmd("settings clear target.prefetch-frame-variables", check=False)
+        if os.path.exists(self.log_file):
+            os.remove(self.log_file)
+        TestBase.tearDown(self)
+
+    def launch_to_breakpoint(self):
+        self.build()
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        breakpoint = target.BreakpointCreateBySourceRegex("Set breakpoint here", self.main_source_spec)
+        self.assertTrue(breakpoint.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        self.process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(self.process, PROCESS_IS_VALID)
+        threads = lldbutil.get_threads_stopped_at_breakpoint(self.process, breakpoint)
+        self.assertEqual(len(threads), 1)
+
+        self.runCmd("log enable -f %s gdb-remote packets" % self.log_file)
+        return threads[0].GetFrameAtIndex(0)
+
+    def count_memory_read_packets(self):
+        """Return how many memory read packets were sent since the last call."""
+        with open(self.log_file) as f:
+            f.seek(self.log_offset)
+            contents = f.read()
+            self.log_offset = f.tell()
+        return len(re.findall(r"send packet: \$(?:x|m|qSharedMemoryRead:)[0-9a-fA-F]+,", contents))
+
+    def get_variable_values(self, frame):
+        """List the frame's variables and read each one's data."""
+        variables = frame.GetVariables(True, True, False, True)
+        self.assertTrue(variables.GetSize() >= 3)
+        self.count_memory_read_packets()
+        for variable in variables:
+            error = lldb.SBError()
+            variable.GetData().GetUnsignedInt8(error, 0)
+            self.assertTrue(error.Success(), "reading %s failed" % variable.GetName())
+        return self.count_memory_read_packets()
+
+    @skipIfRemote
+    @skipIfWindows
+    def test_prefetched_values_need_no_packets(self):
+        """Test that the variables' values are read from what was prefetched"""
+        frame = self.launch_to_breakpoint()
+        self.assertEqual(self.get_variable_values(frame), 0)
+
+        # The two arrays were read separately; a read across where one ends
+        # and the other starts is still answered from the cache.
+        first = frame.FindVariable("first")
+        second = frame.FindVariable("second")
+        (lower, upper) = sorted([first, second], key = lambda v: v.GetLoadAddress())
+        boundary = lower.GetLoadAddress() + lower.GetByteSize()
+        if upper.GetLoadAddress() != boundary:
+            self.skipTest("the arrays aren't adjacent on the stack")
+        error = lldb.SBError()
+        data = self.process.ReadMemory(boundary - 32, 64, error)
+        self.assertTrue(error.Success(), error.GetCString())
+        self.assertEqual(self.count_memory_read_packets(), 0)
+
+    @skipIfRemote
+    @skipIfWindows
+    def test_without_prefetch_values_need_packets(self):
+        """Test that without prefetching the same values do take memory reads"""
+        self.runCmd("settings set target.prefetch-frame-variables false")
+        frame = self.launch_to_breakpoint()
+        self.assertTrue(self.get_variable_values(frame) > 0)
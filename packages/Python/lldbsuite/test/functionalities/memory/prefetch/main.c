@@ -0,0 +1,15 @@
+#include <string.h>
+
+int
+main (int argc, char const *argv[])
+{
+    // Too big to be prefetched in a single read, so each gets a read of
+    // its own.
+    char first[200 * 1024];
+    char second[100 * 1024];
+    int count = argc;
+
+    memset (first, 'a', sizeof(first));
+    memset (second, 'b', sizeof(second));
+    return first[0] + second[0] + count; // Set breakpoint here
+}
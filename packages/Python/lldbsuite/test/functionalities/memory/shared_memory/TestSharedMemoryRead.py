@@ -0,0 +1,67 @@
+"""
+Test reading memory through the buffer shared with a local lldb-server
+"""
+
+from __future__ import print_function
+
+
+
+import os
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class SharedMemoryReadTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        TestBase.setUp(self)
+        self.main_source_spec = lldb.SBFileSpec("main.c")
+        self.log_file = os.path.join(os.getcwd(), "shared-memory-packets.log")
+
+    def tearDown(self):
+        self.runCmd("log disable gdb-remote packets", check=False)
+        if os.path.exists(self.log_file):
+            os.remove(self.log_file)
+        TestBase.tearDown(self)
+
+    def shared_memory_names(self):
+        """Return the shared memory objects this debugger created, see GDBRemoteCommunicationClient::SetUpSharedMemoryBuffer."""
+        # shm_open() keeps its objects in /dev/shm on Linux.
+        prefix = "lldb-%d-" % os.getpid()
+        return [name for name in os.listdir("/dev/shm") if name.startswith(prefix)]
+
+    @skipUnlessPlatform(["linux"])
+    @skipIfRemote # the buffer is only used with an lldb-server on this host
+    def test_read_through_shared_memory(self):
+        """Test that memory reads use the shared buffer and that the buffer's name doesn't outlive setting it up"""
+        self.build()
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        breakpoint = target.BreakpointCreateBySourceRegex("Set breakpoint here", self.main_source_spec)
+        self.assertTrue(breakpoint.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        self.runCmd("log enable -f %s gdb-remote packets" % self.log_file)
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, breakpoint)
+        self.assertEqual(len(threads), 1)
+
+        message = target.FindFirstGlobalVariable("g_message")
+        self.assertTrue(message.IsValid())
+        expected = "Read through the shared memory buffer"
+        error = lldb.SBError()
+        data = process.ReadMemory(message.GetLoadAddress(), len(expected), error)
+        self.assertTrue(error.Success(), error.GetCString())
+        self.assertEqual(data.decode(), expected)
+
+        with open(self.log_file) as f:
+            log = f.read()
+        self.assertTrue("QSetSharedMemoryBuffer:" in log, "the buffer wasn't set up")
+        self.assertTrue("qSharedMemoryRead:" in log, "memory wasn't read through the buffer")
+
+        # The stub has mapped the buffer, so its name is already gone.
+        self.assertEqual(self.shared_memory_names(), [])
@@ -0,0 +1,10 @@
+#include <stdio.h>
+
+char g_message[] = "Read through the shared memory buffer";
+
+int
+main (int argc, char const *argv[])
+{
+    printf ("%s\n", g_message); // Set breakpoint here
+    return 0;
+}
@@ -80,6 +80,136 @@ class LinuxCoreTestCase(TestBase):
         # same pid
         self.do_test("x86_64", self._x86_64_pid)
 
+    def test_memory_views(self):
+        """Test that values read straight out of the core file's segments match the copying reads."""
+        target = self.dbg.CreateTarget("x86_64.out")
+        process = target.LoadCore("x86_64.core")
+        self.assertTrue(process, PROCESS_IS_VALID)
+        with open("x86_64.core", "rb") as f:
+            core = f.read()
+
+        # The load address, file offset and size of the fourth LOAD segment. The next segment
+        # follows it directly, both in memory and in the file. If you update the core file, these
+        # may need updating as well. (Segments can be viewed with readelf --segments.)
+        (load_addr, file_offset, size) = (0x7ffe0c16b000, 0x5000, 0x2000)
+        ulonglong = target.GetBasicType(lldb.eBasicTypeUnsignedLongLong)
+        self.assertTrue(ulonglong.IsValid())
+
+        for offset in [0, 0x100, size - 8,  # inside the first segment, so read as a view
+                       size - 4]:           # straddling both segments, so copied
+            name = "value_%x" % offset
+            value = target.CreateValueFromAddress(name, lldb.SBAddress(load_addr + offset, target), ulonglong)
+            self.assertTrue(value.IsValid(), name)
+            expected = core[file_offset + offset:file_offset + offset + 8]
+            self.assertEqual(value.GetValueAsUnsigned(), struct.unpack("<Q", expected)[0], name)
+
+            error = lldb.SBError()
+            data = value.GetData().ReadRawData(error, 0, 8)
+            self.assertTrue(error.Success(), name)
+            self.assertEqual(data, expected, name)
+            self.assertEqual(process.ReadMemory(load_addr + offset, 8, error), expected, name)
+            self.assertTrue(error.Success(), name)
+
+    def test_many_threads(self):
+        """Test that the threads of a core with enough threads to be parsed in parallel, and whose
+        register sets are only parsed when asked for, match what the notes hold"""
+        num_threads = 200
+        try:
+            shutil.copyfile("x86_64.out", "x86_64-threads.out")
+            expected = self.make_threaded_core("x86_64.core", "x86_64-threads.core", num_threads)
+            target = self.dbg.CreateTarget("x86_64-threads.out")
+            process = target.LoadCore("x86_64-threads.core")
+            self.assertTrue(process, PROCESS_IS_VALID)
+            self.assertEqual(process.GetNumThreads(), num_threads)
+
+            for thread in process:
+                tid = thread.GetThreadID()
+                self.assertTrue(tid in expected, "unexpected thread %d" % tid)
+                (signo, rax, rip, fctrl) = expected.pop(tid)
+                self.assertEqual(thread.GetStopReason(), lldb.eStopReasonSignal)
+                self.assertEqual(thread.GetStopReasonDataAtIndex(0), signo)
+                frame = thread.GetFrameAtIndex(0)
+                self.assertEqual(frame.FindRegister("rax").GetValueAsUnsigned(), rax)
+                self.assertEqual(frame.FindRegister("rip").GetValueAsUnsigned(), rip)
+                self.assertEqual(frame.FindRegister("fctrl").GetValueAsUnsigned(), fctrl)
+            self.assertEqual(len(expected), 0)
+        finally:
+            self.RemoveTempFile("x86_64-threads.out")
+            self.RemoveTempFile("x86_64-threads.core")
+
+    def make_threaded_core(self, source, dest, num_threads):
+        """Copy the single threaded x86_64 core from source to dest, adding threads that have
+        their own pid, rax and x87 control word. The notes are parsed here the way lldb parsed
+        them before they were parsed lazily, and a dictionary of each thread's
+        (signal, rax, rip, fctrl) is returned, keyed by thread id."""
+        with open(source, "rb") as f:
+            core = bytearray(f.read())
+
+        # Find the note segment.
+        (phoff,) = struct.unpack_from("<Q", core, 32)
+        (phentsize, phnum) = struct.unpack_from("<HH", core, 54)
+        for i in range(phnum):
+            phdr = phoff + i * phentsize
+            if struct.unpack_from("<I", core, phdr)[0] == 4: # PT_NOTE
+                break
+        (offset,) = struct.unpack_from("<Q", core, phdr + 8)
+        (filesz,) = struct.unpack_from("<Q", core, phdr + 32)
+
+        def align(n):
+            return (n + 3) & ~3
+
+        notes = []
+        end = offset + filesz
+        while offset < end:
+            (namesz, descsz, note_type) = struct.unpack_from("<III", core, offset)
+            size = 12 + align(namesz) + align(descsz)
+            notes.append((note_type, bytearray(core[offset:offset + size]), 12 + align(namesz)))
+            offset += size
+
+        NT_PRSTATUS = 1
+        NT_FPREGSET = 2
+        # Offsets into the NT_PRSTATUS and NT_FPREGSET descriptions.
+        cursig_offset = 12
+        pid_offset = 32
+        rax_offset = 112 + 10 * 8
+        rip_offset = 112 + 16 * 8
+        fctrl_offset = 0
+
+        prstatus = [n for n in notes if n[0] == NT_PRSTATUS][0]
+        fpregset = [n for n in notes if n[0] == NT_FPREGSET][0]
+        (pid,) = struct.unpack_from("<I", prstatus[1], prstatus[2] + pid_offset)
+        for i in range(1, num_threads):
+            thread_prstatus = bytearray(prstatus[1])
+            struct.pack_into("<I", thread_prstatus, prstatus[2] + pid_offset, pid + i)
+            struct.pack_into("<Q", thread_prstatus, prstatus[2] + rax_offset, i)
+            thread_fpregset = bytearray(fpregset[1])
+            struct.pack_into("<H", thread_fpregset, fpregset[2] + fctrl_offset, 0x300 + i)
+            notes.append((NT_PRSTATUS, thread_prstatus, prstatus[2]))
+            notes.append((NT_FPREGSET, thread_fpregset, fpregset[2]))
+
+        expected = {}
+        thread = None
+        for (note_type, note, desc) in notes:
+            if note_type == NT_PRSTATUS:
+                (tid,) = struct.unpack_from("<I", note, desc + pid_offset)
+                (signo,) = struct.unpack_from("<H", note, desc + cursig_offset)
+                (rax,) = struct.unpack_from("<Q", note, desc + rax_offset)
+                (rip,) = struct.unpack_from("<Q", note, desc + rip_offset)
+                thread = [signo, rax, rip, None]
+                expected[tid] = thread
+            elif note_type == NT_FPREGSET:
+                thread[3] = struct.unpack_from("<H", note, desc + fctrl_offset)[0]
+
+        # Put the new notes at the end of the file and point the note segment at them.
+        note_data = b"".join([bytes(n[1]) for n in notes])
+        core += b"\0" * (align(len(core)) - len(core))
+        struct.pack_into("<Q", core, phdr + 8, len(core))
+        struct.pack_into("<Q", core, phdr + 32, len(note_data))
+        core += note_data
+        with open(dest, "wb") as f:
+            f.write(core)
+        return dict((tid, tuple(values)) for (tid, values) in expected.items())
+
     def do_test(self, filename, pid):
         target = self.dbg.CreateTarget(filename + ".out")
         process = target.LoadCore(filename + ".core")
@@ -0,0 +1,76 @@
+"""
+Test that backtraces are the same whether the unwinder reads the stack
+through its snapshot or a register at a time
+"""
+
+from __future__ import print_function
+
+
+
+import os
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class StackSnapshotUnwind(TestBase):
+    mydir = TestBase.compute_mydir(__file__)
+
+    DEPTH = 100
+
+    def setUp(self):
+        TestBase.setUp(self)
+        self.main_source_spec = lldb.SBFileSpec("main.c")
+
+    def tearDown(self):
+        self.runCmd("settings clear process.unwind-stack-snapshot-size", check=False)
+        TestBase.tearDown(self)
+
+    def get_backtrace(self, snapshot_size):
+        """Run to the deepest call with the given snapshot size and return (function, pc, cfa) for every frame."""
+        self.runCmd("settings set process.unwind-stack-snapshot-size %d" % snapshot_size)
+
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        breakpoint = target.BreakpointCreateBySourceRegex("Set breakpoint here", self.main_source_spec)
+        self.assertTrue(breakpoint.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, breakpoint)
+        self.assertEqual(len(threads), 1)
+
+        backtrace = [(frame.GetFunctionName(), frame.GetPC(), frame.GetCFA()) for frame in threads[0].frames]
+        if self.TraceOn():
+            print("Backtrace with a snapshot of at most %d bytes:" % snapshot_size)
+            for (name, pc, cfa) in backtrace:
+                print("  %s pc=0x%x cfa=0x%x" % (name, pc, cfa))
+
+        process.Kill()
+        self.dbg.DeleteTarget(target)
+        return backtrace
+
+    def check_backtrace(self, backtrace):
+        names = [name for (name, pc, cfa) in backtrace]
+        self.assertEqual(names.count("recurse"), self.DEPTH + 1)
+        self.assertTrue("main" in names)
+
+    @skipIfWindows
+    def test_snapshot_matches_register_reads(self):
+        """Test backtraces through the stack snapshot, as it grows, and past its end"""
+        self.build()
+
+        # Without a snapshot every saved register is read on its own.
+        expected = self.get_backtrace(0)
+        self.check_backtrace(expected)
+
+        # The default snapshot grows as the unwinder goes up the stack, and
+        # the stack is deeper than it may grow, so the outermost frames are
+        # read from the process.
+        self.assertEqual(self.get_backtrace(128 * 1024), expected)
+        # Large enough for the whole stack.
+        self.assertEqual(self.get_backtrace(16 * 1024 * 1024), expected)
+        # Smaller than a single frame, nearly everything falls back to the
+        # process.
+        self.assertEqual(self.get_backtrace(64), expected)
@@ -0,0 +1,25 @@
+#include <stdio.h>
+#include <string.h>
+
+// Each frame is a couple of KB, so that the stack at the breakpoint is
+// larger than the default process.unwind-stack-snapshot-size.
+#define DEPTH 100
+
+static int recurse (int depth) __attribute__((noinline));
+
+static int
+recurse (int depth)
+{
+    volatile char buffer[2048];
+    memset ((char *)buffer, depth, sizeof(buffer));
+    if (depth == 0)
+        return buffer[0]; // Set breakpoint here
+    return recurse (depth - 1) + buffer[depth];
+}
+
+int
+main (int argc, char const *argv[])
+{
+    printf ("%d\n", recurse (DEPTH));
+    return 0;
+}
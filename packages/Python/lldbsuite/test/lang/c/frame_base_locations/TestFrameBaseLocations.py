@@ -0,0 +1,73 @@
+"""Check that variables at a frame base offset evaluate the same with and without the opcode interpreter."""
+
+from __future__ import print_function
+
+
+
+import os
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class FrameBaseLocationsTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break inside sum_points().
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    def collect_variables(self, target):
+        """Launch, stop in sum_points() and return the locals and arguments of it and its caller."""
+        process = target.LaunchSimple (None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(thread.IsValid(), "There should be a thread stopped due to breakpoint")
+
+        variables = {}
+        for frame in [thread.GetFrameAtIndex(0), thread.GetFrameAtIndex(1)]:
+            for var in frame.GetVariables(True, True, False, True):
+                key = frame.GetFunctionName() + "::" + var.GetName()
+                variables[key] = (var.GetLocation(), var.GetValue(), str(var))
+
+        process.Kill()
+        return variables
+
+    @no_debug_info_test
+    def test_frame_base_locations_match_interpreter(self):
+        """Test that the decoded DW_OP_fbreg and DW_OP_breg locations match the opcode interpreter."""
+        self.build()
+        exe = os.path.join(os.getcwd(), "a.out")
+
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByLocation("main.c", self.line)
+        self.assertTrue(breakpoint.GetNumLocations() == 1, VALID_BREAKPOINT)
+
+        # Unoptimized locals and arguments are lone DW_OP_fbreg locations,
+        # which are evaluated without the interpreter.
+        decoded = self.collect_variables(target)
+        self.assertTrue(len(decoded) > 0, "Found no variables")
+        for key in ["sum_points::points", "sum_points::total", "sum_points::name", "sum_points::last", "main::ratio"]:
+            self.assertTrue(key in decoded, "Missing variable %s" % key)
+
+        # A verbose expression log makes every location go through the
+        # interpreter.  Address space randomization is off, so the second
+        # run stops with the same stack.
+        logfile = os.path.join(os.getcwd(), "frame-base-locations-" + self.getArchitecture() + ".txt")
+        def cleanup():
+            self.runCmd("log disable lldb expr", check=False)
+            if os.path.exists (logfile):
+                os.unlink (logfile)
+        self.addTearDownHook(cleanup)
+        self.runCmd("log enable -v -f %s lldb expr" % (logfile))
+
+        interpreted = self.collect_variables(target)
+        self.assertEqual(sorted(decoded.keys()), sorted(interpreted.keys()))
+        for key in decoded:
+            self.assertEqual(decoded[key], interpreted[key], "Variable %s differs" % key)
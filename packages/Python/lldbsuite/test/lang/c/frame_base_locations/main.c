@@ -0,0 +1,34 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+struct point
+{
+    int x;
+    int y;
+};
+
+int
+sum_points (struct point *points, int count, int scale)
+{
+    int total = 0;
+    char name[8] = "points";
+    struct point last = points[count - 1];
+    for (int i = 0; i < count; ++i)
+        total += (points[i].x + points[i].y) * scale;
+    return total + last.x + name[0]; // Set break point at this line.
+}
+
+int
+main (int argc, char const *argv[])
+{
+    struct point points[3] = { { 1, 2 }, { 3, 4 }, { 5, 6 } };
+    double ratio = 0.5;
+    int result = sum_points (points, 3, argc);
+    return result > 0 && ratio > 0 ? 0 : 1;
+}
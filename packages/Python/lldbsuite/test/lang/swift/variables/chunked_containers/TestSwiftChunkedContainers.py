@@ -0,0 +1,127 @@
+# TestSwiftChunkedContainers.py
+#
+# This source file is part of the Swift.org open source project
+#
+# Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+# Licensed under Apache License v2.0 with Runtime Library Exception
+#
+# See http://swift.org/LICENSE.txt for license information
+# See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+#
+# ------------------------------------------------------------------------------
+"""
+Test that the elements of large Swift arrays, slices, dictionaries and sets
+are right across the chunks their formatters read them in, and that those
+reads take far fewer packets than there are elements
+"""
+import lldb
+from lldbsuite.test.lldbtest import *
+import lldbsuite.test.decorators as decorators
+import lldbsuite.test.lldbutil as lldbutil
+import os
+import re
+import unittest2
+
+
+class TestSwiftChunkedContainers(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # The formatters read target.max-children-count elements at a time.
+    CHUNK_ELEMENTS = 16
+
+    def setUp(self):
+        TestBase.setUp(self)
+        self.main_source = "main.swift"
+        self.main_source_spec = lldb.SBFileSpec(self.main_source)
+        self.log_file = os.path.join(os.getcwd(), "chunked-containers-packets.log")
+
+    def tearDown(self):
+        self.runCmd("log disable gdb-remote packets", check=False)
+        self.runCmd("settings clear target.max-children-count", check=False)
+        if os.path.exists(self.log_file):
+            os.remove(self.log_file)
+        TestBase.tearDown(self)
+
+    def launch_to_breakpoint(self):
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateBySourceRegex(
+            'Set breakpoint here', self.main_source_spec)
+        self.assertTrue(breakpoint.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, os.getcwd())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        threads = lldbutil.get_threads_stopped_at_breakpoint(
+            process, breakpoint)
+        self.assertTrue(len(threads) == 1)
+        return threads[0].frames[0]
+
+    def count_memory_read_packets(self):
+        with open(self.log_file) as f:
+            contents = f.read()
+        return len(re.findall(
+            r"send packet: \$(?:x|m|qSharedMemoryRead:)[0-9a-fA-F]+,", contents))
+
+    def get_elements(self, container):
+        count = container.GetNumChildren()
+        return [container.GetChildAtIndex(i) for i in range(count)]
+
+    @decorators.swiftTest
+    @decorators.skipIfRemote
+    def test_chunked_containers(self):
+        """Test every element of containers larger than a chunk"""
+        self.build()
+        self.runCmd(
+            "settings set target.max-children-count %d" %
+            self.CHUNK_ELEMENTS)
+        frame = self.launch_to_breakpoint()
+        self.runCmd("log enable -f %s gdb-remote packets" % self.log_file)
+
+        array = frame.FindVariable("array")
+        elements = self.get_elements(array)
+        self.assertTrue(len(elements) == 1000)
+        for i, element in enumerate(elements):
+            self.assertTrue(element.GetValueAsSigned() == i * 3,
+                            "array[%d] is %s" % (i, element.GetValue()))
+        # One read per chunk, not one per element.
+        self.assertTrue(self.count_memory_read_packets() < 1000 / 4,
+                        "array elements were read one at a time")
+
+        slice = frame.FindVariable("slice")
+        elements = self.get_elements(slice)
+        self.assertTrue(len(elements) == 200)
+        for i, element in enumerate(elements):
+            self.assertTrue(element.GetValueAsSigned() == (100 + i) * 3,
+                            "slice[%d] is %s" % (i, element.GetValue()))
+
+        dictionary = frame.FindVariable("dictionary")
+        elements = self.get_elements(dictionary)
+        self.assertTrue(len(elements) == 200)
+        pairs = {}
+        for element in elements:
+            key = element.GetChildAtIndex(0).GetValueAsSigned()
+            value = element.GetChildAtIndex(1).GetValueAsSigned()
+            self.assertFalse(key in pairs, "key %d listed twice" % key)
+            pairs[key] = value
+        self.assertTrue(pairs == dict((i, i * 2 + 1) for i in range(200)))
+
+        set = frame.FindVariable("set")
+        elements = self.get_elements(set)
+        self.assertTrue(len(elements) == 200)
+        values = sorted(element.GetValueAsSigned() for element in elements)
+        self.assertTrue(values == [i * 5 for i in range(200)])
+
+        # Asking for the same element twice gives the same value, from
+        # whichever chunk is current.
+        self.assertTrue(array.GetChildAtIndex(999).GetValueAsSigned() == 2997)
+        self.assertTrue(array.GetChildAtIndex(0).GetValueAsSigned() == 0)
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lldb.SBDebugger.Terminate)
+    unittest2.main()
@@ -0,0 +1,27 @@
+// main.swift
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See http://swift.org/LICENSE.txt for license information
+// See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+// -----------------------------------------------------------------------------
+func main() {
+  var array = [Int]()
+  for i in 0..<1000 {
+    array.append(i * 3)
+  }
+  let slice = array[100..<300]
+  var dictionary = [Int: Int]()
+  var set = Set<Int>()
+  for i in 0..<200 {
+    dictionary[i] = i * 2 + 1
+    set.insert(i * 5)
+  }
+  print(array.count + slice.count + dictionary.count + set.count) // Set breakpoint here
+}
+
+main()
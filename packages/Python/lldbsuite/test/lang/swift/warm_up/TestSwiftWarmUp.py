@@ -0,0 +1,148 @@
+# TestSwiftWarmUp.py
+#
+# This source file is part of the Swift.org open source project
+#
+# Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+# Licensed under Apache License v2.0 with Runtime Library Exception
+#
+# See http://swift.org/LICENSE.txt for license information
+# See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+#
+# ------------------------------------------------------------------------------
+"""
+Test the background warm-up of the scratch Swift context and the persistent
+Clang module cache
+"""
+import lldb
+from lldbsuite.test.lldbtest import *
+import lldbsuite.test.decorators as decorators
+import lldbsuite.test.lldbutil as lldbutil
+import os
+import shutil
+import unittest2
+
+
+class TestSwiftWarmUp(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        TestBase.setUp(self)
+        self.main_source = "main.swift"
+        self.main_source_spec = lldb.SBFileSpec(self.main_source)
+
+    def tearDown(self):
+        self.runCmd("settings clear target.swift-warm-up-modules", check=False)
+        self.runCmd("settings clear target.swift-persistent-module-cache", check=False)
+        TestBase.tearDown(self)
+
+    def use_fake_home(self):
+        """Point HOME at an empty directory under the build directory and return it."""
+        home = os.path.join(os.getcwd(), "fake-home")
+        if os.path.exists(home):
+            shutil.rmtree(home)
+        os.mkdir(home)
+        old_home = os.environ.get("HOME")
+        def restore_home():
+            if old_home is None:
+                del os.environ["HOME"]
+            else:
+                os.environ["HOME"] = old_home
+            shutil.rmtree(home, ignore_errors=True)
+        self.addTearDownHook(restore_home)
+        os.environ["HOME"] = home
+        return home
+
+    def launch_to_breakpoint(self):
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateBySourceRegex(
+            'Set breakpoint here', self.main_source_spec)
+        self.assertTrue(breakpoint.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, os.getcwd())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        threads = lldbutil.get_threads_stopped_at_breakpoint(
+            process, breakpoint)
+        self.assertTrue(len(threads) == 1)
+        return (target, process, threads[0])
+
+    def check_expression(self, thread):
+        frame = thread.frames[0]
+        self.assertTrue(frame, "Frame 0 is valid.")
+        value = frame.EvaluateExpression("x + y.count")
+        self.assertTrue(value.GetError().Success(), "Expression failed")
+        self.assertTrue(value.GetValue() == "13", "Expression has the right value")
+
+    @decorators.swiftTest
+    def test_persistent_module_cache_is_opt_in(self):
+        """Test that nothing is written under ~/.lldb unless target.swift-persistent-module-cache is set"""
+        self.expect("settings show target.swift-persistent-module-cache",
+                    substrs=["target.swift-persistent-module-cache (boolean) = false"])
+
+        self.build()
+        home = self.use_fake_home()
+        (target, process, thread) = self.launch_to_breakpoint()
+        self.check_expression(thread)
+        self.assertFalse(os.path.exists(os.path.join(home, ".lldb")),
+                         "The module cache was created without being asked for")
+
+    @decorators.swiftTest
+    def test_persistent_module_cache(self):
+        """Test that the Clang modules Swift imports are kept under ~/.lldb/module_cache when asked for"""
+        self.build()
+        home = self.use_fake_home()
+        self.runCmd("settings set target.swift-persistent-module-cache true")
+        (target, process, thread) = self.launch_to_breakpoint()
+        self.check_expression(thread)
+
+        cache_root = os.path.join(home, ".lldb", "module_cache", "swift")
+        self.assertTrue(os.path.isdir(cache_root), "The module cache wasn't created")
+        caches = os.listdir(cache_root)
+        self.assertTrue(len(caches) > 0, "No context was set up to use the module cache")
+        # Each way of setting a context up gets a cache of its own, named by
+        # a hash of that set up.
+        for cache in caches:
+            self.assertTrue(len(cache) == 32, "Unexpected module cache directory " + cache)
+
+    @decorators.swiftTest
+    def test_warm_up(self):
+        """Test that expressions work while and after the scratch context is warmed up, across relaunches"""
+        self.build()
+        self.runCmd("settings set target.swift-warm-up-modules true")
+        (target, process, thread) = self.launch_to_breakpoint()
+        self.check_expression(thread)
+
+        # Relaunching waits for the previous warm-up and starts a new one.
+        process.Kill()
+        process = target.LaunchSimple(None, None, os.getcwd())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        threads = lldbutil.get_stopped_threads(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(len(threads) == 1)
+        self.check_expression(threads[0])
+
+    @decorators.swiftTest
+    def test_delete_target_during_warm_up(self):
+        """Test that a target can be deleted while its warm-up may still be running"""
+        self.build()
+        self.runCmd("settings set target.swift-warm-up-modules true")
+        (target, process, thread) = self.launch_to_breakpoint()
+        process.Kill()
+        self.assertTrue(self.dbg.DeleteTarget(target), "Deleting the target failed")
+
+    @decorators.swiftTest
+    def test_warm_up_disabled(self):
+        """Test that expressions still work with target.swift-warm-up-modules turned off"""
+        self.build()
+        self.runCmd("settings set target.swift-warm-up-modules false")
+        (target, process, thread) = self.launch_to_breakpoint()
+        self.check_expression(thread)
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lldb.SBDebugger.Terminate)
+    unittest2.main()
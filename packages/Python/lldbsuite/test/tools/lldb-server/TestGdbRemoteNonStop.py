@@ -0,0 +1,280 @@
+from __future__ import print_function
+
+
+
+import binascii
+import time
+
+import gdbremote_testcase
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class TestGdbRemoteNonStop(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    THREAD_COUNT = 4
+
+    _STOP_REPLY_REGEX = r"T([0-9a-fA-F]{2})([^#]*)"
+
+    def start_threads_in_non_stop_mode(self, inferior_args=None):
+        if inferior_args is None:
+            inferior_args = []
+        for i in range(self.THREAD_COUNT - 1):
+            inferior_args.append("thread:new")
+        inferior_args.append("sleep:30")
+        procs = self.prep_debug_monitor_and_inferior(inferior_args=inferior_args)
+
+        # Resuming in non-stop mode is acknowledged right away.
+        self.test_sequence.add_log_lines([
+            "read packet: $QNonStop:1#8d",
+            "send packet: $OK#00",
+            "read packet: $vCont;c#a8",
+            "send packet: $OK#00",
+            ], True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        # The main thread is reported first, keep it running.
+        threads = self.wait_for_thread_count(self.THREAD_COUNT, timeout_seconds=5)
+        self.assertEqual(len(threads), self.THREAD_COUNT)
+        return threads
+
+    def stop_threads(self, thread_ids):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines([
+            "read packet: ${}#00".format("vCont" + "".join(";t:{:x}".format(tid) for tid in thread_ids)),
+            "send packet: $OK#00",
+            ], True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+    def thread_from_stop_reply(self, key_vals_text):
+        kv_dict = self.parse_key_val_dict(key_vals_text)
+        self.assertTrue("thread" in kv_dict)
+        return int(kv_dict["thread"], 16)
+
+    def drain_with_vStopped(self):
+        """Send vStopped until the stub says OK, return the threads it reported in order."""
+        thread_ids = []
+        while True:
+            self.reset_test_sequence()
+            self.test_sequence.add_log_lines([
+                "read packet: $vStopped#55",
+                {"direction":"send", "regex":r"^\$(OK|" + self._STOP_REPLY_REGEX + r")#[0-9a-fA-F]{2}$", "capture":{1:"reply", 3:"key_vals_text"} },
+                ], True)
+            context = self.expect_gdbremote_sequence()
+            self.assertIsNotNone(context)
+            if context.get("reply") == "OK":
+                return thread_ids
+            thread_ids.append(self.thread_from_stop_reply(context.get("key_vals_text")))
+
+    def collect_stop_notifications(self, expected_count):
+        """Wait for %Stop notifications and drain each with vStopped."""
+        thread_ids = []
+        while len(thread_ids) < expected_count:
+            self.reset_test_sequence()
+            self.test_sequence.add_log_lines([
+                {"direction":"send", "regex":r"^%Stop:" + self._STOP_REPLY_REGEX + r"#[0-9a-fA-F]{2}$", "capture":{2:"key_vals_text"} },
+                ], True)
+            context = self.expect_gdbremote_sequence()
+            self.assertIsNotNone(context)
+            thread_ids.append(self.thread_from_stop_reply(context.get("key_vals_text")))
+            thread_ids.extend(self.drain_with_vStopped())
+        return thread_ids
+
+    def non_stop_reports_each_stopped_thread_once(self):
+        threads = self.start_threads_in_non_stop_mode()
+        to_stop = threads[1:]
+        self.stop_threads(to_stop)
+
+        # Let every thread stop before draining, so all of them are queued
+        # behind the single outstanding notification.
+        time.sleep(1)
+        reported = self.collect_stop_notifications(len(to_stop))
+        self.assertEqual(len(reported), len(to_stop))
+        self.assertEqual(sorted(reported), sorted(to_stop))
+
+    @skipUnlessPlatform(["linux"])
+    @llgs_test
+    def test_non_stop_reports_each_stopped_thread_once_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.non_stop_reports_each_stopped_thread_once()
+
+    def non_stop_stop_reason_query_restarts_queue(self):
+        threads = self.start_threads_in_non_stop_mode()
+        to_stop = threads[1:]
+        self.stop_threads(to_stop)
+        time.sleep(1)
+        first_pass = self.collect_stop_notifications(len(to_stop))
+
+        # '?' starts the sequence over with every thread that is still
+        # stopped, in the order the queue holds them, and vStopped drains
+        # the rest of it.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines([
+            "read packet: $?#3f",
+            {"direction":"send", "regex":r"^\$" + self._STOP_REPLY_REGEX + r"#[0-9a-fA-F]{2}$", "capture":{2:"key_vals_text"} },
+            ], True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        second_pass = [self.thread_from_stop_reply(context.get("key_vals_text"))]
+        second_pass.extend(self.drain_with_vStopped())
+
+        self.assertEqual(sorted(second_pass), sorted(to_stop))
+        self.assertEqual(len(set(second_pass)), len(second_pass))
+
+        # Once drained, vStopped keeps answering OK.
+        self.assertEqual(self.drain_with_vStopped(), [])
+
+    @skipUnlessPlatform(["linux"])
+    @llgs_test
+    def test_non_stop_stop_reason_query_restarts_queue_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.non_stop_stop_reason_query_restarts_queue()
+
+    def non_stop_vCont_actions_include_t(self):
+        procs = self.prep_debug_monitor_and_inferior()
+        self.test_sequence.add_log_lines([
+            "read packet: $QNonStop:1#8d",
+            "send packet: $OK#00",
+            ], True)
+        self.add_vCont_query_packets()
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        supported_vCont_data = self.parse_vCont_query_response(context)
+        self.assertTrue("t" in supported_vCont_data)
+
+    @skipUnlessPlatform(["linux"])
+    @llgs_test
+    def test_non_stop_vCont_actions_include_t_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.non_stop_vCont_actions_include_t()
+
+    def vStopped_requires_non_stop_mode(self):
+        procs = self.prep_debug_monitor_and_inferior()
+        self.test_sequence.add_log_lines([
+            "read packet: $vStopped#55",
+            "send packet: $#00",
+            ], True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+    @skipUnlessPlatform(["linux"])
+    @llgs_test
+    def test_vStopped_requires_non_stop_mode_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.vStopped_requires_non_stop_mode()
+
+    MEMORY_CONTENTS = "Hello, non-stop"
+
+    def start_threads_and_stop_one(self):
+        """Run every thread, then stop one that isn't the main thread, and return (threads, stopped thread, message address)."""
+        threads = self.start_threads_in_non_stop_mode(inferior_args=["get-data-address-hex:g_message"])
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines([
+            { "type":"output_match", "regex":r"^data address: 0x([0-9a-fA-F]+)\r\n$", "capture":{ 1:"message_address"} },
+            ], True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertIsNotNone(context.get("message_address"))
+        message_address = int(context.get("message_address"), 16)
+
+        # threads[0] is the main thread, which the stub used to go through
+        # for ptrace memory accesses.
+        stopped_thread = threads[1]
+        self.stop_threads([stopped_thread])
+        self.assertEqual(self.collect_stop_notifications(1), [stopped_thread])
+        return (threads, stopped_thread, message_address)
+
+    def send_and_expect_reply(self, packet, reply_regex):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines([
+            "read packet: ${}#00".format(packet),
+            {"direction":"send", "regex":r"^\$(" + reply_regex + r")#[0-9a-fA-F]{2}$", "capture":{1:"reply"} },
+            ], True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        return context.get("reply")
+
+    def non_stop_write_memory_while_main_thread_runs(self):
+        (threads, stopped_thread, message_address) = self.start_threads_and_stop_one()
+
+        contents = self.MEMORY_CONTENTS.encode()
+        self.assertEqual(self.send_and_expect_reply(
+            "M{:x},{:x}:{}".format(message_address, len(contents), binascii.hexlify(contents).decode()), "OK"), "OK")
+        reply = self.send_and_expect_reply("m{:x},{:x}".format(message_address, len(contents)), "[0-9a-fA-F]+")
+        self.assertEqual(binascii.unhexlify(reply), contents)
+
+        # A write that doesn't cover a whole word reads the word through
+        # the same thread.
+        self.assertEqual(self.send_and_expect_reply(
+            "M{:x},1:{}".format(message_address, binascii.hexlify(b"J").decode()), "OK"), "OK")
+        reply = self.send_and_expect_reply("m{:x},{:x}".format(message_address, len(contents)), "[0-9a-fA-F]+")
+        self.assertEqual(binascii.unhexlify(reply), b"J" + contents[1:])
+
+    @skipUnlessPlatform(["linux"])
+    @llgs_test
+    def test_non_stop_write_memory_while_main_thread_runs_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.non_stop_write_memory_while_main_thread_runs()
+
+    def non_stop_set_breakpoint_while_main_thread_runs(self):
+        (threads, stopped_thread, message_address) = self.start_threads_and_stop_one()
+
+        # Setting and clearing a software breakpoint writes the trap opcode
+        # through ptrace.  The threads that are running never get there.
+        self.assertEqual(self.send_and_expect_reply("Z0,{:x},1".format(message_address), "OK|E[0-9a-fA-F]{2}"), "OK")
+        self.assertEqual(self.send_and_expect_reply("z0,{:x},1".format(message_address), "OK|E[0-9a-fA-F]{2}"), "OK")
+
+    @skipUnlessPlatform(["linux"])
+    @llgs_test
+    def test_non_stop_set_breakpoint_while_main_thread_runs_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.non_stop_set_breakpoint_while_main_thread_runs()
+
+    def non_stop_write_memory_without_stopped_thread_fails(self):
+        threads = self.start_threads_in_non_stop_mode()
+        reply = self.send_and_expect_reply("M1000,1:00", "OK|E[0-9a-fA-F]{2}")
+        self.assertTrue(reply.startswith("E"))
+
+    @skipUnlessPlatform(["linux"])
+    @llgs_test
+    def test_non_stop_write_memory_without_stopped_thread_fails_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.non_stop_write_memory_without_stopped_thread_fails()
+
+    def non_stop_continue_leaves_running_threads_alone(self):
+        (threads, stopped_thread, message_address) = self.start_threads_and_stop_one()
+
+        # Continuing everything only resumes the stopped thread, the ones
+        # already running don't make it fail.
+        self.assertEqual(self.send_and_expect_reply("vCont;c", "OK|E[0-9a-fA-F]{2}"), "OK")
+
+        # The thread really was resumed: it can be stopped again.
+        self.stop_threads([stopped_thread])
+        self.assertEqual(self.collect_stop_notifications(1), [stopped_thread])
+
+    @skipUnlessPlatform(["linux"])
+    @llgs_test
+    def test_non_stop_continue_leaves_running_threads_alone_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.non_stop_continue_leaves_running_threads_alone()
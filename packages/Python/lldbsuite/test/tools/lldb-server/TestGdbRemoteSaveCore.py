@@ -0,0 +1,126 @@
+from __future__ import print_function
+
+
+
+import binascii
+import os
+import struct
+
+import gdbremote_testcase
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class TestGdbRemoteSaveCore(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # Writing the core reads all of the inferior's memory.
+    _SAVE_CORE_TIMEOUT_SECONDS = 60
+
+    ET_CORE = 4
+
+    def save_core(self, path_hint=None, skip_file_backed=False):
+        """Send qSaveCore and return the path the stub reports."""
+        packet = "qSaveCore"
+        if path_hint:
+            packet += ";path-hint:" + binascii.hexlify(path_hint.encode()).decode()
+        packet += ";skip-file-backed:{}".format(1 if skip_file_backed else 0)
+
+        self.test_sequence.add_log_lines([
+            "read packet: ${}#00".format(packet),
+            {"direction":"send", "regex":r"^\$core-path:([0-9a-fA-F]+);#[0-9a-fA-F]{2}$", "capture":{1:"core_path"} },
+            ], True)
+        context = self.expect_gdbremote_sequence(timeout_seconds=self._SAVE_CORE_TIMEOUT_SECONDS)
+        self.assertIsNotNone(context)
+        self.reset_test_sequence()
+        return binascii.unhexlify(context.get("core_path")).decode()
+
+    def check_core_file(self, core_path):
+        self.assertTrue(os.path.exists(core_path), "core file {} was not written".format(core_path))
+        with open(core_path, "rb") as core_file:
+            header = core_file.read(18)
+        self.assertEqual(header[0:4], b"\x7fELF")
+        # e_type, in the file's byte order.
+        byte_order = "<" if header[5:6] == b"\x01" else ">"
+        (e_type,) = struct.unpack(byte_order + "H", header[16:18])
+        self.assertEqual(e_type, self.ET_CORE)
+        return os.path.getsize(core_path)
+
+    def remove_on_teardown(self, path):
+        def cleanup():
+            if os.path.exists(path):
+                os.unlink(path)
+        self.addTearDownHook(cleanup)
+
+    def qSupported_reports_qSaveCore(self):
+        procs = self.prep_debug_monitor_and_inferior()
+        self.add_qSupported_packets()
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        supported_dict = self.parse_qSupported_response(context)
+        self.assertEqual(supported_dict.get("qSaveCore"), "+")
+
+    @skipUnlessPlatform(["linux"])
+    @llgs_test
+    def test_qSupported_reports_qSaveCore_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.qSupported_reports_qSaveCore()
+
+    def qSaveCore_writes_to_path_hint(self):
+        procs = self.prep_debug_monitor_and_inferior(inferior_args=["sleep:30"])
+        path_hint = os.path.join(os.getcwd(), "qSaveCore-" + self.getArchitecture() + ".core")
+        self.remove_on_teardown(path_hint)
+
+        core_path = self.save_core(path_hint)
+        self.assertEqual(core_path, path_hint)
+        full_size = self.check_core_file(core_path)
+
+        # Leaving out the file mappings can only make the core smaller.
+        os.unlink(core_path)
+        core_path = self.save_core(path_hint, skip_file_backed=True)
+        self.assertEqual(core_path, path_hint)
+        self.assertTrue(self.check_core_file(core_path) <= full_size)
+
+    @skipUnlessPlatform(["linux"])
+    @llgs_test
+    def test_qSaveCore_writes_to_path_hint_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.qSaveCore_writes_to_path_hint()
+
+    def qSaveCore_picks_path_without_hint(self):
+        procs = self.prep_debug_monitor_and_inferior(inferior_args=["sleep:30"])
+        core_path = self.save_core()
+        self.remove_on_teardown(core_path)
+        self.assertTrue(os.path.isabs(core_path))
+        self.check_core_file(core_path)
+
+    @skipUnlessPlatform(["linux"])
+    @llgs_test
+    def test_qSaveCore_picks_path_without_hint_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.qSaveCore_picks_path_without_hint()
+
+    def qSaveCore_unwritable_path_is_an_error(self):
+        procs = self.prep_debug_monitor_and_inferior(inferior_args=["sleep:30"])
+        path_hint = os.path.join(os.getcwd(), "no-such-directory", "qSaveCore.core")
+        self.test_sequence.add_log_lines([
+            "read packet: $qSaveCore;path-hint:{};skip-file-backed:0#00".format(binascii.hexlify(path_hint.encode()).decode()),
+            {"direction":"send", "regex":r"^\$E([0-9a-fA-F]{2})#[0-9a-fA-F]{2}$"},
+            ], True)
+        context = self.expect_gdbremote_sequence(timeout_seconds=self._SAVE_CORE_TIMEOUT_SECONDS)
+        self.assertIsNotNone(context)
+
+    @skipUnlessPlatform(["linux"])
+    @llgs_test
+    def test_qSaveCore_unwritable_path_is_an_error_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.qSaveCore_unwritable_path_is_an_error()
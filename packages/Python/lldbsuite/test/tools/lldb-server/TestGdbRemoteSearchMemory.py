@@ -0,0 +1,110 @@
+from __future__ import print_function
+
+
+
+import gdbremote_testcase
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class TestGdbRemoteSearchMemory(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # Has characters that have to be escaped in the pattern.
+    MEMORY_CONTENTS = "Test contents 0123456789 a}b#c*d$e ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz"
+
+    def escape_binary(self, data):
+        """Escape data the way the client does for binary packet contents."""
+        escaped = ""
+        for ch in data:
+            if ch in "#$}*":
+                escaped += "}" + chr(ord(ch) ^ 0x20)
+            else:
+                escaped += ch
+        return escaped
+
+    def get_message_address(self):
+        """Launch the inferior with MEMORY_CONTENTS in its message buffer, stop it and return the buffer's address."""
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=["set-message:%s" % self.MEMORY_CONTENTS, "get-data-address-hex:g_message", "sleep:5"])
+        self.test_sequence.add_log_lines(
+            ["read packet: $c#63",
+             { "type":"output_match", "regex":r"^data address: 0x([0-9a-fA-F]+)\r\n$", "capture":{ 1:"message_address"} },
+             "read packet: {}".format(chr(3)),
+             {"direction":"send", "regex":r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);", "capture":{1:"stop_signo", 2:"stop_thread_id"} }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.reset_test_sequence()
+        self.assertIsNotNone(context.get("message_address"))
+        return int(context.get("message_address"), 16)
+
+    def search_memory(self, address, length, pattern):
+        """Send qSearch:memory and return the address of the match, or None if there is none."""
+        self.test_sequence.add_log_lines(
+            ["read packet: $qSearch:memory:{:x};{:x};{}#00".format(address, length, self.escape_binary(pattern)),
+             {"direction":"send", "regex":r"^\$(0|1,([0-9a-fA-F]+))#[0-9a-fA-F]{2}$", "capture":{1:"result", 2:"found_address"} }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.reset_test_sequence()
+        if context.get("result") == "0":
+            return None
+        return int(context.get("found_address"), 16)
+
+    def qSearch_memory_finds_pattern(self):
+        message_address = self.get_message_address()
+        length = len(self.MEMORY_CONTENTS)
+
+        for pattern in ["Test", "ABCDEF", "xyz", "a}b#c*d$e", "}#"]:
+            self.assertEqual(self.search_memory(message_address, length, pattern),
+                             message_address + self.MEMORY_CONTENTS.index(pattern),
+                             "searching for " + pattern)
+
+        # The first of several matches is reported.
+        self.assertEqual(self.search_memory(message_address, length, "c"),
+                         message_address + self.MEMORY_CONTENTS.index("c"))
+
+        self.assertIsNone(self.search_memory(message_address, length, "not in there"))
+
+    @skipUnlessPlatform(["linux"])
+    @llgs_test
+    def test_qSearch_memory_finds_pattern_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.qSearch_memory_finds_pattern()
+
+    def qSearch_memory_match_must_fit_in_range(self):
+        message_address = self.get_message_address()
+        pattern = "ABCDEF"
+        offset = self.MEMORY_CONTENTS.index(pattern)
+
+        # A range that ends just before the last byte of the match misses it.
+        self.assertIsNone(self.search_memory(message_address, offset + len(pattern) - 1, pattern))
+        self.assertEqual(self.search_memory(message_address, offset + len(pattern), pattern),
+                         message_address + offset)
+        # So does one that starts just after the first byte.
+        self.assertIsNone(self.search_memory(message_address + offset + 1, len(self.MEMORY_CONTENTS), pattern))
+
+    @skipUnlessPlatform(["linux"])
+    @llgs_test
+    def test_qSearch_memory_match_must_fit_in_range_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.qSearch_memory_match_must_fit_in_range()
+
+    def qSearch_memory_skips_unmapped_memory(self):
+        procs = self.prep_debug_monitor_and_inferior()
+        # Nothing is mapped at the first page.
+        self.assertIsNone(self.search_memory(0, 0x1000, "ABCDEF"))
+
+    @skipUnlessPlatform(["linux"])
+    @llgs_test
+    def test_qSearch_memory_skips_unmapped_memory_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.qSearch_memory_skips_unmapped_memory()
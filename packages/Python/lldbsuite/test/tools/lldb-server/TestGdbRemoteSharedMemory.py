@@ -0,0 +1,200 @@
+from __future__ import print_function
+
+
+
+import binascii
+import os
+import re
+import socket
+import time
+
+import gdbremote_testcase
+import lldbgdbserverutils
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class TestGdbRemoteSharedMemory(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    MEMORY_CONTENTS = "Test contents 0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz"
+
+    # Smaller than MEMORY_CONTENTS, so reads of all of it get cut short.
+    SMALL_BUFFER_SIZE = 16
+
+    def create_shared_memory(self, size):
+        """Create a POSIX shared memory object the way the debugger does and return its name."""
+        name = "/lldb-test-shared-memory-{}-{}".format(os.getpid(), self.getArchitecture())
+        # shm_open() keeps its objects in /dev/shm on Linux.
+        path = "/dev/shm" + name
+        with open(path, "wb") as shm_file:
+            shm_file.truncate(size)
+        def cleanup():
+            if os.path.exists(path):
+                os.unlink(path)
+        self.addTearDownHook(cleanup)
+        return (name, path)
+
+    def read_shared_memory(self, path, size):
+        with open(path, "rb") as shm_file:
+            return shm_file.read(size)
+
+    def get_message_address(self):
+        """Launch the inferior with MEMORY_CONTENTS in its message buffer, stop it and return the buffer's address."""
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=["set-message:%s" % self.MEMORY_CONTENTS, "get-data-address-hex:g_message", "sleep:5"])
+        self.test_sequence.add_log_lines(
+            ["read packet: $c#63",
+             { "type":"output_match", "regex":r"^data address: 0x([0-9a-fA-F]+)\r\n$", "capture":{ 1:"message_address"} },
+             "read packet: {}".format(chr(3)),
+             {"direction":"send", "regex":r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);", "capture":{1:"stop_signo", 2:"stop_thread_id"} }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.reset_test_sequence()
+        self.assertIsNotNone(context.get("message_address"))
+        return int(context.get("message_address"), 16)
+
+    def set_shared_memory_buffer(self, name, size, expected_reply):
+        self.test_sequence.add_log_lines(
+            ["read packet: $QSetSharedMemoryBuffer:name:{};size:{:x};#00".format(binascii.hexlify(name.encode()).decode(), size),
+             {"direction":"send", "regex":r"^\$(OK|E[0-9a-fA-F]{2})#[0-9a-fA-F]{2}$", "capture":{1:"reply"} }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.reset_test_sequence()
+        if expected_reply == "OK":
+            self.assertEqual(context.get("reply"), "OK")
+        else:
+            self.assertTrue(context.get("reply").startswith("E"))
+
+    def shared_memory_read(self, address, length):
+        """Send qSharedMemoryRead and return the byte count the stub reports."""
+        self.test_sequence.add_log_lines(
+            ["read packet: $qSharedMemoryRead:{:x},{:x}#00".format(address, length),
+             {"direction":"send", "regex":r"^\$([0-9a-fA-F]+)#[0-9a-fA-F]{2}$", "capture":{1:"byte_count"} }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.reset_test_sequence()
+        return int(context.get("byte_count"), 16)
+
+    def qSupported_reports_QSetSharedMemoryBuffer(self):
+        procs = self.prep_debug_monitor_and_inferior()
+        self.add_qSupported_packets()
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        supported_dict = self.parse_qSupported_response(context)
+        self.assertEqual(supported_dict.get("QSetSharedMemoryBuffer"), "+")
+
+    @skipUnlessPlatform(["linux"])
+    @llgs_test
+    def test_qSupported_reports_QSetSharedMemoryBuffer_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.qSupported_reports_QSetSharedMemoryBuffer()
+
+    def get_platform_qSupported(self):
+        """Start lldb-server in platform mode and return its qSupported response."""
+        port_file = os.path.join(os.getcwd(), "platform-port-%d" % int(time.time() * 1000))
+        self.addTearDownHook(lambda: os.path.exists(port_file) and os.unlink(port_file))
+        self.spawnSubprocess(self.debug_monitor_exe,
+                             ["platform", "--listen", "localhost:0", "--socket-file", port_file],
+                             install_remote=False)
+        self.addTearDownHook(self.cleanupSubprocesses)
+
+        port = None
+        for i in range(50):
+            if os.path.exists(port_file):
+                with open(port_file) as f:
+                    contents = f.read().strip()
+                if contents:
+                    port = int(contents)
+                    break
+            time.sleep(0.1)
+        self.assertIsNotNone(port, "lldb-server platform didn't write its port")
+
+        sock = socket.create_connection(("localhost", port))
+        self.addTearDownHook(sock.close)
+        sock.sendall(b"+")
+        sock.sendall(lldbgdbserverutils.gdbremote_packet_encode_string("qSupported").encode())
+        data = ""
+        while True:
+            match = re.search(r"\$([^#]*)#[0-9a-fA-F]{2}", data)
+            if match:
+                return match.group(1)
+            chunk = sock.recv(4096)
+            self.assertTrue(len(chunk) > 0, "platform closed the connection")
+            data += chunk.decode()
+
+    @skipUnlessPlatform(["linux"])
+    @skipIfRemote
+    @llgs_test
+    @no_debug_info_test
+    def test_platform_qSupported_omits_QSetSharedMemoryBuffer(self):
+        self.init_llgs_test(False)
+        response = self.get_platform_qSupported()
+        self.assertTrue(response.startswith("PacketSize="), "unexpected qSupported reply: " + response)
+        # Only the gdbserver handles the shared memory packets.
+        self.assertFalse("QSetSharedMemoryBuffer" in response)
+
+    def qSharedMemoryRead_reads_memory(self):
+        message_address = self.get_message_address()
+        buffer_size = 4096
+        (name, path) = self.create_shared_memory(buffer_size)
+        self.set_shared_memory_buffer(name, buffer_size, "OK")
+
+        byte_count = self.shared_memory_read(message_address, len(self.MEMORY_CONTENTS))
+        self.assertEqual(byte_count, len(self.MEMORY_CONTENTS))
+        self.assertEqual(self.read_shared_memory(path, byte_count).decode(), self.MEMORY_CONTENTS)
+
+    @skipUnlessPlatform(["linux"])
+    @skipIfRemote # the stub has to see the shared memory object the test creates
+    @llgs_test
+    def test_qSharedMemoryRead_reads_memory_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.qSharedMemoryRead_reads_memory()
+
+    def qSharedMemoryRead_is_clamped_to_buffer_size(self):
+        message_address = self.get_message_address()
+        (name, path) = self.create_shared_memory(self.SMALL_BUFFER_SIZE)
+        self.set_shared_memory_buffer(name, self.SMALL_BUFFER_SIZE, "OK")
+
+        byte_count = self.shared_memory_read(message_address, len(self.MEMORY_CONTENTS))
+        self.assertEqual(byte_count, self.SMALL_BUFFER_SIZE)
+        self.assertEqual(self.read_shared_memory(path, self.SMALL_BUFFER_SIZE).decode(),
+                         self.MEMORY_CONTENTS[:self.SMALL_BUFFER_SIZE])
+
+    @skipUnlessPlatform(["linux"])
+    @skipIfRemote # the stub has to see the shared memory object the test creates
+    @llgs_test
+    def test_qSharedMemoryRead_is_clamped_to_buffer_size_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.qSharedMemoryRead_is_clamped_to_buffer_size()
+
+    def QSetSharedMemoryBuffer_unknown_name_is_an_error(self):
+        procs = self.prep_debug_monitor_and_inferior()
+        name = "/lldb-test-no-such-shared-memory-{}".format(os.getpid())
+        self.set_shared_memory_buffer(name, 4096, "Exx")
+
+        # Without a buffer, qSharedMemoryRead isn't available.
+        self.test_sequence.add_log_lines(
+            ["read packet: $qSharedMemoryRead:1000,10#00",
+             "send packet: $#00"],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+    @skipUnlessPlatform(["linux"])
+    @llgs_test
+    def test_QSetSharedMemoryBuffer_unknown_name_is_an_error_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.QSetSharedMemoryBuffer_unknown_name_is_an_error()
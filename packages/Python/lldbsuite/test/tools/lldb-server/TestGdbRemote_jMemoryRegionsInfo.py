@@ -0,0 +1,79 @@
+from __future__ import print_function
+
+
+
+import json
+
+import gdbremote_testcase
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class TestGdbRemote_jMemoryRegionsInfo(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def escape_binary(self, data):
+        """Escape data the way the client does for binary packet contents."""
+        escaped = ""
+        for ch in data:
+            if ch in "#$}*":
+                escaped += "}" + chr(ord(ch) ^ 0x20)
+            else:
+                escaped += ch
+        return escaped
+
+    def get_memory_regions(self, generation=None):
+        """Send jMemoryRegionsInfo and return the decoded response dictionary."""
+        packet = "jMemoryRegionsInfo"
+        if generation is not None:
+            packet += ":" + self.escape_binary(json.dumps({"generation": generation}))
+        self.test_sequence.add_log_lines([
+            "read packet: ${}#00".format(packet),
+            {"direction":"send", "regex":r"^\$(.+)#[0-9a-fA-F]{2}$", "capture":{1:"response"} },
+            ], True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.reset_test_sequence()
+
+        response = json.loads(self.decode_gdbremote_binary(context.get("response")))
+        self.assertTrue("generation" in response)
+        return response
+
+    def check_regions(self, regions):
+        self.assertTrue(len(regions) > 0)
+        previous_end = 0
+        for region in regions:
+            self.assertTrue(region["size"] > 0)
+            self.assertTrue(set(region["permissions"]) <= set("rwx"))
+            # Sorted and not overlapping.
+            self.assertTrue(region["start"] >= previous_end)
+            previous_end = region["start"] + region["size"]
+        # The inferior's code has to be in there.
+        self.assertTrue(any("x" in region["permissions"] for region in regions))
+
+    def jMemoryRegionsInfo_generation_round_trip(self):
+        procs = self.prep_debug_monitor_and_inferior(inferior_args=["sleep:30"])
+
+        first = self.get_memory_regions()
+        self.assertTrue("regions" in first)
+        self.check_regions(first["regions"])
+        generation = first["generation"]
+
+        # Sending the current generation back leaves the regions out.
+        current = self.get_memory_regions(generation)
+        self.assertEqual(current["generation"], generation)
+        self.assertFalse("regions" in current)
+
+        # Any other generation gets the whole list again.
+        stale = self.get_memory_regions(generation + 1)
+        self.assertEqual(stale["generation"], generation)
+        self.assertEqual(stale["regions"], first["regions"])
+
+    @skipUnlessPlatform(["linux"])
+    @llgs_test
+    def test_jMemoryRegionsInfo_generation_round_trip_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.jMemoryRegionsInfo_generation_round_trip()
@@ -1372,6 +1372,69 @@ class LldbGdbServerTestCase(gdbremote_testcase.GdbRemoteTestCaseBase):
         self.set_inferior_startup_launch()
         self.P_writes_all_gpr_registers()
 
+    def read_register_with_p(self, reg_index, endian):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $p{0:x}#00".format(reg_index),
+             { "direction":"send", "regex":r"^\$([0-9a-fA-F]+)#", "capture":{1:"p_response"} },
+            ], True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        p_response = context.get("p_response")
+        self.assertIsNotNone(p_response)
+        return lldbgdbserverutils.unpack_register_hex_unsigned(endian, p_response)
+
+    def write_register_with_P(self, reg_index, endian, value, byte_size):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $P{0:x}={1}#00".format(reg_index, lldbgdbserverutils.pack_register_hex(endian, value, byte_size=byte_size)),
+             "send packet: $OK#00",
+            ], True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+    def P_sub_register_write_updates_full_register(self):
+        procs = self.prep_debug_monitor_and_inferior(inferior_args=["sleep:2"])
+        self.add_register_info_collection_packets()
+        self.add_process_info_collection_packets()
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        reg_infos = self.parse_register_info_packets(context)
+        self.assertIsNotNone(reg_infos)
+        self.add_lldb_register_index(reg_infos)
+        reg_indices = {reg_info["name"]: reg_info["lldb_register_index"] for reg_info in reg_infos}
+        for name in ["rax", "eax", "ah"]:
+            if not name in reg_indices:
+                self.skipTest("inferior has no {} register".format(name))
+
+        process_info = self.parse_process_info_response(context)
+        endian = process_info.get("endian")
+        self.assertIsNotNone(endian)
+
+        # Reading the full register first leaves it in the stub's register
+        # cache, which the sub-register writes below must not bring back.
+        rax = self.read_register_with_p(reg_indices["rax"], endian)
+
+        self.write_register_with_P(reg_indices["eax"], endian, 0x12345678, 4)
+        expected_rax = (rax & ~0xffffffff) | 0x12345678
+        self.assertEqual(self.read_register_with_p(reg_indices["rax"], endian), expected_rax)
+        self.assertEqual(self.read_register_with_p(reg_indices["eax"], endian), 0x12345678)
+
+        self.write_register_with_P(reg_indices["ah"], endian, 0xab, 1)
+        expected_rax = (expected_rax & ~0xff00) | 0xab00
+        self.assertEqual(self.read_register_with_p(reg_indices["rax"], endian), expected_rax)
+
+    @skipUnlessPlatform(["linux"])
+    @skipIf(archs=no_match(["x86_64"]))
+    @llgs_test
+    def test_P_sub_register_write_updates_full_register_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.P_sub_register_write_updates_full_register()
+
     def P_and_p_thread_suffix_work(self):
         # Startup the inferior with three threads.
         procs = self.prep_debug_monitor_and_inferior(inferior_args=["thread:new", "thread:new"])
@@ -0,0 +1,98 @@
+from __future__ import print_function
+
+
+
+import os
+import re
+import socket
+import time
+
+import gdbremote_testcase
+import lldbgdbserverutils
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class TestPlatformGDBServerPool(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def start_platform(self, pool_size):
+        """Start lldb-server platform --server with a gdbserver pool and return (process, port)."""
+        port_file = os.path.join(os.getcwd(), "platform-port-%d" % int(time.time() * 1000))
+        self.addTearDownHook(lambda: os.path.exists(port_file) and os.unlink(port_file))
+        commandline_args = ["platform", "--server", "--listen", "localhost:0", "--socket-file", port_file,
+                            "--gdbserver-pool-size", str(pool_size)]
+        platform = self.spawnSubprocess(self.debug_monitor_exe, commandline_args, install_remote=False)
+        self.addTearDownHook(self.cleanupSubprocesses)
+
+        for i in range(50):
+            if os.path.exists(port_file):
+                with open(port_file) as f:
+                    contents = f.read().strip()
+                if contents:
+                    return (platform, int(contents))
+            time.sleep(0.1)
+        self.fail("lldb-server platform didn't write its port")
+
+    def read_packet(self, sock):
+        data = ""
+        while True:
+            match = re.search(r"\$([^#]*)#[0-9a-fA-F]{2}", data)
+            if match:
+                return match.group(1)
+            chunk = sock.recv(4096)
+            self.assertTrue(len(chunk) > 0, "platform closed the connection")
+            data += chunk.decode()
+
+    def launch_gdbserver(self, port):
+        """Connect to the platform, ask it for a gdbserver and return the gdbserver's pid."""
+        sock = socket.create_connection(("localhost", port))
+        self.addTearDownHook(sock.close)
+        sock.sendall(b"+")
+        sock.sendall(lldbgdbserverutils.gdbremote_packet_encode_string("qLaunchGDBServer;host:127.0.0.1;").encode())
+        response = self.read_packet(sock)
+        sock.sendall(b"+")
+
+        match = re.match(r"pid:(\d+);port:(\d+);", response)
+        self.assertIsNotNone(match, "unexpected qLaunchGDBServer reply: " + response)
+        pid = int(match.group(1))
+        self.addTearDownHook(lambda: lldbgdbserverutils.process_is_running(pid, False) and os.kill(pid, 9))
+        return pid
+
+    def get_parent_pid(self, pid):
+        with open("/proc/%d/stat" % pid) as f:
+            # The command name is in parentheses and can contain spaces.
+            return int(f.read().rsplit(")", 1)[1].split()[1])
+
+    @skipUnlessPlatform(["linux"])
+    @skipIfRemote
+    @llgs_test
+    @no_debug_info_test
+    def test_each_connection_gets_a_pooled_gdbserver(self):
+        self.init_llgs_test(False)
+        (platform, port) = self.start_platform(1)
+
+        # Give the platform time to fill its pool before the first client.
+        time.sleep(1)
+        first = self.launch_gdbserver(port)
+        # The pool is kept by the accepting process, not by the process it
+        # forks for each connection.
+        self.assertEqual(self.get_parent_pid(first), platform.pid)
+
+        # It is refilled before the next connection is accepted.
+        second = self.launch_gdbserver(port)
+        self.assertNotEqual(first, second)
+        self.assertEqual(self.get_parent_pid(second), platform.pid)
+
+    @skipUnlessPlatform(["linux"])
+    @skipIfRemote
+    @llgs_test
+    @no_debug_info_test
+    def test_without_pool_connections_start_gdbservers(self):
+        self.init_llgs_test(False)
+        (platform, port) = self.start_platform(0)
+
+        pid = self.launch_gdbserver(port)
+        # Started by the process handling the connection.
+        self.assertNotEqual(self.get_parent_pid(pid), platform.pid)
@@ -808,7 +808,11 @@ class GdbRemoteTestCaseBase(TestBase):
         "qXfer:libraries:read",
         "qXfer:libraries-svr4:read",
         "qXfer:features:read",
-        "qEcho"
+        "qEcho",
+        "QNonStop",
+        "qSaveCore",
+        "PipelinedPackets",
+        "QSetSharedMemoryBuffer"
     ]
 
     def parse_qSupported_response(self, context):
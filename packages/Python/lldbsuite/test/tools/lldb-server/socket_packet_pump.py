@@ -59,13 +59,15 @@ class SocketPacketPump(object):
     All incoming $O packet content is accumulated with the current accumulation
     state put into the OutputQueue.
 
-    All other incoming packets are placed in the packet queue.
+    All other incoming packets, including %-prefixed notifications, are
+    placed in the packet queue.
 
     A select thread can be started and stopped, and runs to place packet
     content into the two queues.
     """
 
-    _GDB_REMOTE_PACKET_REGEX = re.compile(r'^\$([^\#]*)#[0-9a-fA-F]{2}')
+    # Matches both regular packets and %-prefixed notification packets.
+    _GDB_REMOTE_PACKET_REGEX = re.compile(r'^[\$%]([^\#]*)#[0-9a-fA-F]{2}')
 
     def __init__(self, pump_socket, pump_queues, logger=None):
         if not pump_socket:
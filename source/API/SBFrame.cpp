@@ -1174,6 +1174,11 @@ SBFrame::GetVariables (const lldb::SBVariablesOptions& options)
                     const size_t num_variables = variable_list->GetSize();
                     if (num_variables)
                     {
+                        // Front ends ask for the variables of every visible
+                        // frame on every stop, read their memory in bulk.
+                        if (arguments || locals)
+                            frame->PrefetchVariableMemory (*variable_list);
+
                         for (i = 0; i < num_variables; ++i)
                         {
                             VariableSP variable_sp (variable_list->GetVariableAtIndex(i));
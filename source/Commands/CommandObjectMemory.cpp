@@ -1219,19 +1219,7 @@ protected:
             size_t buffer_size)
     {
         Process *process = m_exe_ctx.GetProcessPtr();
-        DataBufferHeap heap(buffer_size, 0);
-        for (auto ptr = low;
-             ptr < high;
-             ptr++)
-        {
-            Error error;
-            process->ReadMemory(ptr, heap.GetBytes(), buffer_size, error);
-            if (error.Fail())
-                return LLDB_INVALID_ADDRESS;
-            if (memcmp(heap.GetBytes(), buffer, buffer_size) == 0)
-                return ptr;
-        }
-        return LLDB_INVALID_ADDRESS;
+        return process->FindInMemory(low, high, buffer, buffer_size);
     }
   
     OptionGroupOptions m_option_group;
@@ -7,8 +7,6 @@
 //
 //===----------------------------------------------------------------------===//
 
-#ifndef __ANDROID_NDK__
-
 #include "lldb/Core/ConnectionSharedMemory.h"
 
 // C Includes
@@ -41,6 +39,7 @@ ConnectionSharedMemory::ConnectionSharedMemory () :
     Connection(),
     m_name(),
     m_fd (-1),
+    m_created (false),
     m_mmap()
 {
 }
@@ -80,19 +79,28 @@ ConnectionStatus
 ConnectionSharedMemory::Disconnect (Error *error_ptr)
 {
     m_mmap.Clear();
-    if (!m_name.empty())
+    Unlink();
+    m_name.clear();
+    if (m_fd >= 0)
     {
-#ifdef _WIN32
         close(m_fd);
         m_fd = -1;
-#else
-        shm_unlink (m_name.c_str());
-#endif
-        m_name.clear();
     }
     return eConnectionStatusSuccess;
 }
 
+void
+ConnectionSharedMemory::Unlink ()
+{
+    // Only the side that created the name removes it.  Windows removes a
+    // mapping's name along with its last handle.
+#if !defined(_WIN32) && !defined(__ANDROID_NDK__)
+    if (m_created && !m_name.empty())
+        shm_unlink (m_name.c_str());
+#endif
+    m_created = false;
+}
+
 size_t
 ConnectionSharedMemory::Read (void *dst, 
                               size_t dst_len, 
@@ -118,6 +126,13 @@ ConnectionSharedMemory::GetURI()
     return "";
 }
 
+bool
+ConnectionSharedMemory::InterruptRead()
+{
+    // Read() never blocks, so there is nothing to interrupt.
+    return false;
+}
+
 ConnectionStatus
 ConnectionSharedMemory::BytesAvailable (uint32_t timeout_usec, Error *error_ptr)
 {
@@ -135,6 +150,7 @@ ConnectionSharedMemory::Open (bool create, const char *name, size_t size, Error
     }
     
     m_name.assign (name);
+    m_created = create;
 
 #ifdef _WIN32
     HANDLE handle = INVALID_HANDLE_VALUE;
@@ -151,21 +167,38 @@ ConnectionSharedMemory::Open (bool create, const char *name, size_t size, Error
     }
 
     m_fd = _open_osfhandle((intptr_t)handle, 0);
+#elif defined(__ANDROID_NDK__)
+    // Bionic has no shm_open().
+    errno = ENOSYS;
 #else
     int oflag = O_RDWR;
     if (create)
-        oflag |= O_CREAT;
+        oflag |= O_CREAT | O_EXCL;
     m_fd = ::shm_open (m_name.c_str(), oflag, S_IRUSR|S_IWUSR);
+    // Don't remove a name someone else created.
+    if (m_fd < 0)
+        m_created = false;
 
-    if (create)
-        ::ftruncate (m_fd, size);
+    if (m_fd >= 0 && create && ::ftruncate (m_fd, size) != 0)
+    {
+        ::close (m_fd);
+        m_fd = -1;
+    }
 #endif
 
+    if (m_fd < 0)
+    {
+        if (error_ptr)
+            error_ptr->SetErrorToErrno();
+        Disconnect(nullptr);
+        return eConnectionStatusError;
+    }
+
     if (m_mmap.MemoryMapFromFileDescriptor(m_fd, 0, size, true, false) == size)
         return eConnectionStatusSuccess;
 
+    if (error_ptr)
+        error_ptr->SetErrorStringWithFormat("couldn't map %" PRIu64 " bytes of shared memory '%s'", (uint64_t)size, name);
     Disconnect(nullptr);
     return eConnectionStatusError;
 }
-
-#endif // __ANDROID_NDK__
@@ -0,0 +1,132 @@
+//===-- InstructionBranchMap.cpp --------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+// C++ Includes
+#include <algorithm>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/InstructionBranchMap.h"
+#include "lldb/Core/Disassembler.h"
+#include "lldb/Core/Timer.h"
+#include "lldb/Target/ExecutionContext.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+InstructionBranchMapSP
+InstructionBranchMap::Create (const ArchSpec &arch,
+                              const ExecutionContext &exe_ctx,
+                              const AddressRange &function_range)
+{
+    InstructionBranchMapSP branch_map_sp;
+    if (function_range.GetByteSize() == 0 || function_range.GetByteSize() > UINT32_MAX)
+        return branch_map_sp;
+
+    Timer scoped_timer (__PRETTY_FUNCTION__, __PRETTY_FUNCTION__);
+
+    const char *plugin_name = nullptr;
+    const char *flavor = nullptr;
+    const bool prefer_file_cache = true;
+    DisassemblerSP disassembler_sp = Disassembler::DisassembleRange (arch,
+                                                                     plugin_name,
+                                                                     flavor,
+                                                                     exe_ctx,
+                                                                     function_range,
+                                                                     prefer_file_cache);
+    if (!disassembler_sp)
+        return branch_map_sp;
+
+    InstructionList &instructions = disassembler_sp->GetInstructionList();
+    const size_t num_instructions = instructions.GetSize();
+    if (num_instructions == 0)
+        return branch_map_sp;
+
+    branch_map_sp.reset (new InstructionBranchMap (function_range));
+    branch_map_sp->m_insn_offsets.reserve (num_instructions);
+    for (size_t i = 0; i < num_instructions; ++i)
+    {
+        InstructionSP inst_sp = instructions.GetInstructionAtIndex (i);
+        if (!inst_sp)
+            return InstructionBranchMapSP();
+        branch_map_sp->AppendInstruction (inst_sp->GetAddress().GetFileAddress(), inst_sp->DoesBranch());
+    }
+    branch_map_sp->Finalize();
+    return branch_map_sp;
+}
+
+InstructionBranchMap::InstructionBranchMap (const AddressRange &function_range) :
+    m_function_range (function_range),
+    m_insn_offsets (),
+    m_next_branch ()
+{
+}
+
+InstructionBranchMap::~InstructionBranchMap ()
+{
+}
+
+void
+InstructionBranchMap::AppendInstruction (addr_t file_addr, bool does_branch)
+{
+    m_insn_offsets.push_back (file_addr - m_function_range.GetBaseAddress().GetFileAddress());
+    // Until Finalize runs, m_next_branch just records which instructions branch.
+    m_next_branch.push_back (does_branch ? 1 : 0);
+}
+
+void
+InstructionBranchMap::Finalize ()
+{
+    uint32_t next_branch = UINT32_MAX;
+    for (size_t i = m_next_branch.size(); i > 0; --i)
+    {
+        if (m_next_branch[i - 1])
+            next_branch = i - 1;
+        m_next_branch[i - 1] = next_branch;
+    }
+}
+
+uint32_t
+InstructionBranchMap::GetIndexOfInstructionAtFileAddress (addr_t file_addr) const
+{
+    const addr_t base_addr = m_function_range.GetBaseAddress().GetFileAddress();
+    if (file_addr < base_addr)
+        return UINT32_MAX;
+
+    const addr_t offset = file_addr - base_addr;
+    if (offset == m_function_range.GetByteSize())
+        return m_insn_offsets.size();
+    if (offset > m_function_range.GetByteSize())
+        return UINT32_MAX;
+
+    std::vector<uint32_t>::const_iterator pos = std::lower_bound (m_insn_offsets.begin(), m_insn_offsets.end(), (uint32_t)offset);
+    if (pos == m_insn_offsets.end() || *pos != offset)
+        return UINT32_MAX;
+    return pos - m_insn_offsets.begin();
+}
+
+uint32_t
+InstructionBranchMap::GetIndexOfNextBranchInstruction (uint32_t start) const
+{
+    if (start >= m_next_branch.size())
+        return UINT32_MAX;
+    return m_next_branch[start];
+}
+
+addr_t
+InstructionBranchMap::GetFileAddressAtIndex (uint32_t index) const
+{
+    const addr_t base_addr = m_function_range.GetBaseAddress().GetFileAddress();
+    if (index < m_insn_offsets.size())
+        return base_addr + m_insn_offsets[index];
+    if (index == m_insn_offsets.size())
+        return base_addr + m_function_range.GetByteSize();
+    return LLDB_INVALID_ADDRESS;
+}
@@ -20,6 +20,7 @@
 #include "lldb/Core/Error.h"
 #include "lldb/Core/DataBuffer.h"
 #include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/InstructionBranchMap.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/ModuleList.h"
 #include "lldb/Core/ModuleSpec.h"
@@ -160,10 +161,12 @@ Module::Module (const ModuleSpec &module_spec) :
     m_object_offset (),
     m_object_mod_time (),
     m_objfile_sp (),
+    m_data_sp (),
     m_symfile_ap (),
     m_type_system_map(),
     m_source_mappings (),
     m_sections_ap(),
+    m_branch_maps(),
     m_did_load_objfile (false),
     m_did_load_symbol_vendor (false),
     m_did_parse_uuid (false),
@@ -186,6 +189,20 @@ Module::Module (const ModuleSpec &module_spec) :
                      module_spec.GetObjectName().IsEmpty() ? "" : module_spec.GetObjectName().AsCString(""),
                      module_spec.GetObjectName().IsEmpty() ? "" : ")");
 
+    // Modules that come with their own object file contents don't have a
+    // file we could get module specifications from, take the spec as is.
+    if (module_spec.GetData())
+    {
+        m_data_sp = module_spec.GetData();
+        m_file = module_spec.GetFileSpec();
+        m_platform_file = module_spec.GetPlatformFileSpec();
+        m_arch = module_spec.GetArchitecture();
+        m_object_name = module_spec.GetObjectName();
+        if (m_file)
+            m_mod_time = m_file.GetModificationTime();
+        return;
+    }
+
     // First extract all module specifications from the file using the local
     // file path. If there are no specifications, then don't fill anything in
     ModuleSpecList modules_specs;
@@ -263,10 +280,12 @@ Module::Module(const FileSpec& file_spec,
     m_object_offset (object_offset),
     m_object_mod_time (),
     m_objfile_sp (),
+    m_data_sp (),
     m_symfile_ap (),
     m_type_system_map(),
     m_source_mappings (),
     m_sections_ap(),
+    m_branch_maps(),
     m_did_load_objfile (false),
     m_did_load_symbol_vendor (false),
     m_did_parse_uuid (false),
@@ -308,10 +327,12 @@ Module::Module () :
     m_object_offset (0),
     m_object_mod_time (),
     m_objfile_sp (),
+    m_data_sp (),
     m_symfile_ap (),
     m_type_system_map(),
     m_source_mappings (),
     m_sections_ap(),
+    m_branch_maps(),
     m_did_load_objfile (false),
     m_did_load_symbol_vendor (false),
     m_did_parse_uuid (false),
@@ -1485,9 +1506,9 @@ Module::GetObjectFile()
         {
             Timer scoped_timer(__PRETTY_FUNCTION__,
                                "Module::GetObjectFile () module = %s", GetFileSpec().GetFilename().AsCString(""));
-            DataBufferSP data_sp;
+            DataBufferSP data_sp (m_data_sp);
             lldb::offset_t data_offset = 0;
-            const lldb::offset_t file_size = m_file.GetByteSize();
+            const lldb::offset_t file_size = m_data_sp ? m_data_sp->GetByteSize() : m_file.GetByteSize();
             if (file_size > m_object_offset)
             {
                 m_did_load_objfile = true;
@@ -1961,6 +1982,35 @@ Module::ClearModuleDependentCaches ()
         swift_ast->ClearModuleDependentCaches();
 }
 
+InstructionBranchMapSP
+Module::GetInstructionBranchMap (const ExecutionContext &exe_ctx, const AddressRange &function_range)
+{
+    const Address &base_addr = function_range.GetBaseAddress();
+    if (base_addr.GetModule().get() != this)
+        return InstructionBranchMapSP();
+
+    const addr_t func_file_addr = base_addr.GetFileAddress();
+    {
+        Mutex::Locker locker (m_mutex);
+        auto pos = m_branch_maps.find (func_file_addr);
+        if (pos != m_branch_maps.end())
+        {
+            // Functions that share a start address but not a size (e.g. a
+            // symbol and a debug info function that disagree) are rebuilt.
+            if (!pos->second || pos->second->GetFunctionRange().GetByteSize() == function_range.GetByteSize())
+                return pos->second;
+        }
+    }
+
+    // Disassemble without holding the module mutex, the disassembler may
+    // need to read from the process.
+    InstructionBranchMapSP branch_map_sp = InstructionBranchMap::Create (GetArchitecture(), exe_ctx, function_range);
+
+    Mutex::Locker locker (m_mutex);
+    m_branch_maps[func_file_addr] = branch_map_sp;
+    return branch_map_sp;
+}
+
 bool
 Module::GetIsDynamicLinkEditor()
 {
@@ -27,6 +27,7 @@
 #include "lldb/Host/HostInfo.h"
 #include "lldb/Host/Mutex.h"
 #include "lldb/Interpreter/OptionValueProperties.h"
+#include "lldb/Target/Process.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -1306,6 +1307,9 @@ Error
 PluginManager::SaveCore (const lldb::ProcessSP &process_sp, const FileSpec &outfile)
 {
     Error error;
+    if (process_sp && process_sp->SaveCore(outfile, error))
+        return error;
+
     Mutex::Locker locker (GetObjectFileMutex ());
     ObjectFileInstances &instances = GetObjectFileInstances ();
     
@@ -644,6 +644,15 @@ Value::GetValueAsData (ExecutionContext *exe_ctx,
     if (error.Fail())
         return error;
 
+    // Processes that have their memory mapped already, like core files,
+    // can hand us a view of it instead of copying it into "data".
+    if (exe_ctx && data_offset == 0 && byte_size > 0 && address_type == eAddressTypeLoad && !file_so_addr.IsValid())
+    {
+        Process *process = exe_ctx->GetProcessPtr();
+        if (process && process->GetMemoryData (address, byte_size, data))
+            return error;
+    }
+
     // Make sure we have enough room within "data", and if we don't make
     // something large enough that does
     if (!data.ValidOffsetForDataOfSize (data_offset, byte_size))
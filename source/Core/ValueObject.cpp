@@ -651,6 +651,131 @@ ValueObject::SetValueDidChange (bool value_changed)
     m_value_did_change = value_changed;
 }
 
+lldb::ValueObjectSP
+ValueObject::ChildrenManager::GetChildSPAtIndex (size_t idx)
+{
+    Mutex::Locker locker(m_mutex);
+    ValueObject *child = FindChild(idx);
+    if (child == nullptr)
+        return lldb::ValueObjectSP();
+    if (m_window_size == 0)
+    {
+        OwnedChildrenMap::const_iterator pos = m_owned_children_map.find(idx);
+        if (pos != m_owned_children_map.end())
+            return pos->second;
+        return child->GetSP();
+    }
+    const size_t slot = idx - m_first_index;
+    if (slot < m_owned_children.size() && m_owned_children[slot])
+        return m_owned_children[slot];
+    return child->GetSP();
+}
+
+void
+ValueObject::ChildrenManager::SetChild (size_t idx, ValueObject *valobj, const lldb::ValueObjectSP &valobj_sp)
+{
+    // Declared before the locker so that evicted children are destroyed
+    // after the lock is released.
+    OwnedChildrenVector evicted;
+    Mutex::Locker locker(m_mutex);
+    if (m_window_size == 0)
+    {
+        // Like the map this used to be, keep the first child stored for idx.
+        if (!m_children_map.insert(ChildrenMap::value_type(idx, valobj)).second)
+            return;
+        if (valobj_sp)
+            m_owned_children_map[idx] = valobj_sp;
+        return;
+    }
+    MakeSlotForIndex(idx, evicted);
+    const size_t slot = idx - m_first_index;
+    if (m_children[slot] != nullptr)
+        return;
+    m_children[slot] = valobj;
+    if (valobj_sp)
+    {
+        if (m_owned_children.size() != m_children.size())
+            m_owned_children.resize(m_children.size());
+        m_owned_children[slot] = valobj_sp;
+    }
+}
+
+void
+ValueObject::ChildrenManager::MakeSlotForIndex (size_t idx, OwnedChildrenVector &evicted)
+{
+    if (idx < m_first_index || idx >= m_first_index + m_window_size)
+    {
+        // Center the window on idx so that paging in either direction
+        // only has to move it every m_window_size / 2 children.
+        const size_t new_first_index = idx > m_window_size / 2 ? idx - m_window_size / 2 : 0;
+        const size_t new_end_index = new_first_index + m_window_size;
+
+        ChildrenVector children;
+        OwnedChildrenVector owned_children;
+        for (size_t slot = 0; slot < m_children.size(); ++slot)
+        {
+            const size_t child_idx = m_first_index + slot;
+            const bool has_owner = slot < m_owned_children.size() && m_owned_children[slot];
+            if (child_idx >= new_first_index && child_idx < new_end_index)
+            {
+                const size_t new_slot = child_idx - new_first_index;
+                if (new_slot >= children.size())
+                    children.resize(new_slot + 1, nullptr);
+                children[new_slot] = m_children[slot];
+                if (has_owner)
+                {
+                    if (owned_children.size() < children.size())
+                        owned_children.resize(children.size());
+                    owned_children[new_slot] = std::move(m_owned_children[slot]);
+                }
+            }
+            else if (has_owner)
+            {
+                evicted.push_back(std::move(m_owned_children[slot]));
+            }
+        }
+        m_children.swap(children);
+        m_owned_children.swap(owned_children);
+        m_first_index = new_first_index;
+    }
+
+    const size_t slot = idx - m_first_index;
+    if (slot >= m_children.size())
+        m_children.resize(slot + 1, nullptr);
+    if (!m_owned_children.empty() && m_owned_children.size() != m_children.size())
+        m_owned_children.resize(m_children.size());
+}
+
+void
+ValueObject::ChildrenManager::SetWindowSize (size_t window_size)
+{
+    OwnedChildrenMap owned_children_map;
+    OwnedChildrenVector owned_children;
+    Mutex::Locker locker(m_mutex);
+    if (window_size == m_window_size)
+        return;
+    m_window_size = window_size;
+    m_children_map.clear();
+    m_owned_children_map.swap(owned_children_map);
+    m_children.clear();
+    m_owned_children.swap(owned_children);
+    m_first_index = 0;
+}
+
+void
+ValueObject::ChildrenManager::Clear (size_t new_count)
+{
+    OwnedChildrenMap owned_children_map;
+    OwnedChildrenVector owned_children;
+    Mutex::Locker locker(m_mutex);
+    m_children_count = new_count;
+    m_children_map.clear();
+    m_owned_children_map.swap(owned_children_map);
+    m_children.clear();
+    m_owned_children.swap(owned_children);
+    m_first_index = 0;
+}
+
 ValueObjectSP
 ValueObject::GetChildAtIndex (size_t idx, bool can_create)
 {
@@ -1126,6 +1251,8 @@ ValueObject::GetPointeeData (DataExtractor& data,
                     Process *process = exe_ctx.GetProcessPtr();
                     if (process)
                     {
+                        if (process->GetMemoryData(addr + offset, bytes, data))
+                            return bytes;
                         heap_buf_ptr->SetByteSize(bytes);
                         size_t bytes_read = process->ReadMemory(addr + offset, heap_buf_ptr->GetBytes(), bytes, error);
                         if (error.Success() || bytes_read > 0)
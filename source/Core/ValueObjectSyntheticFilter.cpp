@@ -16,6 +16,7 @@
 #include "lldb/Core/Log.h"
 #include "lldb/Core/ValueObject.h"
 #include "lldb/DataFormatters/TypeSynthetic.h"
+#include "lldb/Target/Target.h"
 
 using namespace lldb_private;
 
@@ -63,7 +64,6 @@ ValueObjectSynthetic::ValueObjectSynthetic (ValueObject &parent, lldb::Synthetic
     m_children_byindex(),
     m_name_toindex(),
     m_synthetic_children_count(UINT32_MAX),
-    m_synthetic_children_cache(),
     m_parent_type_name(parent.GetTypeName()),
     m_might_have_children(eLazyBoolCalculate),
     m_provides_value(eLazyBoolCalculate)
@@ -213,7 +213,6 @@ ValueObjectSynthetic::UpdateValue ()
         // for a synthetic VO that might indeed happen, so we need to tell the upper echelons
         // that they need to come back to us asking for children
         m_children_count_valid = false;
-        m_synthetic_children_cache.Clear();
         m_synthetic_children_count = UINT32_MAX;
         m_might_have_children = eLazyBoolCalculate;
     }
@@ -222,6 +221,10 @@ ValueObjectSynthetic::UpdateValue ()
         if (log)
             log->Printf("[ValueObjectSynthetic::UpdateValue] name=%s, synthetic filter said caches are still valid", GetName().AsCString());
     }
+
+    // Pick up changes to target.max-cached-synthetic-children.
+    if (lldb::TargetSP target_sp = GetTargetSP())
+        m_children_byindex.SetWindowSize(target_sp->GetMaximumNumberOfCachedSyntheticChildren());
     
     m_provides_value = eLazyBoolCalculate;
     
@@ -260,8 +263,8 @@ ValueObjectSynthetic::GetChildAtIndex (size_t idx, bool can_create)
     
     UpdateValueIfNeeded();
     
-    ValueObject *valobj;
-    if (m_children_byindex.GetValueForKey(idx, valobj) == false)
+    lldb::ValueObjectSP valobj_sp = m_children_byindex.GetChildSPAtIndex(idx);
+    if (!valobj_sp)
     {
         if (can_create && m_synth_filter_ap.get() != nullptr)
         {
@@ -283,8 +286,9 @@ ValueObjectSynthetic::GetChildAtIndex (size_t idx, bool can_create)
                 return synth_guy;
             
             if (synth_guy->IsSyntheticChildrenGenerated())
-                m_synthetic_children_cache.AppendObject(synth_guy);
-            m_children_byindex.SetValueForKey(idx, synth_guy.get());
+                m_children_byindex.SetChildAtIndex(idx, synth_guy);
+            else
+                m_children_byindex.SetChildAtIndex(idx, synth_guy.get());
             synth_guy->SetPreferredDisplayLanguageIfNeeded(GetPreferredDisplayLanguage());
             return synth_guy;
         }
@@ -306,9 +310,9 @@ ValueObjectSynthetic::GetChildAtIndex (size_t idx, bool can_create)
             log->Printf("[ValueObjectSynthetic::GetChildAtIndex] name=%s, child at index %zu cached as %p",
                         GetName().AsCString(),
                         idx,
-                        valobj);
+                        valobj_sp.get());
 
-        return valobj->GetSP();
+        return valobj_sp;
     }
 }
 
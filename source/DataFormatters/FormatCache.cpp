@@ -158,42 +158,64 @@ FormatCache::Entry::SetValidator (lldb::TypeValidatorImplSP validator_sp)
     m_validator_sp = validator_sp;
 }
 
+FormatCache::Shard::Shard () :
+m_mutex (),
+m_map (),
+m_generation (0)
+{
+}
+
 FormatCache::FormatCache () :
-m_map(),
-m_mutex (Mutex::eMutexTypeRecursive)
-#ifdef LLDB_CONFIGURATION_DEBUG
-,m_cache_hits(0),m_cache_misses(0)
-#endif
+m_generation (0),
+m_cache_hits (0),
+m_cache_misses (0)
+{
+}
+
+FormatCache::Shard &
+FormatCache::GetShard (const ConstString& type)
 {
+    // ConstString pointers are at least pointer aligned, skip the low bits.
+    const uintptr_t key = reinterpret_cast<uintptr_t>(type.GetCString());
+    return m_shards[((key >> 4) ^ (key >> 12)) % kNumShards];
+}
+
+FormatCache::Entry *
+FormatCache::FindEntry (Shard &shard, const ConstString& type)
+{
+    if (shard.m_generation != m_generation.load(std::memory_order_acquire))
+        return nullptr;
+    auto pos = shard.m_map.find(type.GetCString());
+    if (pos == shard.m_map.end())
+        return nullptr;
+    return &pos->second;
 }
 
 FormatCache::Entry&
-FormatCache::GetEntry (const ConstString& type)
+FormatCache::GetEntry (Shard &shard, const ConstString& type)
 {
-    auto i = m_map.find(type),
-    e = m_map.end();
-    if (i != e)
-        return i->second;
-    m_map[type] = FormatCache::Entry();
-    return m_map[type];
+    const uint32_t generation = m_generation.load(std::memory_order_acquire);
+    if (shard.m_generation != generation)
+    {
+        shard.m_map.clear();
+        shard.m_generation = generation;
+    }
+    return shard.m_map[type.GetCString()];
 }
 
 bool
 FormatCache::GetFormat (const ConstString& type,lldb::TypeFormatImplSP& format_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    auto entry = GetEntry(type);
-    if (entry.IsFormatCached())
+    Shard &shard = GetShard(type);
+    Mutex::Locker lock(shard.m_mutex);
+    Entry *entry = FindEntry(shard, type);
+    if (entry && entry->IsFormatCached())
     {
-#ifdef LLDB_CONFIGURATION_DEBUG
-        m_cache_hits++;
-#endif
-        format_sp = entry.GetFormat();
+        m_cache_hits.fetch_add(1, std::memory_order_relaxed);
+        format_sp = entry->GetFormat();
         return true;
     }
-#ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_misses++;
-#endif
+    m_cache_misses.fetch_add(1, std::memory_order_relaxed);
     format_sp.reset();
     return false;
 }
@@ -201,19 +223,16 @@ FormatCache::GetFormat (const ConstString& type,lldb::TypeFormatImplSP& format_s
 bool
 FormatCache::GetSummary (const ConstString& type,lldb::TypeSummaryImplSP& summary_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    auto entry = GetEntry(type);
-    if (entry.IsSummaryCached())
+    Shard &shard = GetShard(type);
+    Mutex::Locker lock(shard.m_mutex);
+    Entry *entry = FindEntry(shard, type);
+    if (entry && entry->IsSummaryCached())
     {
-#ifdef LLDB_CONFIGURATION_DEBUG
-        m_cache_hits++;
-#endif
-        summary_sp = entry.GetSummary();
+        m_cache_hits.fetch_add(1, std::memory_order_relaxed);
+        summary_sp = entry->GetSummary();
         return true;
     }
-#ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_misses++;
-#endif
+    m_cache_misses.fetch_add(1, std::memory_order_relaxed);
     summary_sp.reset();
     return false;
 }
@@ -221,19 +240,16 @@ FormatCache::GetSummary (const ConstString& type,lldb::TypeSummaryImplSP& summar
 bool
 FormatCache::GetSynthetic (const ConstString& type,lldb::SyntheticChildrenSP& synthetic_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    auto entry = GetEntry(type);
-    if (entry.IsSyntheticCached())
+    Shard &shard = GetShard(type);
+    Mutex::Locker lock(shard.m_mutex);
+    Entry *entry = FindEntry(shard, type);
+    if (entry && entry->IsSyntheticCached())
     {
-#ifdef LLDB_CONFIGURATION_DEBUG
-        m_cache_hits++;
-#endif
-        synthetic_sp = entry.GetSynthetic();
+        m_cache_hits.fetch_add(1, std::memory_order_relaxed);
+        synthetic_sp = entry->GetSynthetic();
         return true;
     }
-#ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_misses++;
-#endif
+    m_cache_misses.fetch_add(1, std::memory_order_relaxed);
     synthetic_sp.reset();
     return false;
 }
@@ -241,19 +257,16 @@ FormatCache::GetSynthetic (const ConstString& type,lldb::SyntheticChildrenSP& sy
 bool
 FormatCache::GetValidator (const ConstString& type,lldb::TypeValidatorImplSP& validator_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    auto entry = GetEntry(type);
-    if (entry.IsValidatorCached())
+    Shard &shard = GetShard(type);
+    Mutex::Locker lock(shard.m_mutex);
+    Entry *entry = FindEntry(shard, type);
+    if (entry && entry->IsValidatorCached())
     {
-#ifdef LLDB_CONFIGURATION_DEBUG
-        m_cache_hits++;
-#endif
-        validator_sp = entry.GetValidator();
+        m_cache_hits.fetch_add(1, std::memory_order_relaxed);
+        validator_sp = entry->GetValidator();
         return true;
     }
-#ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_misses++;
-#endif
+    m_cache_misses.fetch_add(1, std::memory_order_relaxed);
     validator_sp.reset();
     return false;
 }
@@ -261,35 +274,37 @@ FormatCache::GetValidator (const ConstString& type,lldb::TypeValidatorImplSP& va
 void
 FormatCache::SetFormat (const ConstString& type,lldb::TypeFormatImplSP& format_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    GetEntry(type).SetFormat(format_sp);
+    Shard &shard = GetShard(type);
+    Mutex::Locker lock(shard.m_mutex);
+    GetEntry(shard, type).SetFormat(format_sp);
 }
 
 void
 FormatCache::SetSummary (const ConstString& type,lldb::TypeSummaryImplSP& summary_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    GetEntry(type).SetSummary(summary_sp);
+    Shard &shard = GetShard(type);
+    Mutex::Locker lock(shard.m_mutex);
+    GetEntry(shard, type).SetSummary(summary_sp);
 }
 
 void
 FormatCache::SetSynthetic (const ConstString& type,lldb::SyntheticChildrenSP& synthetic_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    GetEntry(type).SetSynthetic(synthetic_sp);
+    Shard &shard = GetShard(type);
+    Mutex::Locker lock(shard.m_mutex);
+    GetEntry(shard, type).SetSynthetic(synthetic_sp);
 }
 
 void
 FormatCache::SetValidator (const ConstString& type,lldb::TypeValidatorImplSP& validator_sp)
 {
-    Mutex::Locker lock(m_mutex);
-    GetEntry(type).SetValidator(validator_sp);
+    Shard &shard = GetShard(type);
+    Mutex::Locker lock(shard.m_mutex);
+    GetEntry(shard, type).SetValidator(validator_sp);
 }
 
 void
 FormatCache::Clear ()
 {
-    Mutex::Locker lock(m_mutex);
-    m_map.clear();
+    m_generation.fetch_add(1, std::memory_order_acq_rel);
 }
-
@@ -10,6 +10,7 @@
 // C Includes
 
 // C++ Includes
+#include <algorithm>
 
 // Other libraries and framework includes
 
@@ -17,7 +18,10 @@
 #include "lldb/DataFormatters/FormattersHelpers.h"
 
 #include "lldb/Core/ConstString.h"
+#include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/RegularExpression.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/StackFrame.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
@@ -162,3 +166,184 @@ lldb_private::formatters::GetArrayAddressOrPointerValue (ValueObject& valobj)
 
     return data_addr;
 }
+
+// Don't let a single chunk grow past this many bytes, however many
+// children the user asked to see.
+static const size_t g_max_chunk_byte_size = 512 * 1024;
+
+ChunkedElementReader::ChunkedElementReader () :
+    m_process_wp (),
+    m_base_addr (LLDB_INVALID_ADDRESS),
+    m_element_stride (0),
+    m_element_count (0),
+    m_chunk_elements (1),
+    m_chunk_sp (),
+    m_chunk_start (0),
+    m_chunk_count (0)
+{
+}
+
+void
+ChunkedElementReader::Reset (const lldb::ProcessSP &process_sp,
+                             lldb::addr_t base_addr,
+                             size_t element_stride,
+                             size_t element_count,
+                             size_t chunk_elements)
+{
+    m_process_wp = process_sp;
+    m_base_addr = base_addr;
+    m_element_stride = element_stride;
+    m_element_count = element_count;
+    m_chunk_elements = std::max<size_t>(chunk_elements, 1);
+    if (m_element_stride > 0)
+        m_chunk_elements = std::max<size_t>(std::min<size_t>(m_chunk_elements, g_max_chunk_byte_size / m_element_stride), 1);
+    m_chunk_sp.reset();
+    m_chunk_start = 0;
+    m_chunk_count = 0;
+}
+
+bool
+ChunkedElementReader::ReadChunkContainingIndex (size_t idx)
+{
+    if (m_chunk_sp && idx >= m_chunk_start && idx < m_chunk_start + m_chunk_count)
+        return true;
+
+    ProcessSP process_sp(m_process_wp.lock());
+    if (!process_sp || m_base_addr == LLDB_INVALID_ADDRESS || idx >= m_element_count)
+        return false;
+
+    m_chunk_sp.reset();
+    m_chunk_start = idx - (idx % m_chunk_elements);
+    m_chunk_count = std::min<size_t>(m_chunk_elements, m_element_count - m_chunk_start);
+
+    const size_t chunk_byte_size = m_chunk_count * m_element_stride;
+    DataBufferHeap *heap = new DataBufferHeap(chunk_byte_size, 0);
+    DataBufferSP chunk_sp(heap);
+    if (chunk_byte_size > 0)
+    {
+        Error error;
+        const size_t bytes_read = process_sp->ReadMemory(m_base_addr + m_chunk_start * m_element_stride,
+                                                         heap->GetBytes(),
+                                                         chunk_byte_size,
+                                                         error);
+        // The tail of the chunk may run into unreadable memory, keep the
+        // elements we did get and read the rest one at a time.
+        const size_t elements_read = bytes_read / m_element_stride;
+        if (m_chunk_start + elements_read <= idx)
+        {
+            m_chunk_start = idx;
+            m_chunk_count = 1;
+            heap->SetByteSize(m_element_stride);
+            if (process_sp->ReadMemory(m_base_addr + idx * m_element_stride,
+                                       heap->GetBytes(),
+                                       m_element_stride,
+                                       error) != m_element_stride)
+            {
+                m_chunk_count = 0;
+                return false;
+            }
+        }
+        else
+            m_chunk_count = elements_read;
+    }
+    m_chunk_sp = chunk_sp;
+    return true;
+}
+
+bool
+ChunkedElementReader::GetElementData (size_t idx, size_t byte_size, DataExtractor &data)
+{
+    if (byte_size > m_element_stride)
+        return false;
+    if (!ReadChunkContainingIndex(idx))
+        return false;
+    ProcessSP process_sp(m_process_wp.lock());
+    if (!process_sp)
+        return false;
+    data.SetByteOrder(process_sp->GetByteOrder());
+    data.SetAddressByteSize(process_sp->GetAddressByteSize());
+    return data.SetData(m_chunk_sp, (idx - m_chunk_start) * m_element_stride, byte_size) == byte_size;
+}
+
+bool
+ChunkedElementReader::CopyElementData (size_t idx, size_t byte_size, void *dst)
+{
+    if (dst == nullptr || byte_size > m_element_stride)
+        return false;
+    if (!ReadChunkContainingIndex(idx))
+        return false;
+    if (byte_size)
+        memcpy(dst, m_chunk_sp->GetBytes() + (idx - m_chunk_start) * m_element_stride, byte_size);
+    return true;
+}
+
+bool
+lldb_private::formatters::PrefetchMemory (Process &process, lldb::addr_t addr, size_t byte_size)
+{
+    // Reads that fit in a cache line are cached a line at a time anyway.
+    if (process.GetDisableMemoryCache() || byte_size <= process.GetMemoryCacheLineSize())
+        return false;
+    byte_size = std::min(byte_size, g_max_chunk_byte_size);
+    DataBufferHeap buffer(byte_size, 0);
+    Error error;
+    return process.ReadMemory(addr, buffer.GetBytes(), byte_size, error) > 0;
+}
+
+// Start out assuming a few nodes per window and let the hit rate decide.
+static const size_t g_initial_window_nodes = 8;
+
+NodePrefetcher::NodePrefetcher () :
+    m_process_wp (),
+    m_node_size (0),
+    m_max_nodes (1),
+    m_window_nodes (g_initial_window_nodes),
+    m_window_hits (0),
+    m_window_start (LLDB_INVALID_ADDRESS),
+    m_window_end (LLDB_INVALID_ADDRESS)
+{
+}
+
+void
+NodePrefetcher::Reset (const lldb::ProcessSP &process_sp, size_t node_size, size_t max_nodes)
+{
+    m_process_wp = process_sp;
+    m_node_size = node_size;
+    m_max_nodes = std::max<size_t>(max_nodes, 1);
+    m_window_nodes = std::min(g_initial_window_nodes, m_max_nodes);
+    m_window_hits = 0;
+    m_window_start = LLDB_INVALID_ADDRESS;
+    m_window_end = LLDB_INVALID_ADDRESS;
+}
+
+void
+NodePrefetcher::WillReadNode (lldb::addr_t node_addr)
+{
+    if (m_node_size == 0 || node_addr == 0 || node_addr == LLDB_INVALID_ADDRESS)
+        return;
+
+    const bool have_window = m_window_start != LLDB_INVALID_ADDRESS;
+    if (have_window && node_addr >= m_window_start && node_addr + m_node_size <= m_window_end)
+    {
+        ++m_window_hits;
+        return;
+    }
+
+    if (have_window)
+    {
+        // The first node is always in the window, it was prefetched for it.
+        if (m_window_hits > 1)
+            m_window_nodes = std::min(m_window_nodes * 2, m_max_nodes);
+        else
+            m_window_nodes = std::max<size_t>(m_window_nodes / 2, 1);
+    }
+
+    ProcessSP process_sp(m_process_wp.lock());
+    if (!process_sp)
+        return;
+
+    const size_t window_size = m_window_nodes * m_node_size;
+    PrefetchMemory(*process_sp, node_addr, window_size);
+    m_window_start = node_addr;
+    m_window_end = node_addr + window_size;
+    m_window_hits = 1;
+}
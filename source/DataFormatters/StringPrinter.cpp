@@ -19,7 +19,10 @@
 #include "llvm/Support/ConvertUTF.h"
 
 #include <ctype.h>
+#include <string.h>
+#include <algorithm>
 #include <locale>
+#include <vector>
 
 using namespace lldb;
 using namespace lldb_private;
@@ -404,6 +407,306 @@ lldb_private::formatters::StringPrinter::ReadBufferAndDumpToStreamOptions::ReadB
 }
 
 
+namespace {
+
+//----------------------------------------------------------------------
+// Reads a string out of the inferior one chunk at a time, through the
+// process memory cache, so that it can be printed while it is being read
+// and at most one chunk is held in memory.  The first chunk is a single
+// cache line, which is all most strings need; after that chunks double
+// in size up to kMaxChunkSize so that long strings take few round trips.
+// Chunks stay within chunk aligned boundaries, and if a large read fails
+// (part of it may be unmapped) the reader goes back to cache line sized
+// reads.
+//----------------------------------------------------------------------
+class StringChunkReader
+{
+public:
+    StringChunkReader (Process &process, lldb::addr_t location, size_t max_bytes, size_t element_size) :
+        m_process (process),
+        m_next_addr (location),
+        m_bytes_left (max_bytes - max_bytes % element_size),
+        m_element_size (element_size),
+        m_line_size (std::max<size_t>(process.GetMemoryCacheLineSize(), element_size)),
+        m_chunk_size (m_line_size),
+        m_max_chunk_size (std::max<size_t>(kMaxChunkSize, m_line_size)),
+        m_chunk (),
+        m_found_terminator (false)
+    {
+    }
+
+    //------------------------------------------------------------------
+    // Read the next chunk.  If stop_at_zero, the chunk is cut at the
+    // first zero element and nothing more is read after it.
+    //
+    // Returns false once there is nothing left to read, in which case
+    // error tells whether the read failed.
+    //------------------------------------------------------------------
+    bool
+    ReadNextChunk (bool stop_at_zero, Error &error)
+    {
+        m_chunk.clear();
+        if (m_bytes_left == 0 || m_found_terminator)
+            return false;
+
+        size_t bytes_to_read = 0;
+        size_t bytes_read = 0;
+        while (true)
+        {
+            bytes_to_read = std::min<size_t>(m_bytes_left, m_chunk_size - m_next_addr % m_chunk_size);
+            bytes_to_read -= bytes_to_read % m_element_size;
+            if (bytes_to_read == 0)
+                bytes_to_read = m_element_size; // The boundary splits an element
+            m_chunk.resize(bytes_to_read);
+            bytes_read = m_process.ReadMemory(m_next_addr, m_chunk.data(), bytes_to_read, error);
+            if (bytes_read > 0 || m_chunk_size <= m_line_size)
+                break;
+            m_chunk_size = m_max_chunk_size = m_line_size;
+        }
+
+        bytes_read -= bytes_read % m_element_size;
+        if (bytes_read == 0)
+        {
+            m_chunk.clear();
+            m_bytes_left = 0;
+            return false;
+        }
+        error.Clear();
+
+        m_chunk.resize(bytes_read);
+        m_next_addr += bytes_read;
+        m_bytes_left -= bytes_read;
+        if (bytes_read < bytes_to_read)
+            m_bytes_left = 0;
+
+        if (stop_at_zero)
+        {
+            const size_t length = FindTerminator();
+            if (length < m_chunk.size())
+            {
+                m_chunk.resize(length);
+                m_found_terminator = true;
+            }
+        }
+
+        if (m_chunk_size < m_max_chunk_size)
+            m_chunk_size = std::min<size_t>(m_chunk_size * 2, m_max_chunk_size);
+        return true;
+    }
+
+    uint8_t *
+    GetBytes ()
+    {
+        return m_chunk.data();
+    }
+
+    size_t
+    GetByteSize () const
+    {
+        return m_chunk.size();
+    }
+
+private:
+    static const size_t kMaxChunkSize = 16 * 1024;
+
+    // Returns the byte offset of the first zero element in the chunk, or
+    // the chunk size if there is none.
+    size_t
+    FindTerminator () const
+    {
+        const uint8_t *bytes = m_chunk.data();
+        const size_t size = m_chunk.size();
+        if (m_element_size == 1)
+        {
+            const void *zero = ::memchr(bytes, 0, size);
+            return zero ? static_cast<const uint8_t *>(zero) - bytes : size;
+        }
+        static const uint8_t g_zeroes[4] = { 0, 0, 0, 0 };
+        for (size_t offset = 0; offset + m_element_size <= size; offset += m_element_size)
+        {
+            if (::memcmp(bytes + offset, g_zeroes, m_element_size) == 0)
+                return offset;
+        }
+        return size;
+    }
+
+    Process &m_process;
+    lldb::addr_t m_next_addr;
+    size_t m_bytes_left;
+    const size_t m_element_size;
+    const size_t m_line_size;
+    size_t m_chunk_size;
+    size_t m_max_chunk_size;
+    std::vector<uint8_t> m_chunk;
+    bool m_found_terminator;
+};
+
+//----------------------------------------------------------------------
+// The streaming counterpart of DumpUTFBufferToStream: converts source
+// data to UTF8 and prints it as it is handed in, holding back surrogate
+// pairs and UTF8 sequences that a chunk boundary cut in two.
+//----------------------------------------------------------------------
+template<typename SourceDataType>
+class UTFStreamDumper
+{
+public:
+    typedef ConversionResult (*ConvertFunctionType) (const SourceDataType**,
+                                                     const SourceDataType*,
+                                                     UTF8**,
+                                                     UTF8*,
+                                                     ConversionFlags);
+
+    UTFStreamDumper (ConvertFunctionType convert_function,
+                     const StringPrinter::ReadBufferAndDumpToStreamOptions& dump_options) :
+        m_convert_function (convert_function),
+        m_options (dump_options),
+        m_stream (*dump_options.GetStream()),
+        m_escaping_callback (),
+        m_pending (),
+        m_utf8 (),
+        m_done (false)
+    {
+        if (dump_options.GetEscapeNonPrintables())
+        {
+            if (Language *language = Language::FindPlugin(dump_options.GetLanguage()))
+                m_escaping_callback = language->GetStringPrinterEscapingHelper(StringPrinter::GetPrintableElementType::UTF8);
+            else
+                m_escaping_callback = StringPrinter::GetDefaultEscapingHelper(StringPrinter::GetPrintableElementType::UTF8);
+        }
+    }
+
+    void
+    Begin ()
+    {
+        if (m_options.GetPrefixToken() != 0)
+            m_stream.Printf("%s", m_options.GetPrefixToken());
+        if (m_options.GetQuote() != 0)
+            m_stream.Printf("%c", m_options.GetQuote());
+    }
+
+    // Returns false once the string was terminated.
+    bool
+    Dump (const uint8_t *bytes, size_t length)
+    {
+        if (m_done)
+            return false;
+
+        m_pending.insert(m_pending.end(), bytes, bytes + length);
+        const SourceDataType *source = reinterpret_cast<const SourceDataType *>(m_pending.data());
+        const SourceDataType *source_end = source + m_pending.size() / sizeof(SourceDataType);
+        if (m_options.GetBinaryZeroIsTerminator())
+        {
+            const SourceDataType *zero = std::find(source, source_end, 0);
+            if (zero != source_end)
+            {
+                source_end = zero;
+                m_done = true;
+            }
+        }
+
+        const size_t consumed = DumpSource(source, source_end, !m_done);
+        if (m_done)
+            m_pending.clear();
+        else
+            m_pending.erase(m_pending.begin(), m_pending.begin() + consumed * sizeof(SourceDataType));
+        return !m_done;
+    }
+
+    void
+    End ()
+    {
+        if (!m_pending.empty())
+        {
+            const SourceDataType *source = reinterpret_cast<const SourceDataType *>(m_pending.data());
+            DumpSource(source, source + m_pending.size() / sizeof(SourceDataType), false);
+            m_pending.clear();
+        }
+        if (m_options.GetQuote() != 0)
+            m_stream.Printf("%c", m_options.GetQuote());
+        if (m_options.GetSuffixToken() != 0)
+            m_stream.Printf("%s", m_options.GetSuffixToken());
+        if (m_options.GetIsTruncated())
+            m_stream.Printf("...");
+    }
+
+private:
+    // Returns how many source elements were printed.
+    size_t
+    DumpSource (const SourceDataType *source, const SourceDataType *source_end, bool hold_back_partial)
+    {
+        size_t consumed = source_end - source;
+        UTF8 *utf8 = nullptr;
+        UTF8 *utf8_end = nullptr;
+        if (m_convert_function)
+        {
+            m_utf8.resize(4 * consumed);
+            const SourceDataType *source_pos = source;
+            utf8 = utf8_end = m_utf8.data();
+            m_convert_function(&source_pos, source_end, &utf8_end, utf8 + m_utf8.size(), lenientConversion);
+            if (hold_back_partial)
+                consumed = source_pos - source;
+        }
+        else
+        {
+            // This only happens for UTF8 data, see DumpUTFBufferToStream.
+            utf8 = const_cast<UTF8 *>(reinterpret_cast<const UTF8 *>(source));
+            utf8_end = const_cast<UTF8 *>(reinterpret_cast<const UTF8 *>(source_end));
+            if (hold_back_partial)
+            {
+                utf8_end = FindIncompleteUTF8Tail(utf8, utf8_end);
+                consumed = utf8_end - utf8;
+            }
+        }
+
+        if (!m_escaping_callback)
+        {
+            m_stream.Write(utf8, utf8_end - utf8);
+            return consumed;
+        }
+
+        for (uint8_t *data = utf8; data < utf8_end;)
+        {
+            uint8_t *next_data = nullptr;
+            auto printable = m_escaping_callback(data, utf8_end, next_data);
+            auto printable_bytes = printable.GetBytes();
+            auto printable_size = printable.GetSize();
+            if (!printable_bytes || !next_data)
+            {
+                // GetPrintable() failed on us - print one byte in a desperate resync attempt
+                printable_bytes = data;
+                printable_size = 1;
+                next_data = data+1;
+            }
+            m_stream.Write(printable_bytes, printable_size);
+            data = next_data;
+        }
+        return consumed;
+    }
+
+    static UTF8 *
+    FindIncompleteUTF8Tail (UTF8 *begin, UTF8 *end)
+    {
+        // A sequence is at most 4 bytes, so its lead byte is in the last 3.
+        for (UTF8 *pos = end; pos > begin && end - pos < 4;)
+        {
+            --pos;
+            if ((*pos & 0xC0) != 0x80)
+                return (getNumBytesForUTF8(*pos) > static_cast<unsigned>(end - pos)) ? pos : end;
+        }
+        return end;
+    }
+
+    ConvertFunctionType m_convert_function;
+    const StringPrinter::ReadBufferAndDumpToStreamOptions& m_options;
+    Stream &m_stream;
+    StringPrinter::EscapingHelper m_escaping_callback;
+    std::vector<uint8_t> m_pending;
+    std::vector<UTF8> m_utf8;
+    bool m_done;
+};
+
+} // anonymous namespace
+
 namespace lldb_private
 {
 
@@ -440,11 +743,10 @@ StringPrinter::ReadStringAndDumpToStream<StringPrinter::StringElementType::ASCII
     else
         size = options.GetSourceSize();
 
-    lldb::DataBufferSP buffer_sp(new DataBufferHeap(size,0));
-
-    process_sp->ReadCStringFromMemory(options.GetLocation(), (char*)buffer_sp->GetBytes(), size, my_error);
+    // Leave room for the terminator like ReadCStringFromMemory did.
+    StringChunkReader reader(*process_sp, options.GetLocation(), size > 0 ? size - 1 : 0, 1);
 
-    if (my_error.Fail())
+    if (!reader.ReadNextChunk(true, my_error) && my_error.Fail())
         return false;
 
     const char* prefix_token = options.GetPrefixToken();
@@ -455,8 +757,6 @@ StringPrinter::ReadStringAndDumpToStream<StringPrinter::StringElementType::ASCII
     else if (quote != 0)
         options.GetStream()->Printf("%c",quote);
 
-    uint8_t* data_end = buffer_sp->GetBytes()+buffer_sp->GetByteSize();
-
     const bool escape_non_printables = options.GetEscapeNonPrintables();
     lldb_private::formatters::StringPrinter::EscapingHelper escaping_callback;
     if (escape_non_printables)
@@ -467,12 +767,18 @@ StringPrinter::ReadStringAndDumpToStream<StringPrinter::StringElementType::ASCII
             escaping_callback = lldb_private::formatters::StringPrinter::GetDefaultEscapingHelper(lldb_private::formatters::StringPrinter::GetPrintableElementType::ASCII);
     }
     
-    // since we tend to accept partial data (and even partially malformed data)
-    // we might end up with no NULL terminator before the end_ptr
-    // hence we need to take a slower route and ensure we stay within boundaries
-    for (uint8_t* data = buffer_sp->GetBytes(); *data && (data < data_end);)
+    // Print each chunk as it comes in, the reader already cut the last one
+    // at the terminator.
+    do
     {
-        if (escape_non_printables)
+        uint8_t* data = reader.GetBytes();
+        uint8_t* data_end = data + reader.GetByteSize();
+        if (!escape_non_printables)
+        {
+            options.GetStream()->Write(data, data_end - data);
+            continue;
+        }
+        while (data < data_end)
         {
             uint8_t* next_data = nullptr;
             auto printable = escaping_callback(data, data_end, next_data);
@@ -485,16 +791,10 @@ StringPrinter::ReadStringAndDumpToStream<StringPrinter::StringElementType::ASCII
                 printable_size = 1;
                 next_data = data+1;
             }
-            for (unsigned c = 0; c < printable_size; c++)
-                options.GetStream()->Printf("%c", *(printable_bytes+c));
+            options.GetStream()->Write(printable_bytes, printable_size);
             data = (uint8_t*)next_data;
         }
-        else
-        {
-            options.GetStream()->Printf("%c",*data);
-            data++;
-        }
-    }
+    } while (reader.ReadNextChunk(true, my_error));
     
     const char* suffix_token = options.GetSuffixToken();
     
@@ -559,35 +859,30 @@ ReadUTFBufferAndDumpToStream (const StringPrinter::ReadStringAndDumpToStreamOpti
         }
     }
 
-    const int bufferSPSize = sourceSize * type_width;
+    const size_t bufferSize = sourceSize * type_width;
 
-    lldb::DataBufferSP buffer_sp(new DataBufferHeap(bufferSPSize,0));
-
-    if (!buffer_sp->GetBytes())
-        return false;
+    // Read and print the string a chunk at a time instead of reading it
+    // all into one buffer first.
+    StringChunkReader reader(*process_sp, options.GetLocation(), bufferSize, type_width);
 
     Error error;
-    char *buffer = reinterpret_cast<char *>(buffer_sp->GetBytes());
-
-    if (needs_zero_terminator)
-        process_sp->ReadStringFromMemory(options.GetLocation(), buffer, bufferSPSize, error, type_width);
-    else
-        process_sp->ReadMemoryFromInferior(options.GetLocation(), (char*)buffer_sp->GetBytes(), bufferSPSize, error);
-
-    if (error.Fail())
+    if (!reader.ReadNextChunk(needs_zero_terminator, error) && error.Fail())
     {
         options.GetStream()->Printf("unable to read data");
         return true;
     }
 
-    DataExtractor data(buffer_sp, process_sp->GetByteOrder(), process_sp->GetAddressByteSize());
-    
     StringPrinter::ReadBufferAndDumpToStreamOptions dump_options(options);
-    dump_options.SetData(data);
     dump_options.SetSourceSize(sourceSize);
     dump_options.SetIsTruncated(is_truncated);
 
-    return DumpUTFBufferToStream(ConvertFunction, dump_options);
+    UTFStreamDumper<SourceDataType> dumper(ConvertFunction, dump_options);
+    dumper.Begin();
+    while (dumper.Dump(reader.GetBytes(), reader.GetByteSize()) &&
+           reader.ReadNextChunk(needs_zero_terminator, error))
+        ;
+    dumper.End();
+    return true;
 }
 
 template <>
@@ -13,6 +13,7 @@
 #include <inttypes.h>
 
 // C++ Includes
+#include <algorithm>
 #include <vector>
 
 #include "lldb/Core/DataEncoder.h"
@@ -60,7 +61,8 @@ DWARFExpression::DWARFExpression(DWARFCompileUnit* dwarf_cu) :
     m_data(),
     m_dwarf_cu(dwarf_cu),
     m_reg_kind (eRegisterKindDWARF),
-    m_loclist_slide (LLDB_INVALID_ADDRESS)
+    m_loclist_slide (LLDB_INVALID_ADDRESS),
+    m_compiled_sp ()
 {
 }
 
@@ -69,10 +71,26 @@ DWARFExpression::DWARFExpression(const DWARFExpression& rhs) :
     m_data(rhs.m_data),
     m_dwarf_cu(rhs.m_dwarf_cu),
     m_reg_kind (rhs.m_reg_kind),
-    m_loclist_slide(rhs.m_loclist_slide)
+    m_loclist_slide(rhs.m_loclist_slide),
+    m_compiled_sp ()
 {
 }
 
+const DWARFExpression&
+DWARFExpression::operator= (const DWARFExpression& rhs)
+{
+    if (this != &rhs)
+    {
+        m_module_wp = rhs.m_module_wp;
+        m_data = rhs.m_data;
+        m_dwarf_cu = rhs.m_dwarf_cu;
+        m_reg_kind = rhs.m_reg_kind;
+        m_loclist_slide = rhs.m_loclist_slide;
+        InvalidateCompiledExpression();
+    }
+    return *this;
+}
+
 
 DWARFExpression::DWARFExpression(lldb::ModuleSP module_sp,
                                  const DataExtractor& data,
@@ -83,7 +101,8 @@ DWARFExpression::DWARFExpression(lldb::ModuleSP module_sp,
     m_data(data, data_offset, data_length),
     m_dwarf_cu(dwarf_cu),
     m_reg_kind (eRegisterKindDWARF),
-    m_loclist_slide(LLDB_INVALID_ADDRESS)
+    m_loclist_slide(LLDB_INVALID_ADDRESS),
+    m_compiled_sp ()
 {
     if (module_sp)
         m_module_wp = module_sp;
@@ -107,6 +126,7 @@ void
 DWARFExpression::SetOpcodeData (const DataExtractor& data)
 {
     m_data = data;
+    InvalidateCompiledExpression();
 }
 
 void
@@ -119,6 +139,7 @@ DWARFExpression::CopyOpcodeData (lldb::ModuleSP module_sp, const DataExtractor&
         m_data.SetData(DataBufferSP(new DataBufferHeap(bytes, data_length)));
         m_data.SetByteOrder(data.GetByteOrder());
         m_data.SetAddressByteSize(data.GetAddressByteSize());
+        InvalidateCompiledExpression();
     }
 }
 
@@ -133,6 +154,7 @@ DWARFExpression::CopyOpcodeData (const void *data,
         m_data.SetData(DataBufferSP(new DataBufferHeap(data, data_length)));
         m_data.SetByteOrder(byte_order);
         m_data.SetAddressByteSize(addr_byte_size);
+        InvalidateCompiledExpression();
     }
 }
 
@@ -146,6 +168,7 @@ DWARFExpression::CopyOpcodeData (uint64_t const_value,
         m_data.SetData(DataBufferSP(new DataBufferHeap(&const_value, const_value_byte_size)));
         m_data.SetByteOrder(endian::InlHostByteOrder());
         m_data.SetAddressByteSize(addr_byte_size);
+        InvalidateCompiledExpression();
     }
 }
 
@@ -154,6 +177,7 @@ DWARFExpression::SetOpcodeData (lldb::ModuleSP module_sp, const DataExtractor& d
 {
     m_module_wp = module_sp;
     m_data.SetData(data, data_offset, data_length);
+    InvalidateCompiledExpression();
 }
 
 void
@@ -527,6 +551,7 @@ void
 DWARFExpression::SetLocationListSlide (addr_t slide)
 {
     m_loclist_slide = slide;
+    InvalidateCompiledExpression();
 }
 
 int
@@ -989,6 +1014,7 @@ DWARFExpression::Update_DW_OP_addr (lldb::addr_t file_addr)
             // pointer to the heap data so "m_data" will now correctly 
             // manage the heap data.
             m_data.SetData (DataBufferSP (head_data_ap.release()));
+            InvalidateCompiledExpression();
             return true;
         }
         else
@@ -1120,6 +1146,7 @@ DWARFExpression::LinkThreadLocalStorage(
     // is evaluated it can resolve the file address to a load address and read the TLS data
     m_module_wp = new_module_sp;
     m_data.SetData(heap_data_sp);
+    InvalidateCompiledExpression();
     return true;
 }
 
@@ -1261,10 +1288,10 @@ DWARFExpression::Evaluate
 ) const
 {
     ModuleSP module_sp = m_module_wp.lock();
+    CompiledExpressionSP compiled_sp = GetCompiledExpression();
 
     if (IsLocationList())
     {
-        lldb::offset_t offset = 0;
         addr_t pc;
         StackFrame *frame = NULL;
         if (reg_ctx)
@@ -1289,50 +1316,261 @@ DWARFExpression::Evaluate
                 return false;
             }
 
-            addr_t curr_loclist_base_load_addr = loclist_base_load_addr;
+            // The entries are relative to the base address, slid back.
+            const addr_t pc_file_addr = pc - (loclist_base_load_addr - m_loclist_slide);
+            const CompiledLocation *location = FindLocationForAddress(*compiled_sp, pc_file_addr);
+            if (location)
+                return EvaluateLocation (*location,
+                                         exe_ctx,
+                                         expr_locals,
+                                         decl_map,
+                                         reg_ctx,
+                                         module_sp,
+                                         initial_value_ptr,
+                                         object_address_ptr,
+                                         result,
+                                         error_ptr);
+        }
+        if (error_ptr)
+            error_ptr->SetErrorString ("variable not available");
+        return false;
+    }
+
+    // Not a location list, just a single expression.
+    return EvaluateLocation (compiled_sp->locations.front(),
+                             exe_ctx,
+                             expr_locals,
+                             decl_map,
+                             reg_ctx,
+                             module_sp,
+                             initial_value_ptr,
+                             object_address_ptr,
+                             result,
+                             error_ptr);
+}
+
+DWARFExpression::CompiledExpressionSP
+DWARFExpression::GetCompiledExpression () const
+{
+    // There is one of these per variable, so rather than paying for a
+    // mutex in each, the decoded form is published atomically.  Threads
+    // racing here may each decode it, the first one to publish wins.
+    CompiledExpressionSP published_sp = std::atomic_load (&m_compiled_sp);
+    if (published_sp)
+        return published_sp;
+
+    CompiledExpressionSP compiled_sp (new CompiledExpression());
+    std::vector<CompiledLocation> &locations = compiled_sp->locations;
+    if (IsLocationList())
+    {
+        // Same walk as GetLocation() and LocationListContainsAddress(),
+        // done once.
+        lldb::offset_t offset = 0;
+        while (m_data.ValidOffset(offset))
+        {
+            addr_t lo_pc = LLDB_INVALID_ADDRESS;
+            addr_t hi_pc = LLDB_INVALID_ADDRESS;
+            if (!AddressRangeForLocationListEntry(m_dwarf_cu, m_data, &offset, lo_pc, hi_pc))
+                break;
+
+            if (lo_pc == 0 && hi_pc == 0)
+                break;
 
-            while (m_data.ValidOffset(offset))
+            const uint16_t length = m_data.GetU16(&offset);
+            if (length > 0 && lo_pc < hi_pc)
             {
-                // We need to figure out what the value is for the location.
-                addr_t lo_pc = LLDB_INVALID_ADDRESS;
-                addr_t hi_pc = LLDB_INVALID_ADDRESS;
-                if (!AddressRangeForLocationListEntry(m_dwarf_cu, m_data, &offset, lo_pc, hi_pc))
-                    break;
+                CompiledLocation location;
+                location.lo_pc = lo_pc;
+                location.hi_pc = hi_pc;
+                location.offset = offset;
+                location.length = length;
+                ClassifyLocation(m_data, location);
+                locations.push_back(location);
+            }
+            offset += length;
+        }
 
-                if (lo_pc == 0 && hi_pc == 0)
-                    break;
+        compiled_sp->sorted = true;
+        for (size_t i = 1; i < locations.size(); ++i)
+        {
+            if (locations[i].lo_pc < locations[i - 1].hi_pc)
+            {
+                compiled_sp->sorted = false;
+                break;
+            }
+        }
+    }
+    else
+    {
+        CompiledLocation location;
+        location.lo_pc = 0;
+        location.hi_pc = LLDB_INVALID_ADDRESS;
+        location.offset = 0;
+        location.length = m_data.GetByteSize();
+        ClassifyLocation(m_data, location);
+        locations.push_back(location);
+    }
 
-                lo_pc += curr_loclist_base_load_addr - m_loclist_slide;
-                hi_pc += curr_loclist_base_load_addr - m_loclist_slide;
+    if (!std::atomic_compare_exchange_strong (&m_compiled_sp, &published_sp, compiled_sp))
+        return published_sp;
+    return compiled_sp;
+}
 
-                uint16_t length = m_data.GetU16(&offset);
+void
+DWARFExpression::InvalidateCompiledExpression ()
+{
+    std::atomic_store (&m_compiled_sp, CompiledExpressionSP());
+}
 
-                if (length > 0 && lo_pc <= pc && pc < hi_pc)
-                {
-                    return DWARFExpression::Evaluate (exe_ctx,
-                                                      expr_locals,
-                                                      decl_map,
-                                                      reg_ctx,
-                                                      module_sp,
-                                                      m_data,
-                                                      m_dwarf_cu,
-                                                      offset,
-                                                      length,
-                                                      m_reg_kind,
-                                                      initial_value_ptr,
-                                                      object_address_ptr,
-                                                      result,
-                                                      error_ptr);
-                }
-                offset += length;
+void
+DWARFExpression::ClassifyLocation (const DataExtractor& opcodes, CompiledLocation &location)
+{
+    location.kind = CompiledLocation::eKindGeneric;
+    location.reg_num = LLDB_INVALID_REGNUM;
+    location.reg_offset = 0;
+
+    if (location.length == 0 || !opcodes.ValidOffsetForDataOfSize(location.offset, location.length))
+        return;
+
+    lldb::offset_t offset = location.offset;
+    const lldb::offset_t end_offset = location.offset + location.length;
+    CompiledLocation::Kind kind = CompiledLocation::eKindGeneric;
+    uint32_t reg_num = LLDB_INVALID_REGNUM;
+    int64_t reg_offset = 0;
+
+    const uint8_t op = opcodes.GetU8(&offset);
+    if (op >= DW_OP_reg0 && op <= DW_OP_reg31)
+    {
+        kind = CompiledLocation::eKindRegister;
+        reg_num = op - DW_OP_reg0;
+    }
+    else if (op == DW_OP_regx)
+    {
+        kind = CompiledLocation::eKindRegister;
+        reg_num = opcodes.GetULEB128(&offset);
+    }
+    else if (op >= DW_OP_breg0 && op <= DW_OP_breg31)
+    {
+        kind = CompiledLocation::eKindRegisterOffset;
+        reg_num = op - DW_OP_breg0;
+        reg_offset = opcodes.GetSLEB128(&offset);
+    }
+    else if (op == DW_OP_bregx)
+    {
+        kind = CompiledLocation::eKindRegisterOffset;
+        reg_num = opcodes.GetULEB128(&offset);
+        reg_offset = opcodes.GetSLEB128(&offset);
+    }
+    else if (op == DW_OP_fbreg)
+    {
+        kind = CompiledLocation::eKindFrameBaseOffset;
+        reg_offset = opcodes.GetSLEB128(&offset);
+    }
+
+    // Only a lone opcode can skip the interpreter.
+    if (offset != end_offset)
+        return;
+
+    location.kind = kind;
+    location.reg_num = reg_num;
+    location.reg_offset = reg_offset;
+}
+
+const DWARFExpression::CompiledLocation *
+DWARFExpression::FindLocationForAddress (CompiledExpression &compiled, addr_t file_addr)
+{
+    const std::vector<CompiledLocation> &locations = compiled.locations;
+    if (!compiled.sorted)
+    {
+        // Overlapping entries, the first one that matches wins.
+        for (const CompiledLocation &location : locations)
+        {
+            if (location.lo_pc <= file_addr && file_addr < location.hi_pc)
+                return &location;
+        }
+        return nullptr;
+    }
+
+    // Variables are usually looked at again and again at the same PC.
+    const uint32_t last_index = compiled.last_index.load(std::memory_order_relaxed);
+    if (last_index < locations.size() &&
+        locations[last_index].lo_pc <= file_addr && file_addr < locations[last_index].hi_pc)
+        return &locations[last_index];
+
+    auto pos = std::upper_bound(locations.begin(),
+                                locations.end(),
+                                file_addr,
+                                [](addr_t addr, const CompiledLocation &location) { return addr < location.lo_pc; });
+    if (pos == locations.begin())
+        return nullptr;
+    --pos;
+    if (file_addr >= pos->hi_pc)
+        return nullptr;
+    compiled.last_index.store(pos - locations.begin(), std::memory_order_relaxed);
+    return &*pos;
+}
+
+bool
+DWARFExpression::EvaluateLocation (const CompiledLocation &location,
+                                   ExecutionContext *exe_ctx,
+                                   ClangExpressionVariableList *expr_locals,
+                                   ClangExpressionDeclMap *decl_map,
+                                   RegisterContext *reg_ctx,
+                                   const lldb::ModuleSP &module_sp,
+                                   const Value* initial_value_ptr,
+                                   const Value* object_address_ptr,
+                                   Value& result,
+                                   Error *error_ptr) const
+{
+    Log *log(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_EXPRESSIONS));
+
+    // These do what the interpreter does for the same lone opcode, without
+    // decoding anything.  An initial value or a verbose log needs the
+    // interpreter.
+    if (location.kind != CompiledLocation::eKindGeneric &&
+        initial_value_ptr == nullptr &&
+        !(log && log->GetVerbose()))
+    {
+        StackFrame *frame = exe_ctx ? exe_ctx->GetFramePtr() : nullptr;
+        if (location.kind == CompiledLocation::eKindFrameBaseOffset)
+        {
+            if (!exe_ctx)
+            {
+                if (error_ptr)
+                    error_ptr->SetErrorStringWithFormat ("NULL execution context for DW_OP_fbreg.\n");
+                return false;
+            }
+            if (!frame)
+            {
+                if (error_ptr)
+                    error_ptr->SetErrorString ("Invalid stack frame in context for DW_OP_fbreg opcode.");
+                return false;
             }
+            Scalar value;
+            if (!frame->GetFrameBaseValue(value, error_ptr))
+                return false;
+            value += location.reg_offset;
+            result = Value(value);
+            result.SetValueType (Value::eValueTypeLoadAddress);
+            return true;
         }
-        if (error_ptr)
-            error_ptr->SetErrorString ("variable not available");
-        return false;
+
+        if (reg_ctx == NULL && frame)
+            reg_ctx = frame->GetRegisterContext().get();
+
+        Value tmp;
+        if (!ReadRegisterValueAsScalar (reg_ctx, m_reg_kind, location.reg_num, error_ptr, tmp))
+            return false;
+        if (location.kind == CompiledLocation::eKindRegisterOffset)
+        {
+            tmp.ResolveValue(exe_ctx) += (uint64_t)location.reg_offset;
+            tmp.ClearContext();
+            tmp.SetValueType (Value::eValueTypeLoadAddress);
+        }
+        result = tmp;
+        return true;
     }
 
-    // Not a location list, just a single expression.
     return DWARFExpression::Evaluate (exe_ctx,
                                       expr_locals,
                                       decl_map,
@@ -1340,8 +1578,8 @@ DWARFExpression::Evaluate
                                       module_sp,
                                       m_data,
                                       m_dwarf_cu,
-                                      0,
-                                      m_data.GetByteSize(),
+                                      location.offset,
+                                      location.length,
                                       m_reg_kind,
                                       initial_value_ptr,
                                       object_address_ptr,
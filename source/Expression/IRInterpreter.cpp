@@ -21,12 +21,16 @@
 #include "lldb/Expression/IRExecutionUnit.h"
 #include "lldb/Expression/IRMemoryMap.h"
 #include "lldb/Host/Endian.h"
+#include "lldb/Symbol/ClangASTContext.h"
+#include "lldb/Symbol/CompilerType.h"
 
 #include "lldb/Target/ABI.h"
 #include "lldb/Target/ExecutionContext.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/ThreadPlan.h"
+#include "lldb/Target/ThreadPlanCallFunction.h"
 #include "lldb/Target/ThreadPlanCallFunctionUsingABI.h"
 
 #include "llvm/IR/Constants.h"
@@ -37,9 +41,13 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Operator.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <cmath>
 #include <map>
+#include <string.h>
+#include <vector>
 
 using namespace llvm;
 
@@ -106,6 +114,7 @@ public:
     DataLayout                             &m_target_data;
     lldb_private::IRExecutionUnit          &m_execution_unit;
     const BasicBlock                       *m_bb;
+    const BasicBlock                       *m_prev_bb;  // The block m_bb was entered from, for PHI nodes
     BasicBlock::const_iterator              m_ii;
     BasicBlock::const_iterator              m_ie;
 
@@ -121,7 +130,9 @@ public:
                            lldb::addr_t stack_frame_bottom,
                            lldb::addr_t stack_frame_top) :
         m_target_data (target_data),
-        m_execution_unit (execution_unit)
+        m_execution_unit (execution_unit),
+        m_bb (nullptr),
+        m_prev_bb (nullptr)
     {
         m_byte_order = (target_data.isLittleEndian() ? lldb::eByteOrderLittle : lldb::eByteOrderBig);
         m_addr_byte_size = (target_data.getPointerSize(0));
@@ -137,6 +148,7 @@ public:
 
     void Jump (const BasicBlock *bb)
     {
+        m_prev_bb = m_bb;
         m_bb = bb;
         m_ii = m_bb->begin();
         m_ie = m_bb->end();
@@ -222,6 +234,62 @@ public:
         return false;
     }
 
+    // Floating point values are kept as their bit patterns, like any other
+    // value; only float and double are handled.
+    bool EvaluateFloatValue (double &result, const Value *value, Module &module)
+    {
+        lldb_private::Scalar bits;
+
+        if (!EvaluateValue(bits, value, module))
+            return false;
+
+        Type *type = value->getType();
+
+        if (type->isFloatTy())
+        {
+            const uint32_t u32 = bits.UInt();
+            float f;
+            memcpy(&f, &u32, sizeof(f));
+            result = f;
+            return true;
+        }
+
+        if (type->isDoubleTy())
+        {
+            const uint64_t u64 = bits.ULongLong();
+            memcpy(&result, &u64, sizeof(result));
+            return true;
+        }
+
+        return false;
+    }
+
+    bool AssignFloatValue (const Value *value, double d, Module &module)
+    {
+        Type *type = value->getType();
+        lldb_private::Scalar bits;
+
+        if (type->isFloatTy())
+        {
+            const float f = d;
+            uint32_t u32;
+            memcpy(&u32, &f, sizeof(u32));
+            bits = u32;
+        }
+        else if (type->isDoubleTy())
+        {
+            uint64_t u64;
+            memcpy(&u64, &d, sizeof(u64));
+            bits = u64;
+        }
+        else
+        {
+            return false;
+        }
+
+        return AssignValue(value, bits, module);
+    }
+
     bool AssignValue (const Value *value, lldb_private::Scalar &scalar, Module &module)
     {
         lldb::addr_t process_address = ResolveValue (value, module);
@@ -517,11 +585,278 @@ CanResolveConstant (llvm::Constant *constant)
     }
 }
 
+static void
+SetUnsupportedError (lldb_private::Error &error, const char *reason, const Value *value)
+{
+    error.SetErrorToGenericError();
+    error.SetErrorStringWithFormat("%s: %s", reason, PrintValue(value).c_str());
+}
+
+// The values the interpreter can compute with, as opposed to just load and
+// store: integers up to 64 bits, pointers, floats and doubles.
+static bool
+IsScalarType (Type *type)
+{
+    if (type->isIntegerTy())
+        return type->getIntegerBitWidth() <= 64;
+    return type->isPointerTy() || type->isFloatTy() || type->isDoubleTy();
+}
+
+static bool
+IsFloatOrDoubleType (Type *type)
+{
+    return type->isFloatTy() || type->isDoubleTy();
+}
+
+static FunctionType *
+GetCalledFunctionType (const CallInst *call_inst)
+{
+    PointerType *pointer_type = dyn_cast<PointerType>(call_inst->getCalledValue()->getType());
+    if (!pointer_type)
+        return nullptr;
+    return dyn_cast<FunctionType>(pointer_type->getElementType());
+}
+
+// The ABIs' PrepareTrivialCall handle at least this many integer or
+// pointer arguments, all passed in registers.
+static const unsigned max_trivial_call_arguments = 6;
+
+// Look through the address arithmetic and casts between a pointer and the
+// value it was computed from.
+static const Value *
+StripAddressArithmetic (const Value *value)
+{
+    while (true)
+    {
+        if (const GEPOperator *gep = dyn_cast<GEPOperator>(value))
+            value = gep->getPointerOperand();
+        else if (Operator::getOpcode(value) == Instruction::BitCast)
+            value = cast<Operator>(value)->getOperand(0);
+        else
+            return value;
+    }
+}
+
+// The interpreter keeps the argument struct, the expression's locals and
+// any persistent variables it creates in memory that may only exist in the
+// debugger, so an address taken of any of those can't be handed to a
+// function in the process.  Only accept pointers that can't be one of
+// those: constant addresses, pointers a called function returned, and
+// pointers read out of a variable (as opposed to the variable's address).
+static bool
+IsPointerIntoProcess (const Value *pointer)
+{
+    const Value *base = StripAddressArithmetic(pointer);
+
+    if (isa<Function>(base))
+        return true;
+
+    if (isa<Constant>(base))
+        return !isa<GlobalValue>(base);
+
+    if (isa<CallInst>(base))
+        return true;
+
+    if (const LoadInst *load_inst = dyn_cast<LoadInst>(base))
+    {
+        // A variable's address is itself loaded from the argument struct,
+        // so a pointer stored in a variable is a load from a load.
+        const Value *load_base = StripAddressArithmetic(load_inst->getPointerOperand());
+        return isa<LoadInst>(load_base) || (isa<Constant>(load_base) && !isa<GlobalValue>(load_base));
+    }
+
+    return false;
+}
+
+static bool
+CanCallTrivially (const CallInst *call_inst, lldb_private::Error &error)
+{
+    if (call_inst->isInlineAsm())
+    {
+        SetUnsupportedError(error, "Interpreter can't run inline assembly", call_inst);
+        return false;
+    }
+
+    FunctionType *function_type = GetCalledFunctionType(call_inst);
+
+    if (!function_type || function_type->isVarArg())
+    {
+        SetUnsupportedError(error, "Interpreter can only call functions with a fixed prototype", call_inst);
+        return false;
+    }
+
+    Type *return_type = call_inst->getType();
+
+    if (!return_type->isVoidTy() && !return_type->isPointerTy() &&
+        !(return_type->isIntegerTy() && return_type->getIntegerBitWidth() <= 64))
+    {
+        SetUnsupportedError(error, "Interpreter can't call a function with this return type", call_inst);
+        return false;
+    }
+
+    if (call_inst->getNumArgOperands() > max_trivial_call_arguments)
+    {
+        SetUnsupportedError(error, "Interpreter can't call a function with this many arguments", call_inst);
+        return false;
+    }
+
+    for (unsigned i = 0, e = call_inst->getNumArgOperands(); i != e; ++i)
+    {
+        Type *arg_type = call_inst->getArgOperand(i)->getType();
+
+        if (!arg_type->isPointerTy() &&
+            !(arg_type->isIntegerTy() && arg_type->getIntegerBitWidth() <= 64))
+        {
+            SetUnsupportedError(error, "Interpreter can only pass integer and pointer arguments", call_inst);
+            return false;
+        }
+
+        if (arg_type->isPointerTy() && !IsPointerIntoProcess(call_inst->getArgOperand(i)))
+        {
+            SetUnsupportedError(error, "Interpreter can't pass a pointer that may be to memory only the debugger has", call_inst);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Call a function whose arguments and return value fit in registers, the
+// way Process::RunThreadPlan calls any other function, without needing the
+// ABI to understand the IR prototype.
+static bool
+InterpretTrivialCall (const CallInst *call_inst,
+                      const lldb_private::Address &function_address,
+                      InterpreterStackFrame &frame,
+                      Module &module,
+                      lldb_private::IRExecutionUnit &execution_unit,
+                      lldb_private::ExecutionContext &exe_ctx,
+                      const lldb_private::EvaluateExpressionOptions &options,
+                      lldb_private::Error &error)
+{
+    lldb_private::Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
+
+    std::vector<lldb::addr_t> args;
+
+    for (unsigned i = 0, e = call_inst->getNumArgOperands(); i != e; ++i)
+    {
+        const Value *arg_op = call_inst->getArgOperand(i);
+        Type *arg_type = arg_op->getType();
+        lldb_private::Scalar arg;
+
+        if (!frame.EvaluateValue(arg, arg_op, module))
+        {
+            error.SetErrorToGenericError();
+            error.SetErrorStringWithFormat("unable to evaluate argument %u", i);
+            return false;
+        }
+
+        const uint64_t arg_value = arg.ULongLong();
+
+        if (arg_type->isPointerTy())
+        {
+            // CanCallTrivially only lets through pointers that shouldn't be
+            // into memory the interpreter allocated, make sure.
+            size_t alloc_size = 1;
+            if (execution_unit.GetAllocSize(arg_value, alloc_size))
+            {
+                error.SetErrorToGenericError();
+                error.SetErrorStringWithFormat("argument %u points to memory that isn't in the process", i);
+                return false;
+            }
+            args.push_back(arg_value);
+        }
+        else if (call_inst->paramHasAttr(i + 1, Attribute::SExt))
+        {
+            args.push_back(SignExtend64(arg_value, arg_type->getIntegerBitWidth()));
+        }
+        else
+        {
+            args.push_back(arg_value);
+        }
+    }
+
+    Type *return_type = call_inst->getType();
+    lldb_private::CompilerType return_compiler_type;
+
+    if (!return_type->isVoidTy())
+    {
+        lldb_private::ClangASTContext *ast_context = exe_ctx.GetTargetRef().GetScratchClangASTContext();
+
+        if (ast_context)
+        {
+            if (return_type->isPointerTy())
+                return_compiler_type = ast_context->GetBasicType(lldb::eBasicTypeVoid).GetPointerType();
+            else
+                return_compiler_type = ast_context->GetBuiltinTypeForEncodingAndBitSize(lldb::eEncodingUint,
+                                                                                        frame.m_target_data.getTypeStoreSizeInBits(return_type));
+        }
+
+        if (!return_compiler_type.IsValid())
+        {
+            error.SetErrorToGenericError();
+            error.SetErrorString("unable to make a type for the return value");
+            return false;
+        }
+    }
+
+    lldb_private::DiagnosticManager diagnostics;
+
+    lldb::ThreadPlanSP call_plan_sp(new lldb_private::ThreadPlanCallFunction(exe_ctx.GetThreadRef(),
+                                                                             function_address,
+                                                                             return_compiler_type,
+                                                                             args,
+                                                                             options));
+
+    lldb_private::StreamString ss;
+    if (!call_plan_sp->ValidatePlan(&ss))
+    {
+        error.SetErrorToGenericError();
+        error.SetErrorStringWithFormat("unable to make ThreadPlanCallFunction for 0x%" PRIx64 ": %s",
+                                       function_address.GetOffset(),
+                                       ss.GetData());
+        return false;
+    }
+
+    if (log)
+        log->Printf("Calling 0x%" PRIx64 " with %" PRIu64 " arguments", function_address.GetOffset(), (uint64_t)args.size());
+
+    exe_ctx.GetProcessPtr()->SetRunningUserExpression(true);
+
+    lldb::ExpressionResults res =
+        exe_ctx.GetProcessRef().RunThreadPlan(exe_ctx, call_plan_sp, options, diagnostics);
+
+    exe_ctx.GetProcessPtr()->SetRunningUserExpression(false);
+
+    if (res != lldb::eExpressionCompleted)
+    {
+        error.SetErrorToGenericError();
+        error.SetErrorStringWithFormat("ThreadPlanCallFunction failed: %s", diagnostics.GetString().c_str());
+        return false;
+    }
+
+    if (return_type->isVoidTy())
+        return true;
+
+    lldb::ValueObjectSP return_valobj_sp = call_plan_sp->GetReturnValueObject();
+    lldb_private::Scalar return_value;
+
+    if (!return_valobj_sp || !return_valobj_sp->ResolveValue(return_value))
+    {
+        error.SetErrorToGenericError();
+        error.SetErrorString("unable to get the return value");
+        return false;
+    }
+
+    return frame.AssignValue(call_inst, return_value, module);
+}
+
 bool
 IRInterpreter::CanInterpret (llvm::Module &module,
                              llvm::Function &function,
                              lldb_private::Error &error,
-                             const bool support_function_calls)
+                             const bool support_function_calls,
+                             const bool support_trivial_function_calls)
 {
     lldb_private::Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
 
@@ -534,7 +869,13 @@ IRInterpreter::CanInterpret (llvm::Module &module,
         if (fi->begin() != fi->end())
         {
             if (saw_function_with_body)
+            {
+                if (log)
+                    log->Printf("Unsupported module: more than one function has a body");
+                error.SetErrorToGenericError();
+                error.SetErrorString("Interpreter can't call functions defined in the expression");
                 return false;
+            }
             saw_function_with_body = true;
         }
     }
@@ -553,8 +894,7 @@ IRInterpreter::CanInterpret (llvm::Module &module,
                 {
                     if (log)
                         log->Printf("Unsupported instruction: %s", PrintValue(&*ii).c_str());
-                    error.SetErrorToGenericError();
-                    error.SetErrorString(unsupported_opcode_error);
+                    SetUnsupportedError(error, unsupported_opcode_error, &*ii);
                     return false;
                 }
             case Instruction::Add:
@@ -575,11 +915,20 @@ IRInterpreter::CanInterpret (llvm::Module &module,
 
                     if (!CanIgnoreCall(call_inst) && !support_function_calls)
                     {
-                        if (log)
-                            log->Printf("Unsupported instruction: %s", PrintValue(&*ii).c_str());
-                        error.SetErrorToGenericError();
-                        error.SetErrorString(unsupported_opcode_error);
-                        return false;
+                        if (!support_trivial_function_calls)
+                        {
+                            if (log)
+                                log->Printf("Unsupported instruction: %s", PrintValue(&*ii).c_str());
+                            SetUnsupportedError(error, "Interpreter can't call functions in this process", &*ii);
+                            return false;
+                        }
+
+                        if (!CanCallTrivially(call_inst, error))
+                        {
+                            if (log)
+                                log->Printf("Unsupported call: %s", PrintValue(&*ii).c_str());
+                            return false;
+                        }
                     }
                 }
                 break;
@@ -603,8 +952,7 @@ IRInterpreter::CanInterpret (llvm::Module &module,
                         if (log)
                             log->Printf("Unsupported ICmp predicate: %s", PrintValue(&*ii).c_str());
 
-                        error.SetErrorToGenericError();
-                        error.SetErrorString(unsupported_opcode_error);
+                        SetUnsupportedError(error, unsupported_opcode_error, &*ii);
                         return false;
                     }
                     case CmpInst::ICMP_EQ:
@@ -642,6 +990,85 @@ IRInterpreter::CanInterpret (llvm::Module &module,
             case Instruction::Xor:
             case Instruction::ZExt:
                 break;
+            case Instruction::FAdd:
+            case Instruction::FSub:
+            case Instruction::FMul:
+            case Instruction::FDiv:
+            case Instruction::FRem:
+            case Instruction::FCmp:
+            case Instruction::FPExt:
+            case Instruction::FPTrunc:
+            case Instruction::FPToSI:
+            case Instruction::FPToUI:
+            case Instruction::SIToFP:
+            case Instruction::UIToFP:
+                {
+                    // Operands and results are either float/double or
+                    // integers, never long double or half.
+                    bool supported = IsScalarType(ii->getType()) && !ii->getType()->isPointerTy();
+                    for (unsigned oi = 0, oe = ii->getNumOperands(); supported && oi != oe; ++oi)
+                    {
+                        Type *operand_type = ii->getOperand(oi)->getType();
+                        supported = IsScalarType(operand_type) && !operand_type->isPointerTy();
+                    }
+
+                    if (ii->getOpcode() == Instruction::FCmp)
+                        supported = supported && IsFloatOrDoubleType(ii->getOperand(0)->getType());
+
+                    if (!supported)
+                    {
+                        if (log)
+                            log->Printf("Unsupported floating point type: %s", PrintValue(&*ii).c_str());
+                        SetUnsupportedError(error, unsupported_operand_error, &*ii);
+                        return false;
+                    }
+                }
+                break;
+            case Instruction::Select:
+                {
+                    if (!IsScalarType(ii->getType()))
+                    {
+                        if (log)
+                            log->Printf("Unsupported Select type: %s", PrintValue(&*ii).c_str());
+                        SetUnsupportedError(error, unsupported_operand_error, &*ii);
+                        return false;
+                    }
+                }
+                break;
+            case Instruction::PHI:
+                {
+                    PHINode *phi_node = dyn_cast<PHINode>(ii);
+
+                    if (!phi_node)
+                    {
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(interpreter_internal_error);
+                        return false;
+                    }
+
+                    if (!IsScalarType(phi_node->getType()))
+                    {
+                        if (log)
+                            log->Printf("Unsupported PHI type: %s", PrintValue(&*ii).c_str());
+                        SetUnsupportedError(error, unsupported_operand_error, &*ii);
+                        return false;
+                    }
+
+                    // PHI nodes are interpreted one at a time, so they can't
+                    // depend on each other the way a block's PHIs may.
+                    for (unsigned vi = 0, ve = phi_node->getNumIncomingValues(); vi != ve; ++vi)
+                    {
+                        PHINode *incoming_phi = dyn_cast<PHINode>(phi_node->getIncomingValue(vi));
+                        if (incoming_phi && incoming_phi->getParent() == phi_node->getParent())
+                        {
+                            if (log)
+                                log->Printf("Unsupported PHI cycle: %s", PrintValue(&*ii).c_str());
+                            SetUnsupportedError(error, unsupported_opcode_error, &*ii);
+                            return false;
+                        }
+                    }
+                }
+                break;
             }
 
             for (int oi = 0, oe = ii->getNumOperands();
@@ -659,7 +1086,7 @@ IRInterpreter::CanInterpret (llvm::Module &module,
                     {
                         if (log)
                             log->Printf("Unsupported operand type: %s", PrintType(operand_type).c_str());
-                        error.SetErrorString(unsupported_operand_error);
+                        SetUnsupportedError(error, "Interpreter doesn't handle vector operands", &*ii);
                         return false;
                     }
                 }
@@ -670,7 +1097,7 @@ IRInterpreter::CanInterpret (llvm::Module &module,
                     {
                         if (log)
                             log->Printf("Unsupported constant: %s", PrintValue(constant).c_str());
-                        error.SetErrorString(unsupported_operand_error);
+                        SetUnsupportedError(error, unsupported_operand_error, constant);
                         return false;
                     }
                 }
@@ -689,7 +1116,8 @@ IRInterpreter::Interpret (llvm::Module &module,
                           lldb_private::Error &error,
                           lldb::addr_t stack_frame_bottom,
                           lldb::addr_t stack_frame_top,
-                          lldb_private::ExecutionContext &exe_ctx)
+                          lldb_private::ExecutionContext &exe_ctx,
+                          const lldb_private::EvaluateExpressionOptions &options)
 {
     lldb_private::Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
 
@@ -1004,6 +1432,363 @@ IRInterpreter::Interpret (llvm::Module &module,
                 frame.AssignValue(inst, S_signextend, module);
             }
                 break;
+            case Instruction::FAdd:
+            case Instruction::FSub:
+            case Instruction::FMul:
+            case Instruction::FDiv:
+            case Instruction::FRem:
+            {
+                Value *lhs = inst->getOperand(0);
+                Value *rhs = inst->getOperand(1);
+
+                double L;
+                double R;
+
+                if (!frame.EvaluateFloatValue(L, lhs, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(lhs).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                if (!frame.EvaluateFloatValue(R, rhs, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(rhs).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                // Float operands are exact in a double, and rounding the
+                // double result back to float gives the float result.
+                double result = 0;
+
+                switch (inst->getOpcode())
+                {
+                    default:
+                        break;
+                    case Instruction::FAdd:
+                        result = L + R;
+                        break;
+                    case Instruction::FSub:
+                        result = L - R;
+                        break;
+                    case Instruction::FMul:
+                        result = L * R;
+                        break;
+                    case Instruction::FDiv:
+                        result = L / R;
+                        break;
+                    case Instruction::FRem:
+                        result = fmod(L, R);
+                        break;
+                }
+
+                if (!frame.AssignFloatValue(inst, result, module))
+                {
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                if (log)
+                {
+                    log->Printf("Interpreted a %s", inst->getOpcodeName());
+                    log->Printf("  L : %s", frame.SummarizeValue(lhs).c_str());
+                    log->Printf("  R : %s", frame.SummarizeValue(rhs).c_str());
+                    log->Printf("  = : %s", frame.SummarizeValue(inst).c_str());
+                }
+            }
+                break;
+            case Instruction::FCmp:
+            {
+                const FCmpInst *fcmp_inst = dyn_cast<FCmpInst>(inst);
+
+                if (!fcmp_inst)
+                {
+                    if (log)
+                        log->Printf("getOpcode() returns FCmp, but instruction is not an FCmpInst");
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(interpreter_internal_error);
+                    return false;
+                }
+
+                Value *lhs = inst->getOperand(0);
+                Value *rhs = inst->getOperand(1);
+
+                double L;
+                double R;
+
+                if (!frame.EvaluateFloatValue(L, lhs, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(lhs).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                if (!frame.EvaluateFloatValue(R, rhs, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(rhs).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                const bool unordered = std::isnan(L) || std::isnan(R);
+                bool result = false;
+
+                switch (fcmp_inst->getPredicate())
+                {
+                    default:
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(unsupported_opcode_error);
+                        return false;
+                    case CmpInst::FCMP_FALSE:
+                        result = false;
+                        break;
+                    case CmpInst::FCMP_OEQ:
+                        result = !unordered && L == R;
+                        break;
+                    case CmpInst::FCMP_OGT:
+                        result = !unordered && L > R;
+                        break;
+                    case CmpInst::FCMP_OGE:
+                        result = !unordered && L >= R;
+                        break;
+                    case CmpInst::FCMP_OLT:
+                        result = !unordered && L < R;
+                        break;
+                    case CmpInst::FCMP_OLE:
+                        result = !unordered && L <= R;
+                        break;
+                    case CmpInst::FCMP_ONE:
+                        result = !unordered && L != R;
+                        break;
+                    case CmpInst::FCMP_ORD:
+                        result = !unordered;
+                        break;
+                    case CmpInst::FCMP_UNO:
+                        result = unordered;
+                        break;
+                    case CmpInst::FCMP_UEQ:
+                        result = unordered || L == R;
+                        break;
+                    case CmpInst::FCMP_UGT:
+                        result = unordered || L > R;
+                        break;
+                    case CmpInst::FCMP_UGE:
+                        result = unordered || L >= R;
+                        break;
+                    case CmpInst::FCMP_ULT:
+                        result = unordered || L < R;
+                        break;
+                    case CmpInst::FCMP_ULE:
+                        result = unordered || L <= R;
+                        break;
+                    case CmpInst::FCMP_UNE:
+                        result = unordered || L != R;
+                        break;
+                    case CmpInst::FCMP_TRUE:
+                        result = true;
+                        break;
+                }
+
+                lldb_private::Scalar S(result ? 1 : 0);
+
+                frame.AssignValue(inst, S, module);
+
+                if (log)
+                {
+                    log->Printf("Interpreted an FCmpInst");
+                    log->Printf("  L : %s", frame.SummarizeValue(lhs).c_str());
+                    log->Printf("  R : %s", frame.SummarizeValue(rhs).c_str());
+                    log->Printf("  = : %s", frame.SummarizeValue(inst).c_str());
+                }
+            }
+                break;
+            case Instruction::FPExt:
+            case Instruction::FPTrunc:
+            {
+                Value *source = inst->getOperand(0);
+
+                double D;
+
+                if (!frame.EvaluateFloatValue(D, source, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(source).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                frame.AssignFloatValue(inst, D, module);
+            }
+                break;
+            case Instruction::SIToFP:
+            case Instruction::UIToFP:
+            {
+                Value *source = inst->getOperand(0);
+
+                lldb_private::Scalar S;
+
+                if (!frame.EvaluateValue(S, source, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(source).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                // Convert straight to the destination type, going through
+                // double could round twice.
+                const bool to_float = inst->getType()->isFloatTy();
+                double D;
+
+                if (inst->getOpcode() == Instruction::SIToFP)
+                {
+                    const int64_t i64 = SignExtend64(S.ULongLong(), source->getType()->getIntegerBitWidth());
+                    D = to_float ? (double)(float)i64 : (double)i64;
+                }
+                else
+                {
+                    const uint64_t u64 = S.ULongLong();
+                    D = to_float ? (double)(float)u64 : (double)u64;
+                }
+
+                frame.AssignFloatValue(inst, D, module);
+            }
+                break;
+            case Instruction::FPToSI:
+            case Instruction::FPToUI:
+            {
+                Value *source = inst->getOperand(0);
+
+                double D;
+
+                if (!frame.EvaluateFloatValue(D, source, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(source).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                // Out of range conversions are undefined in IR; don't make
+                // them undefined here too.
+                lldb_private::Scalar S;
+
+                if (inst->getOpcode() == Instruction::FPToSI)
+                    S = (D >= -9223372036854775808.0 && D < 9223372036854775808.0) ? (int64_t)D : (int64_t)0;
+                else
+                    S = (D > -1.0 && D < 18446744073709551616.0) ? (uint64_t)D : (uint64_t)0;
+
+                frame.AssignValue(inst, S, module);
+            }
+                break;
+            case Instruction::Select:
+            {
+                const SelectInst *select_inst = dyn_cast<SelectInst>(inst);
+
+                if (!select_inst)
+                {
+                    if (log)
+                        log->Printf("getOpcode() returns Select, but instruction is not a SelectInst");
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(interpreter_internal_error);
+                    return false;
+                }
+
+                const Value *condition = select_inst->getCondition();
+
+                lldb_private::Scalar C;
+
+                if (!frame.EvaluateValue(C, condition, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(condition).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                const Value *chosen = (C.ULongLong() & 1) ? select_inst->getTrueValue() : select_inst->getFalseValue();
+
+                lldb_private::Scalar S;
+
+                if (!frame.EvaluateValue(S, chosen, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(chosen).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                frame.AssignValue(inst, S, module);
+
+                if (log)
+                {
+                    log->Printf("Interpreted a SelectInst");
+                    log->Printf("  C : %s", frame.SummarizeValue(condition).c_str());
+                    log->Printf("  = : %s", frame.SummarizeValue(inst).c_str());
+                }
+            }
+                break;
+            case Instruction::PHI:
+            {
+                const PHINode *phi_node = dyn_cast<PHINode>(inst);
+
+                if (!phi_node)
+                {
+                    if (log)
+                        log->Printf("getOpcode() returns PHI, but instruction is not a PHINode");
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(interpreter_internal_error);
+                    return false;
+                }
+
+                const int incoming_index = frame.m_prev_bb ? phi_node->getBasicBlockIndex(frame.m_prev_bb) : -1;
+
+                if (incoming_index < 0)
+                {
+                    if (log)
+                        log->Printf("PHINode has no value for the block it was reached from");
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                const Value *incoming = phi_node->getIncomingValue(incoming_index);
+
+                lldb_private::Scalar S;
+
+                if (!frame.EvaluateValue(S, incoming, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(incoming).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                frame.AssignValue(inst, S, module);
+
+                if (log)
+                {
+                    log->Printf("Interpreted a PHINode");
+                    log->Printf("  = : %s", frame.SummarizeValue(inst).c_str());
+                }
+            }
+                break;
             case Instruction::Br:
             {
                 const BranchInst *br_inst = dyn_cast<BranchInst>(inst);
@@ -1608,7 +2393,6 @@ IRInterpreter::Interpret (llvm::Module &module,
                 lldb_private::Address funcAddr(I.ULongLong(LLDB_INVALID_ADDRESS));
 
                 lldb_private::DiagnosticManager diagnostics;
-                lldb_private::EvaluateExpressionOptions options;
 
                 // We generally receive a function pointer which we must dereference
                 llvm::Type* prototype = val->getType();
@@ -1628,6 +2412,21 @@ IRInterpreter::Interpret (llvm::Module &module,
                     return false;
                 }
 
+                // Without an ABI that understands the IR prototype, only the
+                // calls CanCallTrivially accepted get this far.
+                if (!exe_ctx.GetProcessRef().CanInterpretFunctionCalls())
+                {
+                    if (!InterpretTrivialCall(call_inst, funcAddr, frame, module, execution_unit, exe_ctx, options, error))
+                        return false;
+
+                    if (log)
+                    {
+                        log->Printf("Interpreted a CallInst");
+                        log->Printf("  = : %s", frame.SummarizeValue(inst).c_str());
+                    }
+                    break;
+                }
+
                 // Find number of arguments
                 const int numArgs = call_inst->getNumArgOperands();
 
@@ -29,6 +29,7 @@
 #include "lldb/Expression/IRInterpreter.h"
 #include "lldb/Expression/Materializer.h"
 #include "lldb/Expression/UserExpression.h"
+#include "lldb/Expression/UserExpressionCache.h"
 #include "lldb/Host/HostInfo.h"
 #include "lldb/Symbol/Block.h"
 #include "lldb/Symbol/Function.h"
@@ -239,21 +240,46 @@ UserExpression::Evaluate (ExecutionContext &exe_ctx,
             language = frame->GetLanguage();
     }
 
-    lldb::UserExpressionSP user_expression_sp(target->GetUserExpressionForLanguage (expr_cstr,
-                                                                                    full_prefix,
-                                                                                    language,
-                                                                                    desired_type,
-                                                                                    options,
-                                                                                    error));
-    if (error.Fail())
+    // Top level code can change what names in other expressions refer to.
+    if (execution_policy == eExecutionPolicyTopLevel)
+        target->GetUserExpressionCache().Clear("top level expression");
+
+    UserExpressionCache::Key cache_key;
+    const bool use_expression_cache = target->GetEnableExpressionCache() &&
+                                      UserExpressionCache::MakeKey(exe_ctx,
+                                                                   expr_cstr,
+                                                                   full_prefix,
+                                                                   language,
+                                                                   desired_type,
+                                                                   execution_policy,
+                                                                   options,
+                                                                   cache_key);
+
+    lldb::UserExpressionSP user_expression_sp;
+    if (use_expression_cache)
+        user_expression_sp = target->GetUserExpressionCache().Take(cache_key, exe_ctx);
+
+    const bool reuse_parsed_expression = (bool)user_expression_sp;
+    if (!reuse_parsed_expression)
     {
-        if (log)
-            log->Printf ("== [UserExpression::Evaluate] Getting expression: %s ==", error.AsCString());
-        return lldb::eExpressionSetupError;
+        user_expression_sp.reset(target->GetUserExpressionForLanguage (expr_cstr,
+                                                                       full_prefix,
+                                                                       language,
+                                                                       desired_type,
+                                                                       options,
+                                                                       error));
+        if (error.Fail())
+        {
+            if (log)
+                log->Printf ("== [UserExpression::Evaluate] Getting expression: %s ==", error.AsCString());
+            return lldb::eExpressionSetupError;
+        }
     }
 
     if (log)
-        log->Printf("== [UserExpression::Evaluate] Parsing expression %s ==", expr_cstr);
+        log->Printf("== [UserExpression::Evaluate] %s expression %s ==",
+                    reuse_parsed_expression ? "Reusing parsed" : "Parsing",
+                    expr_cstr);
 
     const bool keep_expression_in_memory = true;
     const bool generate_debug_info = options.GetGenerateDebugInfo();
@@ -267,7 +293,8 @@ UserExpression::Evaluate (ExecutionContext &exe_ctx,
 
     DiagnosticManager diagnostic_manager;
 
-    bool parse_success = user_expression_sp->Parse(diagnostic_manager,
+    bool parse_success = reuse_parsed_expression ||
+                         user_expression_sp->Parse(diagnostic_manager,
                                                    exe_ctx,
                                                    execution_policy,
                                                    keep_expression_in_memory,
@@ -397,6 +424,15 @@ UserExpression::Evaluate (ExecutionContext &exe_ctx,
 
                     error.SetError(UserExpression::kNoResult, lldb::eErrorTypeGeneric);
                 }
+
+                // Only keep expressions that parsed as typed and ran to
+                // completion; generic Swift code binds its type parameters
+                // from the frame, which can differ on the next call.
+                if (use_expression_cache &&
+                    fixed_expression->empty() &&
+                    user_expression_sp->GetSwiftGenericInfo().function_bindings.empty() &&
+                    user_expression_sp->GetSwiftGenericInfo().class_bindings.empty())
+                    target->GetUserExpressionCache().Insert(cache_key, user_expression_sp);
             }
         }
     }
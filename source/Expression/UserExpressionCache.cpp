@@ -0,0 +1,250 @@
+//===-- UserExpressionCache.cpp ---------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+// C++ Includes
+#include <string.h>
+#include <tuple>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Expression/UserExpressionCache.h"
+#include "lldb/Core/Log.h"
+#include "lldb/Core/StreamString.h"
+#include "lldb/Expression/UserExpression.h"
+#include "lldb/Target/ExecutionContext.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/StackFrame.h"
+#include "lldb/Target/Target.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+bool
+UserExpressionCache::Key::operator < (const Key &rhs) const
+{
+    // The cheap, most selective fields go first.
+    return std::tie(frame_pc, process_id, language, option_language, desired_type, execution_policy,
+                    coerce_to_id, auto_apply_fixits, repl, playground, generate_debug_info, use_dynamic,
+                    pound_line_line, expr_text, expr_prefix, option_prefix, pound_line_file) <
+           std::tie(rhs.frame_pc, rhs.process_id, rhs.language, rhs.option_language, rhs.desired_type, rhs.execution_policy,
+                    rhs.coerce_to_id, rhs.auto_apply_fixits, rhs.repl, rhs.playground, rhs.generate_debug_info, rhs.use_dynamic,
+                    rhs.pound_line_line, rhs.expr_text, rhs.expr_prefix, rhs.option_prefix, rhs.pound_line_file);
+}
+
+UserExpressionCache::UserExpressionCache () :
+    m_mutex (Mutex::eMutexTypeRecursive),
+    m_expressions (),
+    m_recency (),
+    m_hits (0),
+    m_misses (0),
+    m_inserts (0),
+    m_invalidations (0)
+{
+}
+
+UserExpressionCache::~UserExpressionCache ()
+{
+}
+
+bool
+UserExpressionCache::MakeKey (ExecutionContext &exe_ctx,
+                              const char *expr_cstr,
+                              const char *expr_prefix,
+                              lldb::LanguageType language,
+                              Expression::ResultType desired_type,
+                              ExecutionPolicy execution_policy,
+                              const EvaluateExpressionOptions &options,
+                              Key &key)
+{
+    if (expr_cstr == nullptr || expr_cstr[0] == '\0')
+        return false;
+
+    // Top level code adds declarations that later expressions can see, and
+    // the REPL and playgrounds keep their declarations too, so none of those
+    // can be replayed.
+    if (execution_policy == eExecutionPolicyTopLevel ||
+        options.GetREPLEnabled() ||
+        options.GetPlaygroundTransformEnabled())
+        return false;
+
+    // Expressions with debug info or #line remapping get a module named
+    // after their expression number, so each one needs its own parse.
+    if (options.GetGenerateDebugInfo() || options.GetPoundLineFilePath())
+        return false;
+
+    // Expressions that mention '$' names may declare or depend on
+    // persistent variables and types, which the parse binds once.
+    if (strchr(expr_cstr, '$') != nullptr)
+        return false;
+
+    Process *process = exe_ctx.GetProcessPtr();
+    Target *target = exe_ctx.GetTargetPtr();
+    if (process == nullptr || target == nullptr)
+        return false;
+
+    key.expr_text.assign(expr_cstr);
+    if (expr_prefix)
+        key.expr_prefix.assign(expr_prefix);
+    else
+        key.expr_prefix.clear();
+    const char *option_prefix = options.GetPrefix();
+    if (option_prefix)
+        key.option_prefix.assign(option_prefix);
+    else
+        key.option_prefix.clear();
+    key.language = language;
+    key.option_language = options.GetLanguage();
+    key.desired_type = desired_type;
+    key.execution_policy = execution_policy;
+    key.coerce_to_id = options.DoesCoerceToId();
+    key.auto_apply_fixits = options.GetAutoApplyFixIts();
+    key.repl = options.GetREPLEnabled();
+    key.playground = options.GetPlaygroundTransformEnabled();
+    key.generate_debug_info = options.GetGenerateDebugInfo();
+    key.use_dynamic = options.GetUseDynamic();
+    const char *pound_line_file = options.GetPoundLineFilePath();
+    if (pound_line_file)
+        key.pound_line_file.assign(pound_line_file);
+    else
+        key.pound_line_file.clear();
+    key.pound_line_line = options.GetPoundLineLine();
+    key.process_id = process->GetUniqueID();
+    key.frame_pc = LLDB_INVALID_ADDRESS;
+    if (StackFrame *frame = exe_ctx.GetFramePtr())
+        key.frame_pc = frame->GetFrameCodeAddress().GetLoadAddress(target);
+    return true;
+}
+
+lldb::UserExpressionSP
+UserExpressionCache::Take (const Key &key, ExecutionContext &exe_ctx)
+{
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
+
+    lldb::UserExpressionSP expr_sp;
+    Mutex::Locker locker (m_mutex);
+    collection::iterator pos = m_expressions.find(key);
+    if (pos != m_expressions.end())
+    {
+        expr_sp = pos->second.expr_sp;
+        m_recency.erase(pos->second.recency_pos);
+        m_expressions.erase(pos);
+        // The key already pins the frame address, but the expression also
+        // remembers the process it was JIT'ed into.
+        if (expr_sp && !expr_sp->MatchesContext(exe_ctx))
+            expr_sp.reset();
+    }
+
+    if (expr_sp)
+        ++m_hits;
+    else
+        ++m_misses;
+
+    if (log)
+        log->Printf("UserExpressionCache::%s() %s for \"%s\" at 0x%" PRIx64 " (%" PRIu64 " hits, %" PRIu64 " misses)",
+                    __FUNCTION__,
+                    expr_sp ? "hit" : "miss",
+                    key.expr_text.c_str(),
+                    key.frame_pc,
+                    m_hits,
+                    m_misses);
+    return expr_sp;
+}
+
+void
+UserExpressionCache::Insert (const Key &key, const lldb::UserExpressionSP &expr_sp)
+{
+    if (!expr_sp)
+        return;
+
+    // Destroy the evicted expression outside the lock, freeing its JIT
+    // memory can talk to the process.
+    lldb::UserExpressionSP evicted_sp;
+    {
+        Mutex::Locker locker (m_mutex);
+        collection::iterator pos = m_expressions.find(key);
+        if (pos != m_expressions.end())
+        {
+            evicted_sp = pos->second.expr_sp;
+            m_recency.erase(pos->second.recency_pos);
+            m_expressions.erase(pos);
+        }
+        else if (m_expressions.size() >= kMaxEntries)
+        {
+            Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
+            if (log)
+                log->Printf("UserExpressionCache::%s() evicting \"%s\" at 0x%" PRIx64,
+                            __FUNCTION__,
+                            m_recency.back().expr_text.c_str(),
+                            m_recency.back().frame_pc);
+
+            collection::iterator oldest_pos = m_expressions.find(m_recency.back());
+            evicted_sp = oldest_pos->second.expr_sp;
+            m_expressions.erase(oldest_pos);
+            m_recency.pop_back();
+        }
+
+        m_recency.push_front(key);
+        Entry &entry = m_expressions[key];
+        entry.expr_sp = expr_sp;
+        entry.recency_pos = m_recency.begin();
+        ++m_inserts;
+    }
+}
+
+void
+UserExpressionCache::Clear (const char *reason)
+{
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
+
+    // Destroy the expressions outside the lock, freeing their JIT memory
+    // can talk to the process.
+    collection expressions;
+    recency_list recency;
+    {
+        Mutex::Locker locker (m_mutex);
+        if (m_expressions.empty())
+            return;
+
+        ++m_invalidations;
+        if (log)
+        {
+            StreamString strm;
+            Dump(strm);
+            log->Printf("UserExpressionCache::%s(%s) dropping %" PRIu64 " expressions: %s",
+                        __FUNCTION__,
+                        reason ? reason : "",
+                        (uint64_t)m_expressions.size(),
+                        strm.GetData());
+        }
+        expressions.swap(m_expressions);
+        recency.swap(m_recency);
+    }
+}
+
+size_t
+UserExpressionCache::GetSize () const
+{
+    Mutex::Locker locker (m_mutex);
+    return m_expressions.size();
+}
+
+void
+UserExpressionCache::Dump (Stream &s) const
+{
+    Mutex::Locker locker (m_mutex);
+    const uint64_t lookups = m_hits + m_misses;
+    s.Printf("%" PRIu64 " entries, %" PRIu64 " hits, %" PRIu64 " misses (%.1f%% hit rate), %" PRIu64 " inserts, %" PRIu64 " invalidations",
+             (uint64_t)m_expressions.size(),
+             m_hits,
+             m_misses,
+             lookups ? (100.0 * m_hits) / lookups : 0.0,
+             m_inserts,
+             m_invalidations);
+}
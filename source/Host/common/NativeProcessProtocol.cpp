@@ -41,7 +41,8 @@ NativeProcessProtocol::NativeProcessProtocol (lldb::pid_t pid) :
     m_breakpoint_list (),
     m_watchpoint_list (),
     m_terminal_fd (-1),
-    m_stop_id (0)
+    m_stop_id (0),
+    m_non_stop_mode (false)
 {
 }
 
@@ -64,6 +65,13 @@ NativeProcessProtocol::GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegion
     return Error ("not implemented");
 }
 
+Error
+NativeProcessProtocol::GetMemoryRegions (std::vector<MemoryRegionInfo> &regions, uint32_t &generation)
+{
+    // Default: not implemented.
+    return Error ("not implemented");
+}
+
 bool
 NativeProcessProtocol::GetExitStatus (ExitType *exit_type, int *status, std::string &exit_description)
 {
@@ -141,6 +149,12 @@ NativeProcessProtocol::GetThreadByID (lldb::tid_t tid)
     return GetThreadByIDUnlocked (tid);
 }
 
+Error
+NativeProcessProtocol::SaveCore (const std::string &core_path, bool skip_file_backed)
+{
+    return Error ("saving core files is not supported for this process");
+}
+
 bool
 NativeProcessProtocol::IsAlive () const
 {
@@ -360,6 +374,28 @@ NativeProcessProtocol::NotifyDidExec ()
     }
 }
 
+void
+NativeProcessProtocol::NotifyThreadStopped (lldb::tid_t tid)
+{
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+    if (log)
+        log->Printf ("NativeProcessProtocol::%s - pid %" PRIu64 " tid %" PRIu64, __FUNCTION__, GetID (), tid);
+
+    Mutex::Locker locker (m_delegates_mutex);
+    for (auto native_delegate: m_delegates)
+        native_delegate->ThreadStopped (this, tid);
+}
+
+Error
+NativeProcessProtocol::SetNonStopMode (bool enable)
+{
+    // Processes that don't override this only know how to stop the world.
+    if (enable)
+        return Error ("non-stop mode is not supported by this process");
+    m_non_stop_mode = false;
+    return Error ();
+}
+
 
 Error
 NativeProcessProtocol::SetSoftwareBreakpoint (lldb::addr_t addr, uint32_t size_hint)
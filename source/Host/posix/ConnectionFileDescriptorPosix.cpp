@@ -24,6 +24,9 @@
 // C Includes
 #include <errno.h>
 #include <fcntl.h>
+#if defined(__linux__)
+#include <poll.h>
+#endif
 #include <string.h>
 #include <stdlib.h>
 #include <sys/types.h>
@@ -575,7 +578,8 @@ ConnectionFileDescriptor::GetURI()
     return m_uri;
 }
 
-// This ConnectionFileDescriptor::BytesAvailable() uses select().
+// This ConnectionFileDescriptor::BytesAvailable() uses select(), except on
+// Linux where it uses poll().
 //
 // PROS:
 //  - select is consistent across most unix platforms
@@ -588,6 +592,8 @@ ConnectionFileDescriptor::GetURI()
 //     users know that another ConnectionFileDescriptor::BytesAvailable() should
 //     be used or a new version of ConnectionFileDescriptor::BytesAvailable()
 //     should be written for the system that is running into the limitations.
+//     Linux, where lldb-server in platform mode can have thousands of
+//     connections open, avoids the limit by using poll() instead.
 
 #if defined(__APPLE__)
 #define FD_SET_DATA(fds) fds.data()
@@ -636,16 +642,27 @@ ConnectionFileDescriptor::BytesAvailable(uint32_t timeout_usec, Error *error_ptr
         const bool have_pipe_fd = false;
 #else
         const bool have_pipe_fd = pipe_fd >= 0;
-#if !defined(__APPLE__)
+#if !defined(__APPLE__) && !defined(__linux__)
         assert(handle < FD_SETSIZE);
         if (have_pipe_fd)
             assert(pipe_fd < FD_SETSIZE);
 #endif
+#endif
+#if defined(__linux__)
+        const int timeout_msec = tv_ptr ? (int)((timeout_usec + 999) / 1000) : -1;
 #endif
         while (handle == m_read_sp->GetWaitableHandle())
         {
             const int nfds = std::max<int>(handle, pipe_fd) + 1;
-#if defined(__APPLE__)
+#if defined(__linux__)
+            struct pollfd poll_fds[2];
+            poll_fds[0].fd = handle;
+            poll_fds[0].events = POLLIN;
+            poll_fds[0].revents = 0;
+            poll_fds[1].fd = pipe_fd;
+            poll_fds[1].events = POLLIN;
+            poll_fds[1].revents = 0;
+#elif defined(__APPLE__)
             llvm::SmallVector<fd_set, 1> read_fds;
             read_fds.resize((nfds / FD_SETSIZE) + 1);
             for (size_t i = 0; i < read_fds.size(); ++i)
@@ -657,9 +674,11 @@ ConnectionFileDescriptor::BytesAvailable(uint32_t timeout_usec, Error *error_ptr
             fd_set read_fds;
             FD_ZERO(&read_fds);
 #endif
+#if !defined(__linux__)
             FD_SET(handle, FD_SET_DATA(read_fds));
             if (have_pipe_fd)
                 FD_SET(pipe_fd, FD_SET_DATA(read_fds));
+#endif
 
             Error error;
 
@@ -674,7 +693,15 @@ ConnectionFileDescriptor::BytesAvailable(uint32_t timeout_usec, Error *error_ptr
                                 static_cast<void *>(this), nfds, handle, static_cast<void *>(tv_ptr));
             }
 
+#if defined(__linux__)
+            const int num_set_fds = ::poll(poll_fds, have_pipe_fd ? 2 : 1, timeout_msec);
+            const bool handle_ready = poll_fds[0].revents != 0;
+            const bool pipe_ready = have_pipe_fd && poll_fds[1].revents != 0;
+#else
             const int num_set_fds = ::select(nfds, FD_SET_DATA(read_fds), NULL, NULL, tv_ptr);
+            const bool handle_ready = num_set_fds > 0 && FD_ISSET(handle, FD_SET_DATA(read_fds));
+            const bool pipe_ready = num_set_fds > 0 && have_pipe_fd && FD_ISSET(pipe_fd, FD_SET_DATA(read_fds));
+#endif
             if (num_set_fds < 0)
                 error.SetErrorToErrno();
             else
@@ -722,9 +749,14 @@ ConnectionFileDescriptor::BytesAvailable(uint32_t timeout_usec, Error *error_ptr
             }
             else if (num_set_fds > 0)
             {
-                if (FD_ISSET(handle, FD_SET_DATA(read_fds)))
+#if defined(__linux__)
+                // poll() reports closed descriptors instead of failing with EBADF.
+                if (poll_fds[0].revents & POLLNVAL)
+                    return eConnectionStatusLostConnection;
+#endif
+                if (handle_ready)
                     return eConnectionStatusSuccess;
-                if (have_pipe_fd && FD_ISSET(pipe_fd, FD_SET_DATA(read_fds)))
+                if (pipe_ready)
                 {
                     // There is an interrupt or exit command in the command pipe
                     // Read the data from that pipe:
@@ -9,8 +9,15 @@
 
 #include "lldb/Host/posix/MainLoopPosix.h"
 
+#include <algorithm>
 #include <vector>
 
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
+#endif
+
 #include "lldb/Core/Error.h"
 
 using namespace lldb;
@@ -25,11 +32,30 @@ SignalHandler(int signo, siginfo_t *info, void *)
     g_signal_flags[signo] = 1;
 }
 
+#if defined(__linux__)
+// The most events one epoll_wait call hands back, others are picked up on the next iteration.
+static const int kMaxEvents = 64;
+#endif
+
+MainLoopPosix::MainLoopPosix() :
+#if defined(__linux__)
+    m_epoll_fd(epoll_create1(EPOLL_CLOEXEC)),
+    m_signal_fd(-1),
+#endif
+    m_terminate_request(false)
+{
+}
 
 MainLoopPosix::~MainLoopPosix()
 {
     assert(m_read_fds.size() == 0);
     assert(m_signals.size() == 0);
+#if defined(__linux__)
+    if (m_signal_fd != -1)
+        close(m_signal_fd);
+    if (m_epoll_fd != -1)
+        close(m_epoll_fd);
+#endif
 }
 
 MainLoopPosix::ReadHandleUP
@@ -41,14 +67,37 @@ MainLoopPosix::RegisterReadObject(const IOObjectSP &object_sp, const Callback &c
         return nullptr;
     }
 
-    const bool inserted = m_read_fds.insert({object_sp->GetWaitableHandle(), callback}).second;
+    const IOObject::WaitableHandle handle = object_sp->GetWaitableHandle();
+    const bool inserted = m_read_fds.insert({handle, callback}).second;
     if (! inserted)
     {
-        error.SetErrorStringWithFormat("File descriptor %d already monitored.",
-                object_sp->GetWaitableHandle());
+        error.SetErrorStringWithFormat("File descriptor %d already monitored.", handle);
+        return nullptr;
+    }
+
+#if defined(__linux__)
+    if (m_epoll_fd == -1)
+    {
+        m_read_fds.erase(handle);
+        error.SetErrorString("epoll_create1 failed.");
         return nullptr;
     }
 
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = handle;
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, handle, &event) == -1)
+    {
+        if (errno != EPERM)
+        {
+            error.SetErrorToErrno();
+            m_read_fds.erase(handle);
+            return nullptr;
+        }
+        m_always_ready_fds.push_back(handle);
+    }
+#endif
+
     return CreateReadHandle(object_sp);
 }
 
@@ -90,6 +139,15 @@ MainLoopPosix::RegisterSignal(int signo, const Callback &callback, Error &error)
     m_signals.insert({signo, info});
     g_signal_flags[signo] = 0;
 
+#if defined(__linux__)
+    error = UpdateSignalFD();
+    if (error.Fail())
+    {
+        UnregisterSignal(signo);
+        return nullptr;
+    }
+#endif
+
     return SignalHandleUP(new SignalHandle(*this, signo));
 }
 
@@ -99,6 +157,20 @@ MainLoopPosix::UnregisterReadObject(IOObject::WaitableHandle handle)
     bool erased = m_read_fds.erase(handle);
     UNUSED_IF_ASSERT_DISABLED(erased);
     assert(erased);
+
+#if defined(__linux__)
+    auto pos = std::find(m_always_ready_fds.begin(), m_always_ready_fds.end(), handle);
+    if (pos != m_always_ready_fds.end())
+        m_always_ready_fds.erase(pos);
+    else
+    {
+        // This fails if the descriptor is already closed. The kernel only drops a closed
+        // descriptor from the epoll set once no duplicate of it keeps the file open, until then
+        // its events keep coming under the old number. That is why read objects need to be
+        // unregistered before they are closed.
+        epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, handle, nullptr);
+    }
+#endif
 }
 
 void
@@ -116,7 +188,129 @@ MainLoopPosix::UnregisterSignal(int signo)
     pthread_sigmask(it->second.was_blocked ? SIG_BLOCK : SIG_UNBLOCK, &set, nullptr);
 
     m_signals.erase(it);
+
+#if defined(__linux__)
+    if (m_signal_fd != -1)
+        UpdateSignalFD();
+#endif
+}
+
+#if defined(__linux__)
+Error
+MainLoopPosix::UpdateSignalFD()
+{
+    if (m_epoll_fd == -1)
+        return Error("epoll_create1 failed.");
+
+    sigset_t mask;
+    sigemptyset(&mask);
+    for (const auto &sig: m_signals)
+        sigaddset(&mask, sig.first);
+
+    const bool created = m_signal_fd == -1;
+    int fd = signalfd(m_signal_fd, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (fd == -1)
+        return Error(errno, eErrorTypePOSIX);
+    m_signal_fd = fd;
+
+    if (created)
+    {
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = m_signal_fd;
+        if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_signal_fd, &event) == -1)
+        {
+            Error error(errno, eErrorTypePOSIX);
+            close(m_signal_fd);
+            m_signal_fd = -1;
+            return error;
+        }
+    }
+    return Error();
+}
+
+void
+MainLoopPosix::ReadSignalFD()
+{
+    struct signalfd_siginfo info;
+    while (read(m_signal_fd, &info, sizeof(info)) == sizeof(info))
+    {
+        if (info.ssi_signo < NSIG)
+            g_signal_flags[info.ssi_signo] = 1;
+    }
+}
+
+// The signals stay blocked while we wait, they are queued to the signalfd instead of running
+// SignalHandler. The handler is still installed for signals that get delivered to other threads,
+// so both paths end up in g_signal_flags.
+Error
+MainLoopPosix::Run()
+{
+    std::vector<int> signals;
+    std::vector<int> read_fds;
+    struct epoll_event events[kMaxEvents];
+    m_terminate_request = false;
+
+    // run until termination or until we run out of things to listen to
+    while (! m_terminate_request && (!m_read_fds.empty() || !m_signals.empty()))
+    {
+        // Don't block if a regular file is registered, it is always readable.
+        const int timeout = m_always_ready_fds.empty() ? -1 : 0;
+        int num_events = epoll_wait(m_epoll_fd, events, kMaxEvents, timeout);
+        if (num_events == -1)
+        {
+            if (errno != EINTR)
+                return Error(errno, eErrorTypePOSIX);
+            num_events = 0;
+        }
+
+        // To avoid problems with callbacks changing the things we're supposed to listen to, we
+        // will store the *real* list of events separately.
+        signals.clear();
+        read_fds.clear();
+        for (int i = 0; i < num_events; ++i)
+        {
+            if (events[i].data.fd == m_signal_fd)
+                ReadSignalFD();
+            else
+                read_fds.push_back(events[i].data.fd);
+        }
+        read_fds.insert(read_fds.end(), m_always_ready_fds.begin(), m_always_ready_fds.end());
+
+        for (const auto &sig: m_signals)
+            signals.push_back(sig.first);
+
+        for (int sig: signals)
+        {
+            if (g_signal_flags[sig] == 0)
+                continue; // No signal
+            g_signal_flags[sig] = 0;
+
+            auto it = m_signals.find(sig);
+            if (it == m_signals.end())
+                continue; // Signal must have gotten unregistered in the meantime
+
+            it->second.callback(*this); // Do the work
+
+            if (m_terminate_request)
+                return Error();
+        }
+
+        for (int fd: read_fds)
+        {
+            auto it = m_read_fds.find(fd);
+            if (it == m_read_fds.end())
+                continue; // File descriptor must have gotten unregistered in the meantime
+
+            it->second(*this); // Do the work
+
+            if (m_terminate_request)
+                return Error();
+        }
+    }
+    return Error();
 }
+#else
 
 Error
 MainLoopPosix::Run()
@@ -189,5 +383,4 @@ MainLoopPosix::Run()
     }
     return Error();
 }
-
-
+#endif
@@ -899,9 +899,14 @@ ClangExpressionParser::PrepareForExecution (lldb::addr_t &func_addr,
             lldb_private::Error interpret_error;
 
             bool interpret_function_calls = !process ? false : process->CanInterpretFunctionCalls();
+            bool interpret_trivial_function_calls = !process ? false : process->CanRunCode();
             can_interpret =
                 IRInterpreter::CanInterpret(*execution_unit_sp->GetModule(), *execution_unit_sp->GetFunction(),
-                                            interpret_error, interpret_function_calls);
+                                            interpret_error, interpret_function_calls,
+                                            interpret_trivial_function_calls);
+
+            if (!can_interpret && log)
+                log->Printf("Can't interpret the expression, it will be JIT'ed: %s", interpret_error.AsCString());
 
             if (!can_interpret && execution_policy == eExecutionPolicyNever)
             {
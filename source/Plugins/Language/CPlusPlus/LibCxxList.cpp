@@ -201,6 +201,7 @@ namespace lldb_private {
             CompilerType m_element_type;
             size_t m_count;
             std::map<size_t, ListIterator> m_iterators;
+            NodePrefetcher m_prefetcher; // Fed by the loop detection, which always runs ahead of the children
         };
     } // namespace formatters
 } // namespace lldb_private
@@ -214,7 +215,8 @@ lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::LibcxxStdListSynthetic
     m_tail(nullptr),
     m_element_type(),
     m_count(UINT32_MAX),
-    m_iterators()
+    m_iterators(),
+    m_prefetcher()
 {
     if (valobj_sp)
         Update();
@@ -248,7 +250,10 @@ lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::HasLoop(size_t count)
             && m_slow_runner != m_fast_runner) {
 
         m_slow_runner = m_slow_runner.next();
-        m_fast_runner = m_fast_runner.next().next();
+        m_prefetcher.WillReadNode(m_fast_runner.value());
+        ListEntry fast_next = m_fast_runner.next();
+        m_prefetcher.WillReadNode(fast_next.value());
+        m_fast_runner = fast_next.next();
         m_loop_detected++;
     }
     if (count <= m_loop_detected)
@@ -360,6 +365,7 @@ lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::Update()
     m_loop_detected = 0;
     m_slow_runner.SetEntry(nullptr);
     m_fast_runner.SetEntry(nullptr);
+    m_prefetcher.Reset(ProcessSP(), 0, 0);
 
     Error err;
     ValueObjectSP backend_addr(m_backend.AddressOf(err));
@@ -384,6 +390,11 @@ lldb_private::formatters::LibcxxStdListSyntheticFrontEnd::Update()
         return false;
     lldb::TemplateArgumentKind kind;
     m_element_type = list_type.GetTemplateArgument(0, kind);
+    // A list node is the two links followed by the value.
+    if (ProcessSP process_sp = m_backend.GetProcessSP())
+        m_prefetcher.Reset(process_sp,
+                           2 * process_sp->GetAddressByteSize() + m_element_type.GetByteSize(nullptr),
+                           m_list_capping_size);
     m_head = impl_sp->GetChildMemberWithName(ConstString("__next_"), true).get();
     m_tail = impl_sp->GetChildMemberWithName(ConstString("__prev_"), true).get();
     return false;
@@ -240,6 +240,9 @@ namespace lldb_private {
             
             void
             GetValueOffset (const lldb::ValueObjectSP& node);
+
+            void
+            PrefetchNode (lldb::addr_t node_addr);
             
             ValueObject* m_tree;
             ValueObject* m_root_node;
@@ -247,6 +250,8 @@ namespace lldb_private {
             uint32_t m_skip_size;
             size_t m_count;
             std::map<size_t, MapIterator> m_iterators;
+            NodePrefetcher m_prefetcher;
+            size_t m_prefetch_node_size;
         };
     } // namespace formatters
 } // namespace lldb_private
@@ -258,7 +263,9 @@ lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::LibcxxStdMapSyntheticFr
     m_element_type(),
     m_skip_size(UINT32_MAX),
     m_count(UINT32_MAX),
-    m_iterators()
+    m_iterators(),
+    m_prefetcher(),
+    m_prefetch_node_size(0)
 {
     if (valobj_sp)
         Update();
@@ -318,6 +325,25 @@ lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetValueOffset (const l
     m_skip_size = bit_offset / 8u;
 }
 
+void
+lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::PrefetchNode (lldb::addr_t node_addr)
+{
+    if (m_prefetch_node_size == 0)
+    {
+        ProcessSP process_sp(m_backend.GetProcessSP());
+        TargetSP target_sp(m_backend.GetTargetSP());
+        if (!process_sp || !target_sp || !GetDataType())
+            return;
+        // A tree node is the three links and the color, padded to pointer
+        // size, followed by the value.
+        m_prefetch_node_size = 4 * process_sp->GetAddressByteSize() + m_element_type.GetByteSize(nullptr);
+        m_prefetcher.Reset(process_sp, m_prefetch_node_size, target_sp->GetMaximumNumberOfChildrenToDisplay());
+    }
+    // Nodes are allocated in insertion order rather than tree order, the
+    // prefetcher works out whether reading their neighbors pays off.
+    m_prefetcher.WillReadNode(node_addr);
+}
+
 lldb::ValueObjectSP
 lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetChildAtIndex (size_t idx)
 {
@@ -351,6 +377,7 @@ lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetChildAtIndex (size_t
         m_tree = nullptr; // this will stop all future searches until an Update() happens
         return iterated_sp;
     }
+    PrefetchNode(iterated_sp->GetValueAsUnsigned(0));
     if (GetDataType())
     {
         if (!need_to_skip)
@@ -442,6 +469,8 @@ lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::Update()
     m_count = UINT32_MAX;
     m_tree = m_root_node = nullptr;
     m_iterators.clear();
+    m_prefetcher.Reset(ProcessSP(), 0, 0);
+    m_prefetch_node_size = 0;
     m_tree = m_backend.GetChildMemberWithName(g___tree_, true).get();
     if (!m_tree)
         return false;
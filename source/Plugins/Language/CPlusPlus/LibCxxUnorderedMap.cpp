@@ -56,6 +56,7 @@ namespace lldb_private {
             size_t m_num_elements;
             ValueObject* m_next_element;
             std::vector<std::pair<ValueObject*, uint64_t> > m_elements_cache;
+            NodePrefetcher m_prefetcher;
         };
     } // namespace formatters
 } // namespace lldb_private
@@ -65,7 +66,8 @@ lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::LibcxxStdUnord
     m_tree(nullptr),
     m_num_elements(0),
     m_next_element(nullptr),
-    m_elements_cache()
+    m_elements_cache(),
+    m_prefetcher()
 {
     if (valobj_sp)
         Update();
@@ -92,6 +94,8 @@ lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::GetChildAtInde
         if (m_next_element == nullptr)
             return lldb::ValueObjectSP();
         
+        m_prefetcher.WillReadNode(m_next_element->GetValueAsUnsigned(0));
+
         Error error;
         ValueObjectSP node_sp = m_next_element->Dereference(error);
         if (!node_sp || error.Fail())
@@ -138,6 +142,19 @@ lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::Update()
     if (!num_elements_sp)
         return false;
     m_num_elements = num_elements_sp->GetValueAsUnsigned(0);
+    m_prefetcher.Reset(ProcessSP(), 0, 0);
+    ProcessSP process_sp(m_backend.GetProcessSP());
+    TargetSP target_sp(m_backend.GetTargetSP());
+    CompilerType table_type(table_sp->GetCompilerType());
+    lldb::TemplateArgumentKind kind;
+    CompilerType value_type(table_type.GetTemplateArgument(0, kind));
+    if (process_sp && target_sp && value_type)
+    {
+        // A hash node is the next link and the hash followed by the value.
+        m_prefetcher.Reset(process_sp,
+                           2 * process_sp->GetAddressByteSize() + value_type.GetByteSize(nullptr),
+                           target_sp->GetMaximumNumberOfChildrenToDisplay());
+    }
     m_tree = table_sp->GetChildAtNamePath({ConstString("__p1_"),ConstString("__first_"),ConstString("__next_")}).get();
     if (m_num_elements > 0)
         m_next_element = table_sp->GetChildAtNamePath({ConstString("__p1_"),ConstString("__first_"),ConstString("__next_")}).get();
@@ -9,6 +9,8 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
+
 // Other libraries and framework includes
 // Project includes
 #include "LibCxx.h"
@@ -16,6 +18,8 @@
 #include "lldb/Core/ConstString.h"
 #include "lldb/Core/ValueObject.h"
 #include "lldb/DataFormatters/FormattersHelpers.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/Target.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -46,10 +50,16 @@ namespace lldb_private {
             GetIndexOfChildWithName(const ConstString &name) override;
 
         private:
+            void
+            PrefetchChildrenAround (size_t idx);
+
             ValueObject* m_start;
             ValueObject* m_finish;
             CompilerType m_element_type;
             uint32_t m_element_size;
+            size_t m_prefetch_count;        // How many elements to prefetch at a time
+            size_t m_prefetched_start;      // Elements [m_prefetched_start, m_prefetched_end) have been prefetched
+            size_t m_prefetched_end;
         };
     } // namespace formatters
 } // namespace lldb_private
@@ -59,7 +69,10 @@ lldb_private::formatters::LibcxxStdVectorSyntheticFrontEnd::LibcxxStdVectorSynth
     m_start(nullptr),
     m_finish(nullptr),
     m_element_type(),
-    m_element_size(0)
+    m_element_size(0),
+    m_prefetch_count(0),
+    m_prefetched_start(0),
+    m_prefetched_end(0)
 {
     if (valobj_sp)
         Update();
@@ -98,6 +111,8 @@ lldb_private::formatters::LibcxxStdVectorSyntheticFrontEnd::GetChildAtIndex (siz
     if (!m_start || !m_finish)
         return lldb::ValueObjectSP();
     
+    PrefetchChildrenAround(idx);
+
     uint64_t offset = idx * m_element_size;
     offset = offset + m_start->GetValueAsUnsigned(0);
     StreamString name;
@@ -108,10 +123,36 @@ lldb_private::formatters::LibcxxStdVectorSyntheticFrontEnd::GetChildAtIndex (siz
                                         m_element_type);
 }
 
+void
+lldb_private::formatters::LibcxxStdVectorSyntheticFrontEnd::PrefetchChildrenAround (size_t idx)
+{
+    if (idx >= m_prefetched_start && idx < m_prefetched_end)
+        return;
+    if (m_prefetch_count == 0)
+        return;
+    ProcessSP process_sp(m_backend.GetProcessSP());
+    if (!process_sp)
+        return;
+
+    // Each child reads its own element, read the elements in the window
+    // around it in one go so those reads come out of the memory cache.
+    const size_t num_children = CalculateNumChildren();
+    if (idx >= num_children)
+        return;
+    m_prefetched_start = idx - (idx % m_prefetch_count);
+    m_prefetched_end = std::min(m_prefetched_start + m_prefetch_count, num_children);
+    const lldb::addr_t start_addr = m_start->GetValueAsUnsigned(0) + m_prefetched_start * m_element_size;
+    PrefetchMemory(*process_sp, start_addr, (m_prefetched_end - m_prefetched_start) * m_element_size);
+}
+
 bool
 lldb_private::formatters::LibcxxStdVectorSyntheticFrontEnd::Update()
 {
     m_start = m_finish = nullptr;
+    m_prefetched_start = m_prefetched_end = 0;
+    m_prefetch_count = 0;
+    if (TargetSP target_sp = m_backend.GetTargetSP())
+        m_prefetch_count = target_sp->GetMaximumNumberOfChildrenToDisplay();
     ValueObjectSP data_type_finder_sp(m_backend.GetChildMemberWithName(ConstString("__end_cap_"),true));
     if (!data_type_finder_sp)
         return false;
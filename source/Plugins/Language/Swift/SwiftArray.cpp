@@ -55,17 +55,9 @@ SwiftArrayNativeBufferHandler::GetElementAtIndex (size_t idx)
     if (idx >= m_size)
         return ValueObjectSP();
     
-    lldb::addr_t child_location = m_first_elem_ptr + idx * m_element_stride;
-    
-    ProcessSP process_sp(m_exe_ctx_ref.GetProcessSP());
-    if (!process_sp)
+    DataExtractor data;
+    if (!m_element_reader.GetElementData(idx, m_element_size, data))
         return ValueObjectSP();
-    
-    DataBufferSP buffer(new DataBufferHeap(m_element_size,0));
-    Error error;
-    if (process_sp->ReadMemory(child_location, buffer->GetBytes(), m_element_size, error) != m_element_size || error.Fail())
-        return ValueObjectSP();
-    DataExtractor data(buffer, process_sp->GetByteOrder(), process_sp->GetAddressByteSize());
     StreamString name;
     name.Printf("[%zu]",idx);
     return ValueObject::CreateValueObjectFromData(name.GetData(), data, m_exe_ctx_ref, m_elem_type);
@@ -80,7 +72,8 @@ m_first_elem_ptr(LLDB_INVALID_ADDRESS),
 m_elem_type(elem_type),
 m_element_size(elem_type.GetByteSize(nullptr)),
 m_element_stride(elem_type.GetByteStride()),
-m_exe_ctx_ref(valobj.GetExecutionContextRef())
+m_exe_ctx_ref(valobj.GetExecutionContextRef()),
+m_element_reader()
 {
     if (native_ptr == LLDB_INVALID_ADDRESS)
         return;
@@ -116,6 +109,7 @@ m_exe_ctx_ref(valobj.GetExecutionContextRef())
         return;
     next_read += ptr_size;
     m_first_elem_ptr = next_read;
+    m_element_reader.Reset(process_sp, m_first_elem_ptr, m_element_stride, m_size, GetElementsPerRead(valobj));
 }
 
 bool
@@ -201,17 +195,9 @@ SwiftArraySliceBufferHandler::GetElementAtIndex (size_t idx)
     
     const uint64_t effective_idx = idx+m_start_index;
     
-    lldb::addr_t child_location = m_first_elem_ptr + effective_idx * m_element_stride;
-    
-    ProcessSP process_sp(m_exe_ctx_ref.GetProcessSP());
-    if (!process_sp)
-        return ValueObjectSP();
-    
-    DataBufferSP buffer(new DataBufferHeap(m_element_size,0));
-    Error error;
-    if (process_sp->ReadMemory(child_location, buffer->GetBytes(), m_element_size, error) != m_element_size || error.Fail())
+    DataExtractor data;
+    if (!m_element_reader.GetElementData(idx, m_element_size, data))
         return ValueObjectSP();
-    DataExtractor data(buffer, process_sp->GetByteOrder(), process_sp->GetAddressByteSize());
     StreamString name;
     name.Printf("[%" PRIu64 "]",effective_idx);
     return ValueObject::CreateValueObjectFromData(name.GetData(), data, m_exe_ctx_ref, m_elem_type);
@@ -226,7 +212,8 @@ m_element_size(elem_type.GetByteSize(nullptr)),
 m_element_stride(elem_type.GetByteStride()),
 m_exe_ctx_ref(valobj.GetExecutionContextRef()),
 m_native_buffer(false),
-m_start_index(0)
+m_start_index(0),
+m_element_reader()
 {
     static ConstString g_start("subscriptBaseAddress");
     static ConstString g_value("_value");
@@ -259,6 +246,13 @@ m_start_index(0)
     m_size = (isw >> 1).GetValue() - m_start_index;
     
     m_native_buffer = !((isw & 1).IsZero());
+
+    if (m_first_elem_ptr != LLDB_INVALID_ADDRESS)
+        m_element_reader.Reset(process_sp,
+                               m_first_elem_ptr + m_start_index * m_element_stride,
+                               m_element_stride,
+                               m_size,
+                               GetElementsPerRead(valobj));
 }
 
 bool
@@ -309,6 +303,17 @@ SwiftSyntheticFrontEndBufferHandler::IsValid ()
     return m_frontend.get() != nullptr;
 }
 
+size_t
+SwiftArrayBufferHandler::GetElementsPerRead (ValueObject &valobj)
+{
+    // Nobody is going to look at more children than this in one go, and
+    // reading them together saves a round trip per element.
+    TargetSP target_sp(valobj.GetTargetSP());
+    if (!target_sp)
+        return 1;
+    return target_sp->GetMaximumNumberOfChildrenToDisplay();
+}
+
 std::unique_ptr<SwiftArrayBufferHandler>
 SwiftArrayBufferHandler::CreateBufferHandler (ValueObject& valobj)
 {
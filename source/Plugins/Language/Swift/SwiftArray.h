@@ -17,6 +17,7 @@
 
 #include "lldb/Core/ConstString.h"
 #include "lldb/DataFormatters/FormatClasses.h"
+#include "lldb/DataFormatters/FormattersHelpers.h"
 #include "lldb/DataFormatters/TypeSummary.h"
 #include "lldb/DataFormatters/TypeSynthetic.h"
 #include "lldb/Symbol/CompilerType.h"
@@ -54,6 +55,10 @@ namespace lldb_private {
             protected:
                 static bool
                 DoesTypeEntailIndirectBuffer (const CompilerType &element_type);
+
+                // How many elements to read from the inferior at a time
+                static size_t
+                GetElementsPerRead (ValueObject &valobj);
             };
             
             class SwiftArrayEmptyBufferHandler : public SwiftArrayBufferHandler
@@ -119,6 +124,7 @@ namespace lldb_private {
                 size_t m_element_size;
                 size_t m_element_stride;
                 lldb_private::ExecutionContextRef m_exe_ctx_ref;
+                ChunkedElementReader m_element_reader;
             };
             
             class SwiftArrayBridgedBufferHandler : public SwiftArrayBufferHandler
@@ -184,6 +190,7 @@ namespace lldb_private {
                 lldb_private::ExecutionContextRef m_exe_ctx_ref;
                 bool m_native_buffer;
                 uint64_t m_start_index;
+                ChunkedElementReader m_element_reader;
             };
             
             class SwiftSyntheticFrontEndBufferHandler : public SwiftArrayBufferHandler
@@ -86,39 +86,46 @@ SwiftHashedContainerNativeBufferHandler::GetElementAtIndex (size_t idx)
         return null_valobj_sp;
     if (!IsValid())
         return null_valobj_sp;
-    int64_t found_idx = -1;
-    for(Cell cell_idx = 0;
-        cell_idx < m_capacity;
-        cell_idx++)
+
+    // Remember the cells we've walked past so that asking for every child
+    // in turn only scans the bitmask once.
+    while (m_used_cells.size() <= idx && m_next_cell_to_scan < m_capacity)
     {
-        const bool used = ReadBitmaskAtIndex(cell_idx);
-        if (!used)
-            continue;
-        if (++found_idx == idx)
-        {
+        const Cell cell_idx = m_next_cell_to_scan++;
+        if (ReadBitmaskAtIndex(cell_idx))
+            m_used_cells.push_back(cell_idx);
+    }
+    if (idx >= m_used_cells.size())
+        return null_valobj_sp;
+
+    const Cell cell_idx = m_used_cells[idx];
 #ifdef DICTIONARY_IS_BROKEN_AGAIN
-            printf("found idx = %zu at cell_idx = %" PRIu64 "\n", idx, cell_idx);
+    printf("found idx = %zu at cell_idx = %" PRIu64 "\n", idx, cell_idx);
 #endif
-            
-            // you found it!!!
-            DataBufferSP full_buffer_sp(new DataBufferHeap(m_key_stride + m_value_stride, 0));
-            uint8_t* key_buffer_ptr = full_buffer_sp->GetBytes();
-            uint8_t* value_buffer_ptr = m_value_stride ? (key_buffer_ptr + m_key_stride) : nullptr;
-            if (GetDataForKeyAtCell(cell_idx, key_buffer_ptr) &&
-                (value_buffer_ptr == nullptr || GetDataForValueAtCell(cell_idx, value_buffer_ptr)))
-            {
-                DataExtractor full_data;
-                full_data.SetData(full_buffer_sp);
-                StreamString name;
-                name.Printf("[%zu]",idx);
-                return ValueObjectConstResult::Create (m_process,
-                                                       m_element_type,
-                                                       ConstString(name.GetData()),
-                                                       full_data);
-            }
-        }
+
+    DataExtractor full_data;
+    if (m_value_stride == 0)
+    {
+        // Sets have just keys, which can be handed out of the chunk as is.
+        if (!m_keys_reader.GetElementData(cell_idx, m_key_stride, full_data))
+            return null_valobj_sp;
+    }
+    else
+    {
+        DataBufferSP full_buffer_sp(new DataBufferHeap(m_key_stride + m_value_stride, 0));
+        uint8_t* key_buffer_ptr = full_buffer_sp->GetBytes();
+        uint8_t* value_buffer_ptr = key_buffer_ptr + m_key_stride;
+        if (!GetDataForKeyAtCell(cell_idx, key_buffer_ptr) ||
+            !GetDataForValueAtCell(cell_idx, value_buffer_ptr))
+            return null_valobj_sp;
+        full_data.SetData(full_buffer_sp);
     }
-    return null_valobj_sp;
+    StreamString name;
+    name.Printf("[%zu]",idx);
+    return ValueObjectConstResult::Create (m_process,
+                                           m_element_type,
+                                           ConstString(name.GetData()),
+                                           full_data);
 }
 
 bool
@@ -128,28 +135,17 @@ SwiftHashedContainerNativeBufferHandler::ReadBitmaskAtIndex (Index i)
         return false;
     const size_t word = i / (8 * m_ptr_size);
     const size_t offset = i % (8 * m_ptr_size);
-    Error error;
-    const lldb::addr_t effective_ptr = m_bitmask_ptr + (word * m_ptr_size);
 #ifdef DICTIONARY_IS_BROKEN_AGAIN
-    printf("for idx = %" PRIu64 ", reading at word = %zu offset = %zu, effective_ptr = 0x%" PRIx64 "\n", i, word, offset, effective_ptr);
+    printf("for idx = %" PRIu64 ", reading at word = %zu offset = %zu\n", i, word, offset);
 #endif
     
-    uint64_t data = 0;
-    
-    auto cached = m_bitmask_cache.find(effective_ptr);
-    if (cached != m_bitmask_cache.end())
-    {
-        data = cached->second;
-    }
-    else
-    {
-        data = m_process->ReadUnsignedIntegerFromMemory(effective_ptr, m_ptr_size, 0, error);
-        if (error.Fail())
-            return false;
-        m_bitmask_cache[effective_ptr] = data;
-    }
+    DataExtractor word_data;
+    if (!m_bitmask_reader.GetElementData(word, m_ptr_size, word_data))
+        return false;
+    lldb::offset_t data_offset = 0;
+    const uint64_t data = word_data.GetMaxU64(&data_offset, m_ptr_size);
     
-    const uint64_t mask = (1UL << offset);
+    const uint64_t mask = (1ULL << offset);
     const uint64_t value = (data & mask);
 #ifdef DICTIONARY_IS_BROKEN_AGAIN
     printf("data = 0x%" PRIx64 ", mask = 0x%" PRIx64 ", value = 0x%" PRIx64 "\n", data, mask, value);
@@ -177,13 +173,7 @@ SwiftHashedContainerNativeBufferHandler::GetDataForKeyAtCell (Cell i, void *data
     if (!data_ptr)
         return false;
     
-    lldb::addr_t addr = GetLocationOfKeyAtCell(i);
-    Error error;
-    m_process->ReadMemory(addr, data_ptr, m_key_stride, error);
-    if (error.Fail())
-        return false;
-    
-    return true;
+    return m_keys_reader.CopyElementData(i, m_key_stride, data_ptr);
 }
 
 bool
@@ -192,13 +182,7 @@ SwiftHashedContainerNativeBufferHandler::GetDataForValueAtCell (Cell i, void *da
     if (!data_ptr || !m_value_stride)
         return false;
     
-    lldb::addr_t addr = GetLocationOfValueAtCell(i);
-    Error error;
-    m_process->ReadMemory(addr, data_ptr, m_value_stride, error);
-    if (error.Fail())
-        return false;
-    
-    return true;
+    return m_values_reader.CopyElementData(i, m_value_stride, data_ptr);
 }
 
 SwiftHashedContainerNativeBufferHandler::SwiftHashedContainerNativeBufferHandler (lldb::ValueObjectSP nativeStorage_sp, CompilerType key_type, CompilerType value_type) :
@@ -213,7 +197,11 @@ SwiftHashedContainerNativeBufferHandler::SwiftHashedContainerNativeBufferHandler
     m_element_type(),
     m_key_stride(key_type.GetByteStride()),
     m_value_stride(0),
-    m_bitmask_cache()
+    m_bitmask_reader(),
+    m_keys_reader(),
+    m_values_reader(),
+    m_used_cells(),
+    m_next_cell_to_scan(0)
 {
     static ConstString g_initializedEntries("initializedEntries");
     static ConstString g_values("values");
@@ -273,6 +261,18 @@ SwiftHashedContainerNativeBufferHandler::SwiftHashedContainerNativeBufferHandler
         m_values_ptr = value_child_sp->GetValueAsUnsigned(LLDB_INVALID_ADDRESS);
     }
     m_keys_ptr = m_nativeStorage->GetChildAtNamePath( {g_keys,g__rawValue} )->GetValueAsUnsigned(LLDB_INVALID_ADDRESS);
+
+    // Read the whole bitmask at once, and the keys and values in chunks of
+    // as many cells as the user wants to see children.
+    ProcessSP process_sp(m_nativeStorage->GetProcessSP());
+    TargetSP target_sp(m_nativeStorage->GetTargetSP());
+    const size_t cells_per_read = target_sp ? target_sp->GetMaximumNumberOfChildrenToDisplay() : 1;
+    const size_t bitmask_bits_per_word = 8 * m_ptr_size;
+    const size_t bitmask_words = (m_capacity + bitmask_bits_per_word - 1) / bitmask_bits_per_word;
+    m_bitmask_reader.Reset(process_sp, m_bitmask_ptr, m_ptr_size, bitmask_words, bitmask_words);
+    m_keys_reader.Reset(process_sp, m_keys_ptr, m_key_stride, m_capacity, cells_per_read);
+    if (m_value_stride)
+        m_values_reader.Reset(process_sp, m_values_ptr, m_value_stride, m_capacity, cells_per_read);
 }
 
 bool
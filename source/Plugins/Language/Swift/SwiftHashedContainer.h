@@ -17,12 +17,14 @@
 
 #include "lldb/Core/ConstString.h"
 #include "lldb/DataFormatters/FormatClasses.h"
+#include "lldb/DataFormatters/FormattersHelpers.h"
 #include "lldb/DataFormatters/TypeSummary.h"
 #include "lldb/DataFormatters/TypeSynthetic.h"
 #include "lldb/Symbol/CompilerType.h"
 #include "lldb/Target/Target.h"
 
 #include <functional>
+#include <vector>
 
 namespace lldb_private {
     namespace formatters
@@ -154,7 +156,11 @@ namespace lldb_private {
                 CompilerType m_element_type;
                 uint64_t m_key_stride;
                 uint64_t m_value_stride;
-                std::map<lldb::addr_t, uint64_t> m_bitmask_cache;
+                ChunkedElementReader m_bitmask_reader;
+                ChunkedElementReader m_keys_reader;
+                ChunkedElementReader m_values_reader;
+                std::vector<Cell> m_used_cells;     // The cells of the elements found so far, in index order
+                Cell m_next_cell_to_scan;
             };
             
             class SwiftHashedContainerSyntheticFrontEndBufferHandler : public SwiftHashedContainerBufferHandler
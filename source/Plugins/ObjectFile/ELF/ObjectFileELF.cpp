@@ -2871,6 +2871,7 @@ ObjectFileELF::GetSymtab()
         // in the dynsym is therefore also found in the symtab, while the reverse is not
         // necessarily true.
         Section *symtab = section_list->FindSectionByType (eSectionTypeELFSymbolTable, true).get();
+        const bool has_full_symtab = symtab != nullptr;
         if (!symtab)
         {
             // The symtab section is non-allocable and can be stripped, so if it doesn't exist
@@ -2909,7 +2910,9 @@ ObjectFileELF::GetSymtab()
             }
         }
 
-        DWARFCallFrameInfo* eh_frame = GetUnwindTable().GetEHFrameInfo();
+        // A full symbol table already has every function in it, only
+        // stripped files need symbols made up from the unwind info.
+        DWARFCallFrameInfo* eh_frame = has_full_symtab ? nullptr : GetUnwindTable().GetEHFrameInfo();
         if (eh_frame)
         {
             if (m_symtab_ap == nullptr)
@@ -0,0 +1,473 @@
+//===-- ElfCoreWriter.cpp ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ElfCoreWriter.h"
+
+// C Includes
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// C++ Includes
+#include <algorithm>
+
+// Other libraries and framework includes
+#include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/Log.h"
+#include "lldb/Host/Debug.h"
+#include "lldb/Host/common/NativeThreadProtocol.h"
+#include "lldb/Utility/StringExtractor.h"
+
+#include "Plugins/Process/POSIX/ProcessPOSIXLog.h"
+#include "NativeProcessLinux.h"
+#include "ProcFileReader.h"
+#include "Procfs.h"
+
+// System includes - They have to be included after framework includes because they define some
+// macros which collide with variable names in other modules
+#include <elf.h>
+#include <link.h>
+#include <sys/uio.h>
+
+#include "lldb/Host/linux/Ptrace.h"
+#include "lldb/Host/linux/Uio.h"
+
+// Android's headers don't have prstatus_t and prpsinfo_t.
+#if !defined(__ANDROID__)
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::process_linux;
+
+namespace {
+
+// Linux uses this note type for the list of mapped files, <elf.h> doesn't
+// always have it.
+const uint32_t kNoteTypeFile = 0x46494c45;
+
+// Memory is copied to the core file this much at a time.
+const size_t kChunkSize = 4 * 1024 * 1024;
+
+size_t
+AlignTo (size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void
+AppendNote (std::vector<uint8_t> &notes, const char *name, uint32_t type, const void *desc, size_t desc_size)
+{
+    ElfW(Nhdr) header;
+    header.n_namesz = strlen (name) + 1;
+    header.n_descsz = desc_size;
+    header.n_type = type;
+
+    const size_t start = notes.size();
+    notes.resize (start + sizeof(header) + AlignTo (header.n_namesz, 4) + AlignTo (desc_size, 4), 0);
+    uint8_t *dst = notes.data() + start;
+    memcpy (dst, &header, sizeof(header));
+    dst += sizeof(header);
+    memcpy (dst, name, header.n_namesz);
+    dst += AlignTo (header.n_namesz, 4);
+    if (desc_size)
+        memcpy (dst, desc, desc_size);
+}
+
+bool
+IsZeroFilled (const uint8_t *bytes, size_t length)
+{
+    return length == 0 || (bytes[0] == 0 && memcmp (bytes, bytes + 1, length - 1) == 0);
+}
+
+// Write [bytes, bytes + length) to fd at offset, leaving out the pages that
+// are all zeros.
+Error
+WriteNonZeroPages (int fd, const uint8_t *bytes, size_t length, uint64_t offset, size_t page_size)
+{
+    Error error;
+    size_t run_start = 0;
+    size_t pos = 0;
+    while (pos <= length)
+    {
+        const size_t page_len = std::min (page_size, length - pos);
+        if (pos == length || IsZeroFilled (bytes + pos, page_len))
+        {
+            // Flush the run of non-zero pages before this one.
+            while (run_start < pos)
+            {
+                const ssize_t written = ::pwrite (fd, bytes + run_start, pos - run_start, offset + run_start);
+                if (written <= 0)
+                {
+                    error.SetErrorToErrno();
+                    return error;
+                }
+                run_start += written;
+            }
+            if (pos == length)
+                break;
+            run_start = pos + page_len;
+        }
+        pos += page_len;
+    }
+    return error;
+}
+
+} // anonymous namespace
+
+ElfCoreWriter::ElfCoreWriter (NativeProcessLinux &process) :
+    m_process (process),
+    m_mappings (),
+    m_page_size (::sysconf (_SC_PAGESIZE))
+{
+}
+
+Error
+ElfCoreWriter::ReadMappings ()
+{
+    m_mappings.clear();
+    return ProcFileReader::ProcessLineByLine (m_process.GetID (), "maps",
+        [&] (const std::string &line) -> bool
+        {
+            // Format: {address_start_hex}-{address_end_hex} perms offset dev inode pathname
+            StringExtractor line_extractor (line.c_str ());
+            Mapping mapping;
+            mapping.start = line_extractor.GetHexMaxU64 (false, 0);
+            if (line_extractor.GetChar () != '-')
+                return false;
+            mapping.end = line_extractor.GetHexMaxU64 (false, mapping.start);
+            if (line_extractor.GetChar () != ' ' || line_extractor.GetBytesLeft () < 4)
+                return false;
+
+            mapping.flags = 0;
+            if (line_extractor.GetChar () == 'r')
+                mapping.flags |= PF_R;
+            if (line_extractor.GetChar () == 'w')
+                mapping.flags |= PF_W;
+            if (line_extractor.GetChar () == 'x')
+                mapping.flags |= PF_X;
+            mapping.is_private = line_extractor.GetChar () == 'p';
+            line_extractor.SkipSpaces ();
+            mapping.file_offset = line_extractor.GetHexMaxU64 (false, 0);
+
+            // Skip the device and the inode, what's left is the path.
+            line_extractor.SkipSpaces ();
+            while (line_extractor.GetBytesLeft () && line_extractor.PeekChar () != ' ')
+                line_extractor.GetChar ();
+            line_extractor.SkipSpaces ();
+            while (line_extractor.GetBytesLeft () && line_extractor.PeekChar () != ' ')
+                line_extractor.GetChar ();
+            line_extractor.SkipSpaces ();
+            if (line_extractor.GetBytesLeft ())
+                mapping.path = line_extractor.Peek ();
+
+            m_mappings.push_back (mapping);
+            return true;
+        });
+}
+
+bool
+ElfCoreWriter::ShouldDumpMapping (const Mapping &mapping, bool skip_file_backed) const
+{
+    if ((mapping.flags & PF_R) == 0)
+        return false;
+    // process_vm_readv can't read these and they are the same in every
+    // process anyway.
+    if (mapping.path == "[vsyscall]" || mapping.path == "[vvar]")
+        return false;
+    // Clean pages of read-only file mappings are the same as in the file.
+    if (skip_file_backed && !mapping.path.empty() && mapping.path[0] == '/' && (mapping.flags & PF_W) == 0)
+        return false;
+    return true;
+}
+
+Error
+ElfCoreWriter::BuildNotes (std::vector<uint8_t> &notes)
+{
+    Error error;
+    const lldb::pid_t pid = m_process.GetID ();
+
+    // The kernel puts the thread that caused the dump first, lldb treats
+    // the first thread of a core as the selected one.
+    std::vector<NativeThreadProtocolSP> threads;
+    NativeThreadProtocolSP current_thread_sp = m_process.GetCurrentThread ();
+    if (current_thread_sp)
+        threads.push_back (current_thread_sp);
+    for (uint32_t idx = 0; NativeThreadProtocolSP thread_sp = m_process.GetThreadAtIndex (idx); ++idx)
+    {
+        if (thread_sp != current_thread_sp)
+            threads.push_back (thread_sp);
+    }
+
+    bool first_thread = true;
+    for (const NativeThreadProtocolSP &thread_sp : threads)
+    {
+        const lldb::tid_t tid = thread_sp->GetID ();
+
+        prstatus_t prstatus;
+        memset (&prstatus, 0, sizeof(prstatus));
+        prstatus.pr_pid = tid;
+        prstatus.pr_pgrp = ::getpgid (pid);
+        prstatus.pr_sid = ::getsid (pid);
+
+        ThreadStopInfo stop_info;
+        std::string description;
+        if (thread_sp->GetStopReason (stop_info, description) && stop_info.reason == eStopReasonSignal)
+        {
+            prstatus.pr_cursig = stop_info.details.signal.signo;
+            prstatus.pr_info.si_signo = stop_info.details.signal.signo;
+        }
+
+        struct iovec gpr_iov;
+        gpr_iov.iov_base = &prstatus.pr_reg;
+        gpr_iov.iov_len = sizeof(prstatus.pr_reg);
+        error = NativeProcessLinux::PtraceWrapper (PTRACE_GETREGSET, tid, (void *)NT_PRSTATUS, &gpr_iov, sizeof(gpr_iov));
+        if (error.Fail())
+            return error;
+
+        elf_fpregset_t fpregset;
+        memset (&fpregset, 0, sizeof(fpregset));
+        struct iovec fpr_iov;
+        fpr_iov.iov_base = &fpregset;
+        fpr_iov.iov_len = sizeof(fpregset);
+        prstatus.pr_fpvalid = NativeProcessLinux::PtraceWrapper (PTRACE_GETREGSET, tid, (void *)NT_PRFPREG, &fpr_iov, sizeof(fpr_iov)).Success();
+
+        AppendNote (notes, "CORE", NT_PRSTATUS, &prstatus, sizeof(prstatus));
+
+        if (first_thread)
+        {
+            first_thread = false;
+
+            prpsinfo_t prpsinfo;
+            memset (&prpsinfo, 0, sizeof(prpsinfo));
+            prpsinfo.pr_pid = pid;
+            prpsinfo.pr_pgrp = prstatus.pr_pgrp;
+            prpsinfo.pr_sid = prstatus.pr_sid;
+            prpsinfo.pr_state = 3;  // Traced
+            prpsinfo.pr_sname = 't';
+            DataBufferSP comm_sp = ProcFileReader::ReadIntoDataBuffer (pid, "comm");
+            if (comm_sp && comm_sp->GetByteSize())
+            {
+                const size_t len = std::min<size_t> (comm_sp->GetByteSize(), sizeof(prpsinfo.pr_fname) - 1);
+                memcpy (prpsinfo.pr_fname, comm_sp->GetBytes(), len);
+                if (char *newline = (char *)memchr (prpsinfo.pr_fname, '\n', len))
+                    *newline = '\0';
+            }
+            DataBufferSP cmdline_sp = ProcFileReader::ReadIntoDataBuffer (pid, "cmdline");
+            if (cmdline_sp && cmdline_sp->GetByteSize())
+            {
+                const size_t len = std::min<size_t> (cmdline_sp->GetByteSize(), sizeof(prpsinfo.pr_psargs) - 1);
+                memcpy (prpsinfo.pr_psargs, cmdline_sp->GetBytes(), len);
+                for (size_t i = 0; i < len; ++i)
+                {
+                    if (prpsinfo.pr_psargs[i] == '\0')
+                        prpsinfo.pr_psargs[i] = ' ';
+                }
+            }
+            AppendNote (notes, "CORE", NT_PRPSINFO, &prpsinfo, sizeof(prpsinfo));
+
+            DataBufferSP auxv_sp = ProcFileReader::ReadIntoDataBuffer (pid, "auxv");
+            if (auxv_sp && auxv_sp->GetByteSize())
+                AppendNote (notes, "CORE", NT_AUXV, auxv_sp->GetBytes(), auxv_sp->GetByteSize());
+
+            // NT_FILE: count and page size, then start, end and page
+            // offset of every file mapping, then their paths.
+            std::vector<ElfW(Addr)> file_ranges;
+            std::string file_paths;
+            for (const Mapping &mapping : m_mappings)
+            {
+                if (mapping.path.empty() || mapping.path[0] != '/')
+                    continue;
+                file_ranges.push_back (mapping.start);
+                file_ranges.push_back (mapping.end);
+                file_ranges.push_back (mapping.file_offset / m_page_size);
+                file_paths.append (mapping.path.c_str(), mapping.path.size() + 1);
+            }
+            std::vector<uint8_t> file_note;
+            const ElfW(Addr) file_header[2] = { file_ranges.size() / 3, m_page_size };
+            file_note.insert (file_note.end(), (const uint8_t *)file_header, (const uint8_t *)(file_header + 2));
+            file_note.insert (file_note.end(), (const uint8_t *)file_ranges.data(), (const uint8_t *)(file_ranges.data() + file_ranges.size()));
+            file_note.insert (file_note.end(), file_paths.begin(), file_paths.end());
+            AppendNote (notes, "CORE", kNoteTypeFile, file_note.data(), file_note.size());
+        }
+
+        if (prstatus.pr_fpvalid)
+            AppendNote (notes, "CORE", NT_FPREGSET, &fpregset, sizeof(fpregset));
+    }
+    return error;
+}
+
+Error
+ElfCoreWriter::WriteMappingContents (int fd, const Mapping &mapping, uint64_t file_offset)
+{
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+    Error error;
+
+    std::vector<uint8_t> buffer (std::min<uint64_t> (kChunkSize, mapping.end - mapping.start));
+    for (lldb::addr_t addr = mapping.start; addr < mapping.end; )
+    {
+        const size_t chunk_size = std::min<uint64_t> (buffer.size(), mapping.end - addr);
+        struct iovec local_iov, remote_iov;
+        local_iov.iov_base = buffer.data();
+        local_iov.iov_len = chunk_size;
+        remote_iov.iov_base = reinterpret_cast<void *>(addr);
+        remote_iov.iov_len = chunk_size;
+        ssize_t bytes_read = ::process_vm_readv (m_process.GetID (), &local_iov, 1, &remote_iov, 1, 0);
+        if (bytes_read <= 0)
+        {
+            // Skip the unreadable page, the file keeps a hole there.
+            if (log)
+                log->Printf ("ElfCoreWriter::%s can't read 0x%" PRIx64 ": %s", __FUNCTION__, addr, strerror (errno));
+            addr += m_page_size;
+            continue;
+        }
+
+        error = WriteNonZeroPages (fd, buffer.data(), bytes_read, file_offset + (addr - mapping.start), m_page_size);
+        if (error.Fail())
+            return error;
+        addr += bytes_read;
+    }
+    return error;
+}
+
+Error
+ElfCoreWriter::Write (const std::string &path, bool skip_file_backed)
+{
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+
+    Error error = ReadMappings ();
+    if (error.Fail())
+        return error;
+
+    std::vector<uint8_t> notes;
+    error = BuildNotes (notes);
+    if (error.Fail())
+        return error;
+
+    ArchSpec arch;
+    m_process.GetArchitecture (arch);
+
+    // ELF header, program headers and notes, then the memory of each
+    // mapping at a page aligned offset.
+    const size_t num_segments = m_mappings.size() + 1;
+    ElfW(Ehdr) ehdr;
+    memset (&ehdr, 0, sizeof(ehdr));
+    memcpy (ehdr.e_ident, ELFMAG, SELFMAG);
+    ehdr.e_ident[EI_CLASS] = __ELF_NATIVE_CLASS == 64 ? ELFCLASS64 : ELFCLASS32;
+    ehdr.e_ident[EI_DATA] = arch.GetByteOrder() == eByteOrderBig ? ELFDATA2MSB : ELFDATA2LSB;
+    ehdr.e_ident[EI_VERSION] = EV_CURRENT;
+    ehdr.e_ident[EI_OSABI] = ELFOSABI_NONE;
+    ehdr.e_type = ET_CORE;
+    ehdr.e_version = EV_CURRENT;
+    ehdr.e_phoff = sizeof(ehdr);
+    ehdr.e_ehsize = sizeof(ehdr);
+    ehdr.e_phentsize = sizeof(ElfW(Phdr));
+    // With too many segments for e_phnum, the real count goes in the
+    // sh_info of a lone section header at the end of the file.
+    const bool extended_numbering = num_segments >= PN_XNUM;
+    ehdr.e_phnum = extended_numbering ? PN_XNUM : num_segments;
+    // The headers and notes are laid out for the host, and
+    // NativeProcessLinux::SaveCore() refuses processes of any other
+    // architecture (an i386 process under an x86_64 lldb-server, say).
+#if defined(__x86_64__)
+    ehdr.e_machine = EM_X86_64;
+#elif defined(__i386__)
+    ehdr.e_machine = EM_386;
+#elif defined(__aarch64__)
+    ehdr.e_machine = EM_AARCH64;
+#elif defined(__arm__)
+    ehdr.e_machine = EM_ARM;
+#elif defined(__mips__)
+    ehdr.e_machine = EM_MIPS;
+#elif defined(__powerpc64__)
+    ehdr.e_machine = EM_PPC64;
+#elif defined(__s390x__)
+    ehdr.e_machine = EM_S390;
+#endif
+
+    std::vector<ElfW(Phdr)> phdrs (num_segments);
+    memset (phdrs.data(), 0, phdrs.size() * sizeof(ElfW(Phdr)));
+    uint64_t offset = sizeof(ehdr) + phdrs.size() * sizeof(ElfW(Phdr));
+    phdrs[0].p_type = PT_NOTE;
+    phdrs[0].p_offset = offset;
+    phdrs[0].p_filesz = notes.size();
+    phdrs[0].p_align = 4;
+    offset = AlignTo (offset + notes.size(), m_page_size);
+
+    uint64_t num_dumped_bytes = 0;
+    for (size_t i = 0; i < m_mappings.size(); ++i)
+    {
+        const Mapping &mapping = m_mappings[i];
+        ElfW(Phdr) &phdr = phdrs[i + 1];
+        phdr.p_type = PT_LOAD;
+        phdr.p_flags = mapping.flags;
+        phdr.p_offset = offset;
+        phdr.p_vaddr = mapping.start;
+        phdr.p_memsz = mapping.end - mapping.start;
+        phdr.p_filesz = ShouldDumpMapping (mapping, skip_file_backed) ? phdr.p_memsz : 0;
+        phdr.p_align = m_page_size;
+        offset += phdr.p_filesz;
+        num_dumped_bytes += phdr.p_filesz;
+    }
+
+    ElfW(Shdr) shdr;
+    memset (&shdr, 0, sizeof(shdr));
+    if (extended_numbering)
+    {
+        shdr.sh_type = SHT_NULL;
+        shdr.sh_size = 1;
+        shdr.sh_link = SHN_UNDEF;
+        shdr.sh_info = num_segments;
+        offset = AlignTo (offset, sizeof(ElfW(Off)));
+        ehdr.e_shoff = offset;
+        ehdr.e_shentsize = sizeof(shdr);
+        ehdr.e_shnum = 1;
+        ehdr.e_shstrndx = SHN_UNDEF;
+        offset += sizeof(shdr);
+    }
+
+    const int fd = ::open (path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0)
+    {
+        error.SetErrorToErrno();
+        return error;
+    }
+
+    if (::pwrite (fd, &ehdr, sizeof(ehdr), 0) != sizeof(ehdr) ||
+        ::pwrite (fd, phdrs.data(), phdrs.size() * sizeof(ElfW(Phdr)), sizeof(ehdr)) != (ssize_t)(phdrs.size() * sizeof(ElfW(Phdr))) ||
+        ::pwrite (fd, notes.data(), notes.size(), phdrs[0].p_offset) != (ssize_t)notes.size() ||
+        (extended_numbering && ::pwrite (fd, &shdr, sizeof(shdr), ehdr.e_shoff) != sizeof(shdr)))
+        error.SetErrorToErrno();
+
+    for (size_t i = 0; error.Success() && i < m_mappings.size(); ++i)
+    {
+        if (phdrs[i + 1].p_filesz)
+            error = WriteMappingContents (fd, m_mappings[i], phdrs[i + 1].p_offset);
+    }
+
+    // Pages we didn't write are holes, make sure the file covers them.
+    if (error.Success() && ::ftruncate (fd, offset) != 0)
+        error.SetErrorToErrno();
+    ::close (fd);
+
+    if (log)
+        log->Printf ("ElfCoreWriter::%s wrote %" PRIu64 " bytes of %" PRIu64 " mappings for pid %" PRIu64 " to %s: %s",
+                     __FUNCTION__,
+                     num_dumped_bytes,
+                     (uint64_t)m_mappings.size(),
+                     m_process.GetID (),
+                     path.c_str(),
+                     error.Success() ? "success" : error.AsCString());
+    if (error.Fail())
+        ::unlink (path.c_str());
+    return error;
+}
+
+#endif // !defined(__ANDROID__)
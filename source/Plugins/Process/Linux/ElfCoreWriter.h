@@ -0,0 +1,89 @@
+//===-- ElfCoreWriter.h -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_ElfCoreWriter_H_
+#define liblldb_ElfCoreWriter_H_
+
+// C Includes
+// C++ Includes
+#include <string>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-types.h"
+#include "lldb/Core/Error.h"
+
+namespace lldb_private {
+namespace process_linux {
+
+    class NativeProcessLinux;
+
+    //------------------------------------------------------------------
+    /// @class ElfCoreWriter
+    /// @brief Writes an ELF core file of a stopped NativeProcessLinux.
+    ///
+    /// The layout is the one the kernel uses: an ELF header, one PT_NOTE
+    /// segment with NT_PRSTATUS and NT_FPREGSET notes for every thread
+    /// (the current thread first) plus NT_PRPSINFO, NT_AUXV and NT_FILE,
+    /// followed by one page aligned PT_LOAD segment per mapping in
+    /// /proc/{pid}/maps.
+    ///
+    /// Memory is streamed from the inferior to the file with
+    /// process_vm_readv in large chunks.  Pages that can't be read and
+    /// pages that are all zeros are never written, which leaves holes in
+    /// the output so that it stays sparse.
+    //------------------------------------------------------------------
+    class ElfCoreWriter
+    {
+    public:
+        ElfCoreWriter (NativeProcessLinux &process);
+
+        //------------------------------------------------------------------
+        /// Write the core file to \a path.
+        ///
+        /// @param[in] skip_file_backed
+        ///     If true, read-only mappings of files get no contents in
+        ///     the core, so that memory reads as zeros when it is loaded.
+        //------------------------------------------------------------------
+        Error
+        Write (const std::string &path, bool skip_file_backed);
+
+    private:
+        struct Mapping
+        {
+            lldb::addr_t start;
+            lldb::addr_t end;
+            uint64_t file_offset;
+            uint32_t flags;         // PF_R, PF_W and PF_X
+            bool is_private;
+            std::string path;
+        };
+
+        Error
+        ReadMappings ();
+
+        bool
+        ShouldDumpMapping (const Mapping &mapping, bool skip_file_backed) const;
+
+        Error
+        BuildNotes (std::vector<uint8_t> &notes);
+
+        Error
+        WriteMappingContents (int fd, const Mapping &mapping, uint64_t file_offset);
+
+        NativeProcessLinux &m_process;
+        std::vector<Mapping> m_mappings;
+        size_t m_page_size;
+    };
+
+} // namespace process_linux
+} // namespace lldb_private
+
+#endif // #ifndef liblldb_ElfCoreWriter_H_
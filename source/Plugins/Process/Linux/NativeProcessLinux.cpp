@@ -16,7 +16,9 @@
 #include <unistd.h>
 
 // C++ Includes
+#include <algorithm>
 #include <fstream>
+#include <iterator>
 #include <mutex>
 #include <sstream>
 #include <string>
@@ -32,6 +34,7 @@
 #include "lldb/Host/common/NativeBreakpoint.h"
 #include "lldb/Host/common/NativeRegisterContext.h"
 #include "lldb/Host/Host.h"
+#include "lldb/Host/HostInfo.h"
 #include "lldb/Host/ThreadLauncher.h"
 #include "lldb/Target/Platform.h"
 #include "lldb/Target/Process.h"
@@ -42,6 +45,7 @@
 #include "lldb/Utility/StringExtractor.h"
 
 #include "Plugins/Process/POSIX/ProcessPOSIXLog.h"
+#include "ElfCoreWriter.h"
 #include "NativeThreadLinux.h"
 #include "ProcFileReader.h"
 #include "Procfs.h"
@@ -428,7 +432,12 @@ NativeProcessLinux::NativeProcessLinux () :
     m_supports_mem_region (eLazyBoolCalculate),
     m_mem_region_cache (),
     m_mem_region_cache_mutex(),
-    m_pending_notification_tid(LLDB_INVALID_THREAD_ID)
+    m_mem_region_maps_sp (),
+    m_mem_region_generation (0),
+    m_mem_region_cache_stale (false),
+    m_pending_notification_tid(LLDB_INVALID_THREAD_ID),
+    m_stop_request_time(),
+    m_stop_request_count(0)
 {
 }
 
@@ -1454,7 +1463,15 @@ NativeProcessLinux::MonitorSignal(const siginfo_t &info, NativeThreadLinux &thre
             // case of an asynchronous Interrupt(), this *is* the real stop reason, so we
             // leave the signal intact if this is the thread that was chosen as the
             // triggering thread.
-            if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID)
+            //
+            // In non-stop mode we never stop threads on behalf of another one, so a
+            // SIGSTOP from us is always an explicit request to stop this thread.
+            if (m_non_stop_mode)
+            {
+                thread.SetStoppedBySignal(SIGSTOP, &info);
+                ReportThreadStop(thread.GetID());
+            }
+            else if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID)
             {
                 if (m_pending_notification_tid == thread.GetID())
                     thread.SetStoppedBySignal(SIGSTOP, &info);
@@ -1713,6 +1730,7 @@ NativeProcessLinux::Resume (const ResumeActionList &resume_actions)
     bool software_single_step = !SupportHardwareSingleStepping();
 
     Mutex::Locker locker (m_threads_mutex);
+    Error error;
 
     if (software_single_step)
     {
@@ -1724,11 +1742,11 @@ NativeProcessLinux::Resume (const ResumeActionList &resume_actions)
             if (action == nullptr)
                 continue;
 
-            if (action->state == eStateStepping)
+            if (action->state == eStateStepping && !StateIsRunningState(thread_sp->GetState()))
             {
-                Error error = SetupSoftwareSingleStepping(static_cast<NativeThreadLinux &>(*thread_sp));
-                if (error.Fail())
-                    return error;
+                Error step_error = SetupSoftwareSingleStepping(static_cast<NativeThreadLinux &>(*thread_sp));
+                if (step_error.Fail())
+                    return step_error;
             }
         }
     }
@@ -1758,14 +1776,39 @@ NativeProcessLinux::Resume (const ResumeActionList &resume_actions)
         case eStateRunning:
         case eStateStepping:
         {
+            // In non-stop mode, the actions for a thread that is already
+            // running (vCont;c with no thread id) leave it alone.
+            if (StateIsRunningState(thread_sp->GetState()))
+            {
+                if (log)
+                    log->Printf ("NativeProcessLinux::%s pid %" PRIu64 " tid %" PRIu64 " is already running",
+                            __FUNCTION__, GetID (), thread_sp->GetID ());
+                break;
+            }
+
             // Run the thread, possibly feeding it the signal.
             const int signo = action->signal;
-            ResumeThread(static_cast<NativeThreadLinux &>(*thread_sp), action->state, signo);
+            Error resume_error = ResumeThread(static_cast<NativeThreadLinux &>(*thread_sp), action->state, signo);
+            if (resume_error.Fail())
+            {
+                if (log)
+                    log->Printf ("NativeProcessLinux::%s failed to resume pid %" PRIu64 " tid %" PRIu64 ": %s",
+                            __FUNCTION__, GetID (), thread_sp->GetID (), resume_error.AsCString ());
+                // Save the error, but still resume the other threads.
+                error = resume_error;
+            }
             break;
         }
 
         case eStateSuspended:
         case eStateStopped:
+            // Only non-stop mode lets a client stop individual threads (vCont;t).
+            if (action->state == eStateStopped && m_non_stop_mode)
+            {
+                if (StateIsRunningState(thread_sp->GetState()))
+                    static_pointer_cast<NativeThreadLinux>(thread_sp)->RequestStop();
+                break;
+            }
             lldbassert(0 && "Unexpected state");
 
         default:
@@ -1774,7 +1817,7 @@ NativeProcessLinux::Resume (const ResumeActionList &resume_actions)
         }
     }
 
-    return Error();
+    return error;
 }
 
 Error
@@ -1835,12 +1878,27 @@ NativeProcessLinux::Interrupt ()
 
     NativeThreadProtocolSP running_thread_sp;
     NativeThreadProtocolSP stopped_thread_sp;
-        
-    if (log)
-        log->Printf ("NativeProcessLinux::%s selecting running thread for interrupt target", __FUNCTION__);
 
     Mutex::Locker locker (m_threads_mutex);
 
+    if (m_non_stop_mode)
+    {
+        // There is no single stop-reason thread in non-stop mode: every running
+        // thread is asked to stop and reports its own SIGSTOP.
+        if (log)
+            log->Printf ("NativeProcessLinux::%s requesting a stop of all running threads", __FUNCTION__);
+
+        for (const auto &thread_sp: m_threads)
+        {
+            if (StateIsRunningState(thread_sp->GetState()))
+                static_pointer_cast<NativeThreadLinux>(thread_sp)->RequestStop();
+        }
+        return Error();
+    }
+
+    if (log)
+        log->Printf ("NativeProcessLinux::%s selecting running thread for interrupt target", __FUNCTION__);
+
     for (auto thread_sp : m_threads)
     {
         // The thread shouldn't be null but lets just cover that here.
@@ -1993,108 +2051,116 @@ ParseMemoryRegionInfoFromProcMapsLine (const std::string &maps_line, MemoryRegio
 }
 
 Error
-NativeProcessLinux::GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegionInfo &range_info)
+NativeProcessLinux::PopulateMemoryRegionCache ()
 {
-    // FIXME review that the final memory region returned extends to the end of the virtual address space,
-    // with no perms if it is not mapped.
-
-    // Use an approach that reads memory regions from /proc/{pid}/maps.
-    // Assume proc maps entries are in ascending order.
-    // FIXME assert if we find differently.
-    Mutex::Locker locker (m_mem_region_cache_mutex);
-
     Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
-    Error error;
 
     if (m_supports_mem_region == LazyBool::eLazyBoolNo)
+        return Error ("unsupported");
+
+    if (!m_mem_region_cache_stale && !m_mem_region_cache.empty ())
     {
-        // We're done.
-        error.SetErrorString ("unsupported");
-        return error;
+        if (log)
+            log->Printf ("NativeProcessLinux::%s reusing %" PRIu64 " cached memory region entries", __FUNCTION__, static_cast<uint64_t> (m_mem_region_cache.size ()));
+        return Error ();
     }
 
-    // If our cache is empty, pull the latest.  There should always be at least one memory region
-    // if memory region handling is supported.
-    if (m_mem_region_cache.empty ())
-    {
-        error = ProcFileReader::ProcessLineByLine (GetID (), "maps",
-             [&] (const std::string &line) -> bool
-             {
-                 MemoryRegionInfo info;
-                 const Error parse_error = ParseMemoryRegionInfoFromProcMapsLine (line, info);
-                 if (parse_error.Success ())
-                 {
-                     m_mem_region_cache.push_back (info);
-                     return true;
-                 }
-                 else
-                 {
-                     if (log)
-                         log->Printf ("NativeProcessLinux::%s failed to parse proc maps line '%s': %s", __FUNCTION__, line.c_str (), error.AsCString ());
-                     return false;
-                 }
-             });
-
-        // If we had an error, we'll mark unsupported.
-        if (error.Fail ())
-        {
-            m_supports_mem_region = LazyBool::eLazyBoolNo;
-            return error;
-        }
-        else if (m_mem_region_cache.empty ())
+    // Most stops don't map or unmap anything.  procfs doesn't keep a
+    // modification time for /proc/{pid}/maps that we could check, so compare
+    // the text with the one the cache came from and only parse it again,
+    // and bump the generation, when it differs.
+    DataBufferSP maps_sp = ProcFileReader::ReadIntoDataBuffer (GetID (), "maps");
+    m_mem_region_cache_stale = false;
+    if (m_mem_region_maps_sp && !m_mem_region_cache.empty () &&
+        maps_sp->GetByteSize () == m_mem_region_maps_sp->GetByteSize () &&
+        ::memcmp (maps_sp->GetBytes (), m_mem_region_maps_sp->GetBytes (), maps_sp->GetByteSize ()) == 0)
+    {
+        if (log)
+            log->Printf ("NativeProcessLinux::%s /proc/%" PRIu64 "/maps is unchanged, keeping %" PRIu64 " cached memory region entries", __FUNCTION__, GetID (), static_cast<uint64_t> (m_mem_region_cache.size ()));
+        return Error ();
+    }
+
+    std::vector<MemoryRegionInfo> regions;
+    const char *maps = reinterpret_cast<const char *> (maps_sp->GetBytes ());
+    const size_t maps_size = maps_sp->GetByteSize ();
+    size_t line_start = 0;
+    while (line_start < maps_size && maps[line_start] != '\0')
+    {
+        const char *line_end = static_cast<const char *> (::memchr (maps + line_start, '\n', maps_size - line_start));
+        const size_t line_len = line_end ? line_end - (maps + line_start) : maps_size - line_start;
+        const std::string line (maps + line_start, line_len);
+        line_start += line_len + 1;
+
+        MemoryRegionInfo info;
+        const Error parse_error = ParseMemoryRegionInfoFromProcMapsLine (line, info);
+        if (parse_error.Fail ())
         {
-            // No entries after attempting to read them.  This shouldn't happen if /proc/{pid}/maps
-            // is supported.  Assume we don't support map entries via procfs.
             if (log)
-                log->Printf ("NativeProcessLinux::%s failed to find any procfs maps entries, assuming no support for memory region metadata retrieval", __FUNCTION__);
-            m_supports_mem_region = LazyBool::eLazyBoolNo;
-            error.SetErrorString ("not supported");
-            return error;
+                log->Printf ("NativeProcessLinux::%s failed to parse proc maps line '%s': %s", __FUNCTION__, line.c_str (), parse_error.AsCString ());
+            break;
         }
-
-        if (log)
-            log->Printf ("NativeProcessLinux::%s read %" PRIu64 " memory region entries from /proc/%" PRIu64 "/maps", __FUNCTION__, static_cast<uint64_t> (m_mem_region_cache.size ()), GetID ());
-
-        // We support memory retrieval, remember that.
-        m_supports_mem_region = LazyBool::eLazyBoolYes;
+        regions.push_back (info);
     }
-    else
+
+    if (regions.empty ())
     {
+        // No entries after attempting to read them.  This shouldn't happen if /proc/{pid}/maps
+        // is supported.  Assume we don't support map entries via procfs.
         if (log)
-            log->Printf ("NativeProcessLinux::%s reusing %" PRIu64 " cached memory region entries", __FUNCTION__, static_cast<uint64_t> (m_mem_region_cache.size ()));
+            log->Printf ("NativeProcessLinux::%s failed to find any procfs maps entries, assuming no support for memory region metadata retrieval", __FUNCTION__);
+        m_supports_mem_region = LazyBool::eLazyBoolNo;
+        return Error ("not supported");
     }
 
-    lldb::addr_t prev_base_address = 0;
+    m_mem_region_cache.swap (regions);
+    m_mem_region_maps_sp = maps_sp;
+    ++m_mem_region_generation;
 
-    // FIXME start by finding the last region that is <= target address using binary search.  Data is sorted.
-    // There can be a ton of regions on pthreads apps with lots of threads.
-    for (auto it = m_mem_region_cache.begin(); it != m_mem_region_cache.end (); ++it)
-    {
-        MemoryRegionInfo &proc_entry_info = *it;
+    if (log)
+        log->Printf ("NativeProcessLinux::%s read %" PRIu64 " memory region entries from /proc/%" PRIu64 "/maps, generation %" PRIu32, __FUNCTION__, static_cast<uint64_t> (m_mem_region_cache.size ()), GetID (), m_mem_region_generation);
 
-        // Sanity check assumption that /proc/{pid}/maps entries are ascending.
-        assert ((proc_entry_info.GetRange ().GetRangeBase () >= prev_base_address) && "descending /proc/pid/maps entries detected, unexpected");
-        prev_base_address = proc_entry_info.GetRange ().GetRangeBase ();
+    // We support memory retrieval, remember that.
+    m_supports_mem_region = LazyBool::eLazyBoolYes;
+    return Error ();
+}
 
-        // If the target address comes before this entry, indicate distance to next region.
-        if (load_addr < proc_entry_info.GetRange ().GetRangeBase ())
-        {
-            range_info.GetRange ().SetRangeBase (load_addr);
-            range_info.GetRange ().SetByteSize (proc_entry_info.GetRange ().GetRangeBase () - load_addr);
-            range_info.SetReadable (MemoryRegionInfo::OptionalBool::eNo);
-            range_info.SetWritable (MemoryRegionInfo::OptionalBool::eNo);
-            range_info.SetExecutable (MemoryRegionInfo::OptionalBool::eNo);
+Error
+NativeProcessLinux::GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegionInfo &range_info)
+{
+    // FIXME review that the final memory region returned extends to the end of the virtual address space,
+    // with no perms if it is not mapped.
 
-            return error;
-        }
-        else if (proc_entry_info.GetRange ().Contains (load_addr))
-        {
-            // The target address is within the memory region we're processing here.
-            range_info = proc_entry_info;
-            return error;
-        }
+    // Use an approach that reads memory regions from /proc/{pid}/maps.
+    // Assume proc maps entries are in ascending order.
+    Mutex::Locker locker (m_mem_region_cache_mutex);
 
-        // The target memory address comes somewhere after the region we just parsed.
+    Error error = PopulateMemoryRegionCache ();
+    if (error.Fail ())
+        return error;
+
+    // There can be a ton of regions on pthreads apps with lots of threads, so
+    // find the first region that starts after the address with a binary
+    // search.  Only the region before it can contain the address.
+    auto pos = std::upper_bound (m_mem_region_cache.begin (), m_mem_region_cache.end (), load_addr,
+                                 [] (lldb::addr_t addr, const MemoryRegionInfo &info) {
+                                     return addr < info.GetRange ().GetRangeBase ();
+                                 });
+    if (pos != m_mem_region_cache.begin () && std::prev (pos)->GetRange ().Contains (load_addr))
+    {
+        // The target address is within the memory region we're processing here.
+        range_info = *std::prev (pos);
+        return error;
+    }
+
+    if (pos != m_mem_region_cache.end ())
+    {
+        // The target address comes before this entry, indicate distance to next region.
+        range_info.GetRange ().SetRangeBase (load_addr);
+        range_info.GetRange ().SetByteSize (pos->GetRange ().GetRangeBase () - load_addr);
+        range_info.SetReadable (MemoryRegionInfo::OptionalBool::eNo);
+        range_info.SetWritable (MemoryRegionInfo::OptionalBool::eNo);
+        range_info.SetExecutable (MemoryRegionInfo::OptionalBool::eNo);
+        return error;
     }
 
     // If we made it here, we didn't find an entry that contained the given address. Return the
@@ -2119,6 +2185,20 @@ NativeProcessLinux::GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegionInf
     return error;
 }
 
+Error
+NativeProcessLinux::GetMemoryRegions (std::vector<MemoryRegionInfo> &regions, uint32_t &generation)
+{
+    Mutex::Locker locker (m_mem_region_cache_mutex);
+
+    Error error = PopulateMemoryRegionCache ();
+    if (error.Success ())
+    {
+        regions = m_mem_region_cache;
+        generation = m_mem_region_generation;
+    }
+    return error;
+}
+
 void
 NativeProcessLinux::DoStopIDBumped (uint32_t newBumpId)
 {
@@ -2127,10 +2207,12 @@ NativeProcessLinux::DoStopIDBumped (uint32_t newBumpId)
         log->Printf ("NativeProcessLinux::%s(newBumpId=%" PRIu32 ") called", __FUNCTION__, newBumpId);
 
     {
+        // Keep the entries, they are checked against /proc/{pid}/maps the
+        // next time they are needed.
         Mutex::Locker locker (m_mem_region_cache_mutex);
         if (log)
-            log->Printf ("NativeProcessLinux::%s clearing %" PRIu64 " entries from the cache", __FUNCTION__, static_cast<uint64_t> (m_mem_region_cache.size ()));
-        m_mem_region_cache.clear ();
+            log->Printf ("NativeProcessLinux::%s marking %" PRIu64 " cached memory region entries stale", __FUNCTION__, static_cast<uint64_t> (m_mem_region_cache.size ()));
+        m_mem_region_cache_stale = true;
     }
 }
 
@@ -2537,6 +2619,14 @@ NativeProcessLinux::ReadMemory (lldb::addr_t addr, void *buf, size_t size, size_
     size_t remainder;
     long data;
 
+    lldb::tid_t tid;
+    Error tid_error = GetMemoryAccessThreadID(tid);
+    if (tid_error.Fail())
+    {
+        bytes_read = 0;
+        return tid_error;
+    }
+
     Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_ALL));
     if (log)
         ProcessPOSIXLog::IncNestLevel();
@@ -2545,7 +2635,7 @@ NativeProcessLinux::ReadMemory (lldb::addr_t addr, void *buf, size_t size, size_
 
     for (bytes_read = 0; bytes_read < size; bytes_read += remainder)
     {
-        Error error = NativeProcessLinux::PtraceWrapper(PTRACE_PEEKDATA, GetID(), (void*)addr, nullptr, 0, &data);
+        Error error = NativeProcessLinux::PtraceWrapper(PTRACE_PEEKDATA, tid, (void*)addr, nullptr, 0, &data);
         if (error.Fail())
         {
             if (log)
@@ -2580,6 +2670,39 @@ NativeProcessLinux::ReadMemory (lldb::addr_t addr, void *buf, size_t size, size_
     return Error();
 }
 
+Error
+NativeProcessLinux::GetMemoryAccessThreadID(lldb::tid_t &tid)
+{
+    tid = GetID();
+    if (!m_non_stop_mode)
+        return Error();
+
+    Mutex::Locker locker (m_threads_mutex);
+    NativeThreadProtocolSP main_thread_sp;
+    for (auto thread_sp : m_threads)
+    {
+        if (thread_sp->GetID() == GetID())
+        {
+            main_thread_sp = thread_sp;
+            break;
+        }
+    }
+    if (main_thread_sp && main_thread_sp->GetState() == eStateStopped)
+        return Error();
+
+    for (auto thread_sp : m_threads)
+    {
+        if (thread_sp->GetState() == eStateStopped)
+        {
+            tid = thread_sp->GetID();
+            return Error();
+        }
+    }
+
+    tid = LLDB_INVALID_THREAD_ID;
+    return Error("no stopped thread to access the memory of process %" PRIu64 " through", GetID());
+}
+
 Error
 NativeProcessLinux::ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf, size_t size, size_t &bytes_read)
 {
@@ -2593,7 +2716,12 @@ NativeProcessLinux::WriteMemory(lldb::addr_t addr, const void *buf, size_t size,
 {
     const unsigned char *src = static_cast<const unsigned char*>(buf);
     size_t remainder;
-    Error error;
+
+    bytes_written = 0;
+    lldb::tid_t tid;
+    Error error = GetMemoryAccessThreadID(tid);
+    if (error.Fail())
+        return error;
 
     Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_ALL));
     if (log)
@@ -2618,7 +2746,7 @@ NativeProcessLinux::WriteMemory(lldb::addr_t addr, const void *buf, size_t size,
                 log->Printf ("NativeProcessLinux::%s() [%p]:0x%lx (0x%lx)", __FUNCTION__,
                         (void*)addr, *(const unsigned long*)src, data);
 
-            error = NativeProcessLinux::PtraceWrapper(PTRACE_POKEDATA, GetID(), (void*)addr, (void*)data);
+            error = NativeProcessLinux::PtraceWrapper(PTRACE_POKEDATA, tid, (void*)addr, (void*)data);
             if (error.Fail())
             {
                 if (log)
@@ -2921,6 +3049,25 @@ NativeProcessLinux::GetFileLoadAddress(const llvm::StringRef& file_name, lldb::a
     return error; 
 }
 
+Error
+NativeProcessLinux::SaveCore (const std::string &core_path, bool skip_file_backed)
+{
+#if defined(__ANDROID__)
+    return Error ("saving core files is not supported on Android");
+#else
+    if (GetState () != eStateStopped)
+        return Error ("process must be stopped to save a core file");
+    // The core file is written with the host's ELF class, machine type and
+    // note layouts.
+    const ArchSpec &host_arch = HostInfo::GetArchitecture ();
+    if (m_arch.GetMachine () != host_arch.GetMachine ())
+        return Error ("saving core files of %s processes is not supported by a %s lldb-server",
+                      m_arch.GetArchitectureName (),
+                      host_arch.GetArchitectureName ());
+    return ElfCoreWriter (*this).Write (core_path, skip_file_backed);
+#endif
+}
+
 NativeThreadLinuxSP
 NativeProcessLinux::GetThreadByID(lldb::tid_t tid)
 {
@@ -2986,14 +3133,34 @@ NativeProcessLinux::StopRunningThreads(const lldb::tid_t triggering_tid)
                 __FUNCTION__, triggering_tid);
     }
 
+    if (m_non_stop_mode)
+    {
+        // Leave the other threads alone and report just this one.
+        ReportThreadStop(triggering_tid);
+        return;
+    }
+
     m_pending_notification_tid = triggering_tid;
+    m_stop_request_time = std::chrono::steady_clock::now();
+    m_stop_request_count = 0;
 
     // Request a stop for all the thread stops that need to be stopped
     // and are not already known to be stopped.
     for (const auto &thread_sp: m_threads)
     {
         if (StateIsRunningState(thread_sp->GetState()))
+        {
             static_pointer_cast<NativeThreadLinux>(thread_sp)->RequestStop();
+            ++m_stop_request_count;
+        }
+    }
+
+    if (log)
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - m_stop_request_time;
+        log->Printf("NativeProcessLinux::%s requested stop of %zu of %zu threads in %" PRIu64 " us",
+                __FUNCTION__, m_stop_request_count, m_threads.size(),
+                static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
     }
 
     SignalIfAllThreadsStopped();
@@ -3019,6 +3186,15 @@ NativeProcessLinux::SignalIfAllThreadsStopped()
     // We have a pending notification and all threads have stopped.
     Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
 
+    if (log)
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - m_stop_request_time;
+        log->Printf("NativeProcessLinux::%s pid %" PRIu64 " all threads stopped %" PRIu64 " us after stopping %zu threads",
+                __FUNCTION__, GetID(),
+                static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()),
+                m_stop_request_count);
+    }
+
     // Clear any temporary breakpoints we used to implement software single stepping.
     for (const auto &thread_info: m_threads_stepping_with_breakpoint)
     {
@@ -3036,6 +3212,44 @@ NativeProcessLinux::SignalIfAllThreadsStopped()
     m_pending_notification_tid = LLDB_INVALID_THREAD_ID;
 }
 
+void
+NativeProcessLinux::ReportThreadStop(lldb::tid_t tid)
+{
+    Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+
+    // Clear the temporary breakpoint used to implement software single stepping
+    // for this thread, if any.  Other threads may still be stepping.
+    const auto stepping_pos = m_threads_stepping_with_breakpoint.find(tid);
+    if (stepping_pos != m_threads_stepping_with_breakpoint.end())
+    {
+        Error error = RemoveBreakpoint (stepping_pos->second);
+        if (error.Fail())
+            if (log)
+                log->Printf("NativeProcessLinux::%s() pid = %" PRIu64 " remove stepping breakpoint: %s",
+                        __FUNCTION__, tid, error.AsCString());
+        m_threads_stepping_with_breakpoint.erase(stepping_pos);
+    }
+
+    SetCurrentThreadID(tid);
+    NotifyThreadStopped(tid);
+}
+
+Error
+NativeProcessLinux::SetNonStopMode(bool enable)
+{
+    Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_PROCESS));
+    if (log)
+        log->Printf("NativeProcessLinux::%s pid %" PRIu64 " %s non-stop mode",
+                __FUNCTION__, GetID(), enable ? "enabling" : "disabling");
+
+    Mutex::Locker locker (m_threads_mutex);
+    if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID)
+        return Error("cannot change non-stop mode while a stop is pending");
+
+    m_non_stop_mode = enable;
+    return Error();
+}
+
 void
 NativeProcessLinux::ThreadWasCreated(NativeThreadLinux &thread)
 {
@@ -11,6 +11,7 @@
 #define liblldb_NativeProcessLinux_H_
 
 // C++ Includes
+#include <chrono>
 #include <unordered_set>
 
 // Other libraries and framework includes
@@ -71,12 +72,18 @@ namespace process_linux {
         Error
         Interrupt () override;
 
+        Error
+        SetNonStopMode (bool enable) override;
+
         Error
         Kill () override;
 
         Error
         GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegionInfo &range_info) override;
 
+        Error
+        GetMemoryRegions (std::vector<MemoryRegionInfo> &regions, uint32_t &generation) override;
+
         Error
         ReadMemory(lldb::addr_t addr, void *buf, size_t size, size_t &bytes_read) override;
 
@@ -113,6 +120,9 @@ namespace process_linux {
         Error
         GetFileLoadAddress(const llvm::StringRef& file_name, lldb::addr_t& load_addr) override;
 
+        Error
+        SaveCore (const std::string &core_path, bool skip_file_backed) override;
+
         NativeThreadLinuxSP
         GetThreadByID(lldb::tid_t id);
 
@@ -139,15 +149,27 @@ namespace process_linux {
 
     private:
 
+        // Must be called with m_mem_region_cache_mutex locked.
+        Error
+        PopulateMemoryRegionCache ();
+
         MainLoop::SignalHandleUP m_sigchld_handle;
         ArchSpec m_arch;
 
         LazyBool m_supports_mem_region;
         std::vector<MemoryRegionInfo> m_mem_region_cache;
         Mutex m_mem_region_cache_mutex;
+        lldb::DataBufferSP m_mem_region_maps_sp;    // The /proc/{pid}/maps text m_mem_region_cache was parsed from
+        uint32_t m_mem_region_generation;           // Bumped whenever m_mem_region_cache changes
+        bool m_mem_region_cache_stale;              // Set when the process stops, the maps may have changed
 
         lldb::tid_t m_pending_notification_tid;
 
+        // Stop latency instrumentation: when StopRunningThreads() started the
+        // current all-stop and how many threads it had to interrupt.
+        std::chrono::steady_clock::time_point m_stop_request_time;
+        size_t m_stop_request_count;
+
         // List of thread ids stepping with a breakpoint with the address of
         // the relevan breakpoint
         std::map<lldb::tid_t, lldb::addr_t> m_threads_stepping_with_breakpoint;
@@ -291,6 +313,12 @@ namespace process_linux {
         Error
         Detach(lldb::tid_t tid);
 
+        // ptrace() memory requests have to go through a thread in a ptrace
+        // stop.  That is the process's main thread, unless in non-stop mode
+        // it is running, in which case any other stopped thread will do.
+        Error
+        GetMemoryAccessThreadID(lldb::tid_t &tid);
+
 
         // This method is requests a stop on all threads which are still running. It sets up a
         // deferred delegate notification, which will fire once threads report as stopped. The
@@ -301,6 +329,11 @@ namespace process_linux {
         // Notify the delegate if all threads have stopped.
         void SignalIfAllThreadsStopped();
 
+        // In non-stop mode, report the stop of a single thread to the delegate
+        // without touching any of the other threads.
+        void
+        ReportThreadStop(lldb::tid_t tid);
+
         // Resume the given thread, optionally passing it the given signal. The type of resume
         // operation (continue, single-step) depends on the state parameter.
         Error
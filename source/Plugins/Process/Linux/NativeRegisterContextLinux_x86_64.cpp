@@ -369,7 +369,8 @@ NativeRegisterContextLinux_x86_64::NativeRegisterContextLinux_x86_64 (const Arch
     m_iovec (),
     m_ymm_set (),
     m_reg_info (),
-    m_gpr_x86_64 ()
+    m_gpr_x86_64 (),
+    m_gpr_valid (false)
 {
     // Set up data about ranges of valid registers.
     switch (target_arch.GetMachine ())
@@ -682,6 +683,51 @@ NativeRegisterContextLinux_x86_64::WriteRegister (const RegisterInfo *reg_info,
     return Error ("failed - register wasn't recognized to be a GPR or an FPR, write strategy unknown");
 }
 
+void
+NativeRegisterContextLinux_x86_64::InvalidateAllRegisters ()
+{
+    m_gpr_valid = false;
+}
+
+Error
+NativeRegisterContextLinux_x86_64::ReadRegisterRaw(uint32_t reg_index, RegisterValue &reg_value)
+{
+    // A stop reply or jThreadsInfo expedites a dozen or more general purpose
+    // registers per thread.  Fetch the whole GPR block with one PTRACE_GETREGS
+    // instead of issuing a PTRACE_PEEKUSER for every one of them.  The GPR area
+    // is at the start of the user area on x86_64, so the byte offsets match.
+    const RegisterInfo *const reg_info = GetRegisterInfoAtIndex(reg_index);
+    if (reg_info &&
+        GetRegisterInfoInterface().GetTargetArchitecture().GetMachine() == llvm::Triple::x86_64 &&
+        reg_info->byte_offset + sizeof(uint64_t) <= GetGPRSize())
+    {
+        if (!m_gpr_valid)
+            m_gpr_valid = ReadGPR().Success();
+
+        if (m_gpr_valid)
+        {
+            uint64_t value;
+            ::memcpy (&value, reinterpret_cast<const uint8_t *>(m_gpr_x86_64) + reg_info->byte_offset, sizeof(value));
+            reg_value.SetUInt64(value);
+            return Error();
+        }
+    }
+
+    return NativeRegisterContextLinux::ReadRegisterRaw(reg_index, reg_value);
+}
+
+Error
+NativeRegisterContextLinux_x86_64::WriteRegisterRaw(uint32_t reg_index, const RegisterValue &reg_value)
+{
+    // Writing a sub-register like eax or ah makes the base class read the
+    // full register first, which goes through ReadRegisterRaw above and
+    // refills the cache with the value from before the write.  Drop the
+    // cache only once the write is done, whether or not it worked.
+    Error error = NativeRegisterContextLinux::WriteRegisterRaw(reg_index, reg_value);
+    m_gpr_valid = false;
+    return error;
+}
+
 Error
 NativeRegisterContextLinux_x86_64::ReadAllRegisterValues (lldb::DataBufferSP &data_sp)
 {
@@ -777,6 +823,7 @@ NativeRegisterContextLinux_x86_64::WriteAllRegisterValues (const lldb::DataBuffe
         error.SetErrorStringWithFormat ("NativeRegisterContextLinux_x86_64::%s DataBuffer::GetBytes() returned a null pointer", __FUNCTION__);
         return error;
     }
+    m_gpr_valid = false;
     ::memcpy (&m_gpr_x86_64, src, GetRegisterInfoInterface ().GetGPRSize ());
 
     error = WriteGPR();
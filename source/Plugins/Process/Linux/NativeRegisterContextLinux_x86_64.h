@@ -49,6 +49,9 @@ namespace process_linux {
         Error
         WriteAllRegisterValues (const lldb::DataBufferSP &data_sp) override;
 
+        void
+        InvalidateAllRegisters () override;
+
         Error
         IsWatchpointHit(uint32_t wp_index, bool &is_hit) override;
 
@@ -79,6 +82,12 @@ namespace process_linux {
         NumSupportedHardwareWatchpoints() override;
 
     protected:
+        Error
+        ReadRegisterRaw(uint32_t reg_index, RegisterValue &reg_value) override;
+
+        Error
+        WriteRegisterRaw(uint32_t reg_index, const RegisterValue &reg_value) override;
+
         void*
         GetGPRBuffer() override { return &m_gpr_x86_64; }
 
@@ -136,6 +145,7 @@ namespace process_linux {
         YMM m_ymm_set;
         RegInfo m_reg_info;
         uint64_t m_gpr_x86_64[k_num_gpr_registers_x86_64];
+        bool m_gpr_valid; // m_gpr_x86_64 holds the registers of the stopped thread
         uint32_t m_fctrl_offset_in_userarea;
 
         // Private member methods.
@@ -211,6 +211,9 @@ NativeThreadLinux::Resume(uint32_t signo)
     m_stop_info.reason = StopReason::eStopReasonNone;
     m_stop_description.clear();
 
+    if (m_reg_context_sp)
+        m_reg_context_sp->InvalidateAllRegisters();
+
     // If watchpoints have been set, but none on this thread,
     // then this is a new thread. So set all existing watchpoints.
     if (m_watchpoint_index_map.empty())
@@ -290,6 +293,9 @@ NativeThreadLinux::SingleStep(uint32_t signo)
     m_state = new_state;
     m_stop_info.reason = StopReason::eStopReasonNone;
 
+    if (m_reg_context_sp)
+        m_reg_context_sp->InvalidateAllRegisters();
+
     MaybePrepareSingleStepWorkaround();
 
     intptr_t data = 0;
@@ -361,6 +367,10 @@ NativeThreadLinux::SetStopped()
     MaybeLogStateChange(new_state);
     m_state = new_state;
     m_stop_description.clear();
+
+    // The thread ran since the registers were last read.
+    if (m_reg_context_sp)
+        m_reg_context_sp->InvalidateAllRegisters();
 }
 
 void
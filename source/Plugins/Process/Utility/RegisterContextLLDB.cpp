@@ -1091,6 +1091,45 @@ RegisterContextLLDB::ReadRegisterValueFromRegisterLocation (lldb_private::Unwind
     return success;
 }
 
+// Saved registers and dereferenced CFAs live on the stack, so read them
+// through UnwindLLDB which can serve them from its bulk stack snapshot
+// instead of sending one memory read per register to the process.
+Error
+RegisterContextLLDB::ReadRegisterValueFromMemory (const RegisterInfo *reg_info,
+                                                  addr_t src_addr,
+                                                  uint32_t src_len,
+                                                  RegisterValue &reg_value)
+{
+    Error error;
+    if (reg_info == nullptr)
+    {
+        error.SetErrorString ("invalid register info argument.");
+        return error;
+    }
+
+    if (src_len > RegisterValue::kMaxRegisterByteSize || src_len > reg_info->byte_size)
+        return RegisterContext::ReadRegisterValueFromMemory (reg_info, src_addr, src_len, reg_value);
+
+    ProcessSP process_sp (m_thread.GetProcess());
+    if (!process_sp)
+    {
+        error.SetErrorString ("invalid process");
+        return error;
+    }
+
+    uint8_t src[RegisterValue::kMaxRegisterByteSize];
+    const size_t bytes_read = m_parent_unwind.ReadStackMemory (src_addr, src, src_len, error);
+    if (bytes_read != src_len)
+    {
+        if (error.Success())
+            error.SetErrorStringWithFormat ("read %u of %u bytes", (uint32_t)bytes_read, src_len);
+        return error;
+    }
+
+    reg_value.SetFromMemoryData (reg_info, src, src_len, process_sp->GetByteOrder(), error);
+    return error;
+}
+
 bool
 RegisterContextLLDB::WriteRegisterValueToRegisterLocation (lldb_private::UnwindLLDB::RegisterLocation regloc,
                                                            const RegisterInfo *reg_info,
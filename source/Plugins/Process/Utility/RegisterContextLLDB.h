@@ -71,6 +71,12 @@ public:
     uint32_t
     ConvertRegisterKindToRegisterNumber(lldb::RegisterKind kind, uint32_t num) override;
 
+    lldb_private::Error
+    ReadRegisterValueFromMemory(const lldb_private::RegisterInfo *reg_info,
+                                lldb::addr_t src_addr,
+                                uint32_t src_len,
+                                lldb_private::RegisterValue &reg_value) override;
+
     bool
     IsValid () const;
 
@@ -7,12 +7,16 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+
+#include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Symbol/FuncUnwinders.h"
 #include "lldb/Symbol/Function.h"
 #include "lldb/Symbol/UnwindPlan.h"
 #include "lldb/Target/ABI.h"
+#include "lldb/Target/MemoryRegionInfo.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Process.h"
@@ -28,7 +32,13 @@ UnwindLLDB::UnwindLLDB (Thread &thread) :
     Unwind (thread),
     m_frames(),
     m_unwind_complete(false),
-    m_user_supplied_trap_handler_functions()
+    m_user_supplied_trap_handler_functions(),
+    m_stack_snapshot_sp(),
+    m_stack_snapshot_addr(LLDB_INVALID_ADDRESS),
+    m_stack_snapshot_limit(0),
+    m_stack_snapshot_stop_id(UINT32_MAX),
+    m_stack_snapshot_memory_id(UINT32_MAX),
+    m_stack_snapshot_attempted(false)
 {
     ProcessSP process_sp(thread.GetProcess());
     if (process_sp)
@@ -533,3 +543,127 @@ UnwindLLDB::SearchForSavedLocationForRegister (uint32_t lldb_regnum, lldb_privat
     }
     return false;
 }
+
+// Most backtraces only need the few frames nearest the stack pointer, so
+// the snapshot starts out this size and only grows when a frame needs more.
+static const uint64_t g_initial_stack_snapshot_size = 4 * 1024;
+
+void
+UnwindLLDB::TakeStackSnapshot (Process &process)
+{
+    m_stack_snapshot_attempted = true;
+    m_stack_snapshot_stop_id = process.GetModIDRef().GetStopID();
+    m_stack_snapshot_memory_id = process.GetModIDRef().GetMemoryID();
+
+    const uint64_t max_snapshot_size = process.GetUnwindStackSnapshotSize();
+    if (max_snapshot_size == 0)
+        return;
+
+    RegisterContextSP reg_ctx_sp (m_thread.GetRegisterContext());
+    if (!reg_ctx_sp)
+        return;
+    const addr_t sp = reg_ctx_sp->GetSP (LLDB_INVALID_ADDRESS);
+    if (sp == LLDB_INVALID_ADDRESS || sp == 0)
+        return;
+
+    // Stacks grow down on every architecture we unwind, so all of the
+    // caller's saved registers and CFAs live above the current stack
+    // pointer.  Don't read past the end of the region the stack pointer is
+    // in, that would make the whole bulk read fail on most process plug-ins.
+    uint64_t snapshot_limit = max_snapshot_size;
+    MemoryRegionInfo region_info;
+    if (process.GetMemoryRegionInfo (sp, region_info).Success() &&
+        region_info.GetRange().Contains (sp))
+    {
+        if (region_info.GetReadable() == MemoryRegionInfo::eNo)
+            return;
+        snapshot_limit = std::min<uint64_t> (snapshot_limit, region_info.GetRange().GetRangeEnd() - sp);
+    }
+    if (snapshot_limit == 0)
+        return;
+
+    m_stack_snapshot_sp.reset (new DataBufferHeap ());
+    m_stack_snapshot_addr = sp;
+    m_stack_snapshot_limit = snapshot_limit;
+    if (!GrowStackSnapshot (process, sp + std::min<uint64_t> (g_initial_stack_snapshot_size, snapshot_limit)))
+    {
+        m_stack_snapshot_sp.reset();
+        m_stack_snapshot_addr = LLDB_INVALID_ADDRESS;
+        m_stack_snapshot_limit = 0;
+    }
+}
+
+bool
+UnwindLLDB::GrowStackSnapshot (Process &process, addr_t end_addr)
+{
+    DataBufferHeap *heap_buffer = static_cast<DataBufferHeap *>(m_stack_snapshot_sp.get());
+    const uint64_t old_size = heap_buffer->GetByteSize();
+    if (end_addr <= m_stack_snapshot_addr || end_addr - m_stack_snapshot_addr > m_stack_snapshot_limit)
+        return false;
+
+    // Grow at least twofold so that a deep backtrace only takes a handful
+    // of reads.
+    const uint64_t new_size = std::min<uint64_t> (std::max<uint64_t> (end_addr - m_stack_snapshot_addr, old_size * 2),
+                                                  m_stack_snapshot_limit);
+    if (new_size <= old_size)
+        return true;
+
+    heap_buffer->SetByteSize (new_size);
+    Error error;
+    const size_t bytes_read = process.ReadMemory (m_stack_snapshot_addr + old_size,
+                                                  heap_buffer->GetBytes() + old_size,
+                                                  new_size - old_size,
+                                                  error);
+    heap_buffer->SetByteSize (old_size + bytes_read);
+
+    Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
+    if (bytes_read < new_size - old_size)
+    {
+        // Whatever stopped this read would stop the next one too.
+        m_stack_snapshot_limit = old_size + bytes_read;
+        if (log)
+            log->Printf ("th%d unable to snapshot stack at 0x%" PRIx64 ": %s",
+                         m_thread.GetIndexID(), m_stack_snapshot_addr + old_size + bytes_read, error.AsCString("unknown error"));
+    }
+    else if (log)
+    {
+        log->Printf ("th%d snapshot of %" PRIu64 " stack bytes taken at 0x%" PRIx64,
+                     m_thread.GetIndexID(), (uint64_t)(old_size + bytes_read), m_stack_snapshot_addr);
+    }
+
+    return end_addr - m_stack_snapshot_addr <= heap_buffer->GetByteSize();
+}
+
+size_t
+UnwindLLDB::ReadStackMemory (addr_t addr, void *buf, size_t size, Error &error)
+{
+    ProcessSP process_sp (m_thread.GetProcess());
+    if (!process_sp)
+    {
+        error.SetErrorString ("invalid process");
+        return 0;
+    }
+
+    if (m_stack_snapshot_attempted &&
+        (m_stack_snapshot_stop_id != process_sp->GetModIDRef().GetStopID() ||
+         m_stack_snapshot_memory_id != process_sp->GetModIDRef().GetMemoryID()))
+        ClearStackSnapshot();
+
+    if (!m_stack_snapshot_attempted)
+        TakeStackSnapshot (*process_sp);
+
+    if (m_stack_snapshot_sp && addr >= m_stack_snapshot_addr && size <= m_stack_snapshot_limit)
+    {
+        const addr_t offset = addr - m_stack_snapshot_addr;
+        if (offset <= m_stack_snapshot_limit - size &&
+            (offset + size <= m_stack_snapshot_sp->GetByteSize() ||
+             GrowStackSnapshot (*process_sp, addr + size)))
+        {
+            ::memcpy (buf, m_stack_snapshot_sp->GetBytes() + offset, size);
+            error.Clear();
+            return size;
+        }
+    }
+
+    return process_sp->ReadMemory (addr, buf, size, error);
+}
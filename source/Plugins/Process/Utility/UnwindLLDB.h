@@ -70,6 +70,7 @@ protected:
         m_frames.clear();
         m_candidate_frame.reset();
         m_unwind_complete = false;
+        ClearStackSnapshot();
     }
 
     uint32_t
@@ -96,6 +97,25 @@ protected:
     SearchForSavedLocationForRegister (uint32_t lldb_regnum, lldb_private::UnwindLLDB::RegisterLocation &regloc, uint32_t starting_frame_num, bool pc_register);
 
 
+    //------------------------------------------------------------------
+    /// Read memory from the thread's stack on behalf of a
+    /// RegisterContextLLDB.
+    ///
+    /// The first read after the unwinder is cleared prefetches a few KB
+    /// of the stack from the thread's current stack pointer in one read.
+    /// A read past the end of that snapshot grows it, at least doubling
+    /// it, up to the end of the stack's memory region or the
+    /// "process.unwind-stack-snapshot-size" setting, whichever is closer.
+    /// Reads below the stack pointer or past that limit go to the
+    /// process.  The snapshot is dropped whenever the process stop or
+    /// memory ID changes, so writes to inferior memory are never hidden.
+    ///
+    /// @return
+    ///     The number of bytes read into \a buf.
+    //------------------------------------------------------------------
+    size_t
+    ReadStackMemory (lldb::addr_t addr, void *buf, size_t size, lldb_private::Error &error);
+
     //------------------------------------------------------------------
     /// Provide the list of user-specified trap handler functions
     ///
@@ -136,6 +156,32 @@ private:
  
     std::vector<ConstString> m_user_supplied_trap_handler_functions;
 
+    lldb::DataBufferSP m_stack_snapshot_sp;     // Bytes of the stack starting at m_stack_snapshot_addr
+    lldb::addr_t m_stack_snapshot_addr;         // The stack pointer when the snapshot was taken
+    uint64_t m_stack_snapshot_limit;            // How many bytes past m_stack_snapshot_addr the snapshot may grow to
+    uint32_t m_stack_snapshot_stop_id;          // Process stop ID the snapshot is valid for
+    uint32_t m_stack_snapshot_memory_id;        // Process memory ID the snapshot is valid for
+    bool m_stack_snapshot_attempted;            // True once we tried to take the snapshot for this stop
+
+    void
+    ClearStackSnapshot ()
+    {
+        m_stack_snapshot_sp.reset();
+        m_stack_snapshot_addr = LLDB_INVALID_ADDRESS;
+        m_stack_snapshot_limit = 0;
+        m_stack_snapshot_stop_id = UINT32_MAX;
+        m_stack_snapshot_memory_id = UINT32_MAX;
+        m_stack_snapshot_attempted = false;
+    }
+
+    void
+    TakeStackSnapshot (lldb_private::Process &process);
+
+    // Read more of the stack into the snapshot so that it covers the bytes
+    // up to end_addr.  Returns false if it can't.
+    bool
+    GrowStackSnapshot (lldb_private::Process &process, lldb::addr_t end_addr);
+
     //-----------------------------------------------------------------
     // Check if Full UnwindPlan of First frame is valid or not.
     // If not then try Fallback UnwindPlan of the frame. If Fallback
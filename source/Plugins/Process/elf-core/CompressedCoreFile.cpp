@@ -0,0 +1,401 @@
+//===-- CompressedCoreFile.cpp ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+
+// Other libraries and framework includes
+#include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Core/Log.h"
+#include "lldb/Host/FileSpec.h"
+
+#if defined (HAVE_LIBZ)
+#include <zlib.h>
+#endif
+
+// Project includes
+#include "CompressedCoreFile.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+
+// gzip member header layout, see RFC 1952.
+const uint8_t kGzipID1 = 0x1f;
+const uint8_t kGzipID2 = 0x8b;
+const uint8_t kGzipCMDeflate = 8;
+const uint8_t kGzipFlagExtra = 0x04;
+const size_t kGzipHeaderSize = 10;
+const size_t kGzipTrailerSize = 8;
+
+bool
+IsGzipHeader (const uint8_t *bytes)
+{
+    return bytes[0] == kGzipID1 && bytes[1] == kGzipID2 && bytes[2] == kGzipCMDeflate;
+}
+
+bool
+IsZeroFilled (const uint8_t *bytes, size_t length)
+{
+    return length == 0 || (bytes[0] == 0 && memcmp (bytes, bytes + 1, length - 1) == 0);
+}
+
+} // anonymous namespace
+
+bool
+CompressedCoreFile::IsCompressed (const FileSpec &file)
+{
+    uint8_t header[3];
+    Error error;
+    return file.ReadFileContents (0, header, sizeof(header), &error) == sizeof(header) && IsGzipHeader (header);
+}
+
+std::unique_ptr<CompressedCoreFile>
+CompressedCoreFile::Open (const FileSpec &file, Error &error)
+{
+    std::unique_ptr<CompressedCoreFile> core_file;
+#if defined (HAVE_LIBZ)
+    core_file.reset (new CompressedCoreFile (file));
+    error = core_file->m_file.Open (file.GetPath().c_str(), File::eOpenOptionRead | File::eOpenOptionCloseOnExec);
+    if (error.Success())
+        error = core_file->BuildIndex();
+    if (error.Fail())
+        core_file.reset();
+#else
+    error.SetErrorStringWithFormat ("can't read compressed core file %s, lldb was built without zlib",
+                                    file.GetPath().c_str());
+#endif
+    return core_file;
+}
+
+CompressedCoreFile::CompressedCoreFile (const FileSpec &file) :
+    m_file (),
+    m_file_size (file.GetByteSize()),
+    m_byte_size (0),
+    m_max_block_size (0),
+    m_blocks (),
+    m_mutex (Mutex::eMutexTypeNormal),
+    m_lru (),
+    m_cache (),
+    m_cache_byte_size (0),
+    m_zero_block_sp ()
+{
+}
+
+CompressedCoreFile::~CompressedCoreFile ()
+{
+}
+
+Error
+CompressedCoreFile::BuildIndex ()
+{
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+
+    Error error;
+    uint64_t file_offset = 0;
+    uint64_t data_offset = 0;
+    size_t num_scanned = 0;
+    while (file_offset < m_file_size)
+    {
+        uint8_t header[kGzipHeaderSize + 2];
+        size_t header_size = std::min<uint64_t> (sizeof(header), m_file_size - file_offset);
+        off_t read_offset = file_offset;
+        error = m_file.Read (header, header_size, read_offset);
+        if (error.Fail())
+            return error;
+        if (header_size < kGzipHeaderSize || !IsGzipHeader (header))
+        {
+            error.SetErrorStringWithFormat ("no gzip member at offset 0x%" PRIx64 " of the compressed core file", file_offset);
+            return error;
+        }
+
+        // bgzip stores the size of each member in a "BC" extra subfield.
+        uint32_t compressed_size = 0;
+        uint32_t data_size = 0;
+        if ((header[3] & kGzipFlagExtra) && header_size == sizeof(header))
+        {
+            const uint16_t xlen = header[10] | (header[11] << 8);
+            std::vector<uint8_t> extra (xlen);
+            size_t extra_size = xlen;
+            error = m_file.Read (extra.data(), extra_size, read_offset);
+            if (error.Fail())
+                return error;
+            for (size_t pos = 0; pos + 4 <= extra_size; )
+            {
+                const uint16_t slen = extra[pos + 2] | (extra[pos + 3] << 8);
+                if (extra[pos] == 'B' && extra[pos + 1] == 'C' && slen == 2 && pos + 6 <= extra_size)
+                {
+                    compressed_size = (extra[pos + 4] | (extra[pos + 5] << 8)) + 1;
+                    break;
+                }
+                pos += 4 + slen;
+            }
+        }
+
+        if (compressed_size >= kGzipHeaderSize + kGzipTrailerSize && file_offset + compressed_size <= m_file_size)
+        {
+            // ISIZE is the last field of the member.
+            uint8_t isize[4];
+            size_t isize_size = sizeof(isize);
+            read_offset = file_offset + compressed_size - sizeof(isize);
+            error = m_file.Read (isize, isize_size, read_offset);
+            if (error.Fail())
+                return error;
+            data_size = isize[0] | (isize[1] << 8) | (isize[2] << 16) | ((uint32_t)isize[3] << 24);
+        }
+        else
+        {
+            error = ScanMember (file_offset, compressed_size, data_size);
+            if (error.Fail())
+                return error;
+            ++num_scanned;
+        }
+
+        if (data_size > kMaxBlockSize)
+        {
+            error.SetErrorStringWithFormat ("gzip member at offset 0x%" PRIx64 " of the compressed core file is too big "
+                                            "for random access, recompress the core with bgzip",
+                                            file_offset);
+            return error;
+        }
+
+        // bgzip ends its files with an empty member.
+        if (data_size > 0)
+        {
+            Block block = { file_offset, compressed_size, data_offset, data_size, false };
+            m_blocks.push_back (block);
+            m_max_block_size = std::max (m_max_block_size, data_size);
+        }
+        file_offset += compressed_size;
+        data_offset += data_size;
+    }
+    m_byte_size = data_offset;
+
+    if (log)
+        log->Printf ("CompressedCoreFile::%s() %" PRIu64 " compressed bytes, %" PRIu64 " bytes in %" PRIu64 " blocks (%" PRIu64 " inflated to find their size)",
+                     __FUNCTION__,
+                     m_file_size,
+                     m_byte_size,
+                     (uint64_t)m_blocks.size(),
+                     (uint64_t)num_scanned);
+    return error;
+}
+
+Error
+CompressedCoreFile::ScanMember (uint64_t file_offset, uint32_t &compressed_size, uint32_t &data_size)
+{
+    Error error;
+#if defined (HAVE_LIBZ)
+    z_stream stream;
+    memset (&stream, 0, sizeof (z_stream));
+    if (inflateInit2 (&stream, 16 + MAX_WBITS) != Z_OK)
+    {
+        error.SetErrorString ("failed to initialize zlib");
+        return error;
+    }
+
+    std::vector<uint8_t> in (256 * 1024);
+    std::vector<uint8_t> out (256 * 1024);
+    off_t read_offset = file_offset;
+    int status = Z_OK;
+    while (status == Z_OK)
+    {
+        if (stream.avail_in == 0)
+        {
+            size_t in_size = std::min<uint64_t> (in.size(), m_file_size - read_offset);
+            if (in_size == 0)
+                break;
+            error = m_file.Read (in.data(), in_size, read_offset);
+            if (error.Fail() || in_size == 0)
+                break;
+            stream.next_in = in.data();
+            stream.avail_in = in_size;
+        }
+        stream.next_out = out.data();
+        stream.avail_out = out.size();
+        status = inflate (&stream, Z_NO_FLUSH);
+        // Don't inflate a whole single member core just to find out that
+        // it is too big.
+        if (stream.total_out > kMaxBlockSize)
+            break;
+    }
+
+    if (error.Success())
+    {
+        if (status == Z_STREAM_END)
+        {
+            compressed_size = stream.total_in;
+            data_size = stream.total_out;
+        }
+        else if (stream.total_out > kMaxBlockSize)
+        {
+            compressed_size = 0;
+            data_size = stream.total_out;
+        }
+        else
+        {
+            error.SetErrorStringWithFormat ("corrupt gzip member at offset 0x%" PRIx64 " of the compressed core file", file_offset);
+        }
+    }
+    inflateEnd (&stream);
+#else
+    error.SetErrorString ("lldb was built without zlib");
+#endif
+    return error;
+}
+
+Error
+CompressedCoreFile::InflateBlock (const Block &block, DataBufferSP &data_sp)
+{
+    Error error;
+#if defined (HAVE_LIBZ)
+    std::vector<uint8_t> in (block.compressed_size);
+    size_t in_size = in.size();
+    off_t read_offset = block.file_offset;
+    error = m_file.Read (in.data(), in_size, read_offset);
+    if (error.Fail())
+        return error;
+
+    DataBufferHeap *heap_ptr = new DataBufferHeap (block.data_size, 0);
+    data_sp.reset (heap_ptr);
+
+    z_stream stream;
+    memset (&stream, 0, sizeof (z_stream));
+    stream.next_in = in.data();
+    stream.avail_in = in_size;
+    stream.next_out = heap_ptr->GetBytes();
+    stream.avail_out = heap_ptr->GetByteSize();
+    if (inflateInit2 (&stream, 16 + MAX_WBITS) != Z_OK)
+    {
+        error.SetErrorString ("failed to initialize zlib");
+    }
+    else
+    {
+        const int status = inflate (&stream, Z_FINISH);
+        if (status != Z_STREAM_END || stream.total_out != block.data_size)
+            error.SetErrorStringWithFormat ("corrupt gzip member at offset 0x%" PRIx64 " of the compressed core file", block.file_offset);
+        inflateEnd (&stream);
+    }
+    if (error.Fail())
+        data_sp.reset();
+#else
+    error.SetErrorString ("lldb was built without zlib");
+#endif
+    return error;
+}
+
+uint32_t
+CompressedCoreFile::FindBlock (uint64_t offset) const
+{
+    if (offset >= m_byte_size)
+        return UINT32_MAX;
+    // Find the first block that starts after offset, the one before it
+    // contains it.
+    std::vector<Block>::const_iterator pos = std::upper_bound (m_blocks.begin(), m_blocks.end(), offset,
+                                                               [](uint64_t offset, const Block &block) {
+                                                                   return offset < block.data_offset;
+                                                               });
+    if (pos == m_blocks.begin())
+        return UINT32_MAX;
+    --pos;
+    if (offset >= pos->data_offset + pos->data_size)
+        return UINT32_MAX;
+    return pos - m_blocks.begin();
+}
+
+DataBufferSP
+CompressedCoreFile::GetBlockData (uint32_t block_idx, Error &error)
+{
+    Block &block = m_blocks[block_idx];
+    if (block.zero_filled)
+        return m_zero_block_sp;
+
+    BlockCache::iterator pos = m_cache.find (block_idx);
+    if (pos != m_cache.end())
+    {
+        m_lru.splice (m_lru.begin(), m_lru, pos->second.second);
+        return pos->second.first;
+    }
+
+    DataBufferSP data_sp;
+    error = InflateBlock (block, data_sp);
+    if (error.Fail())
+        return DataBufferSP();
+
+    if (IsZeroFilled (data_sp->GetBytes(), data_sp->GetByteSize()))
+    {
+        block.zero_filled = true;
+        if (!m_zero_block_sp)
+            m_zero_block_sp.reset (new DataBufferHeap (m_max_block_size, 0));
+        return m_zero_block_sp;
+    }
+
+    while (!m_lru.empty() && m_cache_byte_size + block.data_size > kMaxCacheByteSize)
+    {
+        BlockCache::iterator evict_pos = m_cache.find (m_lru.back());
+        m_cache_byte_size -= evict_pos->second.first->GetByteSize();
+        m_cache.erase (evict_pos);
+        m_lru.pop_back();
+    }
+    m_lru.push_front (block_idx);
+    m_cache[block_idx] = std::make_pair (data_sp, m_lru.begin());
+    m_cache_byte_size += block.data_size;
+    return data_sp;
+}
+
+size_t
+CompressedCoreFile::Read (uint64_t offset, void *dst, size_t length, Error &error)
+{
+    Mutex::Locker locker (m_mutex);
+
+    uint8_t *dst_bytes = (uint8_t *)dst;
+    size_t bytes_read = 0;
+    while (bytes_read < length)
+    {
+        const uint32_t block_idx = FindBlock (offset + bytes_read);
+        if (block_idx == UINT32_MAX)
+            break;
+        DataBufferSP data_sp = GetBlockData (block_idx, error);
+        if (!data_sp)
+            break;
+
+        const Block &block = m_blocks[block_idx];
+        const uint64_t block_offset = offset + bytes_read - block.data_offset;
+        const size_t curr_len = std::min<uint64_t> (length - bytes_read, block.data_size - block_offset);
+        memcpy (dst_bytes + bytes_read, data_sp->GetBytes() + block_offset, curr_len);
+        bytes_read += curr_len;
+    }
+    return bytes_read;
+}
+
+bool
+CompressedCoreFile::GetData (uint64_t offset, size_t length, DataExtractor &data)
+{
+    Mutex::Locker locker (m_mutex);
+
+    const uint32_t block_idx = FindBlock (offset);
+    if (block_idx == UINT32_MAX)
+        return false;
+    const Block &block = m_blocks[block_idx];
+    const uint64_t block_offset = offset - block.data_offset;
+    if (block_offset + length > block.data_size)
+        return false;
+
+    Error error;
+    DataBufferSP data_sp = GetBlockData (block_idx, error);
+    if (!data_sp)
+        return false;
+    return data.SetData (data_sp, block_offset, length) == length;
+}
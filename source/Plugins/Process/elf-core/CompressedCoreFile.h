@@ -0,0 +1,160 @@
+//===-- CompressedCoreFile.h ------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_CompressedCoreFile_h_
+#define liblldb_CompressedCoreFile_h_
+
+// C Includes
+// C++ Includes
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Host/File.h"
+#include "lldb/Host/Mutex.h"
+
+//----------------------------------------------------------------------
+/// @class CompressedCoreFile CompressedCoreFile.h
+/// @brief Random access to a gzip compressed core file.
+///
+/// The file must be a sequence of gzip members, each of them small
+/// enough to be decompressed on its own.  Files written by "bgzip" are
+/// the common case: their members carry their compressed size in a "BC"
+/// extra field, so the block index is built from the member headers
+/// alone.  Other multi-member files (e.g. "pigz --independent" output
+/// split into members) are indexed by inflating each member once.
+///
+/// Blocks are only decompressed when a read touches them and the most
+/// recently used ones are kept in a cache of bounded size.  Blocks that
+/// turn out to be all zeros, which is what the holes of a sparse core
+/// compress to, are remembered as such and never cached.
+//----------------------------------------------------------------------
+class CompressedCoreFile
+{
+public:
+    //------------------------------------------------------------------
+    /// @return
+    ///     True if \a file starts with a gzip header.
+    //------------------------------------------------------------------
+    static bool
+    IsCompressed (const lldb_private::FileSpec &file);
+
+    //------------------------------------------------------------------
+    /// Open \a file and build its block index.
+    ///
+    /// @return
+    ///     The reader, or NULL with \a error set if the file can't be
+    ///     opened, isn't made of independent gzip members, or lldb was
+    ///     built without zlib.
+    //------------------------------------------------------------------
+    static std::unique_ptr<CompressedCoreFile>
+    Open (const lldb_private::FileSpec &file, lldb_private::Error &error);
+
+    ~CompressedCoreFile();
+
+    //------------------------------------------------------------------
+    /// @return
+    ///     The size of the decompressed core file.
+    //------------------------------------------------------------------
+    uint64_t
+    GetByteSize () const
+    {
+        return m_byte_size;
+    }
+
+    size_t
+    GetNumBlocks () const
+    {
+        return m_blocks.size();
+    }
+
+    //------------------------------------------------------------------
+    /// Copy \a length decompressed bytes starting at \a offset into
+    /// \a dst.
+    ///
+    /// @return
+    ///     The number of bytes copied, which is less than \a length if
+    ///     the read runs past the end of the file or a block fails to
+    ///     decompress.
+    //------------------------------------------------------------------
+    size_t
+    Read (uint64_t offset, void *dst, size_t length, lldb_private::Error &error);
+
+    //------------------------------------------------------------------
+    /// Point \a data at \a length decompressed bytes starting at
+    /// \a offset without copying them, which works as long as the range
+    /// lies within one block.  The view keeps the block alive after it
+    /// is evicted from the cache.
+    ///
+    /// @return
+    ///     True if \a data was set.
+    //------------------------------------------------------------------
+    bool
+    GetData (uint64_t offset, size_t length, lldb_private::DataExtractor &data);
+
+protected:
+    struct Block
+    {
+        uint64_t file_offset;       // Offset of the gzip member in the compressed file
+        uint32_t compressed_size;   // Size of the whole gzip member
+        uint64_t data_offset;       // Offset of the member's contents in the core file
+        uint32_t data_size;         // Size of the member's contents
+        bool zero_filled;           // True once the contents were found to be all zeros
+    };
+
+    typedef std::list<uint32_t> BlockList;
+    typedef std::map<uint32_t, std::pair<lldb::DataBufferSP, BlockList::iterator> > BlockCache;
+
+    // Most bgzip blocks are 64KB, so this holds a thousand of them.
+    static const size_t kMaxCacheByteSize = 64 * 1024 * 1024;
+
+    // Members bigger than this can't be read a block at a time.
+    static const uint32_t kMaxBlockSize = 16 * 1024 * 1024;
+
+    CompressedCoreFile (const lldb_private::FileSpec &file);
+
+    lldb_private::Error
+    BuildIndex ();
+
+    lldb_private::Error
+    ScanMember (uint64_t file_offset, uint32_t &compressed_size, uint32_t &data_size);
+
+    lldb_private::Error
+    InflateBlock (const Block &block, lldb::DataBufferSP &data_sp);
+
+    // Returns the index of the block containing \a offset, or UINT32_MAX.
+    uint32_t
+    FindBlock (uint64_t offset) const;
+
+    // Returns the contents of block \a block_idx, or the zero block if it
+    // is all zeros.  Must be called with m_mutex locked.
+    lldb::DataBufferSP
+    GetBlockData (uint32_t block_idx, lldb_private::Error &error);
+
+    lldb_private::File m_file;
+    uint64_t m_file_size;
+    uint64_t m_byte_size;
+    uint32_t m_max_block_size;
+    std::vector<Block> m_blocks;
+    lldb_private::Mutex m_mutex;
+    BlockList m_lru;                    // Cached block indexes, most recently used first
+    BlockCache m_cache;
+    size_t m_cache_byte_size;
+    lldb::DataBufferSP m_zero_block_sp; // Stands in for every zero filled block
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (CompressedCoreFile);
+};
+
+#endif // liblldb_CompressedCoreFile_h_
@@ -11,6 +11,7 @@
 #include <stdlib.h>
 
 // C++ Includes
+#include <algorithm>
 #include <mutex>
 
 // Other libraries and framework includes
@@ -25,6 +26,7 @@
 #include "lldb/Target/MemoryRegionInfo.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/UnixSignals.h"
+#include "lldb/Utility/TaskPool.h"
 
 #include "llvm/Support/ELF.h"
 
@@ -32,6 +34,7 @@
 #include "Plugins/DynamicLoader/POSIX-DYLD/DynamicLoaderPOSIXDYLD.h"
 
 // Project includes
+#include "CompressedCoreFile.h"
 #include "ProcessElfCore.h"
 #include "ThreadElfCore.h"
 
@@ -66,7 +69,27 @@ ProcessElfCore::CreateInstance (lldb::TargetSP target_sp, lldb::ListenerSP liste
         // Read enough data for a ELF32 header or ELF64 header
         const size_t header_size = sizeof(llvm::ELF::Elf64_Ehdr);
 
-        lldb::DataBufferSP data_sp (crash_file->ReadFileContents(0, header_size));
+        std::unique_ptr<CompressedCoreFile> compressed_core;
+        lldb::DataBufferSP data_sp;
+        if (CompressedCoreFile::IsCompressed (*crash_file))
+        {
+            Error error;
+            compressed_core = CompressedCoreFile::Open (*crash_file, error);
+            if (!compressed_core)
+            {
+                Log *log (GetLogIfAllCategoriesSet(LIBLLDB_LOG_PROCESS));
+                if (log)
+                    log->Printf ("ProcessElfCore::%s() %s", __FUNCTION__, error.AsCString());
+                return process_sp;
+            }
+            DataBufferHeap *heap_ptr = new DataBufferHeap (header_size, 0);
+            data_sp.reset (heap_ptr);
+            if (compressed_core->Read (0, heap_ptr->GetBytes(), header_size, error) != header_size)
+                return process_sp;
+        }
+        else
+            data_sp = crash_file->ReadFileContents(0, header_size);
+
         if (data_sp && data_sp->GetByteSize() == header_size &&
             elf::ELFHeader::MagicBytesMatch (data_sp->GetBytes()))
         {
@@ -76,13 +99,66 @@ ProcessElfCore::CreateInstance (lldb::TargetSP target_sp, lldb::ListenerSP liste
             if (elf_header.Parse(data, &data_offset))
             {
                 if (elf_header.e_type == llvm::ELF::ET_CORE)
-                    process_sp.reset(new ProcessElfCore (target_sp, listener_sp, *crash_file));
+                {
+                    ProcessElfCore *core_process = new ProcessElfCore (target_sp, listener_sp, *crash_file);
+                    core_process->m_compressed_core = std::move (compressed_core);
+                    process_sp.reset(core_process);
+                }
             }
         }
     }
     return process_sp;
 }
 
+// Decompress the start of a compressed core, up to the end of the program
+// headers and PT_NOTE segments, which is all the object file parses.
+static lldb::DataBufferSP
+ReadCompressedCoreHeaders (CompressedCoreFile &compressed_core, Error &error)
+{
+    const size_t header_size = sizeof(llvm::ELF::Elf64_Ehdr);
+    DataBufferHeap *heap_ptr = new DataBufferHeap (header_size, 0);
+    lldb::DataBufferSP data_sp (heap_ptr);
+    if (compressed_core.Read (0, heap_ptr->GetBytes(), header_size, error) != header_size)
+        return lldb::DataBufferSP();
+
+    elf::ELFHeader elf_header;
+    DataExtractor data (data_sp, lldb::eByteOrderLittle, 4);
+    lldb::offset_t offset = 0;
+    if (!elf_header.Parse (data, &offset))
+        return lldb::DataBufferSP();
+
+    const uint64_t phdrs_end = elf_header.e_phoff + (uint64_t)elf_header.e_phnum * elf_header.e_phentsize;
+    if (phdrs_end > compressed_core.GetByteSize())
+        return lldb::DataBufferSP();
+    heap_ptr->SetByteSize (phdrs_end);
+    if (compressed_core.Read (0, heap_ptr->GetBytes(), phdrs_end, error) != phdrs_end)
+        return lldb::DataBufferSP();
+
+    data.SetData (data_sp);
+    data.SetByteOrder (elf_header.GetByteOrder());
+    data.SetAddressByteSize (elf_header.Is32Bit() ? 4 : 8);
+    uint64_t headers_end = phdrs_end;
+    for (uint32_t i = 0; i < elf_header.e_phnum; ++i)
+    {
+        elf::ELFProgramHeader program_header;
+        offset = elf_header.e_phoff + i * elf_header.e_phentsize;
+        if (!program_header.Parse (data, &offset))
+            return lldb::DataBufferSP();
+        if (program_header.p_type == llvm::ELF::PT_NOTE)
+            headers_end = std::max<uint64_t> (headers_end, program_header.p_offset + program_header.p_filesz);
+    }
+
+    if (headers_end > phdrs_end)
+    {
+        if (headers_end > compressed_core.GetByteSize())
+            return lldb::DataBufferSP();
+        heap_ptr->SetByteSize (headers_end);
+        if (compressed_core.Read (phdrs_end, heap_ptr->GetBytes() + phdrs_end, headers_end - phdrs_end, error) != headers_end - phdrs_end)
+            return lldb::DataBufferSP();
+    }
+    return data_sp;
+}
+
 bool
 ProcessElfCore::CanDebug(lldb::TargetSP target_sp, bool plugin_specified_by_name)
 {
@@ -90,8 +166,22 @@ ProcessElfCore::CanDebug(lldb::TargetSP target_sp, bool plugin_specified_by_name
     if (!m_core_module_sp && m_core_file.Exists())
     {
         ModuleSpec core_module_spec(m_core_file, target_sp->GetArchitecture());
-        Error error (ModuleList::GetSharedModule (core_module_spec, m_core_module_sp,
-                                                  NULL, NULL, NULL));
+        if (m_compressed_core)
+        {
+            // Only the headers and notes are decompressed up front, memory
+            // reads go through m_compressed_core.
+            Error error;
+            lldb::DataBufferSP data_sp (ReadCompressedCoreHeaders (*m_compressed_core, error));
+            if (!data_sp)
+                return false;
+            core_module_spec.SetData (data_sp);
+            m_core_module_sp.reset (new Module (core_module_spec));
+        }
+        else
+        {
+            Error error (ModuleList::GetSharedModule (core_module_spec, m_core_module_sp,
+                                                      NULL, NULL, NULL));
+        }
         if (m_core_module_sp)
         {
             ObjectFile *core_objfile = m_core_module_sp->GetObjectFile();
@@ -110,6 +200,7 @@ ProcessElfCore::ProcessElfCore(lldb::TargetSP target_sp, lldb::ListenerSP listen
     Process (target_sp, listener_sp),
     m_core_module_sp (),
     m_core_file (core_file),
+    m_compressed_core (),
     m_dyld_plugin_name (),
     m_os(llvm::Triple::UnknownOS),
     m_thread_data_valid(false),
@@ -235,6 +326,8 @@ ProcessElfCore::DoLoadCore ()
         }
     }
 
+    ParseThreadData();
+
     if (!ranges_are_sorted)
     {
         m_core_aranges.Sort();
@@ -327,6 +420,43 @@ ProcessElfCore::ReadMemory (lldb::addr_t addr, void *buf, size_t size, Error &er
     return DoReadMemory (addr, buf, size, error);
 }
 
+bool
+ProcessElfCore::GetMemoryData (lldb::addr_t addr, size_t size, DataExtractor &data)
+{
+    ObjectFile *core_objfile = m_core_module_sp ? m_core_module_sp->GetObjectFile() : NULL;
+    if (core_objfile == NULL || size == 0)
+        return false;
+
+    const VMRangeToFileOffset::Entry *address_range = m_core_aranges.FindEntryThatContains (addr);
+    if (address_range == NULL)
+        return false;
+
+    // The whole core file is mmapped by the object file, so any read that
+    // stays within the on-disk part of one segment can share its pages.
+    // Reads that need zero fill or cross into the next segment are left to
+    // ReadMemory.
+    const lldb::addr_t file_offset = address_range->data.GetRangeBase() + (addr - address_range->GetRangeBase());
+    if (file_offset + size > address_range->data.GetRangeEnd())
+        return false;
+
+    DataExtractor view;
+    if (m_compressed_core)
+    {
+        // Views of decompressed blocks work the same, as long as the read
+        // stays within one block.
+        if (!m_compressed_core->GetData (file_offset, size, view))
+            return false;
+    }
+    else if (core_objfile->GetData (file_offset, size, view) != size)
+        return false;
+
+    const ArchSpec &arch = GetTarget().GetArchitecture();
+    view.SetByteOrder (arch.GetByteOrder());
+    view.SetAddressByteSize (arch.GetAddressByteSize());
+    data = view;
+    return true;
+}
+
 Error
 ProcessElfCore::GetMemoryRegionInfo(lldb::addr_t load_addr, MemoryRegionInfo &region_info)
 {
@@ -399,7 +529,12 @@ ProcessElfCore::DoReadMemory (lldb::addr_t addr, void *buf, size_t size, Error &
 
     // If there is data available on the core file read it
     if (bytes_to_read)
-        bytes_copied = core_objfile->CopyData(offset + file_start, bytes_to_read, buf);
+    {
+        if (m_compressed_core)
+            bytes_copied = m_compressed_core->Read(offset + file_start, buf, bytes_to_read, error);
+        else
+            bytes_copied = core_objfile->CopyData(offset + file_start, bytes_to_read, buf);
+    }
 
     assert(zero_fill_size <= size);
     // Pad remaining bytes
@@ -506,6 +641,75 @@ ParseFreeBSDThrMisc(ThreadData &thread_data, DataExtractor &data)
     thread_data.name = data.GetCStr(&offset, 20);
 }
 
+// Parse the notes of one thread, found by ParseThreadContextsFromNoteSegment.
+// The NT_PRSTATUS note is always parsed since it holds the thread's ID and
+// signal.  The other register sets are only located when
+// parse_register_sets is true.
+static void
+ParseThreadNotes(ThreadData &thread_data, ArchSpec &arch, bool parse_register_sets)
+{
+    const DataExtractor &notes = thread_data.notes;
+    lldb::offset_t offset = 0;
+    while (offset < notes.GetByteSize())
+    {
+        ELFNote note = ELFNote();
+        if (!note.Parse(notes, &offset))
+            break;
+
+        const size_t note_start = offset;
+        const size_t note_size = llvm::alignTo(note.n_descsz, 4);
+        DataExtractor note_data (notes, note_start, note_size);
+        note_data.SetAddressByteSize(notes.GetAddressByteSize());
+        if (note.n_name == "FreeBSD")
+        {
+            switch (note.n_type)
+            {
+                case FREEBSD::NT_PRSTATUS:
+                    ParseFreeBSDPrStatus(thread_data, note_data, arch);
+                    break;
+                case FREEBSD::NT_FPREGSET:
+                    if (parse_register_sets)
+                        thread_data.fpregset = note_data;
+                    break;
+                case FREEBSD::NT_THRMISC:
+                    ParseFreeBSDThrMisc(thread_data, note_data);
+                    break;
+                case FREEBSD::NT_PPC_VMX:
+                    if (parse_register_sets)
+                        thread_data.vregset = note_data;
+                    break;
+                default:
+                    break;
+            }
+        }
+        else if (note.n_name == "CORE")
+        {
+            switch (note.n_type)
+            {
+                case NT_PRSTATUS:
+                    {
+                        ELFLinuxPrStatus prstatus;
+                        prstatus.Parse(note_data, arch);
+                        thread_data.signo = prstatus.pr_cursig;
+                        thread_data.tid = prstatus.pr_pid;
+                        const size_t header_size = ELFLinuxPrStatus::GetSize(arch);
+                        const size_t len = note_data.GetByteSize() - header_size;
+                        thread_data.gpregset = DataExtractor(note_data, header_size, len);
+                    }
+                    break;
+                case NT_FPREGSET:
+                    if (parse_register_sets)
+                        thread_data.fpregset = note_data;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        offset += note_size;
+    }
+}
+
 /// Parse Thread context from PT_NOTE segment and store it in the thread list
 /// Notes:
 /// 1) A PT_NOTE segment is composed of one or more NOTE entries.
@@ -524,6 +728,10 @@ ParseFreeBSDThrMisc(ThreadData &thread_data, DataExtractor &data)
 ///        new thread when it finds NT_PRSTATUS or NT_PRPSINFO NOTE entry.
 ///    For case (b) there may be either one NT_PRPSINFO per thread, or a single
 ///    one that applies to all threads (depending on the platform type).
+/// 6) Only the process wide notes are parsed here.  Each thread just records
+///    the range of notes that belongs to it, ParseThreadData pulls out the
+///    thread IDs once all segments have been seen and the register sets are
+///    only located when a thread's registers are first asked for.
 void
 ProcessElfCore::ParseThreadContextsFromNoteSegment(const elf::ELFProgramHeader *segment_header,
                                                    DataExtractor segment_data)
@@ -531,19 +739,19 @@ ProcessElfCore::ParseThreadContextsFromNoteSegment(const elf::ELFProgramHeader *
     assert(segment_header && segment_header->p_type == llvm::ELF::PT_NOTE);
 
     lldb::offset_t offset = 0;
-    std::unique_ptr<ThreadData> thread_data(new ThreadData);
+    lldb::offset_t thread_start = 0;
+    ThreadData thread_data;
     bool have_prstatus = false;
     bool have_prpsinfo = false;
 
     ArchSpec arch = GetArchitecture();
     ELFLinuxPrPsInfo prpsinfo;
-    ELFLinuxPrStatus prstatus;
-    size_t header_size;
-    size_t len;
+    segment_data.SetAddressByteSize(m_core_module_sp->GetArchitecture().GetAddressByteSize());
 
     // Loop through the NOTE entires in the segment
     while (offset < segment_header->p_filesz)
     {
+        const lldb::offset_t note_offset = offset;
         ELFNote note = ELFNote();
         note.Parse(segment_data, &offset);
 
@@ -551,10 +759,12 @@ ProcessElfCore::ParseThreadContextsFromNoteSegment(const elf::ELFProgramHeader *
         if ((note.n_type == NT_PRSTATUS && have_prstatus) ||
             (note.n_type == NT_PRPSINFO && have_prpsinfo))
         {
-            assert(thread_data->gpregset.GetByteSize() > 0);
+            assert(have_prstatus);
             // Add the new thread to thread list
-            m_thread_data.push_back(*thread_data);
-            *thread_data = ThreadData();
+            thread_data.notes = DataExtractor(segment_data, thread_start, note_offset - thread_start);
+            m_thread_data.push_back(thread_data);
+            thread_data = ThreadData();
+            thread_start = note_offset;
             have_prstatus = false;
             have_prpsinfo = false;
         }
@@ -573,24 +783,14 @@ ProcessElfCore::ParseThreadContextsFromNoteSegment(const elf::ELFProgramHeader *
             {
                 case FREEBSD::NT_PRSTATUS:
                     have_prstatus = true;
-                    ParseFreeBSDPrStatus(*thread_data, note_data, arch);
-                    break;
-                case FREEBSD::NT_FPREGSET:
-                    thread_data->fpregset = note_data;
                     break;
                 case FREEBSD::NT_PRPSINFO:
                     have_prpsinfo = true;
                     break;
-                case FREEBSD::NT_THRMISC:
-                    ParseFreeBSDThrMisc(*thread_data, note_data);
-                    break;
                 case FREEBSD::NT_PROCSTAT_AUXV:
                     // FIXME: FreeBSD sticks an int at the beginning of the note
                     m_auxv = DataExtractor(segment_data, note_start + 4, note_size - 4);
                     break;
-                case FREEBSD::NT_PPC_VMX:
-                    thread_data->vregset = note_data;
-                    break;
                 default:
                     break;
             }
@@ -601,20 +801,11 @@ ProcessElfCore::ParseThreadContextsFromNoteSegment(const elf::ELFProgramHeader *
             {
                 case NT_PRSTATUS:
                     have_prstatus = true;
-                    prstatus.Parse(note_data, arch);
-                    thread_data->signo = prstatus.pr_cursig;
-                    thread_data->tid = prstatus.pr_pid;
-                    header_size = ELFLinuxPrStatus::GetSize(arch);
-                    len = note_data.GetByteSize() - header_size;
-                    thread_data->gpregset = DataExtractor(note_data, header_size, len);
-                    break;
-                case NT_FPREGSET:
-                    thread_data->fpregset = note_data;
                     break;
                 case NT_PRPSINFO:
                     have_prpsinfo = true;
                     prpsinfo.Parse(note_data, arch);
-                    thread_data->name = prpsinfo.pr_fname;
+                    thread_data.name = prpsinfo.pr_fname;
                     SetID(prpsinfo.pr_pid);
                     break;
                 case NT_AUXV:
@@ -650,12 +841,56 @@ ProcessElfCore::ParseThreadContextsFromNoteSegment(const elf::ELFProgramHeader *
         offset += note_size;
     }
     // Add last entry in the note section
-    if (thread_data && thread_data->gpregset.GetByteSize() > 0)
+    if (have_prstatus)
     {
-        m_thread_data.push_back(*thread_data);
+        thread_data.notes = DataExtractor(segment_data, thread_start, offset - thread_start);
+        m_thread_data.push_back(thread_data);
     }
 }
 
+void
+ProcessElfCore::ParseThreadData()
+{
+    ArchSpec arch = GetArchitecture();
+    const size_t num_threads = m_thread_data.size();
+    auto parser_fn = [this, &arch](size_t begin, size_t end)
+    {
+        ArchSpec task_arch(arch);
+        for (size_t i = begin; i < end; ++i)
+            ParseThreadNotes(m_thread_data[i], task_arch, false);
+    };
+
+    // Cores with a handful of threads aren't worth the trip through the
+    // task pool.
+    const size_t num_tasks = std::min<size_t>(num_threads / 64, std::max(1u, std::thread::hardware_concurrency()));
+    if (num_tasks <= 1)
+    {
+        parser_fn(0, num_threads);
+    }
+    else
+    {
+        const size_t threads_per_task = (num_threads + num_tasks - 1) / num_tasks;
+        std::vector<std::future<void>> futures;
+        for (size_t begin = 0; begin < num_threads; begin += threads_per_task)
+            futures.push_back(TaskPool::AddTask(parser_fn, begin, std::min(begin + threads_per_task, num_threads)));
+        for (auto &future : futures)
+            future.wait();
+    }
+
+    // Drop threads whose NT_PRSTATUS had no registers, like the parse
+    // did before it was split up.
+    m_thread_data.erase(std::remove_if(m_thread_data.begin(), m_thread_data.end(),
+                                       [](const ThreadData &td) { return td.gpregset.GetByteSize() == 0; }),
+                        m_thread_data.end());
+}
+
+void
+ProcessElfCore::ParseThreadRegisterSets(ThreadData &thread_data)
+{
+    ArchSpec arch = GetArchitecture();
+    ParseThreadNotes(thread_data, arch, true);
+}
+
 uint32_t
 ProcessElfCore::GetNumThreadContexts ()
 {
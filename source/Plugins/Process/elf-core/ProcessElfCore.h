@@ -20,6 +20,7 @@
 // C Includes
 // C++ Includes
 #include <list>
+#include <memory>
 #include <vector>
 
 // Other libraries and framework includes
@@ -31,6 +32,7 @@
 #include "Plugins/ObjectFile/ELF/ELFHeader.h"
 
 struct ThreadData;
+class CompressedCoreFile;
 
 class ProcessElfCore : public lldb_private::Process
 {
@@ -102,6 +104,8 @@ public:
 
     size_t DoReadMemory(lldb::addr_t addr, void *buf, size_t size, lldb_private::Error &error) override;
 
+    bool GetMemoryData(lldb::addr_t addr, size_t size, lldb_private::DataExtractor &data) override;
+
     lldb_private::Error
     GetMemoryRegionInfo(lldb::addr_t load_addr, lldb_private::MemoryRegionInfo &region_info) override;
 
@@ -110,6 +114,12 @@ public:
     lldb_private::ArchSpec
     GetArchitecture();
 
+    // Fill in the register sets of a thread from its notes.  This is left
+    // until a thread's registers are first needed, cores of processes with
+    // thousands of threads would take too long to load otherwise.
+    void
+    ParseThreadRegisterSets(ThreadData &thread_data);
+
     // Returns AUXV structure found in the core file
     const lldb::DataBufferSP
     GetAuxvData() override;
@@ -142,6 +152,7 @@ private:
 
     lldb::ModuleSP m_core_module_sp;
     lldb_private::FileSpec m_core_file;
+    std::unique_ptr<CompressedCoreFile> m_compressed_core; // Set if m_core_file is gzip compressed
     std::string  m_dyld_plugin_name;
     DISALLOW_COPY_AND_ASSIGN (ProcessElfCore);
 
@@ -170,6 +181,11 @@ private:
     ParseThreadContextsFromNoteSegment (const elf::ELFProgramHeader *segment_header,
                                         lldb_private::DataExtractor segment_data);
 
+    // Fill in the IDs, signals and names of the threads found by
+    // ParseThreadContextsFromNoteSegment, in parallel for large cores
+    void
+    ParseThreadData();
+
     // Returns number of thread contexts stored in the core file
     uint32_t
     GetNumThreadContexts();
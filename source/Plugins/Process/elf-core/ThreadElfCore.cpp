@@ -44,9 +44,10 @@ ThreadElfCore::ThreadElfCore (Process &process, const ThreadData &td) :
     m_thread_name(td.name),
     m_thread_reg_ctx_sp (),
     m_signo(td.signo),
-    m_gpregset_data(td.gpregset),
-    m_fpregset_data(td.fpregset),
-    m_vregset_data(td.vregset)
+    m_notes_data(td.notes),
+    m_gpregset_data(),
+    m_fpregset_data(),
+    m_vregset_data()
 {
 }
 
@@ -58,7 +59,11 @@ ThreadElfCore::~ThreadElfCore ()
 void
 ThreadElfCore::RefreshStateAfterStop()
 {
-    GetRegisterContext()->InvalidateIfNeeded (false);
+    // The registers in a core never change.  Don't create a register
+    // context just to invalidate it, that would parse the notes of every
+    // thread in the core.
+    if (m_reg_context_sp)
+        m_reg_context_sp->InvalidateIfNeeded (false);
 }
 
 void
@@ -96,6 +101,13 @@ ThreadElfCore::CreateRegisterContextForFrame (StackFrame *frame)
 
         ProcessElfCore *process = static_cast<ProcessElfCore *>(GetProcess().get());
         ArchSpec arch = process->GetArchitecture();
+
+        ThreadData td;
+        td.notes = m_notes_data;
+        process->ParseThreadRegisterSets(td);
+        m_gpregset_data = td.gpregset;
+        m_fpregset_data = td.fpregset;
+        m_vregset_data = td.vregset;
         RegisterInfoInterface *reg_interface = NULL;
 
         switch (arch.GetTriple().getOS())
@@ -114,12 +114,17 @@ struct ELFLinuxPrPsInfo
 
 struct ThreadData
 {
+    lldb_private::DataExtractor notes;      // All of this thread's notes
     lldb_private::DataExtractor gpregset;
     lldb_private::DataExtractor fpregset;
     lldb_private::DataExtractor vregset;
     lldb::tid_t tid;
     int signo;
     std::string name;
+
+    ThreadData() : tid(0), signo(0)
+    {
+    }
 };
 
 class ThreadElfCore : public lldb_private::Thread
@@ -173,6 +178,7 @@ protected:
 
     int m_signo;
 
+    lldb_private::DataExtractor m_notes_data;
     lldb_private::DataExtractor m_gpregset_data;
     lldb_private::DataExtractor m_fpregset_data;
     lldb_private::DataExtractor m_vregset_data;
@@ -307,6 +307,38 @@ GDBRemoteCommunication::SendPacketNoLock (const char *payload, size_t payload_le
     return PacketResult::ErrorSendFailed;
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunication::SendNotificationPacketNoLock (const char *notify_name, const char *payload, size_t payload_length)
+{
+    if (!IsConnected())
+        return PacketResult::ErrorSendFailed;
+
+    StreamString body;
+    body.Printf ("%s:", notify_name);
+    body.Write (payload, payload_length);
+
+    StreamString packet(0, 4, eByteOrderBig);
+    packet.PutChar('%');
+    packet.Write (body.GetData(), body.GetSize());
+    packet.PutChar('#');
+    packet.PutHex8(CalculcateChecksum (body.GetData(), body.GetSize()));
+
+    ConnectionStatus status = eConnectionStatusSuccess;
+    const char *packet_data = packet.GetData();
+    const size_t packet_length = packet.GetSize();
+    size_t bytes_written = Write (packet_data, packet_length, status, NULL);
+
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS));
+    if (log)
+        log->Printf("<%4" PRIu64 "> send notification: %.*s", (uint64_t)bytes_written, (int)packet_length, packet_data);
+
+    m_history.AddPacket (packet.GetString(), packet_length, History::ePacketTypeSend, bytes_written);
+
+    if (bytes_written != packet_length)
+        return PacketResult::ErrorSendFailed;
+    return PacketResult::Success;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunication::GetAck ()
 {
@@ -307,6 +307,13 @@ protected:
     SendPacketNoLock (const char *payload, 
                       size_t payload_length);
 
+    // Send an asynchronous "%<notify_name>:<payload>#xx" notification.
+    // Notifications are never acknowledged.
+    PacketResult
+    SendNotificationPacketNoLock (const char *notify_name,
+                                  const char *payload,
+                                  size_t payload_length);
+
     PacketResult
     ReadPacket (StringExtractorGDBRemote &response, uint32_t timeout_usec, bool sync_on_timeout);
 
@@ -15,6 +15,8 @@
 #include <sys/stat.h>
 
 // C++ Includes
+#include <algorithm>
+#include <atomic>
 #include <sstream>
 #include <numeric>
 
@@ -22,6 +24,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/Triple.h"
 #include "lldb/Interpreter/Args.h"
+#include "lldb/Core/ConnectionSharedMemory.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/State.h"
@@ -86,6 +89,9 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient() :
     m_supports_qXfer_libraries_svr4_read (eLazyBoolCalculate),
     m_supports_qXfer_features_read (eLazyBoolCalculate),
     m_supports_augmented_libraries_svr4_read (eLazyBoolCalculate),
+    m_supports_qSaveCore (eLazyBoolCalculate),
+    m_supports_pipelined_packets (eLazyBoolCalculate),
+    m_supports_shared_memory_buffer (eLazyBoolCalculate),
     m_supports_jThreadExtendedInfo (eLazyBoolCalculate),
     m_supports_jLoadedDynamicLibrariesInfos (eLazyBoolCalculate),
     m_supports_qProcessInfoPID (true),
@@ -104,6 +110,8 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient() :
     m_qSymbol_requests_done (false),
     m_supports_qModuleInfo (true),
     m_supports_jThreadsInfo (true),
+    m_supports_jMemoryRegionsInfo (true),
+    m_supports_qSearch_memory (true),
     m_curr_pid (LLDB_INVALID_PROCESS_ID),
     m_curr_tid (LLDB_INVALID_THREAD_ID),
     m_curr_tid_run (LLDB_INVALID_THREAD_ID),
@@ -127,7 +135,8 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient() :
     m_gdb_server_name(),
     m_gdb_server_version(UINT32_MAX),
     m_default_packet_timeout (0),
-    m_max_packet_size (0)
+    m_max_packet_size (0),
+    m_shared_memory_up ()
 {
 }
 
@@ -240,6 +249,38 @@ GDBRemoteCommunicationClient::GetQXferFeaturesReadSupported ()
     return m_supports_qXfer_features_read == eLazyBoolYes;
 }
 
+bool
+GDBRemoteCommunicationClient::GetQSaveCoreSupported ()
+{
+    if (m_supports_qSaveCore == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return m_supports_qSaveCore == eLazyBoolYes;
+}
+
+bool
+GDBRemoteCommunicationClient::GetPipelinedPacketsSupported ()
+{
+    if (m_supports_pipelined_packets == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    // With acks on every packet waits for its '+' before the next one can
+    // go out, so there is nothing to pipeline.
+    return m_supports_pipelined_packets == eLazyBoolYes && !GetSendAcks();
+}
+
+bool
+GDBRemoteCommunicationClient::GetSharedMemoryBufferSupported ()
+{
+    if (m_supports_shared_memory_buffer == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return m_supports_shared_memory_buffer == eLazyBoolYes;
+}
+
 uint64_t
 GDBRemoteCommunicationClient::GetRemoteMaxPacketSize()
 {
@@ -365,6 +406,9 @@ GDBRemoteCommunicationClient::ResetDiscoverableSettings (bool did_exec)
         m_supports_qXfer_libraries_svr4_read = eLazyBoolCalculate;
         m_supports_qXfer_features_read = eLazyBoolCalculate;
         m_supports_augmented_libraries_svr4_read = eLazyBoolCalculate;
+        m_supports_qSaveCore = eLazyBoolCalculate;
+        m_supports_pipelined_packets = eLazyBoolCalculate;
+        m_supports_shared_memory_buffer = eLazyBoolCalculate;
         m_supports_qProcessInfoPID = true;
         m_supports_qfProcessInfo = true;
         m_supports_qUserName = true;
@@ -380,6 +424,8 @@ GDBRemoteCommunicationClient::ResetDiscoverableSettings (bool did_exec)
         m_supports_qSymbol = true;
         m_qSymbol_requests_done = false;
         m_supports_qModuleInfo = true;
+        m_supports_jMemoryRegionsInfo = true;
+        m_supports_qSearch_memory = true;
         m_host_arch.Clear();
         m_os_version_major = UINT32_MAX;
         m_os_version_minor = UINT32_MAX;
@@ -391,6 +437,7 @@ GDBRemoteCommunicationClient::ResetDiscoverableSettings (bool did_exec)
         m_gdb_server_version = UINT32_MAX;
         m_default_packet_timeout = 0;
         m_max_packet_size = 0;
+        m_shared_memory_up.reset();
     }
 
     // These flags should be reset when we first connect to a GDB server
@@ -408,6 +455,9 @@ GDBRemoteCommunicationClient::GetRemoteQSupported ()
     m_supports_qXfer_libraries_svr4_read = eLazyBoolNo;
     m_supports_augmented_libraries_svr4_read = eLazyBoolNo;
     m_supports_qXfer_features_read = eLazyBoolNo;
+    m_supports_qSaveCore = eLazyBoolNo;
+    m_supports_pipelined_packets = eLazyBoolNo;
+    m_supports_shared_memory_buffer = eLazyBoolNo;
     m_max_packet_size = UINT64_MAX;  // It's supposed to always be there, but if not, we assume no limit
 
     // build the qSupported packet
@@ -439,6 +489,12 @@ GDBRemoteCommunicationClient::GetRemoteQSupported ()
             m_supports_qXfer_libraries_read = eLazyBoolYes;
         if (::strstr (response_cstr, "qXfer:features:read+"))
             m_supports_qXfer_features_read = eLazyBoolYes;
+        if (::strstr (response_cstr, "qSaveCore+"))
+            m_supports_qSaveCore = eLazyBoolYes;
+        if (::strstr (response_cstr, "PipelinedPackets+"))
+            m_supports_pipelined_packets = eLazyBoolYes;
+        if (::strstr (response_cstr, "QSetSharedMemoryBuffer+"))
+            m_supports_shared_memory_buffer = eLazyBoolYes;
 
 
         // Look for a list of compressions in the features list e.g.
@@ -917,6 +973,78 @@ GDBRemoteCommunicationClient::SendPacketAndWaitForResponse
     return packet_result;
 }
 
+GDBRemoteCommunicationClient::PacketResult
+GDBRemoteCommunicationClient::SendPacketsAndWaitForResponses (const std::vector<std::string> &payloads,
+                                                              std::vector<StringExtractorGDBRemote> &responses)
+{
+    responses.clear();
+    responses.resize(payloads.size());
+    if (payloads.empty())
+        return PacketResult::Success;
+
+    Mutex::Locker locker;
+    if (!GetSequenceMutex (locker, "Didn't get sequence mutex for pipelined packets."))
+        return PacketResult::ErrorSendFailed;
+
+    // Keep async notifications from being processed in the middle of the
+    // batch, just like SendPacketAndWaitForResponse does.
+    static ListenerSP hijack_listener_sp(Listener::MakeListener("lldb.NotifyHijacker"));
+    HijackBroadcaster(hijack_listener_sp, eBroadcastBitGdbReadThreadGotNotify);
+
+    PacketResult packet_result = PacketResult::Success;
+    if (GetPipelinedPacketsSupported())
+    {
+        // The stub answers packets in the order it gets them, so the
+        // responses come back in the order of the payloads. Keep at most
+        // kMaxPacketsInFlight packets waiting for their responses.
+        size_t num_sent = 0;
+        size_t num_received = 0;
+        bool send_failed = false;
+        while (num_received < payloads.size())
+        {
+            while (!send_failed &&
+                   num_sent < payloads.size() &&
+                   num_sent - num_received < kMaxPacketsInFlight)
+            {
+                packet_result = SendPacketNoLock (payloads[num_sent].data(), payloads[num_sent].size());
+                if (packet_result == PacketResult::Success)
+                    ++num_sent;
+                else
+                    send_failed = true;
+            }
+
+            // If a send failed, still read the responses to the packets
+            // that went out so they don't get mistaken for the responses
+            // to later packets.
+            if (num_received == num_sent)
+                break;
+
+            const PacketResult read_result = ReadPacket (responses[num_received], GetPacketTimeoutInMicroSeconds (), true);
+            if (read_result != PacketResult::Success)
+            {
+                packet_result = read_result;
+                break;
+            }
+            ++num_received;
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < payloads.size() && packet_result == PacketResult::Success; ++i)
+            packet_result = SendPacketAndWaitForResponseNoLock (payloads[i].data(), payloads[i].size(), responses[i]);
+    }
+
+    // Remove our Hijacking listener from the broadcast.
+    RestoreBroadcaster();
+
+    // If a notification event occurred, rebroadcast since it can now be processed safely.
+    EventSP event_sp;
+    if (hijack_listener_sp->GetNextEvent(event_sp))
+        BroadcastEvent(event_sp);
+
+    return packet_result;
+}
+
 static const char *end_delimiter = "--end--;";
 static const int end_delimiter_len = 8;
 
@@ -2471,6 +2599,133 @@ GDBRemoteCommunicationClient::GetMemoryRegionInfo (lldb::addr_t addr,
 
 }
 
+Error
+GDBRemoteCommunicationClient::GetMemoryRegions (uint32_t &generation, std::vector<MemoryRegionInfo> &regions)
+{
+    if (!m_supports_jMemoryRegionsInfo)
+        return Error("remote stub doesn't support jMemoryRegionsInfo");
+
+    // jMemoryRegionsInfo[:{"generation":<n>}]
+    StreamGDBRemote packet;
+    packet.PutCString("jMemoryRegionsInfo");
+    if (generation != 0)
+    {
+        StreamString args;
+        args.Printf("{\"generation\":%" PRIu32 "}", generation);
+        packet.PutChar(':');
+        packet.PutEscapedBytes(args.GetData(), args.GetSize());
+    }
+
+    StringExtractorGDBRemote response;
+    response.SetResponseValidatorToJSON();
+    if (SendPacketAndWaitForResponse(packet.GetData(), packet.GetSize(), response, false) != PacketResult::Success)
+        return Error("failed to send jMemoryRegionsInfo packet");
+
+    if (response.IsUnsupportedResponse())
+    {
+        m_supports_jMemoryRegionsInfo = false;
+        return Error("remote stub doesn't support jMemoryRegionsInfo");
+    }
+    if (response.IsErrorResponse())
+        return Error("jMemoryRegionsInfo failed");
+
+    StructuredData::ObjectSP object_sp = StructuredData::ParseJSON(response.GetStringRef());
+    StructuredData::Dictionary *dict = object_sp ? object_sp->GetAsDictionary() : nullptr;
+    uint32_t new_generation = 0;
+    if (dict == nullptr || !dict->GetValueForKeyAsInteger("generation", new_generation))
+        return Error("invalid response to jMemoryRegionsInfo packet");
+
+    // The stub leaves the regions out when ours are current.
+    if (new_generation == generation)
+        return Error();
+
+    StructuredData::Array *regions_array = nullptr;
+    if (!dict->GetValueForKeyAsArray("regions", regions_array))
+        return Error("invalid response to jMemoryRegionsInfo packet");
+
+    std::vector<MemoryRegionInfo> new_regions;
+    new_regions.reserve(regions_array->GetSize());
+    const bool success = regions_array->ForEach([&new_regions] (StructuredData::Object *object) -> bool {
+        StructuredData::Dictionary *region_dict = object->GetAsDictionary();
+        uint64_t start = 0;
+        uint64_t size = 0;
+        std::string permissions;
+        if (region_dict == nullptr ||
+            !region_dict->GetValueForKeyAsInteger("start", start) ||
+            !region_dict->GetValueForKeyAsInteger("size", size) ||
+            !region_dict->GetValueForKeyAsString("permissions", permissions))
+            return false;
+
+        MemoryRegionInfo region_info;
+        region_info.GetRange().SetRangeBase(start);
+        region_info.GetRange().SetByteSize(size);
+        region_info.SetReadable(permissions.find('r') != std::string::npos ? MemoryRegionInfo::eYes : MemoryRegionInfo::eNo);
+        region_info.SetWritable(permissions.find('w') != std::string::npos ? MemoryRegionInfo::eYes : MemoryRegionInfo::eNo);
+        region_info.SetExecutable(permissions.find('x') != std::string::npos ? MemoryRegionInfo::eYes : MemoryRegionInfo::eNo);
+        new_regions.push_back(region_info);
+        return true;
+    });
+    if (!success)
+        return Error("invalid region in jMemoryRegionsInfo response");
+
+    regions.swap(new_regions);
+    generation = new_generation;
+    return Error();
+}
+
+Error
+GDBRemoteCommunicationClient::SearchMemory (lldb::addr_t addr,
+                                            lldb::addr_t length,
+                                            const uint8_t *pattern,
+                                            size_t pattern_size,
+                                            lldb::addr_t &found_addr)
+{
+    found_addr = LLDB_INVALID_ADDRESS;
+    if (!m_supports_qSearch_memory)
+        return Error("remote stub doesn't support qSearch:memory");
+
+    // qSearch:memory:<addr>;<length>;<escaped pattern bytes>
+    StreamGDBRemote packet;
+    packet.Printf("qSearch:memory:%" PRIx64 ";%" PRIx64 ";", addr, length);
+    packet.PutEscapedBytes(pattern, pattern_size);
+
+    // The stub scans the whole range before it answers, which is slow for
+    // stubs that can only read memory a word at a time.
+    const uint32_t minimum_timeout = 10;
+    uint32_t old_timeout = GetPacketTimeoutInMicroSeconds() / lldb_private::TimeValue::MicroSecPerSec;
+    GDBRemoteCommunication::ScopedTimeout timeout (*this, std::max (old_timeout, minimum_timeout));
+
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse(packet.GetData(), packet.GetSize(), response, false) != PacketResult::Success)
+        return Error("failed to send qSearch:memory packet");
+
+    if (response.IsUnsupportedResponse())
+    {
+        m_supports_qSearch_memory = false;
+        return Error("remote stub doesn't support qSearch:memory");
+    }
+    if (response.IsErrorResponse())
+        return Error("qSearch:memory failed");
+
+    // "0" means no match, "1,<addr>" gives the address of the first one.
+    switch (response.GetChar())
+    {
+        case '0':
+            return Error();
+        case '1':
+            if (response.GetChar() == ',')
+            {
+                found_addr = response.GetHexMaxU64(false, LLDB_INVALID_ADDRESS);
+                if (found_addr != LLDB_INVALID_ADDRESS)
+                    return Error();
+            }
+            break;
+        default:
+            break;
+    }
+    return Error("invalid response to qSearch:memory packet");
+}
+
 Error
 GDBRemoteCommunicationClient::GetWatchpointSupportInfo (uint32_t &num)
 {
@@ -2630,6 +2885,141 @@ GDBRemoteCommunicationClient::SetSTDERR(const FileSpec &file_spec)
     return -1;
 }
 
+Error
+GDBRemoteCommunicationClient::SaveCore (const char *path_hint, bool skip_file_backed, std::string &core_path)
+{
+    core_path.clear();
+    if (!GetQSaveCoreSupported())
+        return Error("remote stub doesn't support qSaveCore");
+
+    StreamString packet;
+    packet.PutCString("qSaveCore");
+    if (path_hint && path_hint[0])
+    {
+        packet.PutCString(";path-hint:");
+        packet.PutCStringAsRawHex8(path_hint);
+    }
+    packet.Printf(";skip-file-backed:%d", skip_file_backed ? 1 : 0);
+
+    // Writing the core takes as long as reading all of the inferior's
+    // memory, so give the stub plenty of time to reply.
+    GDBRemoteCommunication::ScopedTimeout timeout (*this, 300);
+
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse(packet.GetData(), packet.GetSize(), response, false) != PacketResult::Success)
+        return Error("failed to send '%s' packet", packet.GetData());
+
+    if (response.IsErrorResponse())
+        return Error("remote stub failed to save the core file (error 0x%2.2x)", response.GetError());
+
+    std::string name;
+    std::string value;
+    while (response.GetNameColonValue(name, value))
+    {
+        if (name == "core-path")
+        {
+            StringExtractor extractor(value.c_str());
+            extractor.GetHexByteString(core_path);
+        }
+    }
+    if (core_path.empty())
+        return Error("invalid response to '%s' packet", packet.GetData());
+    return Error();
+}
+
+Error
+GDBRemoteCommunicationClient::SetUpSharedMemoryBuffer (size_t size)
+{
+    m_shared_memory_up.reset();
+    if (!GetSharedMemoryBufferSupported())
+        return Error("remote stub doesn't support QSetSharedMemoryBuffer");
+
+    // The name only has to be unique on this host.
+    static std::atomic<uint32_t> g_buffer_id(0);
+    StreamString name;
+    name.Printf("/lldb-%" PRIu64 "-%u", (uint64_t)Host::GetCurrentProcessID(), ++g_buffer_id);
+
+    Error error;
+    std::unique_ptr<ConnectionSharedMemory> shared_memory_up(new ConnectionSharedMemory());
+    if (shared_memory_up->Open(true, name.GetData(), size, &error) != eConnectionStatusSuccess)
+    {
+        if (error.Success())
+            error.SetErrorStringWithFormat("couldn't create shared memory buffer '%s'", name.GetData());
+        return error;
+    }
+
+    StreamGDBRemote packet;
+    packet.PutCString("QSetSharedMemoryBuffer:name:");
+    packet.PutCStringAsRawHex8(name.GetData());
+    packet.Printf(";size:%" PRIx64 ";", (uint64_t)size);
+
+    StringExtractorGDBRemote response;
+    const PacketResult packet_result = SendPacketAndWaitForResponse(packet.GetData(), packet.GetSize(), response, false);
+    // Once the stub has mapped the buffer, or failed to, nobody needs the
+    // name any more, and removing it now means the memory can't outlive
+    // both of us.
+    shared_memory_up->Unlink();
+    if (packet_result != PacketResult::Success)
+        return Error("failed to send '%s' packet", packet.GetData());
+    // A stub on another host won't find the name.
+    if (!response.IsOKResponse())
+        return Error("remote stub couldn't map shared memory buffer '%s'", name.GetData());
+
+    m_shared_memory_up = std::move(shared_memory_up);
+    return Error();
+}
+
+bool
+GDBRemoteCommunicationClient::ReadMemoryShared (lldb::addr_t addr,
+                                                void *dst,
+                                                size_t size,
+                                                size_t &bytes_read,
+                                                Error &error)
+{
+    bytes_read = 0;
+    if (!m_shared_memory_up)
+        return false;
+
+    // The stub fills the buffer before it replies and nothing else may use
+    // the buffer until the bytes are copied out of it, so hold the sequence
+    // mutex for the whole exchange. If the process is running we can't get
+    // it, and the caller falls back to sending an async memory read.
+    Mutex::Locker locker;
+    if (!GetSequenceMutex (locker))
+        return false;
+
+    size = std::min<size_t>(size, m_shared_memory_up->GetByteSize());
+
+    char packet[64];
+    const int packet_len = ::snprintf(packet, sizeof(packet), "qSharedMemoryRead:%" PRIx64 ",%" PRIx64,
+                                      (uint64_t)addr, (uint64_t)size);
+    assert (packet_len + 1 < (int)sizeof(packet));
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponseNoLock(packet, packet_len, response) != PacketResult::Success)
+    {
+        error.SetErrorStringWithFormat("failed to send packet: '%s'", packet);
+        return true;
+    }
+
+    if (response.IsErrorResponse())
+    {
+        error.SetErrorStringWithFormat("memory read failed for 0x%" PRIx64, addr);
+        return true;
+    }
+
+    if (!response.IsNormalResponse())
+    {
+        // The stub doesn't know the packet after all, stop using the buffer.
+        m_shared_memory_up.reset();
+        return false;
+    }
+
+    bytes_read = std::min<size_t>(response.GetHexMaxU64(false, 0), size);
+    memcpy(dst, m_shared_memory_up->GetBytes(), bytes_read);
+    error.Clear();
+    return true;
+}
+
 bool
 GDBRemoteCommunicationClient::GetWorkingDir(FileSpec &working_dir)
 {
@@ -4195,6 +4585,37 @@ GDBRemoteCommunicationClient::ReadRegister(lldb::tid_t tid, uint32_t reg, String
 }
 
 
+bool
+GDBRemoteCommunicationClient::ReadRegisters (lldb::tid_t tid,
+                                             const std::vector<uint32_t> &reg_nums,
+                                             std::vector<StringExtractorGDBRemote> &responses)
+{
+    Mutex::Locker locker;
+    if (GetSequenceMutex (locker, "Didn't get sequence mutex for p packets."))
+    {
+        const bool thread_suffix_supported = GetThreadSuffixSupported();
+
+        if (thread_suffix_supported || SetCurrentThread(tid))
+        {
+            std::vector<std::string> payloads;
+            payloads.reserve(reg_nums.size());
+            for (uint32_t reg : reg_nums)
+            {
+                char packet[64];
+                int packet_len = 0;
+                if (thread_suffix_supported)
+                    packet_len = ::snprintf (packet, sizeof(packet), "p%x;thread:%4.4" PRIx64 ";", reg, tid);
+                else
+                    packet_len = ::snprintf (packet, sizeof(packet), "p%x", reg);
+                assert (packet_len < ((int)sizeof(packet) - 1));
+                payloads.push_back(std::string(packet, packet_len));
+            }
+            return SendPacketsAndWaitForResponses(payloads, responses) == PacketResult::Success;
+        }
+    }
+    return false;
+}
+
 bool
 GDBRemoteCommunicationClient::ReadAllRegisters (lldb::tid_t tid, StringExtractorGDBRemote &response)
 {
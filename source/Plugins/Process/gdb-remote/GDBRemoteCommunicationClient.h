@@ -25,6 +25,9 @@
 #include "GDBRemoteCommunication.h"
 
 namespace lldb_private {
+
+class ConnectionSharedMemory;
+
 namespace process_gdb_remote {
 
 class GDBRemoteCommunicationClient : public GDBRemoteCommunication
@@ -52,6 +55,30 @@ public:
                                   StringExtractorGDBRemote &response,
                                   bool send_async);
 
+    //------------------------------------------------------------------
+    /// Send a batch of independent packets and wait for all of their
+    /// responses.
+    ///
+    /// If the remote stub supports pipelined packets, up to
+    /// kMaxPacketsInFlight packets are written before the first response
+    /// is read, so the whole batch costs about one round trip instead of
+    /// one per packet. Otherwise the packets are sent one at a time.
+    ///
+    /// @param[in] payloads
+    ///     The packets to send, none of which may change state that a
+    ///     later packet in the batch depends on.
+    ///
+    /// @param[out] responses
+    ///     The responses, in the same order as \a payloads.
+    ///
+    /// @return
+    ///     PacketResult::Success if every packet got a response, the
+    ///     first failure otherwise.
+    //------------------------------------------------------------------
+    PacketResult
+    SendPacketsAndWaitForResponses (const std::vector<std::string> &payloads,
+                                    std::vector<StringExtractorGDBRemote> &responses);
+
     // For packets which specify a range of output to be returned,
     // return all of the output via a series of request packets of the form
     // <prefix>0,<size>
@@ -288,6 +315,49 @@ public:
     Error
     GetMemoryRegionInfo (lldb::addr_t addr, MemoryRegionInfo &range_info); 
 
+    //------------------------------------------------------------------
+    /// Get every mapped region of the process, sorted by address, with
+    /// one "jMemoryRegionsInfo" packet.
+    ///
+    /// @param[in,out] generation
+    ///     The generation of \a regions. If the stub's regions are still
+    ///     of this generation, \a regions is left alone. Otherwise it is
+    ///     replaced and \a generation is updated. Pass zero to always get
+    ///     the regions.
+    //------------------------------------------------------------------
+    Error
+    GetMemoryRegions (uint32_t &generation, std::vector<MemoryRegionInfo> &regions);
+
+    bool
+    GetMemoryRegionsSupported () const
+    {
+        return m_supports_jMemoryRegionsInfo;
+    }
+
+    //------------------------------------------------------------------
+    /// Have the stub search its memory for \a pattern with the standard
+    /// "qSearch:memory" packet, so only the result crosses the wire.
+    /// The stub scans all of \a length before it answers, so callers
+    /// should keep the range to a size it can scan quickly.
+    ///
+    /// @param[out] found_addr
+    ///     The address of the first match that lies entirely within
+    ///     [addr, addr + length), or LLDB_INVALID_ADDRESS if there is
+    ///     none.
+    //------------------------------------------------------------------
+    Error
+    SearchMemory (lldb::addr_t addr,
+                  lldb::addr_t length,
+                  const uint8_t *pattern,
+                  size_t pattern_size,
+                  lldb::addr_t &found_addr);
+
+    bool
+    GetSearchMemorySupported () const
+    {
+        return m_supports_qSearch_memory;
+    }
+
     Error
     GetWatchpointSupportInfo (uint32_t &num); 
 
@@ -450,6 +520,64 @@ public:
     bool
     GetQXferFeaturesReadSupported ();
 
+    bool
+    GetQSaveCoreSupported ();
+
+    bool
+    GetPipelinedPacketsSupported ();
+
+    bool
+    GetSharedMemoryBufferSupported ();
+
+    //------------------------------------------------------------------
+    /// Create a shared memory buffer of \a size bytes and ask the remote
+    /// stub to map it, after which ReadMemoryShared() can read memory
+    /// through it instead of through the connection.  This only works
+    /// when the stub runs on this host, which is how the stub failing to
+    /// map the buffer is reported.
+    //------------------------------------------------------------------
+    Error
+    SetUpSharedMemoryBuffer (size_t size);
+
+    bool
+    HasSharedMemoryBuffer () const
+    {
+        return m_shared_memory_up.get() != nullptr;
+    }
+
+    //------------------------------------------------------------------
+    /// Read inferior memory through the shared memory buffer.  Only the
+    /// "qSharedMemoryRead" request and its reply go over the connection,
+    /// the bytes themselves are copied once out of the buffer.
+    ///
+    /// @param[out] bytes_read
+    ///     The number of bytes copied to \a dst, which is at most the
+    ///     size of the buffer.
+    ///
+    /// @return
+    ///     False if the buffer can't be used right now, e.g. there is
+    ///     none or the process is running, and the caller should read
+    ///     the memory with regular packets instead.
+    //------------------------------------------------------------------
+    bool
+    ReadMemoryShared (lldb::addr_t addr,
+                      void *dst,
+                      size_t size,
+                      size_t &bytes_read,
+                      Error &error);
+
+    //------------------------------------------------------------------
+    /// Ask the remote stub to write a core file of the inferior.
+    ///
+    /// @param[in] path_hint
+    ///     Where the stub should write the core, or NULL to let it pick.
+    ///
+    /// @param[out] core_path
+    ///     The path, on the remote host, of the core that was written.
+    //------------------------------------------------------------------
+    Error
+    SaveCore (const char *path_hint, bool skip_file_backed, std::string &core_path);
+
     LazyBool
     SupportsAllocDeallocMemory () // const
     {
@@ -534,6 +662,20 @@ public:
     ReadAllRegisters (lldb::tid_t tid,
                       StringExtractorGDBRemote &response);
 
+    //------------------------------------------------------------------
+    /// Read several registers of one thread with "p" packets that are
+    /// pipelined when the remote stub allows it.
+    ///
+    /// @return
+    ///     True if every register got a response, in which case
+    ///     \a responses holds them in the order of \a reg_nums. A
+    ///     response can still be an error reply.
+    //------------------------------------------------------------------
+    bool
+    ReadRegisters (lldb::tid_t tid,
+                   const std::vector<uint32_t> &reg_nums,
+                   std::vector<StringExtractorGDBRemote> &responses);
+
     bool
     SaveRegisterState (lldb::tid_t tid, uint32_t &save_id);
     
@@ -573,6 +715,11 @@ public:
     ServeSymbolLookups(lldb_private::Process *process);
 
 protected:
+    // How many pipelined packets may wait for their responses at once.
+    // This keeps the unread responses from filling up the connection
+    // while we are still writing packets that the stub can't read.
+    static const size_t kMaxPacketsInFlight = 32;
+
     LazyBool m_supports_not_sending_acks;
     LazyBool m_supports_thread_suffix;
     LazyBool m_supports_threads_in_stop_reply;
@@ -602,6 +749,9 @@ protected:
     LazyBool m_supports_qXfer_libraries_svr4_read;
     LazyBool m_supports_qXfer_features_read;
     LazyBool m_supports_augmented_libraries_svr4_read;
+    LazyBool m_supports_qSaveCore;
+    LazyBool m_supports_pipelined_packets;
+    LazyBool m_supports_shared_memory_buffer;
     LazyBool m_supports_jThreadExtendedInfo;
     LazyBool m_supports_jLoadedDynamicLibrariesInfos;
 
@@ -621,7 +771,9 @@ protected:
         m_supports_qSymbol:1,
         m_qSymbol_requests_done:1,
         m_supports_qModuleInfo:1,
-        m_supports_jThreadsInfo:1;
+        m_supports_jThreadsInfo:1,
+        m_supports_jMemoryRegionsInfo:1,
+        m_supports_qSearch_memory:1;
     
     lldb::pid_t m_curr_pid;
     lldb::tid_t m_curr_tid;         // Current gdb remote protocol thread index for all other operations
@@ -653,6 +805,7 @@ protected:
     uint32_t m_gdb_server_version; // from reply to qGDBServerVersion, zero if qGDBServerVersion is not supported
     uint32_t m_default_packet_timeout;
     uint64_t m_max_packet_size;  // as returned by qSupported
+    std::unique_ptr<ConnectionSharedMemory> m_shared_memory_up;  // set up by SetUpSharedMemoryBuffer()
 
     PacketResult
     SendPacketAndWaitForResponseNoLock (const char *payload,
@@ -836,9 +836,13 @@ GDBRemoteCommunicationServerCommon::Handle_qSupported (StringExtractorGDBRemote
     response.PutCString (";QThreadSuffixSupported+");
     response.PutCString (";QListThreadsInStopReply+");
     response.PutCString (";qEcho+");
+    response.PutCString (";PipelinedPackets+");
 #if defined(__linux__)
     response.PutCString (";qXfer:auxv:read+");
+    response.PutCString (";QNonStop+");
+    response.PutCString (";qSaveCore+");
 #endif
+    AppendSupportedFeatures (response);
 
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
@@ -1244,6 +1248,11 @@ GDBRemoteCommunicationServerCommon::CreateProcessInfoResponse_DebugServerStyle (
     }
 }
 
+void
+GDBRemoteCommunicationServerCommon::AppendSupportedFeatures (StreamGDBRemote &response)
+{
+}
+
 FileSpec
 GDBRemoteCommunicationServerCommon::FindModuleFile(const std::string& module_path,
                                                    const ArchSpec& arch)
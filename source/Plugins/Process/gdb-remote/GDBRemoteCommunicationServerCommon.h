@@ -26,6 +26,9 @@
 class StringExtractorGDBRemote;
 
 namespace lldb_private {
+
+class StreamGDBRemote;
+
 namespace process_gdb_remote {
 
 class ProcessGDBRemote;
@@ -199,6 +202,13 @@ protected:
 
     virtual FileSpec
     FindModuleFile (const std::string& module_path, const ArchSpec& arch);
+
+    //------------------------------------------------------------------
+    /// Append the qSupported features that only this kind of server
+    /// handles to \a response.
+    //------------------------------------------------------------------
+    virtual void
+    AppendSupportedFeatures (StreamGDBRemote &response);
 };
 
 } // namespace process_gdb_remote
@@ -16,6 +16,7 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
 #include <cstring>
 #include <chrono>
 #include <thread>
@@ -28,6 +29,7 @@
 #include "lldb/Core/RegisterValue.h"
 #include "lldb/Core/State.h"
 #include "lldb/Core/StreamString.h"
+#include "lldb/Core/StructuredData.h"
 #include "lldb/Host/ConnectionFileDescriptor.h"
 #include "lldb/Host/Debug.h"
 #include "lldb/Host/Endian.h"
@@ -45,6 +47,7 @@
 #include "lldb/Host/common/NativeThreadProtocol.h"
 #include "lldb/Utility/JSON.h"
 #include "lldb/Utility/LLDBAssert.h"
+#include "lldb/Utility/MemorySearch.h"
 
 // Project includes
 #include "Utility/StringExtractorGDBRemote.h"
@@ -92,7 +95,10 @@ GDBRemoteCommunicationServerLLGS::GDBRemoteCommunicationServerLLGS(
     m_saved_registers_mutex (),
     m_saved_registers_map (),
     m_next_saved_registers_id (1),
-    m_handshake_completed (false)
+    m_handshake_completed (false),
+    m_non_stop (false),
+    m_stop_notification_queue (),
+    m_shared_memory_up ()
 {
     assert(platform_sp);
     RegisterPacketHandlers();
@@ -145,12 +151,24 @@ GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers()
                                   &GDBRemoteCommunicationServerLLGS::Handle_QSetDisableASLR);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QSetWorkingDir,
                                   &GDBRemoteCommunicationServerLLGS::Handle_QSetWorkingDir);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qSaveCore,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_qSaveCore);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QSetSharedMemoryBuffer,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_QSetSharedMemoryBuffer);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qSharedMemoryRead,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_qSharedMemoryRead);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qSearch_memory,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_qSearch_memory);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qsThreadInfo,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qsThreadInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qThreadStopInfo,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qThreadStopInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_jThreadsInfo,
                                   &GDBRemoteCommunicationServerLLGS::Handle_jThreadsInfo);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_jMemoryRegionsInfo,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_jMemoryRegionsInfo);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QNonStop,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_QNonStop);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qWatchpointSupportInfo,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qWatchpointSupportInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qXfer_auxv_read,
@@ -165,6 +183,8 @@ GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers()
                                   &GDBRemoteCommunicationServerLLGS::Handle_vCont);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_vCont_actions,
                                   &GDBRemoteCommunicationServerLLGS::Handle_vCont_actions);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_vStopped,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_vStopped);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_x,
                                   &GDBRemoteCommunicationServerLLGS::Handle_memory_read);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_Z,
@@ -225,6 +245,14 @@ GDBRemoteCommunicationServerLLGS::LaunchProcess ()
         return error;
     }
 
+    // The client may have asked for non-stop mode before the process existed.
+    if (m_non_stop)
+    {
+        error = m_debugged_process_sp->SetNonStopMode (true);
+        if (error.Fail ())
+            return error;
+    }
+
     // Handle mirroring of inferior stdout/stderr over the gdb-remote protocol
     // as needed.
     // llgs local-process debugging may specify PTY paths, which will make these
@@ -291,6 +319,13 @@ GDBRemoteCommunicationServerLLGS::AttachToProcess (lldb::pid_t pid)
         return error;
     }
 
+    if (m_non_stop)
+    {
+        error = m_debugged_process_sp->SetNonStopMode (true);
+        if (error.Fail ())
+            return error;
+    }
+
     // Setup stdout/stderr mapping from inferior.
     auto terminal_fd = m_debugged_process_sp->GetTerminalFileDescriptor ();
     if (terminal_fd >= 0)
@@ -616,11 +651,35 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
     if (!thread_sp)
         return SendErrorResponse (51);
 
+    const auto start_time = std::chrono::steady_clock::now();
+
+    StreamString response;
+    if (!PrepareStopReplyPacketForThread (*thread_sp, response))
+        return SendErrorResponse (52);
+
+    if (log)
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - start_time;
+        log->Printf ("GDBRemoteCommunicationServerLLGS::%s prepared stop reply for tid %" PRIu64 " in %" PRIu64 " us",
+                __FUNCTION__, tid,
+                static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    }
+
+    return SendPacketNoLock (response.GetData(), response.GetSize());
+}
+
+bool
+GDBRemoteCommunicationServerLLGS::PrepareStopReplyPacketForThread (NativeThreadProtocol &thread, StreamString &response)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+
+    const lldb::tid_t tid = thread.GetID ();
+
     // Grab the reason this thread stopped.
     struct ThreadStopInfo tid_stop_info;
     std::string description;
-    if (!thread_sp->GetStopReason (tid_stop_info, description))
-        return SendErrorResponse (52);
+    if (!thread.GetStopReason (tid_stop_info, description))
+        return false;
 
     // FIXME implement register handling for exec'd inferiors.
     // if (tid_stop_info.reason == eStopReasonExec)
@@ -629,7 +688,6 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
     //     InitializeRegisters(force);
     // }
 
-    StreamString response;
     // Output the T packet with the thread
     response.PutChar ('T');
     int signum = tid_stop_info.details.signal.signo;
@@ -651,7 +709,7 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
     response.Printf ("thread:%" PRIx64 ";", tid);
 
     // Include the thread name if there is one.
-    const std::string thread_name = thread_sp->GetName ();
+    const std::string thread_name = thread.GetName ();
     if (!thread_name.empty ())
     {
         size_t thread_name_len = thread_name.length ();
@@ -723,7 +781,7 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
     //
 
     // Grab the register context.
-    NativeRegisterContextSP reg_ctx_sp = thread_sp->GetRegisterContext ();
+    NativeRegisterContextSP reg_ctx_sp = thread.GetRegisterContext ();
     if (reg_ctx_sp)
     {
         // Expedite all registers in the first register set (i.e. should be GPRs) that are not contained in other registers.
@@ -792,7 +850,7 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
         }
     }
 
-    return SendPacketNoLock (response.GetData(), response.GetSize());
+    return true;
 }
 
 void
@@ -837,6 +895,14 @@ GDBRemoteCommunicationServerLLGS::HandleInferiorState_Stopped (NativeProcessProt
             // Don't send anything per debugserver behavior.
             break;
         default:
+            // In non-stop mode the client is busy with other packets, so the
+            // stop goes out as an asynchronous notification instead.
+            if (m_non_stop)
+            {
+                QueueStopNotificationForThread (process->GetCurrentThreadID ());
+                break;
+            }
+
             // In all other cases, send the stop reason.
             PacketResult result = SendStopReasonForState(StateType::eStateStopped);
             if (result != PacketResult::Success)
@@ -906,6 +972,52 @@ GDBRemoteCommunicationServerLLGS::DidExec (NativeProcessProtocol *process)
     ClearProcessSpecificData ();
 }
 
+void
+GDBRemoteCommunicationServerLLGS::ThreadStopped (NativeProcessProtocol *process, lldb::tid_t tid)
+{
+    assert (process && "process cannot be NULL");
+
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+    if (log)
+        log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " tid %" PRIu64, __FUNCTION__, process->GetID (), tid);
+
+    // Flush what the inferior printed so far so it arrives before the stop.
+    SendProcessOutput ();
+    QueueStopNotificationForThread (tid);
+}
+
+void
+GDBRemoteCommunicationServerLLGS::QueueStopNotificationForThread (lldb::tid_t tid)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+
+    NativeThreadProtocolSP thread_sp;
+    if (m_debugged_process_sp)
+        thread_sp = m_debugged_process_sp->GetThreadByID (tid);
+
+    StreamString response;
+    if (!thread_sp || !PrepareStopReplyPacketForThread (*thread_sp, response))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to prepare stop reply for tid %" PRIu64, __FUNCTION__, tid);
+        return;
+    }
+
+    m_stop_notification_queue.push_back (response.GetString ());
+
+    // Only one notification may be outstanding; the rest are fetched by the
+    // client with vStopped.
+    if (m_stop_notification_queue.size () == 1)
+    {
+        const std::string &payload = m_stop_notification_queue.front ();
+        if (SendNotificationPacketNoLock ("Stop", payload.c_str (), payload.size ()) != PacketResult::Success)
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to send stop notification for tid %" PRIu64, __FUNCTION__, tid);
+        }
+    }
+}
+
 void
 GDBRemoteCommunicationServerLLGS::DataAvailableCallback ()
 {
@@ -1247,6 +1359,9 @@ GDBRemoteCommunicationServerLLGS::Handle_C (StringExtractorGDBRemote &packet)
         return SendErrorResponse (0x38);
     }
 
+    if (m_non_stop)
+        return SendOKResponse ();
+
     // Don't send an "OK" packet; response is the stopped/exited message.
     return PacketResult::Success;
 }
@@ -1296,6 +1411,9 @@ GDBRemoteCommunicationServerLLGS::Handle_c (StringExtractorGDBRemote &packet)
     if (log)
         log->Printf ("GDBRemoteCommunicationServerLLGS::%s continued process %" PRIu64, __FUNCTION__, m_debugged_process_sp->GetID ());
 
+    if (m_non_stop)
+        return SendOKResponse ();
+
     // No response required from continue.
     return PacketResult::Success;
 }
@@ -1305,10 +1423,56 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont_actions (StringExtractorGDBRemote
 {
     StreamString response;
     response.Printf("vCont;c;C;s;S");
+    if (m_non_stop)
+        response.PutCString(";t");
 
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_QNonStop (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    packet.SetFilePos (::strlen ("QNonStop:"));
+    const uint32_t enable = packet.GetU32 (UINT32_MAX);
+    if (enable > 1)
+        return SendIllFormedResponse (packet, "QNonStop expects 0 or 1");
+
+    if (m_debugged_process_sp)
+    {
+        Error error = m_debugged_process_sp->SetNonStopMode (enable == 1);
+        if (error.Fail ())
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to %s non-stop mode: %s",
+                             __FUNCTION__, enable ? "enable" : "disable", error.AsCString ());
+            return SendErrorResponse (0x40);
+        }
+    }
+
+    m_non_stop = (enable == 1);
+    m_stop_notification_queue.clear ();
+    return SendOKResponse ();
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_vStopped (StringExtractorGDBRemote &packet)
+{
+    if (!m_non_stop)
+        return SendUnimplementedResponse (packet.GetStringRef().c_str());
+
+    // The client has seen the front entry, hand out the next one.
+    if (!m_stop_notification_queue.empty ())
+        m_stop_notification_queue.pop_front ();
+
+    if (m_stop_notification_queue.empty ())
+        return SendOKResponse ();
+
+    const std::string &payload = m_stop_notification_queue.front ();
+    return SendPacketNoLock (payload.c_str (), payload.size ());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_vCont (StringExtractorGDBRemote &packet)
 {
@@ -1385,6 +1549,13 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont (StringExtractorGDBRemote &packet
                 thread_action.state = eStateStepping;
                 break;
 
+            case 't':
+                // Stop; only meaningful when the other threads keep running.
+                if (!m_non_stop)
+                    return SendIllFormedResponse (packet, "vCont t action requires non-stop mode");
+                thread_action.state = eStateStopped;
+                break;
+
             default:
                 return SendIllFormedResponse (packet, "Unsupported vCont action");
                 break;
@@ -1420,6 +1591,10 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont (StringExtractorGDBRemote &packet
     if (log)
         log->Printf ("GDBRemoteCommunicationServerLLGS::%s continued process %" PRIu64, __FUNCTION__, m_debugged_process_sp->GetID ());
 
+    // In non-stop mode the stops come later as notifications, so acknowledge now.
+    if (m_non_stop)
+        return SendOKResponse ();
+
     // No response required from vCont.
     return PacketResult::Success;
 }
@@ -1455,6 +1630,30 @@ GDBRemoteCommunicationServerLLGS::Handle_stop_reason (StringExtractorGDBRemote &
     if (!m_debugged_process_sp)
         return SendErrorResponse (02);
 
+    // In non-stop mode '?' restarts the vStopped sequence with every thread
+    // that is currently stopped.
+    if (m_non_stop && StateIsRunningState (m_debugged_process_sp->GetState ()))
+    {
+        m_stop_notification_queue.clear ();
+
+        uint32_t thread_index = 0;
+        NativeThreadProtocolSP thread_sp;
+        for (thread_sp = m_debugged_process_sp->GetThreadAtIndex (thread_index); thread_sp; ++thread_index, thread_sp = m_debugged_process_sp->GetThreadAtIndex (thread_index))
+        {
+            if (!StateIsStoppedState (thread_sp->GetState (), true))
+                continue;
+            StreamString response;
+            if (PrepareStopReplyPacketForThread (*thread_sp, response))
+                m_stop_notification_queue.push_back (response.GetString ());
+        }
+
+        if (m_stop_notification_queue.empty ())
+            return SendOKResponse ();
+
+        const std::string &payload = m_stop_notification_queue.front ();
+        return SendPacketNoLock (payload.c_str (), payload.size ());
+    }
+
     return SendStopReasonForState (m_debugged_process_sp->GetState());
 }
 
@@ -2234,6 +2433,155 @@ GDBRemoteCommunicationServerLLGS::Handle_qMemoryRegionInfo (StringExtractorGDBRe
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_jMemoryRegionsInfo (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    // Ensure we have a process.
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x15);
+    }
+
+    // jMemoryRegionsInfo[:{"generation":<n>}]
+    uint32_t known_generation = 0;
+    packet.SetFilePos (strlen("jMemoryRegionsInfo"));
+    if (packet.GetBytesLeft () > 0)
+    {
+        if (packet.GetChar () != ':')
+            return SendIllFormedResponse (packet, "Malformed jMemoryRegionsInfo packet");
+        StructuredData::ObjectSP args_sp = StructuredData::ParseJSON (packet.Peek ());
+        StructuredData::Dictionary *args = args_sp ? args_sp->GetAsDictionary () : nullptr;
+        if (args == nullptr)
+            return SendIllFormedResponse (packet, "jMemoryRegionsInfo arguments must be a JSON dictionary");
+        args->GetValueForKeyAsInteger ("generation", known_generation);
+    }
+
+    std::vector<MemoryRegionInfo> regions;
+    uint32_t generation = 0;
+    const Error error = m_debugged_process_sp->GetMemoryRegions (regions, generation);
+    if (error.Fail ())
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to get the memory regions: %s", __FUNCTION__, error.AsCString ());
+        // Only tell the client to stop asking if this platform can't list
+        // the regions at all; reading them can also fail for a while, e.g.
+        // while the process is going away.
+        if (::strcmp (error.AsCString (), "not implemented") == 0)
+            return SendUnimplementedResponse (packet.GetStringRef ().c_str ());
+        return SendErrorResponse (0x08);
+    }
+
+    // The regions are left out if the client already has them.
+    JSONObject::SP response_object_sp = std::make_shared<JSONObject>();
+    response_object_sp->SetObject ("generation", std::make_shared<JSONNumber>(generation));
+    if (generation != known_generation)
+    {
+        JSONArray::SP regions_array_sp = std::make_shared<JSONArray>();
+        for (const MemoryRegionInfo &region_info : regions)
+        {
+            std::string permissions;
+            if (region_info.GetReadable ())
+                permissions.push_back ('r');
+            if (region_info.GetWritable ())
+                permissions.push_back ('w');
+            if (region_info.GetExecutable ())
+                permissions.push_back ('x');
+
+            JSONObject::SP region_object_sp = std::make_shared<JSONObject>();
+            region_object_sp->SetObject ("start", std::make_shared<JSONNumber>(region_info.GetRange ().GetRangeBase ()));
+            region_object_sp->SetObject ("size", std::make_shared<JSONNumber>(region_info.GetRange ().GetByteSize ()));
+            region_object_sp->SetObject ("permissions", std::make_shared<JSONString>(permissions));
+            regions_array_sp->AppendObject (region_object_sp);
+        }
+        response_object_sp->SetObject ("regions", regions_array_sp);
+    }
+
+    StreamString response;
+    response_object_sp->Write (response);
+    StreamGDBRemote escaped_response;
+    escaped_response.PutEscapedBytes (response.GetData (), response.GetSize ());
+    return SendPacketNoLock (escaped_response.GetData (), escaped_response.GetSize ());
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qSearch_memory (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    // Ensure we have a process.
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x15);
+    }
+
+    // qSearch:memory:<addr>;<length>;<pattern bytes>
+    packet.SetFilePos (strlen("qSearch:memory:"));
+    if (packet.GetBytesLeft() < 1)
+        return SendIllFormedResponse(packet, "Too short qSearch:memory packet");
+
+    const lldb::addr_t start_addr = packet.GetHexMaxU64(false, 0);
+    if ((packet.GetBytesLeft() < 1) || (packet.GetChar() != ';'))
+        return SendIllFormedResponse(packet, "Semicolon sep missing in qSearch:memory packet");
+
+    const uint64_t length = packet.GetHexMaxU64(false, 0);
+    if ((packet.GetBytesLeft() < 1) || (packet.GetChar() != ';'))
+        return SendIllFormedResponse(packet, "Semicolon sep missing in qSearch:memory packet");
+
+    // The rest of the packet is the pattern, already unescaped.
+    const size_t pattern_size = packet.GetBytesLeft();
+    if (pattern_size == 0)
+        return SendIllFormedResponse(packet, "Pattern missing in qSearch:memory packet");
+    const uint8_t *pattern = reinterpret_cast<const uint8_t *>(packet.Peek());
+
+    const lldb::addr_t end_addr = length > UINT64_MAX - start_addr ? UINT64_MAX : start_addr + length;
+
+    // Read the range a chunk at a time, with process_vm_readv where the
+    // kernel has it, and scan each chunk.
+    const MemorySearcher searcher (pattern, pattern_size);
+    std::string buf (std::max<size_t> (1024 * 1024, 2 * pattern_size), '\0');
+    NativeProcessProtocolSP process_sp = m_debugged_process_sp;
+
+    auto read = [process_sp, &buf] (lldb::addr_t addr, size_t wanted, size_t &bytes_read) -> const uint8_t *
+    {
+        process_sp->ReadMemoryWithoutTrap (addr, &buf[0], wanted, bytes_read);
+        return reinterpret_cast<const uint8_t *>(buf.data());
+    };
+
+    // Skip past memory that isn't mapped or readable.
+    auto skip_unreadable = [process_sp] (lldb::addr_t bad_addr, lldb::addr_t &next_addr) -> bool
+    {
+        MemoryRegionInfo region_info;
+        const Error error = process_sp->GetMemoryRegionInfo (bad_addr, region_info);
+        if (error.Fail () || region_info.GetReadable () == MemoryRegionInfo::eYes)
+            return false;
+        next_addr = region_info.GetRange ().GetRangeEnd ();
+        return true;
+    };
+
+    lldb::addr_t found_addr = LLDB_INVALID_ADDRESS;
+    if (!searcher.FindInRange (start_addr, end_addr, buf.size (), read, skip_unreadable, found_addr))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 ": failed to read memory in [0x%" PRIx64 ", 0x%" PRIx64 ")",
+                         __FUNCTION__, m_debugged_process_sp->GetID (), start_addr, end_addr);
+        return SendErrorResponse (0x08);
+    }
+
+    if (found_addr != LLDB_INVALID_ADDRESS)
+    {
+        StreamGDBRemote response;
+        response.Printf ("1,%" PRIx64, found_addr);
+        return SendPacketNoLock (response.GetData(), response.GetSize());
+    }
+    return SendPacketNoLock ("0", 1);
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_Z (StringExtractorGDBRemote &packet)
 {
@@ -2453,6 +2801,9 @@ GDBRemoteCommunicationServerLLGS::Handle_s (StringExtractorGDBRemote &packet)
         return SendErrorResponse(0x49);
     }
 
+    if (m_non_stop)
+        return SendOKResponse ();
+
     // No response here - the stop or exit will come from the resulting action.
     return PacketResult::Success;
 }
@@ -2780,6 +3131,8 @@ GDBRemoteCommunicationServerLLGS::Handle_jThreadsInfo (StringExtractorGDBRemote
                 __FUNCTION__, m_debugged_process_sp->GetID());
 
 
+    const auto start_time = std::chrono::steady_clock::now();
+
     StreamString response;
     const bool threads_with_valid_stop_info_only = false;
     JSONArray::SP threads_array_sp = GetJSONThreadsInfo(*m_debugged_process_sp,
@@ -2795,6 +3148,14 @@ GDBRemoteCommunicationServerLLGS::Handle_jThreadsInfo (StringExtractorGDBRemote
     threads_array_sp->Write(response);
     StreamGDBRemote escaped_response;
     escaped_response.PutEscapedBytes(response.GetData(), response.GetSize());
+
+    if (log)
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - start_time;
+        log->Printf ("GDBRemoteCommunicationServerLLGS::%s collected stop info and registers of pid %" PRIu64 " into %zu bytes in %" PRIu64 " us",
+                __FUNCTION__, m_debugged_process_sp->GetID(), escaped_response.GetSize(),
+                static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    }
     return SendPacketNoLock (escaped_response.GetData(), escaped_response.GetSize());
 }
 
@@ -2846,6 +3207,142 @@ GDBRemoteCommunicationServerLLGS::Handle_qFileLoadAddress (StringExtractorGDBRem
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qSaveCore (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    // Fail if we don't have a current process.
+    if (!m_debugged_process_sp ||
+            m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID)
+        return SendErrorResponse(67);
+
+    // qSaveCore[;path-hint:<hex path>][;skip-file-backed:<0|1>]
+    packet.SetFilePos(strlen("qSaveCore"));
+    std::string core_path;
+    bool skip_file_backed = false;
+    std::string name;
+    std::string value;
+    while (packet.GetBytesLeft() && packet.GetChar() == ';' && packet.GetNameColonValue(name, value))
+    {
+        if (name == "path-hint")
+        {
+            StringExtractor path_extractor(value.c_str());
+            path_extractor.GetHexByteString(core_path);
+        }
+        else if (name == "skip-file-backed")
+            skip_file_backed = StringConvert::ToUInt32(value.c_str(), 0, 0) != 0;
+    }
+
+    if (core_path.empty())
+    {
+        FileSpec tmpdir_spec;
+        if (!HostInfo::GetLLDBPath(ePathTypeLLDBTempSystemDir, tmpdir_spec))
+            return SendErrorResponse(0x20);
+        StreamString core_name;
+        core_name.Printf("core.%" PRIu64, m_debugged_process_sp->GetID());
+        tmpdir_spec.AppendPathComponent(core_name.GetData());
+        core_path = tmpdir_spec.GetPath();
+    }
+
+    Error error = m_debugged_process_sp->SaveCore(core_path, skip_file_backed);
+    if (error.Fail())
+    {
+        if (log)
+            log->Printf("GDBRemoteCommunicationServerLLGS::%s failed to save a core file to %s: %s",
+                        __FUNCTION__, core_path.c_str(), error.AsCString());
+        return SendErrorResponse(0x21);
+    }
+
+    StreamGDBRemote response;
+    response.PutCString("core-path:");
+    response.PutCStringAsRawHex8(core_path.c_str());
+    response.PutChar(';');
+    return SendPacketNoLock(response.GetData(), response.GetSize());
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_QSetSharedMemoryBuffer (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    // QSetSharedMemoryBuffer:name:<hex name>;size:<hex size>;
+    packet.SetFilePos(strlen("QSetSharedMemoryBuffer:"));
+    std::string buffer_name;
+    uint64_t buffer_size = 0;
+    std::string name;
+    std::string value;
+    while (packet.GetNameColonValue(name, value))
+    {
+        if (name == "name")
+        {
+            StringExtractor name_extractor(value.c_str());
+            name_extractor.GetHexByteString(buffer_name);
+        }
+        else if (name == "size")
+            buffer_size = StringConvert::ToUInt64(value.c_str(), 0, 16);
+    }
+
+    m_shared_memory_up.reset();
+    if (buffer_name.empty() || buffer_size == 0)
+        return SendIllFormedResponse(packet, "QSetSharedMemoryBuffer needs a name and a size");
+
+    // The client created the buffer, so if we can map it we both run on
+    // the same host.
+    Error error;
+    std::unique_ptr<ConnectionSharedMemory> shared_memory_up(new ConnectionSharedMemory());
+    if (shared_memory_up->Open(false, buffer_name.c_str(), buffer_size, &error) != eConnectionStatusSuccess)
+    {
+        if (log)
+            log->Printf("GDBRemoteCommunicationServerLLGS::%s failed to map shared memory buffer %s: %s",
+                        __FUNCTION__, buffer_name.c_str(), error.AsCString());
+        return SendErrorResponse(0x22);
+    }
+
+    m_shared_memory_up = std::move(shared_memory_up);
+    return SendOKResponse();
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qSharedMemoryRead (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    if (!m_shared_memory_up)
+        return SendUnimplementedResponse(packet.GetStringRef().c_str());
+
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x15);
+    }
+
+    // qSharedMemoryRead:<hex address>,<hex length>
+    packet.SetFilePos(strlen("qSharedMemoryRead:"));
+    const lldb::addr_t read_addr = packet.GetHexMaxU64(false, LLDB_INVALID_ADDRESS);
+    if (read_addr == LLDB_INVALID_ADDRESS || packet.GetChar() != ',')
+        return SendIllFormedResponse(packet, "Malformed qSharedMemoryRead packet");
+    const uint64_t byte_count = std::min<uint64_t>(packet.GetHexMaxU64(false, 0),
+                                                   m_shared_memory_up->GetByteSize());
+
+    // Read straight into the buffer, the reply only carries the count.
+    size_t bytes_read = 0;
+    Error error = m_debugged_process_sp->ReadMemoryWithoutTrap(read_addr, m_shared_memory_up->GetBytes(), byte_count, bytes_read);
+    if (error.Fail () || bytes_read == 0)
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " mem 0x%" PRIx64 ": failed to read %" PRIu64 " bytes: %s",
+                         __FUNCTION__, m_debugged_process_sp->GetID (), read_addr, byte_count,
+                         error.Fail () ? error.AsCString () : "nothing readable");
+        return SendErrorResponse (0x08);
+    }
+
+    StreamGDBRemote response;
+    response.Printf("%" PRIx64, (uint64_t)bytes_read);
+    return SendPacketNoLock(response.GetData(), response.GetSize());
+}
+
 void
 GDBRemoteCommunicationServerLLGS::MaybeCloseInferiorTerminalConnection ()
 {
@@ -2967,6 +3464,9 @@ GDBRemoteCommunicationServerLLGS::ClearProcessSpecificData ()
                      m_active_auxv_buffer_sp ? "was set" : "was not set");
     m_active_auxv_buffer_sp.reset ();
 #endif
+
+    // Stop replies queued for the old image refer to threads that are gone.
+    m_stop_notification_queue.clear ();
 }
 
 FileSpec
@@ -2985,3 +3485,12 @@ GDBRemoteCommunicationServerLLGS::FindModuleFile(const std::string& module_path,
 
     return GDBRemoteCommunicationServerCommon::FindModuleFile(module_path, arch);
 }
+
+void
+GDBRemoteCommunicationServerLLGS::AppendSupportedFeatures (StreamGDBRemote &response)
+{
+    // lldb-platform doesn't handle the shared memory packets.
+#if defined(__linux__) && !defined(__ANDROID_NDK__)
+    response.PutCString (";QSetSharedMemoryBuffer+");
+#endif
+}
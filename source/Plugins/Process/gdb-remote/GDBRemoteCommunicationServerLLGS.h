@@ -12,11 +12,15 @@
 
 // C Includes
 // C++ Includes
+#include <deque>
+#include <memory>
+#include <string>
 #include <unordered_map>
 
 // Other libraries and framework includes
 #include "lldb/lldb-private-forward.h"
 #include "lldb/Core/Communication.h"
+#include "lldb/Core/ConnectionSharedMemory.h"
 #include "lldb/Host/Mutex.h"
 #include "lldb/Host/common/NativeProcessProtocol.h"
 #include "lldb/Host/MainLoop.h"
@@ -110,6 +114,9 @@ public:
     void
     DidExec (NativeProcessProtocol *process) override;
 
+    void
+    ThreadStopped (NativeProcessProtocol *process, lldb::tid_t tid) override;
+
     Error
     InitializeConnection (std::unique_ptr<Connection> &&connection);
 
@@ -131,6 +138,13 @@ protected:
     std::unordered_map<uint32_t, lldb::DataBufferSP> m_saved_registers_map;
     uint32_t m_next_saved_registers_id;
     bool m_handshake_completed : 1;
+    bool m_non_stop : 1;
+    // Stop replies waiting to be fetched by the client in non-stop mode.  The
+    // front entry is the one the client was last told about, either through a
+    // %Stop notification or as the reply to '?' or vStopped.
+    std::deque<std::string> m_stop_notification_queue;
+    // The buffer a client on this host asked us to read memory into.
+    std::unique_ptr<ConnectionSharedMemory> m_shared_memory_up;
 
     PacketResult
     SendONotification (const char *buffer, uint32_t len);
@@ -141,6 +155,12 @@ protected:
     PacketResult
     SendStopReplyPacketForThread (lldb::tid_t tid);
 
+    bool
+    PrepareStopReplyPacketForThread (NativeThreadProtocol &thread, StreamString &response);
+
+    void
+    QueueStopNotificationForThread (lldb::tid_t tid);
+
     PacketResult
     SendStopReasonForState (lldb::StateType process_state);
 
@@ -174,6 +194,12 @@ protected:
     PacketResult
     Handle_vCont_actions (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_QNonStop (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_vStopped (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_stop_reason (StringExtractorGDBRemote &packet);
 
@@ -214,6 +240,12 @@ protected:
     PacketResult
     Handle_qMemoryRegionInfo (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_jMemoryRegionsInfo (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_qSearch_memory (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_Z (StringExtractorGDBRemote &packet);
 
@@ -250,6 +282,15 @@ protected:
     PacketResult
     Handle_qFileLoadAddress (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_qSaveCore (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_QSetSharedMemoryBuffer (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_qSharedMemoryRead (StringExtractorGDBRemote &packet);
+
     void
     SetCurrentThreadID (lldb::tid_t tid);
 
@@ -268,6 +309,9 @@ protected:
     FileSpec
     FindModuleFile (const std::string& module_path, const ArchSpec& arch) override;
 
+    void
+    AppendSupportedFeatures (StreamGDBRemote &response) override;
+
 private:
     void
     HandleInferiorState_Exited (NativeProcessProtocol *process);
@@ -55,7 +55,10 @@ GDBRemoteCommunicationServerPlatform::GDBRemoteCommunicationServerPlatform(const
     m_spawned_pids_mutex (Mutex::eMutexTypeRecursive),
     m_platform_sp (Platform::GetHostPlatform ()),
     m_port_map (),
-    m_port_offset(0)
+    m_port_offset(0),
+    m_gdbserver_pool_size(0),
+    m_gdbserver_pool(),
+    m_adopted_gdbservers()
 {
     m_pending_gdb_server.pid = LLDB_INVALID_PROCESS_ID;
     m_pending_gdb_server.port = 0;
@@ -94,6 +97,15 @@ GDBRemoteCommunicationServerPlatform::GDBRemoteCommunicationServerPlatform(const
 //----------------------------------------------------------------------
 GDBRemoteCommunicationServerPlatform::~GDBRemoteCommunicationServerPlatform()
 {
+    // Nobody is going to connect to the gdbservers still waiting in the
+    // pool.  Kill them while we can still reap them.
+    std::vector<GDBServerInfo> pool;
+    {
+        Mutex::Locker locker (m_spawned_pids_mutex);
+        pool.swap(m_gdbserver_pool);
+    }
+    for (const GDBServerInfo &gdbserver : pool)
+        KillSpawnedProcess(gdbserver.pid);
 }
 
 Error
@@ -200,7 +212,11 @@ GDBRemoteCommunicationServerPlatform::Handle_qLaunchGDBServer (StringExtractorGD
 
     lldb::pid_t debugserver_pid = LLDB_INVALID_PROCESS_ID;
     std::string socket_name;
-    Error error = LaunchGDBServer(Args(), hostname, debugserver_pid, port, socket_name);
+    Error error;
+    // The gdbservers in the pool listen on a port of our choosing, so they
+    // can only be used if the client didn't ask for a specific one.
+    if (port != UINT16_MAX || !TakeGDBServerFromPool(debugserver_pid, port, socket_name))
+        error = LaunchGDBServer(Args(), hostname, debugserver_pid, port, socket_name);
     if (error.Fail())
     {
         if (log)
@@ -284,6 +300,13 @@ GDBRemoteCommunicationServerPlatform::KillSpawnedProcess (lldb::pid_t pid)
     // make sure we know about this process
     {
         Mutex::Locker locker (m_spawned_pids_mutex);
+        if (m_adopted_gdbservers.erase(pid) > 0)
+        {
+            // The accepting process reaps it, we can't wait for that.
+            FreePortForProcess(pid);
+            Host::Kill (pid, SIGKILL);
+            return true;
+        }
         if (m_spawned_pids.find(pid) == m_spawned_pids.end())
             return false;
     }
@@ -448,6 +471,14 @@ GDBRemoteCommunicationServerPlatform::DebugserverProcessReaped (lldb::pid_t pid)
 {
     Mutex::Locker locker (m_spawned_pids_mutex);
     FreePortForProcess(pid);
+    for (auto pos = m_gdbserver_pool.begin(); pos != m_gdbserver_pool.end(); ++pos)
+    {
+        if (pos->pid == pid)
+        {
+            m_gdbserver_pool.erase(pos);
+            break;
+        }
+    }
     return m_spawned_pids.erase(pid) > 0;
 }
 
@@ -597,6 +628,87 @@ GDBRemoteCommunicationServerPlatform::SetPortOffset(uint16_t port_offset)
     m_port_offset = port_offset;
 }
 
+void
+GDBRemoteCommunicationServerPlatform::SetGDBServerPoolSize (size_t pool_size)
+{
+    m_gdbserver_pool_size = pool_size;
+}
+
+bool
+GDBRemoteCommunicationServerPlatform::GDBServerPoolNeedsRefill ()
+{
+    Mutex::Locker locker (m_spawned_pids_mutex);
+    return m_gdbserver_pool.size() < m_gdbserver_pool_size;
+}
+
+Error
+GDBRemoteCommunicationServerPlatform::RefillGDBServerPool ()
+{
+    Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PLATFORM));
+
+    GDBServerInfo gdbserver;
+    gdbserver.pid = LLDB_INVALID_PROCESS_ID;
+    gdbserver.port = UINT16_MAX;
+    Error error = LaunchGDBServer(Args(), "", gdbserver.pid, gdbserver.port, gdbserver.socket_name);
+    if (error.Fail())
+    {
+        // Don't keep retrying every time the client goes idle, launching on
+        // demand still works if the problem was temporary.
+        if (log)
+            log->Printf("GDBRemoteCommunicationServerPlatform::%s() failed to start a gdbserver for the pool, disabling it: %s",
+                        __FUNCTION__, error.AsCString());
+        m_gdbserver_pool_size = 0;
+        return error;
+    }
+
+    if (log)
+        log->Printf("GDBRemoteCommunicationServerPlatform::%s() gdbserver pid %" PRIu64 " is waiting on port %u",
+                    __FUNCTION__, gdbserver.pid, gdbserver.port);
+
+    Mutex::Locker locker (m_spawned_pids_mutex);
+    m_gdbserver_pool.push_back(gdbserver);
+    return error;
+}
+
+bool
+GDBRemoteCommunicationServerPlatform::TakeGDBServerFromPool (lldb::pid_t &pid, uint16_t &port, std::string &socket_name)
+{
+    Mutex::Locker locker (m_spawned_pids_mutex);
+    if (m_gdbserver_pool.empty())
+        return false;
+
+    // Hand out the gdbserver that has been waiting the longest.  The ones
+    // that exited in the meantime were already removed by
+    // DebugserverProcessReaped.
+    const GDBServerInfo &gdbserver = m_gdbserver_pool.front();
+    pid = gdbserver.pid;
+    port = gdbserver.port;
+    socket_name = gdbserver.socket_name;
+    m_gdbserver_pool.erase(m_gdbserver_pool.begin());
+    return true;
+}
+
+void
+GDBRemoteCommunicationServerPlatform::AdoptGDBServer (lldb::pid_t pid, uint16_t port, const std::string &socket_name)
+{
+    Mutex::Locker locker (m_spawned_pids_mutex);
+    GDBServerInfo gdbserver;
+    gdbserver.pid = pid;
+    gdbserver.port = port;
+    gdbserver.socket_name = socket_name;
+    m_gdbserver_pool.push_back(gdbserver);
+    m_adopted_gdbservers.insert(pid);
+    AssociatePortWithProcess(port, pid);
+}
+
+void
+GDBRemoteCommunicationServerPlatform::ReserveGDBServerPoolPorts (GDBRemoteCommunicationServerPlatform &connection_platform)
+{
+    Mutex::Locker locker (m_spawned_pids_mutex);
+    for (const GDBServerInfo &gdbserver : m_gdbserver_pool)
+        connection_platform.AssociatePortWithProcess(gdbserver.port, gdbserver.pid);
+}
+
 void
 GDBRemoteCommunicationServerPlatform::SetPendingGdbServer(lldb::pid_t pid,
                                                           uint16_t port,
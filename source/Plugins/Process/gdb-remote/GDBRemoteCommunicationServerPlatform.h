@@ -14,6 +14,7 @@
 // C++ Includes
 #include <map>
 #include <set>
+#include <vector>
 
 // Other libraries and framework includes
 // Project includes
@@ -79,7 +80,50 @@ public:
     void
     SetPendingGdbServer(lldb::pid_t pid, uint16_t port, const std::string& socket_name);
 
+    //----------------------------------------------------------------------
+    // Keep up to pool_size gdbservers started ahead of time, waiting for a
+    // connection, so that qLaunchGDBServer can hand one out right away
+    // instead of waiting for a new lldb-server process to start up.
+    //----------------------------------------------------------------------
+    void
+    SetGDBServerPoolSize (size_t pool_size);
+
+    // Returns true if the pool of waiting gdbservers isn't full.
+    bool
+    GDBServerPoolNeedsRefill ();
+
+    // Start one more gdbserver for the pool.  Meant to be called while the
+    // client is idle, since starting a gdbserver blocks packet handling.
+    Error
+    RefillGDBServerPool ();
+
+    // Take a waiting gdbserver out of the pool.  Returns false if it is empty.
+    bool
+    TakeGDBServerFromPool (lldb::pid_t &pid, uint16_t &port, std::string &socket_name);
+
+    //----------------------------------------------------------------------
+    // With --server, the pool is kept by the accepting process, and the
+    // process forked for a connection is handed one of its gdbservers.
+    // That gdbserver isn't our child: we can kill it but only the accepting
+    // process can reap it.
+    //----------------------------------------------------------------------
+    void
+    AdoptGDBServer (lldb::pid_t pid, uint16_t port, const std::string &socket_name);
+
+    // Mark the ports of the gdbservers waiting in this pool as taken in
+    // connection_platform's port map, so it doesn't start its own
+    // gdbservers on them.
+    void
+    ReserveGDBServerPoolPorts (GDBRemoteCommunicationServerPlatform &connection_platform);
+
 protected:
+    struct GDBServerInfo
+    {
+        lldb::pid_t pid;
+        uint16_t port;
+        std::string socket_name;
+    };
+
     const Socket::SocketProtocol m_socket_protocol;
     const std::string m_socket_scheme;
     Mutex m_spawned_pids_mutex;
@@ -89,6 +133,9 @@ protected:
     PortMap m_port_map;
     uint16_t m_port_offset;
     struct { lldb::pid_t pid; uint16_t port; std::string socket_name; } m_pending_gdb_server;
+    size_t m_gdbserver_pool_size;
+    std::vector<GDBServerInfo> m_gdbserver_pool; // Protected by m_spawned_pids_mutex
+    std::set<lldb::pid_t> m_adopted_gdbservers;  // Protected by m_spawned_pids_mutex
 
     PacketResult
     Handle_qLaunchGDBServer (StringExtractorGDBRemote &packet);
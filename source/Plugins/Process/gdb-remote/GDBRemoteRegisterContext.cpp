@@ -11,6 +11,7 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
 // Other libraries and framework includes
 #include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/DataExtractor.h"
@@ -205,6 +206,59 @@ GDBRemoteRegisterContext::GetPrimordialRegister(const RegisterInfo *reg_info,
     return false;
 }
 
+// Helper function for GDBRemoteRegisterContext::ReadRegisterBytes().
+// Reads \a reg_info and, if it is a general purpose register, the other
+// general purpose registers that aren't valid yet.  The unwinder asks for
+// the pc, sp and fp one at a time, so when the stub takes pipelined
+// packets this costs one round trip instead of one per register.
+bool
+GDBRemoteRegisterContext::GetPrimordialRegisterSet(const RegisterInfo *reg_info,
+                                                   GDBRemoteCommunicationClient &gdb_comm)
+{
+    if (!gdb_comm.GetPipelinedPacketsSupported())
+        return GetPrimordialRegister(reg_info, gdb_comm);
+
+    // Only batch the general purpose registers, the first set, which
+    // usually get read together anyway.  Leave out vector registers:
+    // they are big, and rarely wanted just because a GPR was.
+    const uint32_t reg = reg_info->kinds[eRegisterKindLLDB];
+    const RegisterSet *reg_set = m_reg_info.GetNumRegisterSets() > 0 ? m_reg_info.GetRegisterSet(0) : NULL;
+    if (reg_set == NULL ||
+        std::find(reg_set->registers, reg_set->registers + reg_set->num_registers, reg) == reg_set->registers + reg_set->num_registers)
+        return GetPrimordialRegister(reg_info, gdb_comm);
+
+    std::vector<uint32_t> reg_nums;
+    reg_nums.push_back(reg);
+    for (size_t i = 0; i < reg_set->num_registers; ++i)
+    {
+        const uint32_t set_reg = reg_set->registers[i];
+        if (set_reg == reg || GetRegisterIsValid(set_reg))
+            continue;
+        const RegisterInfo *set_reg_info = GetRegisterInfoAtIndex(set_reg);
+        if (set_reg_info &&
+            set_reg_info->value_regs == NULL &&
+            set_reg_info->encoding != eEncodingVector &&
+            set_reg_info->byte_size <= sizeof(uint64_t))
+            reg_nums.push_back(set_reg);
+    }
+
+    if (reg_nums.size() <= 1)
+        return GetPrimordialRegister(reg_info, gdb_comm);
+
+    std::vector<StringExtractorGDBRemote> responses;
+    if (!gdb_comm.ReadRegisters(m_thread.GetProtocolID(), reg_nums, responses))
+        return false;
+
+    for (size_t i = 0; i < reg_nums.size(); ++i)
+    {
+        // Some registers of a set may not be readable, which only matters
+        // for the one that was asked for.
+        if (responses[i].IsNormalResponse())
+            PrivateSetRegisterValue (reg_nums[i], responses[i]);
+    }
+    return GetRegisterIsValid(reg);
+}
+
 bool
 GDBRemoteRegisterContext::ReadRegisterBytes (const RegisterInfo *reg_info, DataExtractor &data)
 {
@@ -254,7 +308,7 @@ GDBRemoteRegisterContext::ReadRegisterBytes (const RegisterInfo *reg_info, DataE
                 {
                     // Read the containing register if it hasn't already been read
                     if (!GetRegisterIsValid(prim_reg))
-                        success = GetPrimordialRegister(prim_reg_info, gdb_comm);
+                        success = GetPrimordialRegisterSet(prim_reg_info, gdb_comm);
                 }
             }
 
@@ -267,8 +321,9 @@ GDBRemoteRegisterContext::ReadRegisterBytes (const RegisterInfo *reg_info, DataE
         }
         else
         {
-            // Get each register individually
-            GetPrimordialRegister(reg_info, gdb_comm);
+            // Get each register individually, along with the rest of its
+            // register set when the packets can be pipelined.
+            GetPrimordialRegisterSet(reg_info, gdb_comm);
         }
 
         // Make sure we got a valid register value after reading it
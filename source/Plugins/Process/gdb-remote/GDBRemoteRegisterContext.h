@@ -155,6 +155,8 @@ private:
     // Helper function for ReadRegisterBytes().
     bool GetPrimordialRegister(const RegisterInfo *reg_info,
                                GDBRemoteCommunicationClient &gdb_comm);
+    bool GetPrimordialRegisterSet(const RegisterInfo *reg_info,
+                                  GDBRemoteCommunicationClient &gdb_comm);
     // Helper function for WriteRegisterBytes().
     bool SetPrimordialRegister(const RegisterInfo *reg_info,
                                GDBRemoteCommunicationClient &gdb_comm);
@@ -22,6 +22,7 @@
 
 // C++ Includes
 #include <algorithm>
+#include <iterator>
 #include <map>
 #include <mutex>
 
@@ -72,6 +73,7 @@
 #include "Plugins/Process/Utility/StopInfoMachException.h"
 #include "Plugins/Platform/MacOSX/PlatformRemoteiOS.h"
 #include "Utility/StringExtractorGDBRemote.h"
+#include "Utility/UriParser.h"
 #include "GDBRemoteRegisterContext.h"
 #include "ProcessGDBRemote.h"
 #include "ProcessGDBRemoteLog.h"
@@ -107,13 +109,15 @@ namespace {
     {
         { "packet-timeout" , OptionValue::eTypeUInt64 , true , 1, NULL, NULL, "Specify the default packet timeout in seconds." },
         { "target-definition-file" , OptionValue::eTypeFileSpec , true, 0 , NULL, NULL, "The file that provides the description for remote target registers." },
+        { "shared-memory-buffer-size" , OptionValue::eTypeUInt64 , true , 16 * 1024 * 1024, NULL, NULL, "The size of the shared memory buffer used to read memory from a GDB server running on this host, or zero to always read memory with packets." },
         {  NULL            , OptionValue::eTypeInvalid, false, 0, NULL, NULL, NULL  }
     };
 
     enum
     {
         ePropertyPacketTimeout,
-        ePropertyTargetDefinitionFile
+        ePropertyTargetDefinitionFile,
+        ePropertySharedMemoryBufferSize
     };
 
     class PluginProperties : public Properties
@@ -158,6 +162,13 @@ namespace {
             const uint32_t idx = ePropertyTargetDefinitionFile;
             return m_collection_sp->GetPropertyAtIndexAsFileSpec (NULL, idx);
         }
+
+        uint64_t
+        GetSharedMemoryBufferSize() const
+        {
+            const uint32_t idx = ePropertySharedMemoryBufferSize;
+            return m_collection_sp->GetPropertyAtIndexAsUInt64(NULL, idx, g_properties[idx].default_uint_value);
+        }
     };
 
     typedef std::shared_ptr<PluginProperties> ProcessKDPPropertiesSP;
@@ -288,6 +299,9 @@ ProcessGDBRemote::ProcessGDBRemote(lldb::TargetSP target_sp, ListenerSP listener
     m_max_memory_size (0),
     m_remote_stub_max_memory_size (0),
     m_addr_to_mmap_size (),
+    m_memory_regions (),
+    m_memory_regions_generation (0),
+    m_memory_regions_stop_id (UINT32_MAX),
     m_thread_create_bp_sp (),
     m_waiting_for_attach (false),
     m_destroy_tried_resuming (false),
@@ -1133,6 +1147,16 @@ ProcessGDBRemote::ConnectToDebugserver (const char *connect_url)
     m_gdb_comm.GetVContSupported ('c');
     m_gdb_comm.GetVAttachOrWaitSupported();
 
+    // Read memory through shared memory if the GDB server runs on this host.
+    const uint64_t shared_memory_buffer_size = GetGlobalPluginProperties()->GetSharedMemoryBufferSize();
+    if (shared_memory_buffer_size > 0 && m_gdb_comm.GetSharedMemoryBufferSupported())
+    {
+        Error shm_error = m_gdb_comm.SetUpSharedMemoryBuffer(shared_memory_buffer_size);
+        if (log)
+            log->Printf("ProcessGDBRemote::%s shared memory buffer: %s", __FUNCTION__,
+                        shm_error.Success() ? "enabled" : shm_error.AsCString());
+    }
+
     // Ask the remote server for the default thread id
     if (GetTarget().GetNonStopModeEnabled())
         m_gdb_comm.GetDefaultThreadId(m_initial_tid);
@@ -3040,6 +3064,12 @@ ProcessGDBRemote::WillPublicStop ()
 size_t
 ProcessGDBRemote::DoReadMemory (addr_t addr, void *buf, size_t size, Error &error)
 {
+    // Reads through the shared memory buffer are only limited by its size.
+    size_t bytes_read = 0;
+    if (m_gdb_comm.HasSharedMemoryBuffer() &&
+        m_gdb_comm.ReadMemoryShared(addr, buf, size, bytes_read, error))
+        return bytes_read;
+
     GetMaxMemorySize ();
     if (size > m_max_memory_size)
     {
@@ -3095,6 +3125,44 @@ ProcessGDBRemote::DoReadMemory (addr_t addr, void *buf, size_t size, Error &erro
     return 0;
 }
 
+addr_t
+ProcessGDBRemote::FindInMemory (addr_t low, addr_t high, const uint8_t *buf, size_t size)
+{
+    // Let the stub scan the range where the memory lives instead of
+    // pulling all of it over the connection.
+    if (buf != nullptr && size > 0 && low < high && m_gdb_comm.GetSearchMemorySupported())
+    {
+        // The stub can't be interrupted while it handles a packet, so ask
+        // for a bounded slice of the range at a time instead of all of it.
+        // Slices overlap by size - 1 bytes so a match that straddles two
+        // of them is still found.
+        const addr_t slice_size = std::max<addr_t> (16 * 1024 * 1024, 2 * size);
+
+        // A match may start anywhere below high.
+        const addr_t end = high > UINT64_MAX - (size - 1) ? UINT64_MAX : high + (size - 1);
+        addr_t addr = low;
+        while (end - addr >= size)
+        {
+            const addr_t length = std::min<addr_t> (slice_size, end - addr);
+            addr_t found_addr = LLDB_INVALID_ADDRESS;
+            Error error = m_gdb_comm.SearchMemory (addr, length, buf, size, found_addr);
+            if (error.Fail())
+            {
+                Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_MEMORY));
+                if (log)
+                    log->Printf ("ProcessGDBRemote::%s remote search failed, searching locally from 0x%" PRIx64 ": %s",
+                                 __FUNCTION__, addr, error.AsCString());
+                return Process::FindInMemory (addr, high, buf, size);
+            }
+            if (found_addr != LLDB_INVALID_ADDRESS || length == end - addr)
+                return found_addr;
+            addr += length - (size - 1);
+        }
+        return LLDB_INVALID_ADDRESS;
+    }
+    return Process::FindInMemory (low, high, buf, size);
+}
+
 size_t
 ProcessGDBRemote::DoWriteMemory (addr_t addr, const void *buf, size_t size, Error &error)
 {
@@ -3138,6 +3206,10 @@ ProcessGDBRemote::DoAllocateMemory (size_t size, uint32_t permissions, Error &er
     Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS|LIBLLDB_LOG_EXPRESSIONS));
     addr_t allocated_addr = LLDB_INVALID_ADDRESS;
 
+    // The "_M" packet maps memory without a stop, so the cached regions
+    // have to be checked again.
+    m_memory_regions_stop_id = UINT32_MAX;
+
     if (m_gdb_comm.SupportsAllocDeallocMemory() != eLazyBoolNo)
     {
         allocated_addr = m_gdb_comm.AllocateMemory (size, permissions);
@@ -3178,11 +3250,77 @@ Error
 ProcessGDBRemote::GetMemoryRegionInfo (addr_t load_addr,
                                        MemoryRegionInfo &region_info)
 {
+    // Callers that walk the whole address space ask for thousands of
+    // regions, answer them from one "jMemoryRegionsInfo" reply.
+    if (GetMemoryRegionInfoFromCache (load_addr, region_info))
+        return Error();
 
     Error error (m_gdb_comm.GetMemoryRegionInfo (load_addr, region_info));
     return error;
 }
 
+bool
+ProcessGDBRemote::GetMemoryRegionInfoFromCache (addr_t load_addr,
+                                                MemoryRegionInfo &region_info)
+{
+    if (!m_gdb_comm.GetMemoryRegionsSupported())
+        return false;
+
+    // Memory only gets mapped and unmapped while the process runs, and most
+    // stops don't change anything, so after a stop just ask the stub whether
+    // its generation of the regions is still the one we have.
+    const uint32_t stop_id = GetStopID();
+    if (m_memory_regions_generation == 0 || m_memory_regions_stop_id != stop_id)
+    {
+        Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_MEMORY));
+        uint32_t generation = m_memory_regions_generation;
+        Error error = m_gdb_comm.GetMemoryRegions (generation, m_memory_regions);
+        if (error.Fail())
+        {
+            if (log)
+                log->Printf ("ProcessGDBRemote::%s failed to get the memory regions: %s", __FUNCTION__, error.AsCString());
+            m_memory_regions.clear();
+            m_memory_regions_generation = 0;
+            return false;
+        }
+        if (log)
+            log->Printf ("ProcessGDBRemote::%s %s %" PRIu64 " memory regions of generation %" PRIu32,
+                         __FUNCTION__,
+                         generation == m_memory_regions_generation ? "reusing" : "fetched",
+                         (uint64_t)m_memory_regions.size(),
+                         generation);
+        m_memory_regions_generation = generation;
+        m_memory_regions_stop_id = stop_id;
+    }
+
+    // Find the first region that starts after the address, only the one
+    // before it can contain the address.
+    auto pos = std::upper_bound (m_memory_regions.begin(), m_memory_regions.end(), load_addr,
+                                 [] (addr_t addr, const MemoryRegionInfo &info) {
+                                     return addr < info.GetRange().GetRangeBase();
+                                 });
+    if (pos != m_memory_regions.begin() && std::prev(pos)->GetRange().Contains(load_addr))
+    {
+        region_info = *std::prev(pos);
+        return true;
+    }
+
+    // The address isn't mapped, describe the gap up to the next region or
+    // the end of the address space just like "qMemoryRegionInfo" does.
+    region_info.Clear();
+    region_info.GetRange().SetRangeBase(load_addr);
+    if (pos != m_memory_regions.end())
+        region_info.GetRange().SetByteSize(pos->GetRange().GetRangeBase() - load_addr);
+    else if (GetAddressByteSize() == 4)
+        region_info.GetRange().SetByteSize(0x100000000ull - load_addr);
+    else
+        region_info.GetRange().SetByteSize(0ull - load_addr);
+    region_info.SetReadable(MemoryRegionInfo::eNo);
+    region_info.SetWritable(MemoryRegionInfo::eNo);
+    region_info.SetExecutable(MemoryRegionInfo::eNo);
+    return true;
+}
+
 Error
 ProcessGDBRemote::GetWatchpointSupportInfo (uint32_t &num)
 {
@@ -3204,6 +3342,9 @@ ProcessGDBRemote::DoDeallocateMemory (lldb::addr_t addr)
     Error error;
     LazyBool supported = m_gdb_comm.SupportsAllocDeallocMemory();
 
+    // Same as in DoAllocateMemory(), "_m" unmaps memory without a stop.
+    m_memory_regions_stop_id = UINT32_MAX;
+
     switch (supported)
     {
         case eLazyBoolCalculate:
@@ -4949,6 +5090,75 @@ ProcessGDBRemote::GetFileLoadAddress(const FileSpec& file, bool& is_loaded, lldb
     return Error("Unknown error happened during sending the load address packet");
 }
 
+bool
+ProcessGDBRemote::IsDebugserverOnThisHost ()
+{
+    if (m_debugserver_pid != LLDB_INVALID_PROCESS_ID)
+        return true;
+
+    Connection *connection = m_gdb_comm.GetConnection();
+    if (!connection)
+        return false;
+
+    std::string scheme;
+    std::string hostname;
+    int port = -1;
+    std::string path;
+    if (!UriParser::Parse(connection->GetURI(), scheme, hostname, port, path))
+        return false;
+
+    if (scheme == "unix-connect" || scheme == "unix-abstract-connect")
+        return true;
+
+    // A loopback connection may still be forwarded to another machine
+    // (e.g. "adb forward"), which only a remote platform would know.
+    PlatformSP platform_sp(GetTarget().GetPlatform());
+    if (platform_sp && !platform_sp->IsHost())
+        return false;
+
+    return hostname == "localhost" ||
+           hostname == "::1" || hostname == "[::1]" ||
+           hostname.compare(0, 4, "127.") == 0;
+}
+
+bool
+ProcessGDBRemote::SaveCore(const FileSpec &outfile, Error &error)
+{
+    if (!m_gdb_comm.GetQSaveCoreSupported())
+        return false;
+
+    // When the stub runs on this host it can write the core straight to
+    // its destination, otherwise let it pick a path on the remote host
+    // and copy the core from there.
+    const bool is_local = IsDebugserverOnThisHost();
+    const std::string outfile_path = outfile.GetPath(false);
+
+    std::string core_path;
+    error = m_gdb_comm.SaveCore(is_local ? outfile_path.c_str() : nullptr,
+                                GetSaveCoreSkipFileBacked(),
+                                core_path);
+    if (error.Fail())
+        return true;
+
+    if (core_path == outfile_path && is_local)
+        return true;
+
+    // The host platform can only copy files that are on this host.
+    PlatformSP platform_sp(GetTarget().GetPlatform());
+    if (!platform_sp || (!is_local && platform_sp->IsHost()))
+    {
+        error.SetErrorStringWithFormat("core was written to \"%s\" on the remote host, connect to a remote platform to copy it",
+                                       core_path.c_str());
+        return true;
+    }
+
+    const FileSpec remote_core(core_path.c_str(), false);
+    error = platform_sp->GetFile(remote_core, outfile);
+    if (!is_local)
+        platform_sp->Unlink(remote_core);
+    return true;
+}
+
 
 void
 ProcessGDBRemote::ModulesDidLoad (ModuleList &module_list)
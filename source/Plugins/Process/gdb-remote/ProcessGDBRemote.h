@@ -31,6 +31,7 @@
 #include "lldb/Host/HostThread.h"
 #include "lldb/lldb-private-forward.h"
 #include "lldb/Utility/StringExtractor.h"
+#include "lldb/Target/MemoryRegionInfo.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/Thread.h"
 
@@ -169,6 +170,9 @@ public:
     size_t
     DoReadMemory (lldb::addr_t addr, void *buf, size_t size, Error &error) override;
 
+    lldb::addr_t
+    FindInMemory (lldb::addr_t low, lldb::addr_t high, const uint8_t *buf, size_t size) override;
+
     size_t
     DoWriteMemory (lldb::addr_t addr, const void *buf, size_t size, Error &error) override;
 
@@ -254,6 +258,9 @@ public:
     Error
     GetFileLoadAddress(const FileSpec& file, bool& is_loaded, lldb::addr_t& load_addr) override;
 
+    bool
+    SaveCore(const FileSpec &outfile, Error &error) override;
+
     void
     ModulesDidLoad (ModuleList &module_list) override;
 
@@ -300,6 +307,9 @@ protected:
     uint64_t m_max_memory_size;       // The maximum number of bytes to read/write when reading and writing memory
     uint64_t m_remote_stub_max_memory_size;    // The maximum memory size the remote gdb stub can handle
     MMapMap m_addr_to_mmap_size;
+    std::vector<MemoryRegionInfo> m_memory_regions;   // All mapped regions, sorted by address, if "jMemoryRegionsInfo" is supported
+    uint32_t m_memory_regions_generation;             // The stub's generation of m_memory_regions, zero if there are none
+    uint32_t m_memory_regions_stop_id;                // The stop ID m_memory_regions was last checked at
     lldb::BreakpointSP m_thread_create_bp_sp;
     bool m_waiting_for_attach;
     bool m_destroy_tried_resuming;
@@ -365,6 +375,11 @@ protected:
     void
     KillDebugserverProcess ();
 
+    // True if the stub shares this host's file system: lldb launched it,
+    // or it is reached through a loopback or local socket connection.
+    bool
+    IsDebugserverOnThisHost ();
+
     void
     BuildDynamicRegisterInfo (bool force);
 
@@ -383,6 +398,12 @@ protected:
     void
     GetMaxMemorySize();
 
+    // Looks up \a load_addr in the regions from "jMemoryRegionsInfo",
+    // fetching them first if the process has stopped since they were last
+    // checked.  Returns false if the stub can't send all regions at once.
+    bool
+    GetMemoryRegionInfoFromCache (lldb::addr_t load_addr, MemoryRegionInfo &region_info);
+
     bool
     CalculateThreadStopInfo (ThreadGDBRemote *thread);
 
@@ -36,8 +36,13 @@ DWARFCallFrameInfo::DWARFCallFrameInfo(ObjectFile& objfile, SectionSP& section_s
     m_cie_map (),
     m_cfi_data (),
     m_cfi_data_initialized (false),
+    m_cie_map_mutex (),
     m_fde_index (),
     m_fde_index_initialized (false),
+    m_fde_index_mutex (),
+    m_eh_frame_hdr (),
+    m_eh_frame_hdr_initialized (false),
+    m_eh_frame_hdr_valid (false),
     m_is_eh_frame (is_eh_frame)
 {
 }
@@ -73,14 +78,11 @@ DWARFCallFrameInfo::GetAddressRange (Address addr, AddressRange &range)
     if (module_sp.get() == nullptr || module_sp->GetObjectFile() == nullptr || module_sp->GetObjectFile() != &m_objfile)
         return false;
 
-    if (m_section_sp.get() == nullptr || m_section_sp->IsEncrypted())
-        return false;
-    GetFDEIndex();
-    FDEEntryMap::Entry *fde_entry = m_fde_index.FindEntryThatContains (addr.GetFileAddress());
-    if (!fde_entry)
+    FDEEntryMap::Entry fde_entry;
+    if (GetFDEEntryByFileAddress (addr.GetFileAddress(), fde_entry) == false)
         return false;
 
-    range = AddressRange(fde_entry->base, fde_entry->size, m_objfile.GetSectionList());
+    range = AddressRange(fde_entry.base, fde_entry.size, m_objfile.GetSectionList());
     return true;
 }
 
@@ -90,6 +92,11 @@ DWARFCallFrameInfo::GetFDEEntryByFileAddress (addr_t file_addr, FDEEntryMap::Ent
     if (m_section_sp.get() == nullptr || m_section_sp->IsEncrypted())
         return false;
 
+    // Until someone needs the complete list of FDEs, answer single address
+    // lookups from the .eh_frame_hdr search table when there is one.
+    if (!m_fde_index_initialized && GetEHFrameHdr())
+        return GetFDEEntryFromEHFrameHdr (file_addr, fde_entry);
+
     GetFDEIndex();
 
     if (m_fde_index.IsEmpty())
@@ -126,6 +133,8 @@ DWARFCallFrameInfo::GetFunctionAddressAndSizeVector (FunctionAddressAndSizeVecto
 const DWARFCallFrameInfo::CIE*
 DWARFCallFrameInfo::GetCIE(dw_offset_t cie_offset)
 {
+    Mutex::Locker locker(m_cie_map_mutex);
+
     cie_map_t::iterator pos = m_cie_map.find(cie_offset);
 
     if (pos != m_cie_map.end())
@@ -136,6 +145,23 @@ DWARFCallFrameInfo::GetCIE(dw_offset_t cie_offset)
 
         return pos->second.get();
     }
+
+    // FDEs found through the .eh_frame_hdr table can refer to CIEs we haven't
+    // come across yet since we never scanned the section.
+    if (!m_fde_index_initialized)
+    {
+        if (m_cfi_data_initialized == false)
+            GetCFIData();
+        if (m_cfi_data.ValidOffsetForDataOfSize (cie_offset, 8))
+        {
+            CIESP cie_sp = ParseCIE (cie_offset);
+            if (cie_sp && cie_sp->version != (uint8_t)-1)
+            {
+                m_cie_map[cie_offset] = cie_sp;
+                return cie_sp.get();
+            }
+        }
+    }
     return nullptr;
 }
 
@@ -296,6 +322,215 @@ DWARFCallFrameInfo::GetCFIData()
         m_cfi_data_initialized = true;
     }
 }
+
+bool
+DWARFCallFrameInfo::GetClearAddressZerothBit ()
+{
+    ArchSpec arch;
+    if (m_objfile.GetArchitecture (arch))
+    {
+        if (arch.GetTriple().getArch() == llvm::Triple::arm || arch.GetTriple().getArch() == llvm::Triple::thumb)
+            return true;
+    }
+    return false;
+}
+
+bool
+DWARFCallFrameInfo::DecodeFDEAddressRange (lldb::offset_t offset,
+                                           dw_offset_t fde_offset,
+                                           const CIE &cie,
+                                           bool clear_address_zeroth_bit,
+                                           FDEEntryMap::Entry &fde_entry) const
+{
+    const lldb::addr_t pc_rel_addr = m_section_sp->GetFileAddress();
+    const lldb::addr_t text_addr = LLDB_INVALID_ADDRESS;
+    const lldb::addr_t data_addr = LLDB_INVALID_ADDRESS;
+
+    lldb::addr_t addr = m_cfi_data.GetGNUEHPointer(&offset, cie.ptr_encoding, pc_rel_addr, text_addr, data_addr);
+    if (clear_address_zeroth_bit)
+        addr &= ~1ull;
+
+    lldb::addr_t length = m_cfi_data.GetGNUEHPointer(&offset, cie.ptr_encoding & DW_EH_PE_MASK_ENCODING, pc_rel_addr, text_addr, data_addr);
+    fde_entry = FDEEntryMap::Entry (addr, length, fde_offset);
+    return true;
+}
+
+bool
+DWARFCallFrameInfo::ParseFDEEntry (dw_offset_t fde_offset, FDEEntryMap::Entry &fde_entry)
+{
+    if (m_cfi_data_initialized == false)
+        GetCFIData();
+
+    lldb::offset_t offset = fde_offset;
+    if (!m_cfi_data.ValidOffsetForDataOfSize (offset, 8))
+        return false;
+
+    dw_offset_t cie_id, cie_offset;
+    uint32_t len = m_cfi_data.GetU32 (&offset);
+    if (len == UINT32_MAX)
+    {
+        len = m_cfi_data.GetU64 (&offset);
+        cie_id = m_cfi_data.GetU64 (&offset);
+        cie_offset = fde_offset + 12 - cie_id;
+    }
+    else
+    {
+        cie_id = m_cfi_data.GetU32 (&offset);
+        cie_offset = fde_offset + 4 - cie_id;
+    }
+
+    // Only eh_frame has a search table, so the CIE pointer is always relative.
+    if (cie_id == 0 || cie_id == UINT32_MAX || len == 0 || cie_offset > m_cfi_data.GetByteSize())
+        return false;
+
+    const CIE *cie = GetCIE (cie_offset);
+    if (cie == nullptr)
+        return false;
+
+    return DecodeFDEAddressRange (offset, fde_offset, *cie, GetClearAddressZerothBit(), fde_entry);
+}
+
+// Locate and validate the .eh_frame_hdr section that accompanies an ELF
+// .eh_frame.  Its layout is
+//
+//   uint8_t  version (1)
+//   uint8_t  eh_frame_ptr_enc
+//   uint8_t  fde_count_enc
+//   uint8_t  table_enc
+//   encoded  eh_frame_ptr
+//   encoded  fde_count
+//   { encoded initial_location, encoded fde_address } [fde_count], sorted by initial_location
+//
+// We only use the table when its entries have a fixed size so we can binary
+// search it in place.
+
+bool
+DWARFCallFrameInfo::GetEHFrameHdr ()
+{
+    if (m_eh_frame_hdr_initialized)
+        return m_eh_frame_hdr_valid;
+
+    Mutex::Locker locker(m_fde_index_mutex);
+
+    if (m_eh_frame_hdr_initialized) // if two threads hit the locker
+        return m_eh_frame_hdr_valid;
+
+    m_eh_frame_hdr_valid = false;
+
+    SectionList *section_list = m_objfile.GetSectionList();
+    SectionSP hdr_section_sp;
+    if (m_is_eh_frame && section_list)
+        hdr_section_sp = section_list->FindSectionByName (ConstString (".eh_frame_hdr"));
+
+    if (hdr_section_sp && !hdr_section_sp->IsEncrypted() &&
+        m_objfile.ReadSectionData (hdr_section_sp.get(), m_eh_frame_hdr.data) > 4)
+    {
+        DataExtractor &data = m_eh_frame_hdr.data;
+        if (data.GetAddressByteSize() == 0)
+            data.SetAddressByteSize (m_objfile.GetAddressByteSize());
+
+        m_eh_frame_hdr.file_addr = hdr_section_sp->GetFileAddress();
+
+        lldb::offset_t offset = 0;
+        const uint8_t version = data.GetU8 (&offset);
+        const uint8_t eh_frame_ptr_enc = data.GetU8 (&offset);
+        const uint8_t fde_count_enc = data.GetU8 (&offset);
+        const uint8_t table_enc = data.GetU8 (&offset);
+
+        uint32_t field_size = 0;
+        switch (table_enc & DW_EH_PE_MASK_ENCODING)
+        {
+            case DW_EH_PE_absptr:   field_size = data.GetAddressByteSize(); break;
+            case DW_EH_PE_udata2:
+            case DW_EH_PE_sdata2:   field_size = 2; break;
+            case DW_EH_PE_udata4:
+            case DW_EH_PE_sdata4:   field_size = 4; break;
+            case DW_EH_PE_udata8:
+            case DW_EH_PE_sdata8:   field_size = 8; break;
+            default: break;
+        }
+
+        const uint8_t table_application = table_enc & 0x70;
+        if (version == 1 &&
+            eh_frame_ptr_enc != DW_EH_PE_omit &&
+            fde_count_enc != DW_EH_PE_omit &&
+            table_enc != DW_EH_PE_omit &&
+            (table_enc & DW_EH_PE_indirect) == 0 &&
+            (table_application == DW_EH_PE_absptr || table_application == DW_EH_PE_datarel) &&
+            field_size != 0)
+        {
+            const lldb::addr_t hdr_addr = m_eh_frame_hdr.file_addr;
+            const lldb::addr_t eh_frame_ptr = data.GetGNUEHPointer (&offset, eh_frame_ptr_enc, hdr_addr, LLDB_INVALID_ADDRESS, hdr_addr);
+            const uint64_t fde_count = data.GetGNUEHPointer (&offset, fde_count_enc, hdr_addr, LLDB_INVALID_ADDRESS, hdr_addr);
+
+            // Don't trust a table that describes some other eh_frame or that
+            // runs off the end of the section.
+            if (eh_frame_ptr == m_section_sp->GetFileAddress() &&
+                fde_count > 0 && fde_count < UINT32_MAX &&
+                data.ValidOffsetForDataOfSize (offset, fde_count * field_size * 2))
+            {
+                m_eh_frame_hdr.table_offset = offset;
+                m_eh_frame_hdr.fde_count = fde_count;
+                m_eh_frame_hdr.table_enc = table_enc;
+                m_eh_frame_hdr.field_size = field_size;
+                m_eh_frame_hdr_valid = true;
+            }
+        }
+    }
+
+    Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
+    if (log && m_is_eh_frame)
+        m_objfile.GetModule()->LogMessage(log, "%s .eh_frame_hdr search table (%u FDEs)",
+                                          m_eh_frame_hdr_valid ? "using" : "no usable",
+                                          m_eh_frame_hdr.fde_count);
+
+    m_eh_frame_hdr_initialized = true;
+    return m_eh_frame_hdr_valid;
+}
+
+bool
+DWARFCallFrameInfo::GetFDEEntryFromEHFrameHdr (lldb::addr_t file_addr, FDEEntryMap::Entry &fde_entry)
+{
+    const DataExtractor &data = m_eh_frame_hdr.data;
+    const lldb::addr_t hdr_addr = m_eh_frame_hdr.file_addr;
+    const uint32_t entry_size = m_eh_frame_hdr.field_size * 2;
+    const bool clear_address_zeroth_bit = GetClearAddressZerothBit();
+
+    // Find the last entry whose initial location is <= file_addr.
+    uint32_t low = 0;
+    uint32_t high = m_eh_frame_hdr.fde_count;
+    while (low < high)
+    {
+        const uint32_t mid = low + (high - low) / 2;
+        lldb::offset_t offset = m_eh_frame_hdr.table_offset + (lldb::offset_t)mid * entry_size;
+        lldb::addr_t initial_loc = data.GetGNUEHPointer (&offset, m_eh_frame_hdr.table_enc, hdr_addr, LLDB_INVALID_ADDRESS, hdr_addr);
+        if (clear_address_zeroth_bit)
+            initial_loc &= ~1ull;
+        if (initial_loc <= file_addr)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low == 0)
+        return false;
+
+    lldb::offset_t offset = m_eh_frame_hdr.table_offset + (lldb::offset_t)(low - 1) * entry_size + m_eh_frame_hdr.field_size;
+    const lldb::addr_t fde_addr = data.GetGNUEHPointer (&offset, m_eh_frame_hdr.table_enc, hdr_addr, LLDB_INVALID_ADDRESS, hdr_addr);
+    const lldb::addr_t eh_frame_addr = m_section_sp->GetFileAddress();
+    if (fde_addr < eh_frame_addr || fde_addr - eh_frame_addr >= m_section_sp->GetFileSize())
+        return false;
+
+    FDEEntryMap::Entry entry;
+    if (!ParseFDEEntry (fde_addr - eh_frame_addr, entry))
+        return false;
+
+    if (!entry.Contains (file_addr))
+        return false;
+
+    fde_entry = entry;
+    return true;
+}
+
 // Scan through the eh_frame or debug_frame section looking for FDEs and noting the start/end addresses
 // of the functions and a pointer back to the function's FDE for later expansion.
 // Internalize CIEs as we come across them.
@@ -316,13 +551,7 @@ DWARFCallFrameInfo::GetFDEIndex ()
 
     Timer scoped_timer (__PRETTY_FUNCTION__, "%s - %s", __PRETTY_FUNCTION__, m_objfile.GetFileSpec().GetFilename().AsCString(""));
 
-    bool clear_address_zeroth_bit = false;
-    ArchSpec arch;
-    if (m_objfile.GetArchitecture (arch))
-    {
-        if (arch.GetTriple().getArch() == llvm::Triple::arm || arch.GetTriple().getArch() == llvm::Triple::thumb)
-            clear_address_zeroth_bit = true;
-    }
+    const bool clear_address_zeroth_bit = GetClearAddressZerothBit();
 
     lldb::offset_t offset = 0;
     if (m_cfi_data_initialized == false)
@@ -371,7 +600,12 @@ DWARFCallFrameInfo::GetFDEIndex ()
 
         if (cie_id == 0 || cie_id == UINT32_MAX || len == 0)
         {
-            m_cie_map[current_entry] = ParseCIE (current_entry);
+            // GetCIE() may already have parsed this CIE for an FDE found
+            // through .eh_frame_hdr, and callers can still hold pointers to it.
+            Mutex::Locker cie_locker(m_cie_map_mutex);
+            CIESP &cie_sp = m_cie_map[current_entry];
+            if (!cie_sp)
+                cie_sp = ParseCIE (current_entry);
             offset = next_entry;
             continue;
         }
@@ -379,28 +613,21 @@ DWARFCallFrameInfo::GetFDEIndex ()
         const CIE *cie = GetCIE (cie_offset);
         if (cie)
         {
-            const lldb::addr_t pc_rel_addr = m_section_sp->GetFileAddress();
-            const lldb::addr_t text_addr = LLDB_INVALID_ADDRESS;
-            const lldb::addr_t data_addr = LLDB_INVALID_ADDRESS;
-
-            lldb::addr_t addr = m_cfi_data.GetGNUEHPointer(&offset, cie->ptr_encoding, pc_rel_addr, text_addr, data_addr);
-            if (clear_address_zeroth_bit)
-                addr &= ~1ull;
-
-            lldb::addr_t length = m_cfi_data.GetGNUEHPointer(&offset, cie->ptr_encoding & DW_EH_PE_MASK_ENCODING, pc_rel_addr, text_addr, data_addr);
-            FDEEntryMap::Entry fde (addr, length, current_entry);
-            m_fde_index.Append(fde);
+            FDEEntryMap::Entry fde;
+            if (DecodeFDEAddressRange (offset, current_entry, *cie, clear_address_zeroth_bit, fde))
+                m_fde_index.Append (fde);
         }
         else
         {
-            Host::SystemLog (Host::eSystemLogError, 
-                             "error: unable to find CIE at 0x%8.8x for cie_id = 0x%8.8x for entry at 0x%8.8x.\n", 
+            Host::SystemLog (Host::eSystemLogError,
+                             "error: unable to find CIE at 0x%8.8x for cie_id = 0x%8.8x for entry at 0x%8.8x.\n",
                              cie_offset,
                              cie_id,
                              current_entry);
         }
         offset = next_entry;
     }
+
     m_fde_index.Sort();
     m_fde_index_initialized = true;
 }
@@ -915,6 +1142,29 @@ void
 DWARFCallFrameInfo::ForEachFDEEntries(
     const std::function<bool(lldb::addr_t, uint32_t, dw_offset_t)>& callback)
 {
+    // The .eh_frame_hdr search table already lists every FDE sorted by
+    // address, so walking it spares building and sorting the full index.
+    if (m_section_sp && !m_section_sp->IsEncrypted() && !m_fde_index_initialized && GetEHFrameHdr())
+    {
+        const DataExtractor &data = m_eh_frame_hdr.data;
+        const lldb::addr_t hdr_addr = m_eh_frame_hdr.file_addr;
+        const lldb::addr_t eh_frame_addr = m_section_sp->GetFileAddress();
+        for (uint32_t i = 0; i < m_eh_frame_hdr.fde_count; ++i)
+        {
+            lldb::offset_t offset = m_eh_frame_hdr.table_offset + (lldb::offset_t)i * m_eh_frame_hdr.field_size * 2 + m_eh_frame_hdr.field_size;
+            const lldb::addr_t fde_addr = data.GetGNUEHPointer (&offset, m_eh_frame_hdr.table_enc, hdr_addr, LLDB_INVALID_ADDRESS, hdr_addr);
+            if (fde_addr < eh_frame_addr || fde_addr - eh_frame_addr >= m_section_sp->GetFileSize())
+                continue;
+
+            FDEEntryMap::Entry entry;
+            if (!ParseFDEEntry (fde_addr - eh_frame_addr, entry))
+                continue;
+            if (!callback(entry.base, entry.size, entry.data))
+                break;
+        }
+        return;
+    }
+
     GetFDEIndex();
 
     for (size_t i = 0, c = m_fde_index.GetSize(); i < c; ++i)
@@ -24,7 +24,10 @@
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
@@ -3263,6 +3266,50 @@ SwiftASTContext::GetSerializeModuleLoader ()
     return m_serialized_module_loader;
 }
 
+// The Clang modules a ClangImporter builds only depend on how the
+// importer was set up, so every context that is set up the same way, in
+// this session or a later one, can share a module cache.  Returns an
+// empty string if the cache directory can't be created.
+static std::string
+GetPersistentModuleCachePath (const std::string &triple,
+                              const swift::SearchPathOptions &search_path_opts,
+                              const swift::ClangImporterOptions &clang_importer_opts)
+{
+    llvm::MD5 hash;
+    auto add_string = [&hash](llvm::StringRef str)
+    {
+        hash.update(str);
+        hash.update(llvm::StringRef("", 1));
+    };
+
+    add_string(triple);
+    add_string(search_path_opts.SDKPath);
+    add_string(search_path_opts.RuntimeResourcePath);
+    for (const std::string &path : search_path_opts.ImportSearchPaths)
+        add_string(path);
+    add_string("-F");
+    for (const std::string &path : search_path_opts.FrameworkSearchPaths)
+        add_string(path);
+    add_string("-Xcc");
+    add_string(clang_importer_opts.OverrideResourceDir);
+    for (const std::string &arg : clang_importer_opts.ExtraArgs)
+        add_string(arg);
+
+    llvm::MD5::MD5Result result;
+    hash.final(result);
+    llvm::SmallString<32> key;
+    llvm::MD5::stringifyResult(result, key);
+
+    llvm::SmallString<256> path;
+    if (!llvm::sys::path::home_directory(path))
+        return std::string();
+    llvm::sys::path::append(path, ".lldb", "module_cache", "swift", key.str());
+
+    if (llvm::sys::fs::create_directories(path.str()))
+        return std::string();
+    return path.str();
+}
+
 swift::ClangImporter *
 SwiftASTContext::GetClangImporter ()
 {
@@ -3287,6 +3334,25 @@ SwiftASTContext::GetClangImporter ()
                     swift::ClangImporterOptions &clang_importer_options = GetClangImporterOptions();
                     if (!clang_importer_options.OverrideResourceDir.empty())
                     {
+                        // Without an explicit target.module-cache-path, keep
+                        // the modules around for the next debug session.
+                        TargetPropertiesSP properties_sp = Target::GetGlobalProperties();
+                        if (target_sp)
+                            properties_sp = target_sp;
+                        if (clang_importer_options.ModuleCachePath.empty() &&
+                            properties_sp && properties_sp->GetSwiftPersistentModuleCache())
+                        {
+                            clang_importer_options.ModuleCachePath = GetPersistentModuleCachePath(GetCompilerInvocation().getTargetTriple(),
+                                                                                                  ast_ctx->SearchPathOpts,
+                                                                                                  clang_importer_options);
+
+                            Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_TYPES));
+                            if (log)
+                                log->Printf("SwiftASTContext::%s() using module cache \"%s\"",
+                                            __FUNCTION__,
+                                            clang_importer_options.ModuleCachePath.c_str());
+                        }
+
                         std::unique_ptr<swift::ModuleLoader> clang_importer_ap(swift::ClangImporter::create (*m_ast_context_ap,
                                                                                                              clang_importer_options));
                         
@@ -11,6 +11,7 @@
 // C Includes
 #include <inttypes.h>
 // C++ Includes
+#include <algorithm>
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/DataBufferHeap.h"
@@ -62,8 +63,49 @@ MemoryCache::AddL1CacheData(lldb::addr_t addr, const void *src, size_t src_len)
 void
 MemoryCache::AddL1CacheData(lldb::addr_t addr, const DataBufferSP &data_buffer_sp)
 {
+    const addr_t byte_size = data_buffer_sp ? data_buffer_sp->GetByteSize() : 0;
+    if (byte_size == 0)
+        return;
+
     Mutex::Locker locker (m_mutex);
-    m_L1_cache[addr] = data_buffer_sp;
+
+    // Keep the L1 blocks disjoint by merging the new data with every block
+    // it overlaps or touches.  A read is then either entirely within the
+    // last block that starts at or before it, or not in the L1 cache at
+    // all, even if it spans the data of several calls, e.g. the prefetched
+    // variables of different frames.
+    addr_t merged_start = addr;
+    addr_t merged_end = addr + byte_size;
+    BlockMap::iterator first = m_L1_cache.upper_bound(addr);
+    if (first != m_L1_cache.begin())
+    {
+        BlockMap::iterator prev = first;
+        --prev;
+        if (prev->first + prev->second->GetByteSize() >= addr)
+            first = prev;
+    }
+    BlockMap::iterator last = first;
+    while (last != m_L1_cache.end() && last->first <= merged_end)
+    {
+        merged_start = std::min(merged_start, last->first);
+        merged_end = std::max<addr_t>(merged_end, last->first + last->second->GetByteSize());
+        ++last;
+    }
+
+    if (first == last)
+    {
+        m_L1_cache[addr] = data_buffer_sp;
+        return;
+    }
+
+    DataBufferHeap *merged_buffer = new DataBufferHeap(merged_end - merged_start, 0);
+    DataBufferSP merged_buffer_sp(merged_buffer);
+    for (BlockMap::iterator pos = first; pos != last; ++pos)
+        memcpy(merged_buffer->GetBytes() + pos->first - merged_start, pos->second->GetBytes(), pos->second->GetByteSize());
+    // The new data is the most recent where they overlap.
+    memcpy(merged_buffer->GetBytes() + addr - merged_start, data_buffer_sp->GetBytes(), byte_size);
+    m_L1_cache.erase(first, last);
+    m_L1_cache[merged_start] = merged_buffer_sp;
 }
 
 void
@@ -82,6 +124,10 @@ MemoryCache::Flush (addr_t addr, size_t size)
         if (pos != m_L1_cache.begin())
         {
             --pos;
+            // The blocks are disjoint, so if the one before addr ends
+            // before it, the next one is the first that can intersect.
+            if (pos->first + pos->second->GetByteSize() <= addr)
+                ++pos;
         }
         while (pos != m_L1_cache.end())
         {
@@ -163,6 +209,8 @@ MemoryCache::Read (addr_t addr,
     // The L1 cache contains chunks of memory that are not required to be
     // m_L2_cache_line_byte_size bytes in size, so we don't try anything
     // tricky when reading from them (no partial reads from the L1 cache).
+    // AddL1CacheData merges chunks that overlap or touch, so only the chunk
+    // that starts at or before addr can contain the read.
 
     Mutex::Locker locker(m_mutex);
     if (!m_L1_cache.empty())
@@ -9,6 +9,7 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
 #include <atomic>
 #include <mutex>
 
@@ -17,6 +18,8 @@
 #include "Plugins/Process/Utility/InferiorCallPOSIX.h"
 #include "lldb/Breakpoint/BreakpointLocation.h"
 #include "lldb/Breakpoint/StoppointCallbackContext.h"
+#include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Event.h"
 #include "lldb/Core/Log.h"
@@ -62,6 +65,7 @@
 #include "lldb/Target/ThreadPlan.h"
 #include "lldb/Target/ThreadPlanBase.h"
 #include "lldb/Target/UnixSignals.h"
+#include "lldb/Utility/MemorySearch.h"
 #include "lldb/Utility/NameMatches.h"
 
 using namespace lldb;
@@ -126,6 +130,8 @@ g_properties[] =
     { "detach-keeps-stopped" , OptionValue::eTypeBoolean, true, false, nullptr, nullptr, "If true, detach will attempt to keep the process stopped." },
     { "memory-cache-line-size" , OptionValue::eTypeUInt64, false, 512, nullptr, nullptr, "The memory cache line size" },
     { "optimization-warnings" , OptionValue::eTypeBoolean, false, true, nullptr, nullptr, "If true, warn when stopped in code that is optimized where stepping and variable availability may not behave as expected." },
+    { "unwind-stack-snapshot-size" , OptionValue::eTypeUInt64, false, 128 * 1024, nullptr, nullptr, "The maximum number of bytes of a thread's stack the unwinder keeps a copy of.  It reads the first few KB above the stack pointer at once, and more only when a frame's saved registers lie beyond that.  Set to 0 to read each saved register individually." },
+    { "save-core-skip-file-backed" , OptionValue::eTypeBoolean, false, false, nullptr, nullptr, "If true, cores written by a remote stub leave out the contents of read-only file mappings to make them smaller. That memory reads as zeros when the core is loaded." },
     {  nullptr                  , OptionValue::eTypeInvalid, false, 0, nullptr, nullptr, nullptr  }
 };
 
@@ -138,7 +144,9 @@ enum {
     ePropertyStopOnSharedLibraryEvents,
     ePropertyDetachKeepsStopped,
     ePropertyMemCacheLineSize,
-    ePropertyWarningOptimization
+    ePropertyWarningOptimization,
+    ePropertyUnwindStackSnapshotSize,
+    ePropertySaveCoreSkipFileBacked
 };
 
 ProcessProperties::ProcessProperties (lldb_private::Process *process) :
@@ -279,6 +287,20 @@ ProcessProperties::GetWarningsOptimization () const
     return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
 }
 
+uint64_t
+ProcessProperties::GetUnwindStackSnapshotSize () const
+{
+    const uint32_t idx = ePropertyUnwindStackSnapshotSize;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64(nullptr, idx, g_properties[idx].default_uint_value);
+}
+
+bool
+ProcessProperties::GetSaveCoreSkipFileBacked () const
+{
+    const uint32_t idx = ePropertySaveCoreSkipFileBacked;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
 void
 ProcessInstanceInfo::Dump (Stream &s, Platform *platform) const
 {
@@ -2530,6 +2552,61 @@ Process::ReadMemory (addr_t addr, void *buf, size_t size, Error &error)
         return ReadMemoryFromInferior (addr, buf, size, error);
     }
 }
+
+bool
+Process::GetMemoryData (addr_t addr, size_t size, DataExtractor &data)
+{
+    // Live processes have nothing mapped that we could hand out, the
+    // caller has to copy the memory with ReadMemory.
+    return false;
+}
+
+addr_t
+Process::FindInMemory (addr_t low, addr_t high, const uint8_t *buf, size_t size)
+{
+    if (buf == nullptr || size == 0 || low >= high)
+        return LLDB_INVALID_ADDRESS;
+
+    // A match may start at any address below high, so the bytes of the
+    // last candidate run up to size - 1 bytes past it.
+    const addr_t end = high > UINT64_MAX - (size - 1) ? UINT64_MAX : high + (size - 1);
+
+    // Search a large chunk per read instead of reading once per address.
+    const MemorySearcher searcher (buf, size);
+    DataBufferHeap heap (std::max<size_t> (512 * 1024, 2 * size), 0);
+    DataExtractor data;
+
+    auto read = [this, &heap, &data] (addr_t addr, size_t wanted, size_t &bytes_read) -> const uint8_t *
+    {
+        if (GetMemoryData (addr, wanted, data))
+        {
+            bytes_read = wanted;
+            return data.GetDataStart();
+        }
+
+        // Bypass the memory cache, which would keep every chunk of the
+        // range around for as long as the process stays stopped.
+        Error error;
+        bytes_read = ReadMemoryFromInferior (addr, heap.GetBytes(), wanted, error);
+        return heap.GetBytes();
+    };
+
+    // Keep going after an unreadable region if the process can tell us
+    // where it ends, otherwise give up like any other failed read.
+    auto skip_unreadable = [this] (addr_t bad_addr, addr_t &next_addr) -> bool
+    {
+        MemoryRegionInfo region_info;
+        if (GetMemoryRegionInfo (bad_addr, region_info).Fail() ||
+            region_info.GetReadable() == MemoryRegionInfo::eYes)
+            return false;
+        next_addr = region_info.GetRange().GetRangeEnd();
+        return true;
+    };
+
+    addr_t found_addr = LLDB_INVALID_ADDRESS;
+    searcher.FindInRange (low, end, heap.GetByteSize(), read, skip_unreadable, found_addr);
+    return found_addr;
+}
     
 size_t
 Process::ReadCStringFromMemory (addr_t addr, std::string &out_str, Error &error)
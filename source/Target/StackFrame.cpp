@@ -9,17 +9,23 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
+#include <vector>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Target/StackFrame.h"
+#include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Disassembler.h"
 #include "lldb/Core/FormatEntity.h"
+#include "lldb/Core/Log.h"
 #include "lldb/Core/Mangled.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Value.h"
 #include "lldb/Core/ValueObjectVariable.h"
 #include "lldb/Core/ValueObjectConstResult.h"
+#include "lldb/Expression/DWARFExpression.h"
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/Function.h"
 #include "lldb/Symbol/Symbol.h"
@@ -70,6 +76,7 @@ StackFrame::StackFrame (const ThreadSP &thread_sp,
     m_is_history_frame (is_history_frame),
     m_variable_list_sp (),
     m_variable_list_value_objects (),
+    m_variables_prefetch_stop_id (UINT32_MAX),
     m_disassembly (),
     m_mutex (Mutex::eMutexTypeRecursive)
 {
@@ -110,6 +117,7 @@ StackFrame::StackFrame (const ThreadSP &thread_sp,
     m_is_history_frame (false),
     m_variable_list_sp (),
     m_variable_list_value_objects (),
+    m_variables_prefetch_stop_id (UINT32_MAX),
     m_disassembly (),
     m_mutex (Mutex::eMutexTypeRecursive)
 {
@@ -150,6 +158,7 @@ StackFrame::StackFrame (const ThreadSP &thread_sp,
     m_is_history_frame (false),
     m_variable_list_sp (),
     m_variable_list_value_objects (),
+    m_variables_prefetch_stop_id (UINT32_MAX),
     m_disassembly (),
     m_mutex (Mutex::eMutexTypeRecursive)
 {
@@ -1343,6 +1352,117 @@ StackFrame::GetValueObjectForFrameVariable (const VariableSP &variable_sp, Dynam
     return valobj_sp;
 }
 
+void
+StackFrame::PrefetchVariableMemory (VariableList &variable_list)
+{
+    if (m_is_history_frame)
+        return;
+
+    ThreadSP thread_sp (GetThread());
+    ProcessSP process_sp (thread_sp ? thread_sp->GetProcess() : ProcessSP());
+    if (!process_sp || !process_sp->IsAlive() || process_sp->GetDisableMemoryCache())
+        return;
+
+    Target &target = process_sp->GetTarget();
+    if (!target.GetPrefetchFrameVariables())
+        return;
+
+    {
+        // IDEs ask for arguments and locals separately, and on every stop
+        // for every visible frame, only do the work once per stop.
+        Mutex::Locker locker(m_mutex);
+        const uint32_t stop_id = process_sp->GetStopID();
+        if (m_variables_prefetch_stop_id == stop_id)
+            return;
+        m_variables_prefetch_stop_id = stop_id;
+    }
+
+    // Don't let a huge local array turn into a huge read, ValueObjects
+    // only read as much of those as they display anyway.
+    static const addr_t g_max_prefetch_size = 256 * 1024;
+
+    ExecutionContext exe_ctx;
+    CalculateExecutionContext (exe_ctx);
+
+    typedef std::pair<addr_t, addr_t> AddressRangePair; // [start, end)
+    std::vector<AddressRangePair> ranges;
+    const size_t num_variables = variable_list.GetSize();
+    for (size_t i = 0; i < num_variables; ++i)
+    {
+        VariableSP var_sp (variable_list.GetVariableAtIndex(i));
+        if (!var_sp || var_sp->GetLocationIsConstantValueData())
+            continue;
+
+        // Globals and statics are spread all over, only the arguments
+        // and locals are likely to share reads.
+        const ValueType scope = var_sp->GetScope();
+        if (scope != eValueTypeVariableArgument && scope != eValueTypeVariableLocal)
+            continue;
+
+        Type *type = var_sp->GetType();
+        const uint64_t byte_size = type ? type->GetByteSize() : 0;
+        if (byte_size == 0 || byte_size > g_max_prefetch_size)
+            continue;
+
+        DWARFExpression &expr = var_sp->LocationExpression();
+        addr_t loclist_base_load_addr = LLDB_INVALID_ADDRESS;
+        if (expr.IsLocationList())
+        {
+            SymbolContext sc;
+            var_sp->CalculateSymbolContext (&sc);
+            if (sc.function)
+                loclist_base_load_addr = sc.function->GetAddressRange().GetBaseAddress().GetLoadAddress (&target);
+        }
+
+        Value value;
+        Error error;
+        if (!expr.Evaluate (&exe_ctx, nullptr, nullptr, nullptr, loclist_base_load_addr, nullptr, nullptr, value, &error))
+            continue;
+        if (value.GetValueType() != Value::eValueTypeLoadAddress)
+            continue;
+        const addr_t addr = value.GetScalar().ULongLong(LLDB_INVALID_ADDRESS);
+        if (addr == LLDB_INVALID_ADDRESS || addr == 0)
+            continue;
+        ranges.push_back(AddressRangePair(addr, addr + byte_size));
+    }
+
+    if (ranges.empty())
+        return;
+
+    // Merge ranges that overlap or are less than a cache line apart.
+    std::sort(ranges.begin(), ranges.end());
+    const addr_t max_gap = process_sp->GetMemoryCacheLineSize();
+    std::vector<AddressRangePair> reads;
+    for (const AddressRangePair &range : ranges)
+    {
+        if (!reads.empty() &&
+            range.first <= reads.back().second + max_gap &&
+            std::max(range.second, reads.back().second) - reads.back().first <= g_max_prefetch_size)
+            reads.back().second = std::max(range.second, reads.back().second);
+        else
+            reads.push_back(range);
+    }
+
+    Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+    if (log)
+        log->Printf("StackFrame::%s() frame #%u: %" PRIu64 " variables in %" PRIu64 " reads",
+                    __FUNCTION__,
+                    m_frame_index,
+                    (uint64_t)ranges.size(),
+                    (uint64_t)reads.size());
+
+    // Reading through the memory cache leaves the data there for the
+    // ValueObjects to pick up, the cache is flushed when the process
+    // resumes.
+    DataBufferHeap buffer;
+    for (const AddressRangePair &read : reads)
+    {
+        Error error;
+        buffer.SetByteSize(read.second - read.first);
+        process_sp->ReadMemory(read.first, buffer.GetBytes(), buffer.GetByteSize(), error);
+    }
+}
+
 ValueObjectSP
 StackFrame::TrackGlobalVariable (const VariableSP &variable_sp, DynamicValueType use_dynamic)
 {
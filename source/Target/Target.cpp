@@ -41,6 +41,7 @@
 #include "Plugins/ExpressionParser/Swift/SwiftREPL.h"
 #include "lldb/Host/FileSpec.h"
 #include "lldb/Host/Host.h"
+#include "lldb/Host/ThreadLauncher.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
 #include "lldb/Interpreter/OptionGroupWatchpoint.h"
@@ -89,6 +90,10 @@ Target::Target(Debugger &debugger, const ArchSpec &target_arch, const lldb::Plat
     m_process_sp (),
     m_search_filter_sp (),
     m_image_search_paths (ImageSearchPathsChanged, this),
+    m_expression_cache (),
+    m_swift_warm_up_mutex (),
+    m_swift_warm_up (),
+    m_swift_warm_up_thread_id (),
     m_ast_importer_sp (),
     m_source_manager_ap(),
     m_stop_hooks (),
@@ -179,6 +184,7 @@ Target::CleanupProcess ()
     DisableAllWatchpoints(false);
     ClearAllWatchpointHitCounts();
     ClearAllWatchpointHistoricValues();
+    m_expression_cache.Clear("process cleanup");
 }
 
 void
@@ -286,6 +292,7 @@ Target::SetREPL (lldb::LanguageType language, lldb::REPLSP repl_sp)
 void
 Target::Destroy()
 {
+    WaitForSwiftWarmUp();
     Mutex::Locker locker (m_mutex);
     m_valid = false;
     DeleteCurrentProcess ();
@@ -1235,6 +1242,8 @@ LoadScriptingResourceForModule (const ModuleSP &module_sp, Target *target)
 void
 Target::ClearModules(bool delete_locations)
 {
+    // The warm-up works on a scratch context this is about to destroy.
+    WaitForSwiftWarmUp();
     ModulesDidUnload (m_images, delete_locations);
     m_section_load_history.Clear();
     m_images.Clear();
@@ -1456,6 +1465,7 @@ Target::ModulesDidLoad (ModuleList &module_list)
         if (swift_ast_ctx)
             swift_ast_ctx->ModulesDidLoad(module_list);
         module_list.ClearModuleDependentCaches();
+        m_expression_cache.Clear("modules loaded");
         BroadcastEvent (eBroadcastBitModulesLoaded, new TargetEventData (this->shared_from_this(), module_list));
     }
 }
@@ -1489,6 +1499,7 @@ Target::ModulesDidUnload (ModuleList &module_list, bool delete_locations)
         UnloadModuleSections (module_list);
         m_breakpoint_list.UpdateBreakpoints (module_list, false, delete_locations);
         m_internal_breakpoint_list.UpdateBreakpoints (module_list, false, delete_locations);
+        m_expression_cache.Clear("modules unloaded");
         BroadcastEvent (eBroadcastBitModulesUnloaded, new TargetEventData (this->shared_from_this(), module_list));
     }
 }
@@ -2078,6 +2089,9 @@ Target::GetScratchTypeSystemForLanguage (Error *error, lldb::LanguageType langua
         }
     }
 
+    if (language == eLanguageTypeSwift)
+        WaitForSwiftWarmUp();
+
     if (m_cant_make_scratch_type_system.find(language) != m_cant_make_scratch_type_system.end())
     {
         return nullptr;
@@ -2100,6 +2114,7 @@ Target::GetScratchTypeSystemForLanguage (Error *error, lldb::LanguageType langua
                     }
                 }
                 m_scratch_type_system_map.RemoveTypeSystemsForLanguage(language);
+                m_expression_cache.Clear("scratch type system reset");
                 type_system = m_scratch_type_system_map.GetTypeSystemForLanguage(language, this, create_on_demand, compiler_options);
                 
                 if (SwiftASTContext *new_swift_ast_ctx = llvm::dyn_cast_or_null<SwiftASTContext>(type_system))
@@ -2130,6 +2145,7 @@ Target::GetScratchTypeSystemForLanguage (Error *error, lldb::LanguageType langua
 const TypeSystemMap &
 Target::GetTypeSystemMap ()
 {
+    WaitForSwiftWarmUp();
     return m_scratch_type_system_map;
 }
 
@@ -2271,6 +2287,99 @@ Target::GetScratchSwiftASTContext(Error &error, bool create_on_demand, const cha
     return llvm::dyn_cast_or_null<SwiftASTContext>(GetScratchTypeSystemForLanguage(&error, eLanguageTypeSwift, create_on_demand, extra_options));
 }
 
+void
+Target::StartSwiftWarmUp ()
+{
+    if (!GetSwiftWarmUpModules())
+        return;
+
+    // Let a warm-up for an earlier process finish first.
+    WaitForSwiftWarmUp();
+
+    // Loading the standard library can index DWARF, which waits on the
+    // task pool, so this gets a thread of its own rather than a task.
+    // The thread owns a reference to the target until it is done.
+    std::lock_guard<std::mutex> guard(m_swift_warm_up_mutex);
+    Error error;
+    lldb::TargetSP *target_sp_ptr = new lldb::TargetSP(shared_from_this());
+    m_swift_warm_up_thread = ThreadLauncher::LaunchThread("<lldb.target.swift-warm-up>",
+                                                          Target::SwiftWarmUpThread,
+                                                          target_sp_ptr,
+                                                          &error);
+    if (!m_swift_warm_up_thread.IsJoinable())
+    {
+        Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
+        if (log)
+            log->Printf("Target::%s() couldn't launch the warm-up thread: %s", __FUNCTION__, error.AsCString("unknown error"));
+        delete target_sp_ptr;
+    }
+}
+
+lldb::thread_result_t
+Target::SwiftWarmUpThread (lldb::thread_arg_t arg)
+{
+    lldb::TargetSP *target_sp_ptr = static_cast<lldb::TargetSP *>(arg);
+    (*target_sp_ptr)->WarmUpSwiftASTContext();
+    delete target_sp_ptr;
+    return NULL;
+}
+
+void
+Target::WaitForSwiftWarmUp ()
+{
+    HostThread warm_up_thread;
+    {
+        std::lock_guard<std::mutex> guard(m_swift_warm_up_mutex);
+        if (!m_swift_warm_up_thread.IsJoinable())
+            return;
+        // The warm-up itself asks for the scratch context, and if it ends
+        // up dropping the last reference to the target it tears it down
+        // too; it can't wait for itself in either case.
+        if (m_swift_warm_up_thread.EqualsThread(Host::GetCurrentThread()))
+            return;
+        warm_up_thread = m_swift_warm_up_thread;
+        m_swift_warm_up_thread = HostThread();
+    }
+    warm_up_thread.Join(nullptr);
+}
+
+void
+Target::WarmUpSwiftASTContext ()
+{
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
+
+    // Only programs with Swift code in the main executable benefit, don't
+    // make a Swift context for anything else.
+    ModuleSP exe_module_sp (GetExecutableModule());
+    if (!exe_module_sp)
+        return;
+
+    SymbolVendor *sym_vendor = exe_module_sp->GetSymbolVendor();
+    if (!sym_vendor || !sym_vendor->GetASTData(eLanguageTypeSwift))
+        return;
+
+    Timer scoped_timer (__PRETTY_FUNCTION__, "%s", exe_module_sp->GetFileSpec().GetFilename().AsCString("<unknown>"));
+
+    // Only the scratch context is touched here: everything else that uses
+    // it waits for this to finish, while the modules' own Swift contexts
+    // may be in use on other threads.
+    Error error;
+    SwiftASTContext *scratch_swift_ast = GetScratchSwiftASTContext(error);
+    if (!scratch_swift_ast || scratch_swift_ast->HasFatalErrors())
+    {
+        if (log)
+            log->Printf("Target::%s() couldn't create the scratch Swift context: %s", __FUNCTION__, error.AsCString("unknown error"));
+        return;
+    }
+
+    // Every Swift expression imports the standard library, which is most
+    // of what loading modules costs.  The executable's own modules were
+    // registered when the context was made and are imported on demand.
+    Error module_error;
+    if (!scratch_swift_ast->GetModule(ConstString("Swift"), module_error) && log)
+        log->Printf("Target::%s() couldn't load the Swift standard library: %s", __FUNCTION__, module_error.AsCString("unknown error"));
+}
+
 void
 Target::SettingsInitialize ()
 {
@@ -2413,6 +2522,7 @@ Target::EvaluateExpression(const char *expr_cstr,
 lldb::ExpressionVariableSP
 Target::GetPersistentVariable(const ConstString &name)
 {
+    WaitForSwiftWarmUp();
     lldb::ExpressionVariableSP variable_sp;
     m_scratch_type_system_map.ForEach([this, name, &variable_sp](TypeSystem *type_system) -> bool
     {
@@ -2433,6 +2543,7 @@ Target::GetPersistentSymbol(const ConstString &name)
 {
     lldb::addr_t address = LLDB_INVALID_ADDRESS;
     
+    WaitForSwiftWarmUp();
     m_scratch_type_system_map.ForEach([this, name, &address](TypeSystem *type_system) -> bool
     {
         if (PersistentExpressionState *persistent_state = type_system->GetPersistentExpressionState())
@@ -3329,6 +3440,9 @@ Target::Launch (ProcessLaunchInfo &launch_info, Stream *stream)
         error2.SetErrorStringWithFormat ("process launch failed: %s", error.AsCString());
         error = error2;
     }
+
+    if (error.Success())
+        StartSwiftWarmUp();
     return error;
 }
 
@@ -3417,6 +3531,9 @@ Target::Attach (ProcessAttachInfo &attach_info, Stream *stream)
             }
         }
     }
+
+    if (error.Success ())
+        StartSwiftWarmUp ();
     return error;
 }
 
@@ -3600,7 +3717,10 @@ g_properties[] =
     { "use-all-compiler-flags"             , OptionValue::eTypeBoolean   , false, false                     , nullptr, nullptr, "Try to use compiler flags for all modules when setting up the Swift expression parser, not just the main executable." },
     { "auto-apply-fixits"                  , OptionValue::eTypeBoolean   , false, true                      , nullptr, nullptr, "Automatically apply fix-it hints to expressions." },
     { "notify-about-fixits"                , OptionValue::eTypeBoolean   , false, true                      , nullptr, nullptr, "Print the fixed expression text." },
+    { "cache-expressions"                  , OptionValue::eTypeBoolean   , false, true                      , nullptr, nullptr, "Reuse the parsed and JIT'ed code of expressions that are evaluated again at the same address." },
+    { "prefetch-frame-variables"           , OptionValue::eTypeBoolean   , false, true                      , nullptr, nullptr, "When the variables of a frame are listed, read the memory of all its arguments and locals in as few reads as possible." },
     { "max-children-count"                 , OptionValue::eTypeSInt64    , false, 256                       , nullptr, nullptr, "Maximum number of children to expand in any level of depth." },
+    { "max-cached-synthetic-children"      , OptionValue::eTypeSInt64    , false, 0                         , nullptr, nullptr, "Maximum number of synthetic children each value keeps around, 0 for no limit. Children away from the most recently accessed one are released and created again when needed, which bounds memory use when paging through very large containers. Children that the synthetic child provider keeps references to itself, as many Python providers and some built-in ones do, stay alive until the provider lets go of them." },
     { "max-string-summary-length"          , OptionValue::eTypeSInt64    , false, 1024                      , nullptr, nullptr, "Maximum number of characters to show when using %s in summary strings." },
     { "max-memory-read-size"               , OptionValue::eTypeSInt64    , false, 1024                      , nullptr, nullptr, "Maximum number of bytes that 'memory read' will fetch before --force must be specified." },
     { "breakpoints-use-platform-avoid-list", OptionValue::eTypeBoolean   , false, true                      , nullptr, nullptr, "Consult the platform module avoid list when setting non-module specific breakpoints." },
@@ -3639,6 +3759,8 @@ g_properties[] =
     { "trap-handler-names"                 , OptionValue::eTypeArray     , true,  OptionValue::eTypeString,   nullptr, nullptr, "A list of trap handler function names, e.g. a common Unix user process one is _sigtramp." },
     { "sdk-path"                           , OptionValue::eTypeFileSpec  , false, 0,                          nullptr, nullptr, "The path to the SDK used to build the current target." },
     { "module-cache-path"                  , OptionValue::eTypeFileSpec  , false, 0,                          nullptr, nullptr, "The path to the module-cache directory." },
+    { "swift-persistent-module-cache"      , OptionValue::eTypeBoolean   , false, false,                      nullptr, nullptr, "If module-cache-path isn't set, keep the Clang modules imported by Swift in a per-user cache under ~/.lldb/module_cache, keyed by the SDK, search paths and compiler flags, so they are built once rather than in every debug session.  Off by default since it writes to the user's home directory." },
+    { "swift-warm-up-modules"              , OptionValue::eTypeBoolean   , false, true,                       nullptr, nullptr, "After a process is launched or attached to, create the Swift expression context and load the Swift standard library into it in the background, before the first expression needs it." },
     { "display-runtime-support-values"     , OptionValue::eTypeBoolean   , false, false,                      nullptr, nullptr, "If true, LLDB will show variables that are meant to support the operation of a language's runtime support." },
     { "non-stop-mode"                      , OptionValue::eTypeBoolean   , false, 0,                          nullptr, nullptr, "Disable lock-step debugging, instead control threads independently." },
     { nullptr                                 , OptionValue::eTypeInvalid   , false, 0                         , nullptr, nullptr, nullptr }
@@ -3663,7 +3785,10 @@ enum
     ePropertyUseAllCompilerFlags,
     ePropertyAutoApplyFixIts,
     ePropertyNotifyAboutFixIts,
+    ePropertyCacheExpressions,
+    ePropertyPrefetchFrameVariables,
     ePropertyMaxChildrenCount,
+    ePropertyMaxCachedSyntheticChildren,
     ePropertyMaxSummaryLength,
     ePropertyMaxMemReadSize,
     ePropertyBreakpointUseAvoidList,
@@ -3689,6 +3814,8 @@ enum
     ePropertyTrapHandlerNames,
     ePropertySDKPath,
     ePropertyModuleCachePath,
+    ePropertySwiftPersistentModuleCache,
+    ePropertySwiftWarmUpModules,
     ePropertyDisplayRuntimeSupportValues,
     ePropertyNonStopModeEnabled,
     ePropertyExperimental
@@ -4094,6 +4221,20 @@ TargetProperties::GetModuleCachePath ()
     return option_value->GetCurrentValue();
 }
 
+bool
+TargetProperties::GetSwiftPersistentModuleCache () const
+{
+    const uint32_t idx = ePropertySwiftPersistentModuleCache;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
+bool
+TargetProperties::GetSwiftWarmUpModules () const
+{
+    const uint32_t idx = ePropertySwiftWarmUpModules;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
 FileSpec &
 TargetProperties::GetSDKPath ()
 {
@@ -4158,6 +4299,20 @@ TargetProperties::GetEnableNotifyAboutFixIts() const
     return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
 }
 
+bool
+TargetProperties::GetEnableExpressionCache() const
+{
+    const uint32_t idx = ePropertyCacheExpressions;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
+bool
+TargetProperties::GetPrefetchFrameVariables() const
+{
+    const uint32_t idx = ePropertyPrefetchFrameVariables;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
 bool
 TargetProperties::GetEnableSyntheticValue () const
 {
@@ -4172,6 +4327,13 @@ TargetProperties::GetMaximumNumberOfChildrenToDisplay() const
     return m_collection_sp->GetPropertyAtIndexAsSInt64(nullptr, idx, g_properties[idx].default_uint_value);
 }
 
+uint32_t
+TargetProperties::GetMaximumNumberOfCachedSyntheticChildren() const
+{
+    const uint32_t idx = ePropertyMaxCachedSyntheticChildren;
+    return m_collection_sp->GetPropertyAtIndexAsSInt64(nullptr, idx, g_properties[idx].default_uint_value);
+}
+
 uint32_t
 TargetProperties::GetMaximumSizeOfStringSummary() const
 {
@@ -15,7 +15,9 @@
 #include "lldb/Breakpoint/BreakpointLocation.h"
 #include "lldb/Breakpoint/BreakpointSite.h"
 #include "lldb/Core/Disassembler.h"
+#include "lldb/Core/InstructionBranchMap.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/Module.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Symbol/Function.h"
 #include "lldb/Symbol/Symbol.h"
@@ -101,6 +103,7 @@ ThreadPlanStepRange::AddRange(const AddressRange &new_range)
     // Fill the slot for this address range with an empty DisassemblerSP in the instruction ranges. I want the
     // indices to match, but I don't want to do the work to disassemble this range if I don't step into it.
     m_instruction_ranges.push_back (DisassemblerSP());
+    m_branch_maps.push_back (BranchMapSlot());
 }
 
 void
@@ -326,6 +329,84 @@ ThreadPlanStepRange::GetInstructionsForAddress(lldb::addr_t addr, size_t &range_
     return nullptr;
 }
 
+bool
+ThreadPlanStepRange::GetRunToAddressFromBranchMap (lldb::addr_t addr, Address &run_to_address)
+{
+    Target &target = GetTarget();
+
+    // Hexagon has to look at the instruction bytes around the branch to find its packet, so it
+    // always disassembles the range.
+    if (target.GetArchitecture().GetTriple().getArch() == llvm::Triple::hexagon)
+        return false;
+
+    size_t num_ranges = m_address_ranges.size();
+    for (size_t i = 0; i < num_ranges; i++)
+    {
+        const AddressRange &range = m_address_ranges[i];
+        if (!range.ContainsLoadAddress(addr, &target))
+            continue;
+
+        if (range.GetByteSize() == 0)
+            return false;
+
+        ModuleSP module_sp (range.GetBaseAddress().GetModule());
+        if (!module_sp)
+            return false;
+
+        BranchMapSlot &slot = m_branch_maps[i];
+        if (!slot.resolved)
+        {
+            slot.resolved = true;
+            SymbolContext sc;
+            AddressRange function_range;
+            module_sp->ResolveSymbolContextForAddress (range.GetBaseAddress(), eSymbolContextFunction | eSymbolContextSymbol, sc);
+            if (sc.GetAddressRange (eSymbolContextFunction | eSymbolContextSymbol, 0, false, function_range) &&
+                function_range.ContainsFileAddress (range.GetBaseAddress()) &&
+                range.GetBaseAddress().GetFileAddress() + range.GetByteSize() <=
+                    function_range.GetBaseAddress().GetFileAddress() + function_range.GetByteSize())
+            {
+                ExecutionContext exe_ctx (m_thread.GetProcess());
+                slot.branch_map_sp = module_sp->GetInstructionBranchMap (exe_ctx, function_range);
+            }
+        }
+
+        InstructionBranchMap *branch_map = slot.branch_map_sp.get();
+        if (branch_map == nullptr)
+            return false;
+
+        const addr_t range_load_addr = range.GetBaseAddress().GetLoadAddress (&target);
+        const addr_t range_file_addr = range.GetBaseAddress().GetFileAddress();
+        if (range_load_addr == LLDB_INVALID_ADDRESS || range_file_addr == LLDB_INVALID_ADDRESS)
+            return false;
+
+        // If we aren't at an instruction boundary we're probably lost, let the slow path decide.
+        const uint32_t pc_index = branch_map->GetIndexOfInstructionAtFileAddress (range_file_addr + (addr - range_load_addr));
+        const uint32_t end_index = branch_map->GetIndexOfInstructionAtFileAddress (range_file_addr + range.GetByteSize());
+        if (pc_index == UINT32_MAX || end_index == UINT32_MAX || pc_index >= end_index)
+            return false;
+
+        addr_t run_to_file_addr = LLDB_INVALID_ADDRESS;
+        const uint32_t branch_index = branch_map->GetIndexOfNextBranchInstruction (pc_index);
+        if (branch_index == UINT32_MAX || branch_index >= end_index)
+        {
+            // No branch before the end of the range, so run to the end of the range.
+            const uint32_t last_index = end_index - 1;
+            if (last_index - pc_index > 1)
+                run_to_file_addr = branch_map->GetFileAddressAtIndex (end_index);
+        }
+        else if (branch_index - pc_index > 1)
+        {
+            run_to_file_addr = branch_map->GetFileAddressAtIndex (branch_index);
+        }
+
+        run_to_address.Clear();
+        if (run_to_file_addr != LLDB_INVALID_ADDRESS)
+            module_sp->ResolveFileAddress (run_to_file_addr, run_to_address);
+        return true;
+    }
+    return false;
+}
+
 void
 ThreadPlanStepRange::ClearNextBranchBreakpoint()
 {
@@ -352,20 +433,21 @@ ThreadPlanStepRange::SetNextBranchBreakpoint ()
          return false;
 
     lldb::addr_t cur_addr = GetThread().GetRegisterContext()->GetPC();
-    // Find the current address in our address ranges, and fetch the disassembly if we haven't already:
-    size_t pc_index;
-    size_t range_index;
-    InstructionList *instructions = GetInstructionsForAddress (cur_addr, range_index, pc_index);
-    if (instructions == nullptr)
-        return false;
-    else
+    Address run_to_address;
+    // The branch map for the function is shared by all step plans, so try that first.  Otherwise find the
+    // current address in our address ranges, and fetch the disassembly if we haven't already:
+    if (!GetRunToAddressFromBranchMap (cur_addr, run_to_address))
     {
+        size_t pc_index;
+        size_t range_index;
+        InstructionList *instructions = GetInstructionsForAddress (cur_addr, range_index, pc_index);
+        if (instructions == nullptr)
+            return false;
+
         Target &target = GetThread().GetProcess()->GetTarget();
         uint32_t branch_index;
         branch_index = instructions->GetIndexOfNextBranchInstruction (pc_index, target);
         
-        Address run_to_address;
-        
         // If we didn't find a branch, run to the end of the range.
         if (branch_index == UINT32_MAX)
         {
@@ -382,37 +464,37 @@ ThreadPlanStepRange::SetNextBranchBreakpoint ()
         {
             run_to_address = instructions->GetInstructionAtIndex(branch_index)->GetAddress();
         }
-        
-        if (run_to_address.IsValid())
+    }
+
+    if (run_to_address.IsValid())
+    {
+        const bool is_internal = true;
+        m_next_branch_bp_sp = GetTarget().CreateBreakpoint(run_to_address, is_internal, false);
+        if (m_next_branch_bp_sp)
         {
-            const bool is_internal = true;
-            m_next_branch_bp_sp = GetTarget().CreateBreakpoint(run_to_address, is_internal, false);
-            if (m_next_branch_bp_sp)
+            if (log)
             {
-                if (log)
+                lldb::break_id_t bp_site_id = LLDB_INVALID_BREAK_ID;
+                BreakpointLocationSP bp_loc = m_next_branch_bp_sp->GetLocationAtIndex(0);
+                if (bp_loc)
                 {
-                    lldb::break_id_t bp_site_id = LLDB_INVALID_BREAK_ID;
-                    BreakpointLocationSP bp_loc = m_next_branch_bp_sp->GetLocationAtIndex(0);
-                    if (bp_loc)
+                    BreakpointSiteSP bp_site = bp_loc->GetBreakpointSite();
+                    if (bp_site)
                     {
-                        BreakpointSiteSP bp_site = bp_loc->GetBreakpointSite();
-                        if (bp_site)
-                        {
-                            bp_site_id = bp_site->GetID();
-                        }
+                        bp_site_id = bp_site->GetID();
                     }
-                    log->Printf ("ThreadPlanStepRange::SetNextBranchBreakpoint - Setting breakpoint %d (site %d) to run to address 0x%" PRIx64,
-                                 m_next_branch_bp_sp->GetID(),
-                                 bp_site_id,
-                                 run_to_address.GetLoadAddress(&m_thread.GetProcess()->GetTarget()));
                 }
-                m_next_branch_bp_sp->SetThreadID(m_thread.GetID());
-                m_next_branch_bp_sp->SetBreakpointKind ("next-branch-location");
-                return true;
+                log->Printf ("ThreadPlanStepRange::SetNextBranchBreakpoint - Setting breakpoint %d (site %d) to run to address 0x%" PRIx64,
+                             m_next_branch_bp_sp->GetID(),
+                             bp_site_id,
+                             run_to_address.GetLoadAddress(&m_thread.GetProcess()->GetTarget()));
             }
-            else
-                return false;
+            m_next_branch_bp_sp->SetThreadID(m_thread.GetID());
+            m_next_branch_bp_sp->SetBreakpointKind ("next-branch-location");
+            return true;
         }
+        else
+            return false;
     }
     return false;
 }
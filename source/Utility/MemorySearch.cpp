@@ -0,0 +1,152 @@
+//===-- MemorySearch.cpp ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// C++ Includes
+#include <algorithm>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-defines.h"
+#include "lldb/Utility/MemorySearch.h"
+
+using namespace lldb_private;
+
+const size_t MemorySearcher::npos;
+
+MemorySearcher::MemorySearcher (const uint8_t *pattern, size_t pattern_size) :
+    m_pattern (pattern, pattern + pattern_size)
+{
+    for (size_t i = 0; i < 256; ++i)
+        m_skip[i] = pattern_size;
+    // The last byte of the pattern is left out so that a mismatch always
+    // moves the window forward by at least one byte.
+    for (size_t i = 0; i + 1 < pattern_size; ++i)
+        m_skip[pattern[i]] = pattern_size - 1 - i;
+}
+
+size_t
+MemorySearcher::FindHorspool (const uint8_t *data, size_t data_size, size_t start) const
+{
+    const size_t pattern_size = m_pattern.size();
+    const uint8_t *pattern = m_pattern.data();
+    const uint8_t last = pattern[pattern_size - 1];
+
+    size_t pos = start;
+    while (pos + pattern_size <= data_size)
+    {
+        const uint8_t c = data[pos + pattern_size - 1];
+        if (c == last && memcmp (data + pos, pattern, pattern_size - 1) == 0)
+            return pos;
+        pos += m_skip[c];
+    }
+    return npos;
+}
+
+size_t
+MemorySearcher::Find (const uint8_t *data, size_t data_size) const
+{
+    const size_t pattern_size = m_pattern.size();
+    if (pattern_size == 0)
+        return 0;
+    if (data == nullptr || data_size < pattern_size)
+        return npos;
+
+    if (pattern_size == 1)
+    {
+        const void *match = memchr (data, m_pattern[0], data_size);
+        return match ? static_cast<const uint8_t *>(match) - data : npos;
+    }
+
+    size_t pos = 0;
+#if defined(__SSE2__)
+    // Compare the first and last byte of the pattern against 16 candidate
+    // positions at once.  Random data rarely matches both, so the full
+    // comparison only runs for a handful of candidates per block.
+    const uint8_t *pattern = m_pattern.data();
+    const __m128i first = _mm_set1_epi8 (static_cast<char>(pattern[0]));
+    const __m128i last = _mm_set1_epi8 (static_cast<char>(pattern[pattern_size - 1]));
+    for (; pos + pattern_size - 1 + 16 <= data_size; pos += 16)
+    {
+        const __m128i block_first = _mm_loadu_si128 (reinterpret_cast<const __m128i *>(data + pos));
+        const __m128i block_last = _mm_loadu_si128 (reinterpret_cast<const __m128i *>(data + pos + pattern_size - 1));
+        unsigned mask = _mm_movemask_epi8 (_mm_and_si128 (_mm_cmpeq_epi8 (first, block_first),
+                                                          _mm_cmpeq_epi8 (last, block_last)));
+        while (mask)
+        {
+            const unsigned bit = __builtin_ctz (mask);
+            if (memcmp (data + pos + bit + 1, pattern + 1, pattern_size - 2) == 0)
+                return pos + bit;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    // Whatever is left (or everything, without SSE2) is too short for a
+    // full vector and is scanned with the skip table.
+    return FindHorspool (data, data_size, pos);
+}
+
+bool
+MemorySearcher::FindInRange (lldb::addr_t start,
+                             lldb::addr_t end,
+                             size_t chunk_size,
+                             const ReadCallback &read,
+                             const SkipCallback &skip_unreadable,
+                             lldb::addr_t &found_addr) const
+{
+    found_addr = LLDB_INVALID_ADDRESS;
+    const size_t pattern_size = m_pattern.size();
+    if (pattern_size == 0)
+    {
+        if (start < end)
+            found_addr = start;
+        return true;
+    }
+
+    // Each chunk has to move the search forward past the overlap.
+    chunk_size = std::max (chunk_size, 2 * pattern_size);
+
+    lldb::addr_t addr = start;
+    while (addr < end && end - addr >= pattern_size)
+    {
+        const size_t wanted = std::min<lldb::addr_t> (chunk_size, end - addr);
+        size_t bytes_read = 0;
+        const uint8_t *bytes = read (addr, wanted, bytes_read);
+
+        if (bytes != nullptr && bytes_read >= pattern_size)
+        {
+            const size_t offset = Find (bytes, bytes_read);
+            if (offset != npos)
+            {
+                found_addr = addr + offset;
+                return true;
+            }
+        }
+
+        if (bytes_read == wanted)
+        {
+            addr += wanted - (pattern_size - 1);
+            continue;
+        }
+
+        // The read stopped short, so no match can straddle where it
+        // stopped.  Go on after the memory that can't be read.
+        const lldb::addr_t bad_addr = addr + bytes_read;
+        lldb::addr_t next_addr = LLDB_INVALID_ADDRESS;
+        if (!skip_unreadable (bad_addr, next_addr) || next_addr <= bad_addr)
+            return false;
+        addr = next_addr;
+    }
+    return true;
+}
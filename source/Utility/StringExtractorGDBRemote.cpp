@@ -102,6 +102,7 @@ StringExtractorGDBRemote::GetServerPacketType () const
             if (PACKET_STARTS_WITH ("QSetLogging:"))              return eServerPacketType_QSetLogging;
             if (PACKET_STARTS_WITH ("QSetMaxPacketSize:"))        return eServerPacketType_QSetMaxPacketSize;
             if (PACKET_STARTS_WITH ("QSetMaxPayloadSize:"))       return eServerPacketType_QSetMaxPayloadSize;
+            if (PACKET_STARTS_WITH ("QSetSharedMemoryBuffer:"))   return eServerPacketType_QSetSharedMemoryBuffer;
             if (PACKET_STARTS_WITH ("QSetEnableAsyncProfiling;")) return eServerPacketType_QSetEnableAsyncProfiling;
             if (PACKET_STARTS_WITH ("QSyncThreadState:"))         return eServerPacketType_QSyncThreadState;
             break;
@@ -111,6 +112,10 @@ StringExtractorGDBRemote::GetServerPacketType () const
             if (PACKET_MATCHES("QListThreadsInStopReply"))        return eServerPacketType_QListThreadsInStopReply;
             break;
 
+        case 'N':
+            if (PACKET_STARTS_WITH ("QNonStop:"))                 return eServerPacketType_QNonStop;
+            break;
+
         case 'R':
             if (PACKET_STARTS_WITH ("QRestoreRegisterState:"))    return eServerPacketType_QRestoreRegisterState;
             break;
@@ -191,6 +196,9 @@ StringExtractorGDBRemote::GetServerPacketType () const
             break;
 
         case 'S':
+            if (PACKET_STARTS_WITH ("qSaveCore"))               return eServerPacketType_qSaveCore;
+            if (PACKET_STARTS_WITH ("qSearch:memory:"))         return eServerPacketType_qSearch_memory;
+            if (PACKET_STARTS_WITH ("qSharedMemoryRead:"))      return eServerPacketType_qSharedMemoryRead;
             if (PACKET_STARTS_WITH ("qSpeedTest:"))             return eServerPacketType_qSpeedTest;
             if (PACKET_MATCHES ("qShlibInfoAddr"))              return eServerPacketType_qShlibInfoAddr;
             if (PACKET_MATCHES ("qStepPacketSupported"))        return eServerPacketType_qStepPacketSupported;
@@ -225,6 +233,7 @@ StringExtractorGDBRemote::GetServerPacketType () const
     case 'j':
         if (PACKET_MATCHES("jSignalsInfo"))                     return eServerPacketType_jSignalsInfo;
         if (PACKET_MATCHES("jThreadsInfo"))                     return eServerPacketType_jThreadsInfo;
+        if (PACKET_STARTS_WITH("jMemoryRegionsInfo"))           return eServerPacketType_jMemoryRegionsInfo;
         break;
 
     case 'v':
@@ -249,6 +258,7 @@ StringExtractorGDBRemote::GetServerPacketType () const
               if (PACKET_STARTS_WITH ("vAttachName;"))          return eServerPacketType_vAttachName;
               if (PACKET_STARTS_WITH("vCont;"))                 return eServerPacketType_vCont;
               if (PACKET_MATCHES ("vCont?"))                    return eServerPacketType_vCont_actions;
+              if (PACKET_MATCHES ("vStopped"))                  return eServerPacketType_vStopped;
             }
             break;
       case '_':
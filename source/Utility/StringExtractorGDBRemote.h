@@ -112,16 +112,19 @@ public:
       // debug server packages
         eServerPacketType_QEnvironmentHexEncoded,
         eServerPacketType_QListThreadsInStopReply,
+        eServerPacketType_QNonStop,
         eServerPacketType_QRestoreRegisterState,
         eServerPacketType_QSaveRegisterState,
         eServerPacketType_QSetLogging,
         eServerPacketType_QSetMaxPacketSize,
         eServerPacketType_QSetMaxPayloadSize,
+        eServerPacketType_QSetSharedMemoryBuffer,
         eServerPacketType_QSetEnableAsyncProfiling,
         eServerPacketType_QSyncThreadState,
         eServerPacketType_QThreadSuffixSupported,
 
         eServerPacketType_jThreadsInfo,
+        eServerPacketType_jMemoryRegionsInfo,
         eServerPacketType_qsThreadInfo,
         eServerPacketType_qfThreadInfo,
         eServerPacketType_qGetPid,
@@ -132,6 +135,9 @@ public:
         eServerPacketType_qProcessInfo,
         eServerPacketType_qRcmd,
         eServerPacketType_qRegisterInfo,
+        eServerPacketType_qSaveCore,
+        eServerPacketType_qSearch_memory,
+        eServerPacketType_qSharedMemoryRead,
         eServerPacketType_qShlibInfoAddr,
         eServerPacketType_qStepPacketSupported,
         eServerPacketType_qSupported,
@@ -151,6 +157,7 @@ public:
         eServerPacketType_vAttachName,
         eServerPacketType_vCont,
         eServerPacketType_vCont_actions, // vCont?
+        eServerPacketType_vStopped,
 
         eServerPacketType_stop_reason, // '?'
 
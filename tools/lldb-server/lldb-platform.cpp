@@ -21,6 +21,8 @@
 
 // C++ Includes
 #include <fstream>
+#include <memory>
+#include <set>
 
 // Other libraries and framework includes
 #include "llvm/Support/FileSystem.h"
@@ -64,6 +66,7 @@ static struct option g_long_options[] =
     { "min-gdbserver-port", required_argument,  NULL,               'm' },
     { "max-gdbserver-port", required_argument,  NULL,               'M' },
     { "socket-file",        required_argument,  NULL,               'f' },
+    { "gdbserver-pool-size", required_argument, NULL,               'g' },
     { "server",             no_argument,        &g_server,          1   },
     { NULL,                 0,                  NULL,               0   }
 };
@@ -97,7 +100,7 @@ signal_handler(int signo)
 static void
 display_usage (const char *progname, const char *subcommand)
 {
-    fprintf(stderr, "Usage:\n  %s %s [--log-file log-file-name] [--log-channels log-channel-list] [--port-file port-file-path] --server --listen port\n", progname, subcommand);
+    fprintf(stderr, "Usage:\n  %s %s [--log-file log-file-name] [--log-channels log-channel-list] [--port-file port-file-path] [--gdbserver-pool-size count] --server --listen port\n", progname, subcommand);
     exit(0);
 }
 
@@ -157,6 +160,7 @@ main_platform (int argc, char *argv[])
     int min_gdbserver_port = 0;
     int max_gdbserver_port = 0;
     uint16_t port_offset = 0;
+    size_t gdbserver_pool_size = 0;
 
     FileSpec socket_file;
     bool show_usage = false;
@@ -222,6 +226,20 @@ main_platform (int argc, char *argv[])
             }
             break;
                 
+        case 'g':
+            {
+                char *end = NULL;
+                unsigned long pool_size = strtoul(optarg, &end, 0);
+                if (end && *end == '\0')
+                    gdbserver_pool_size = pool_size;
+                else
+                {
+                    fprintf (stderr, "error: invalid gdbserver pool size string %s\n", optarg);
+                    option_error = 6;
+                }
+            }
+            break;
+
         case 'P':
         case 'm':
         case 'M':
@@ -320,6 +338,23 @@ main_platform (int argc, char *argv[])
         }
     }
 
+    // With --server every connection is handled in a process of its own,
+    // so the pool of waiting gdbservers is kept here, in the accepting
+    // process, and each connection is handed one of them.  Otherwise the
+    // connection's platform keeps the pool itself.
+    std::unique_ptr<GDBRemoteCommunicationServerPlatform> pool_platform;
+    if (g_server && gdbserver_pool_size > 0)
+    {
+        pool_platform.reset(new GDBRemoteCommunicationServerPlatform(acceptor_up->GetSocketProtocol(),
+                                                                     acceptor_up->GetSocketScheme()));
+        if (port_offset > 0)
+            pool_platform->SetPortOffset(port_offset);
+        if (!gdbserver_portmap.empty())
+            pool_platform->SetPortMap(GDBRemoteCommunicationServerPlatform::PortMap(gdbserver_portmap));
+        pool_platform->SetGDBServerPoolSize(gdbserver_pool_size);
+    }
+    std::set<lldb::pid_t> connection_pids;
+
     do {
         GDBRemoteCommunicationServerPlatform platform(acceptor_up->GetSocketProtocol(),
                                                       acceptor_up->GetSocketScheme());
@@ -332,6 +367,18 @@ main_platform (int argc, char *argv[])
             platform.SetPortMap(std::move(gdbserver_portmap));
         }
 
+        // Fill the pool between connections.
+        if (pool_platform)
+        {
+            while (pool_platform->GDBServerPoolNeedsRefill())
+            {
+                if (pool_platform->RefillGDBServerPool().Fail())
+                    break;
+            }
+        }
+        else
+            platform.SetGDBServerPoolSize(gdbserver_pool_size);
+
         const bool children_inherit_accept_socket = true;
         Connection* conn = nullptr;
         error = acceptor_up->Accept(children_inherit_accept_socket, conn);
@@ -343,13 +390,37 @@ main_platform (int argc, char *argv[])
         printf ("Connection established.\n");
         if (g_server)
         {
-            // Collect child zombie processes.
-            while (waitpid(-1, nullptr, WNOHANG) > 0);
-            if (fork())
+            // Collect child zombie processes.  Only the connection handlers,
+            // the pool's gdbservers are reaped by the pool's monitors.
+            for (auto pos = connection_pids.begin(); pos != connection_pids.end();)
+            {
+                if (waitpid(*pos, nullptr, WNOHANG) != 0)
+                    pos = connection_pids.erase(pos);
+                else
+                    ++pos;
+            }
+
+            // Settle the pool's part before forking: its monitor threads
+            // don't make it into the child, and neither would any lock
+            // they hold.
+            lldb::pid_t pooled_pid = LLDB_INVALID_PROCESS_ID;
+            uint16_t pooled_port = 0;
+            std::string pooled_socket_name;
+            if (pool_platform)
+            {
+                pool_platform->TakeGDBServerFromPool(pooled_pid, pooled_port, pooled_socket_name);
+                pool_platform->ReserveGDBServerPoolPorts(platform);
+            }
+
+            const ::pid_t connection_pid = fork();
+            if (connection_pid)
             {
                 // Parent doesn't need a connection to the lldb client
                 delete conn;
 
+                if (connection_pid > 0)
+                    connection_pids.insert(connection_pid);
+
                 // Parent will continue to listen for new connections.
                 continue;
             }
@@ -359,6 +430,15 @@ main_platform (int argc, char *argv[])
                 g_server = 0;
                 // Listening socket is owned by parent process.
                 acceptor_up.release();
+
+                if (pool_platform)
+                {
+                    if (pooled_pid != LLDB_INVALID_PROCESS_ID)
+                        platform.AdoptGDBServer(pooled_pid, pooled_port, pooled_socket_name);
+                    // The rest of the pool belongs to the parent.  Our copy
+                    // would kill them when it is destroyed.
+                    pool_platform.release();
+                }
             }
         }
         else
@@ -394,7 +474,18 @@ main_platform (int argc, char *argv[])
                 bool done = false;
                 while (!interrupt && !done)
                 {
-                    if (platform.GetPacketAndSendResponse (UINT32_MAX, error, interrupt, done) != GDBRemoteCommunication::PacketResult::Success)
+                    // Top up the pool of waiting gdbservers whenever the
+                    // client has nothing for us to do.
+                    const bool refill_pool = platform.GDBServerPoolNeedsRefill();
+                    GDBRemoteCommunication::PacketResult result =
+                        platform.GetPacketAndSendResponse (refill_pool ? 0 : UINT32_MAX, error, interrupt, done);
+                    if (refill_pool && result == GDBRemoteCommunication::PacketResult::ErrorReplyTimeout && !done)
+                    {
+                        error.Clear();
+                        platform.RefillGDBServerPool();
+                        continue;
+                    }
+                    if (result != GDBRemoteCommunication::PacketResult::Success)
                         break;
                 }
 
@@ -0,0 +1,107 @@
+//===-- InstructionBranchMapTest.cpp ----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#if defined(_MSC_VER) && (_HAS_EXCEPTIONS == 0)
+// Workaround for MSVC standard library bug, which fails to include <thread> when
+// exceptions are disabled.
+#include <eh.h>
+#endif
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/InstructionBranchMap.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    // Builds the map from a list of instructions instead of disassembling.
+    class TestBranchMap : public InstructionBranchMap
+    {
+    public:
+        TestBranchMap(lldb::addr_t base_addr, lldb::addr_t byte_size) : InstructionBranchMap(AddressRange(base_addr, byte_size)) {}
+
+        void
+        Append(lldb::addr_t offset, bool does_branch)
+        {
+            AppendInstruction(GetFunctionRange().GetBaseAddress().GetFileAddress() + offset, does_branch);
+        }
+
+        void
+        Done()
+        {
+            Finalize();
+        }
+    };
+}
+
+TEST(InstructionBranchMapTest, InstructionLookup)
+{
+    TestBranchMap map(0x1000, 16);
+    map.Append(0, false);
+    map.Append(4, false);
+    map.Append(6, true);
+    map.Append(10, false);
+    map.Done();
+
+    ASSERT_EQ(4u, map.GetSize());
+    EXPECT_EQ(0u, map.GetIndexOfInstructionAtFileAddress(0x1000));
+    EXPECT_EQ(1u, map.GetIndexOfInstructionAtFileAddress(0x1004));
+    EXPECT_EQ(2u, map.GetIndexOfInstructionAtFileAddress(0x1006));
+    EXPECT_EQ(3u, map.GetIndexOfInstructionAtFileAddress(0x100a));
+    // The end of the function maps to one past the last instruction.
+    EXPECT_EQ(4u, map.GetIndexOfInstructionAtFileAddress(0x1010));
+
+    // Not instruction boundaries, or outside the function.
+    EXPECT_EQ(UINT32_MAX, map.GetIndexOfInstructionAtFileAddress(0x1001));
+    EXPECT_EQ(UINT32_MAX, map.GetIndexOfInstructionAtFileAddress(0x100f));
+    EXPECT_EQ(UINT32_MAX, map.GetIndexOfInstructionAtFileAddress(0xfff));
+    EXPECT_EQ(UINT32_MAX, map.GetIndexOfInstructionAtFileAddress(0x1011));
+
+    EXPECT_EQ(0x1000u, map.GetFileAddressAtIndex(0));
+    EXPECT_EQ(0x100au, map.GetFileAddressAtIndex(3));
+    EXPECT_EQ(0x1010u, map.GetFileAddressAtIndex(4));
+    EXPECT_EQ(LLDB_INVALID_ADDRESS, map.GetFileAddressAtIndex(5));
+}
+
+TEST(InstructionBranchMapTest, NextBranch)
+{
+    TestBranchMap map(0x2000, 12);
+    map.Append(0, false);
+    map.Append(2, true);
+    map.Append(4, false);
+    map.Append(6, false);
+    map.Append(8, false);
+    map.Append(10, true);
+    map.Done();
+
+    EXPECT_EQ(1u, map.GetIndexOfNextBranchInstruction(0));
+    // A branch is its own next branch.
+    EXPECT_EQ(1u, map.GetIndexOfNextBranchInstruction(1));
+    EXPECT_EQ(5u, map.GetIndexOfNextBranchInstruction(2));
+    EXPECT_EQ(5u, map.GetIndexOfNextBranchInstruction(4));
+    EXPECT_EQ(5u, map.GetIndexOfNextBranchInstruction(5));
+    // From the end of the function or past it there is no branch.
+    EXPECT_EQ(UINT32_MAX, map.GetIndexOfNextBranchInstruction(6));
+    EXPECT_EQ(UINT32_MAX, map.GetIndexOfNextBranchInstruction(100));
+}
+
+TEST(InstructionBranchMapTest, NoBranches)
+{
+    TestBranchMap map(0x3000, 8);
+    map.Append(0, false);
+    map.Append(4, false);
+    map.Done();
+
+    EXPECT_EQ(UINT32_MAX, map.GetIndexOfNextBranchInstruction(0));
+    EXPECT_EQ(UINT32_MAX, map.GetIndexOfNextBranchInstruction(1));
+    // Step ranges that run to the end of the function stop there.
+    EXPECT_EQ(2u, map.GetIndexOfInstructionAtFileAddress(0x3008));
+    EXPECT_EQ(0x3008u, map.GetFileAddressAtIndex(2));
+}
@@ -0,0 +1,149 @@
+//===-- FormatCacheTest.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#if defined(_MSC_VER) && (_HAS_EXCEPTIONS == 0)
+// Workaround for MSVC standard library bug, which fails to include <thread> when
+// exceptions are disabled.
+#include <eh.h>
+#endif
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/ConstString.h"
+#include "lldb/DataFormatters/FormatCache.h"
+#include "lldb/DataFormatters/TypeFormat.h"
+#include "lldb/DataFormatters/TypeSummary.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    std::vector<ConstString>
+    MakeTypeNames(const char *prefix, size_t count)
+    {
+        std::vector<ConstString> names;
+        for (size_t i = 0; i < count; ++i)
+            names.push_back(ConstString((std::string(prefix) + std::to_string(i)).c_str()));
+        return names;
+    }
+}
+
+TEST(FormatCacheTest, MissThenHit)
+{
+    FormatCache cache;
+    ConstString type("FormatCacheTest::MissThenHit");
+
+    TypeFormatImplSP format_sp;
+    EXPECT_FALSE(cache.GetFormat(type, format_sp));
+    EXPECT_EQ(0u, cache.GetCacheHits());
+    EXPECT_EQ(1u, cache.GetCacheMisses());
+
+    TypeFormatImplSP hex_sp(new TypeFormatImpl_Format(eFormatHex));
+    cache.SetFormat(type, hex_sp);
+    EXPECT_TRUE(cache.GetFormat(type, format_sp));
+    EXPECT_EQ(hex_sp, format_sp);
+    EXPECT_EQ(1u, cache.GetCacheHits());
+    EXPECT_EQ(1u, cache.GetCacheMisses());
+
+    // Only the kind of formatter that was stored is cached.
+    TypeSummaryImplSP summary_sp;
+    EXPECT_FALSE(cache.GetSummary(type, summary_sp));
+    SyntheticChildrenSP synthetic_sp;
+    EXPECT_FALSE(cache.GetSynthetic(type, synthetic_sp));
+    TypeValidatorImplSP validator_sp;
+    EXPECT_FALSE(cache.GetValidator(type, validator_sp));
+}
+
+TEST(FormatCacheTest, NegativeEntries)
+{
+    FormatCache cache;
+    ConstString type("FormatCacheTest::NegativeEntries");
+
+    // Storing no formatter records that the type has none.
+    TypeSummaryImplSP no_summary_sp;
+    cache.SetSummary(type, no_summary_sp);
+
+    TypeSummaryImplSP summary_sp(new StringSummaryFormat(TypeSummaryImpl::Flags(), "stale"));
+    EXPECT_TRUE(cache.GetSummary(type, summary_sp));
+    EXPECT_FALSE(summary_sp);
+
+    TypeSummaryImplSP string_sp(new StringSummaryFormat(TypeSummaryImpl::Flags(), "${var}"));
+    cache.SetSummary(type, string_sp);
+    EXPECT_TRUE(cache.GetSummary(type, summary_sp));
+    EXPECT_EQ(string_sp, summary_sp);
+}
+
+TEST(FormatCacheTest, ClearDropsEveryEntry)
+{
+    FormatCache cache;
+    // Enough names to put several in each shard.
+    std::vector<ConstString> types = MakeTypeNames("FormatCacheTest::Clear", 100);
+    TypeFormatImplSP hex_sp(new TypeFormatImpl_Format(eFormatHex));
+    for (ConstString &type : types)
+        cache.SetFormat(type, hex_sp);
+
+    cache.Clear();
+
+    // Storing one entry after Clear must not bring back the others that
+    // were in its shard.
+    TypeFormatImplSP decimal_sp(new TypeFormatImpl_Format(eFormatDecimal));
+    cache.SetFormat(types[0], decimal_sp);
+
+    TypeFormatImplSP format_sp;
+    EXPECT_TRUE(cache.GetFormat(types[0], format_sp));
+    EXPECT_EQ(decimal_sp, format_sp);
+    for (size_t i = 1; i < types.size(); ++i)
+        EXPECT_FALSE(cache.GetFormat(types[i], format_sp)) << types[i].GetCString();
+
+    // Clearing twice in a row is fine too.
+    cache.Clear();
+    cache.Clear();
+    EXPECT_FALSE(cache.GetFormat(types[0], format_sp));
+}
+
+TEST(FormatCacheTest, ConcurrentAccess)
+{
+    FormatCache cache;
+    const size_t num_threads = 8;
+    const size_t types_per_thread = 50;
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; ++t)
+    {
+        threads.push_back(std::thread([&cache, t, types_per_thread]() {
+            std::vector<ConstString> types = MakeTypeNames(("FormatCacheTest::Concurrent" + std::to_string(t) + "_").c_str(),
+                                                           types_per_thread);
+            TypeFormatImplSP own_sp(new TypeFormatImpl_Format(eFormatHex));
+            for (size_t round = 0; round < 100; ++round)
+            {
+                for (ConstString &type : types)
+                {
+                    TypeFormatImplSP format_sp;
+                    // Another thread may have cleared the cache, but an entry
+                    // is never some other type's.
+                    if (cache.GetFormat(type, format_sp))
+                        ASSERT_EQ(own_sp, format_sp);
+                    else
+                        cache.SetFormat(type, own_sp);
+                }
+                if (t == 0 && round % 10 == 0)
+                    cache.Clear();
+            }
+        }));
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(num_threads * types_per_thread * 100, cache.GetCacheHits() + cache.GetCacheMisses());
+}
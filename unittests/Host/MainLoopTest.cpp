@@ -0,0 +1,149 @@
+//===-- MainLoopTest.cpp ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#if defined(_MSC_VER) && (_HAS_EXCEPTIONS == 0)
+// Workaround for MSVC standard library bug, which fails to include <thread> when
+// exceptions are disabled.
+#include <eh.h>
+#endif
+
+#include "gtest/gtest.h"
+
+#include "lldb/Host/File.h"
+#include "lldb/Host/MainLoop.h"
+
+#ifndef _WIN32
+
+#include <unistd.h>
+
+using namespace lldb_private;
+
+class MainLoopTest : public testing::Test
+{
+  public:
+    void
+    SetUp() override
+    {
+        OpenPipe();
+        m_callback_count = 0;
+    }
+
+    void
+    TearDown() override
+    {
+        ClosePipe();
+    }
+
+  protected:
+    void
+    OpenPipe()
+    {
+        ASSERT_EQ(0, ::pipe(m_fds));
+        m_read_sp.reset(new File(m_fds[0], true));
+    }
+
+    void
+    ClosePipe()
+    {
+        m_read_sp.reset();
+        ::close(m_fds[1]);
+    }
+
+    // Make the read end of the pipe readable.
+    void
+    WriteByte()
+    {
+        ASSERT_EQ(1, ::write(m_fds[1], "X", 1));
+    }
+
+    // Reads the byte WriteByte wrote and stops the loop.
+    MainLoop::Callback
+    MakeCallback()
+    {
+        return [this](MainLoopBase &loop) {
+            char c;
+            EXPECT_EQ(1, ::read(m_fds[0], &c, 1));
+            ++m_callback_count;
+            loop.RequestTermination();
+        };
+    }
+
+    int m_fds[2];
+    lldb::IOObjectSP m_read_sp;
+    int m_callback_count;
+};
+
+TEST_F(MainLoopTest, ReadObject)
+{
+    MainLoop loop;
+    Error error;
+    auto handle = loop.RegisterReadObject(m_read_sp, MakeCallback(), error);
+    ASSERT_TRUE(error.Success());
+    ASSERT_TRUE(handle);
+
+    WriteByte();
+    ASSERT_TRUE(loop.Run().Success());
+    EXPECT_EQ(1, m_callback_count);
+}
+
+TEST_F(MainLoopTest, RegisterTwiceFails)
+{
+    MainLoop loop;
+    Error error;
+    auto handle = loop.RegisterReadObject(m_read_sp, MakeCallback(), error);
+    ASSERT_TRUE(error.Success());
+    ASSERT_TRUE(handle);
+
+    auto second_handle = loop.RegisterReadObject(m_read_sp, MakeCallback(), error);
+    EXPECT_TRUE(error.Fail());
+    EXPECT_FALSE(second_handle);
+}
+
+TEST_F(MainLoopTest, Reregister)
+{
+    MainLoop loop;
+    Error error;
+    auto handle = loop.RegisterReadObject(m_read_sp, MakeCallback(), error);
+    ASSERT_TRUE(error.Success());
+    ASSERT_TRUE(handle);
+
+    // Dropping the handle unregisters the descriptor, so it can be registered again.
+    handle.reset();
+    handle = loop.RegisterReadObject(m_read_sp, MakeCallback(), error);
+    ASSERT_TRUE(error.Success());
+    ASSERT_TRUE(handle);
+
+    WriteByte();
+    ASSERT_TRUE(loop.Run().Success());
+    EXPECT_EQ(1, m_callback_count);
+}
+
+TEST_F(MainLoopTest, ReregisterReusedDescriptor)
+{
+    MainLoop loop;
+    Error error;
+    auto handle = loop.RegisterReadObject(m_read_sp, MakeCallback(), error);
+    ASSERT_TRUE(error.Success());
+    ASSERT_TRUE(handle);
+
+    // Unregister and close the pipe, then open a new one. The new pipe gets the lowest free
+    // descriptor numbers, which are the ones the old pipe had.
+    handle.reset();
+    ClosePipe();
+    OpenPipe();
+    handle = loop.RegisterReadObject(m_read_sp, MakeCallback(), error);
+    ASSERT_TRUE(error.Success());
+    ASSERT_TRUE(handle);
+
+    WriteByte();
+    ASSERT_TRUE(loop.Run().Success());
+    EXPECT_EQ(1, m_callback_count);
+}
+
+#endif
@@ -0,0 +1,146 @@
+//===-- CompressedCoreFileTest.cpp ------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/Path.h"
+
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Host/FileSpec.h"
+
+#include "Plugins/Process/elf-core/CompressedCoreFile.h"
+
+extern const char *TestMainArgv0;
+
+using namespace lldb_private;
+
+namespace
+{
+
+// The inputs hold the same 12KB in three 4KB gzip members: blocks.bgz was
+// written the way bgzip does it, with a "BC" size field in each member and
+// an empty member at the end, and blocks.gz has plain members.  The second
+// block is all zeros.
+const uint32_t kBlockSize = 4096;
+const uint32_t kNumBlocks = 3;
+
+uint8_t
+ExpectedByte(uint64_t offset)
+{
+    return offset / kBlockSize == 1 ? 0 : offset % 251;
+}
+
+FileSpec
+GetInputFile(const char *name)
+{
+    llvm::StringRef exe_folder = llvm::sys::path::parent_path(TestMainArgv0);
+    llvm::SmallString<128> input = exe_folder;
+    llvm::sys::path::append(input, "Inputs", name);
+    return FileSpec(input.c_str(), false);
+}
+
+} // namespace
+
+TEST(CompressedCoreFileTest, IsCompressed)
+{
+    EXPECT_TRUE(CompressedCoreFile::IsCompressed(GetInputFile("blocks.bgz")));
+    EXPECT_TRUE(CompressedCoreFile::IsCompressed(GetInputFile("blocks.gz")));
+    EXPECT_FALSE(CompressedCoreFile::IsCompressed(GetInputFile("blocks.raw")));
+}
+
+#if defined(HAVE_LIBZ)
+
+class CompressedCoreFileReadTest : public testing::TestWithParam<const char *>
+{
+public:
+    void
+    SetUp() override
+    {
+        Error error;
+        m_core_file = CompressedCoreFile::Open(GetInputFile(GetParam()), error);
+        ASSERT_TRUE(error.Success()) << error.AsCString();
+        ASSERT_NE(nullptr, m_core_file.get());
+    }
+
+protected:
+    void
+    ExpectRead(uint64_t offset, size_t length, size_t expected_length)
+    {
+        std::vector<uint8_t> buffer(length, 0xaa);
+        Error error;
+        EXPECT_EQ(expected_length, m_core_file->Read(offset, buffer.data(), length, error));
+        EXPECT_TRUE(error.Success());
+        for (size_t i = 0; i < expected_length; ++i)
+            ASSERT_EQ(ExpectedByte(offset + i), buffer[i]) << "at offset " << offset + i;
+    }
+
+    std::unique_ptr<CompressedCoreFile> m_core_file;
+};
+
+TEST_P(CompressedCoreFileReadTest, Index)
+{
+    // bgzip's empty end of file member isn't a block.
+    EXPECT_EQ(kNumBlocks * kBlockSize, m_core_file->GetByteSize());
+    EXPECT_EQ(kNumBlocks, m_core_file->GetNumBlocks());
+}
+
+TEST_P(CompressedCoreFileReadTest, Read)
+{
+    ExpectRead(0, 16, 16);
+    ExpectRead(100, kBlockSize - 200, kBlockSize - 200);
+    // Reads that cross into and out of the zero filled block.
+    ExpectRead(kBlockSize - 8, 16, 16);
+    ExpectRead(2 * kBlockSize - 8, 16, 16);
+    ExpectRead(kBlockSize, kBlockSize, kBlockSize);
+    // Read the zero filled block again, this time from the zero block.
+    ExpectRead(kBlockSize + 10, 10, 10);
+    // The whole file at once.
+    ExpectRead(0, kNumBlocks * kBlockSize, kNumBlocks * kBlockSize);
+}
+
+TEST_P(CompressedCoreFileReadTest, ReadPastEnd)
+{
+    ExpectRead(kNumBlocks * kBlockSize - 4, 16, 4);
+    ExpectRead(kNumBlocks * kBlockSize, 16, 0);
+    ExpectRead(kNumBlocks * kBlockSize + 100, 16, 0);
+}
+
+TEST_P(CompressedCoreFileReadTest, GetData)
+{
+    for (uint64_t offset : {(uint64_t)8, (uint64_t)kBlockSize + 8, (uint64_t)2 * kBlockSize + 8})
+    {
+        DataExtractor data;
+        ASSERT_TRUE(m_core_file->GetData(offset, 32, data)) << "at offset " << offset;
+        ASSERT_EQ(32u, data.GetByteSize());
+        for (size_t i = 0; i < 32; ++i)
+            EXPECT_EQ(ExpectedByte(offset + i), data.GetDataStart()[i]);
+    }
+
+    // Views can't span blocks or run past the end.
+    DataExtractor data;
+    EXPECT_FALSE(m_core_file->GetData(kBlockSize - 8, 16, data));
+    EXPECT_FALSE(m_core_file->GetData(kNumBlocks * kBlockSize - 8, 16, data));
+}
+
+INSTANTIATE_TEST_CASE_P(GzipMembers, CompressedCoreFileReadTest, testing::Values("blocks.bgz", "blocks.gz"));
+
+#else
+
+TEST(CompressedCoreFileTest, OpenWithoutZlib)
+{
+    Error error;
+    EXPECT_EQ(nullptr, CompressedCoreFile::Open(GetInputFile("blocks.bgz"), error).get());
+    EXPECT_TRUE(error.Fail());
+}
+
+#endif
@@ -0,0 +1,259 @@
+//===-- GDBRemoteCommunicationClientTest.cpp --------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#ifndef LLDB_DISABLE_POSIX
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lldb/Host/ConnectionFileDescriptor.h"
+#include "lldb/Host/HostInfo.h"
+
+#include "Plugins/Process/gdb-remote/GDBRemoteCommunicationClient.h"
+
+using namespace lldb_private;
+using namespace lldb_private::process_gdb_remote;
+
+namespace
+{
+
+// Answers packets the way a stub does, but only once the client has been
+// quiet for a little while.  That way every packet the client is willing to
+// have in flight is queued up before the first response goes out, and the
+// largest queue seen is the number of packets the client had in flight.
+class MockServer
+{
+public:
+    MockServer(int fd, bool pipelined_packets) :
+        m_fd(fd),
+        m_pipelined_packets(pipelined_packets),
+        m_max_in_flight(0)
+    {
+    }
+
+    ~MockServer()
+    {
+        ::close(m_fd);
+    }
+
+    // Runs until the client closes its end of the connection.
+    void
+    Run()
+    {
+        std::string buffer;
+        std::vector<std::string> pending;
+        while (true)
+        {
+            struct pollfd pfd = { m_fd, POLLIN, 0 };
+            const int num_ready = ::poll(&pfd, 1, kIdleMilliSeconds);
+            if (num_ready < 0)
+                return;
+            if (num_ready == 0)
+            {
+                if (pending.size() > m_max_in_flight)
+                    m_max_in_flight = pending.size();
+                for (const std::string &payload : pending)
+                    Respond(payload);
+                pending.clear();
+                continue;
+            }
+
+            char bytes[4096];
+            const ssize_t bytes_read = ::read(m_fd, bytes, sizeof(bytes));
+            if (bytes_read <= 0)
+                return;
+            buffer.append(bytes, bytes_read);
+
+            // Acks are only sent before QStartNoAckMode, skip them.
+            while (!buffer.empty())
+            {
+                if (buffer[0] == '+' || buffer[0] == '-')
+                {
+                    buffer.erase(0, 1);
+                    continue;
+                }
+                const size_t end = buffer.find('#');
+                if (buffer[0] != '$' || end == std::string::npos || buffer.size() < end + 3)
+                    break;
+                pending.push_back(buffer.substr(1, end - 1));
+                buffer.erase(0, end + 3);
+            }
+        }
+    }
+
+    size_t
+    GetMaxInFlight() const
+    {
+        return m_max_in_flight;
+    }
+
+    static std::string
+    ResponseFor(size_t packet_number)
+    {
+        char response[32];
+        ::snprintf(response, sizeof(response), "%8.8zx", packet_number);
+        return response;
+    }
+
+private:
+    static const int kIdleMilliSeconds = 20;
+
+    void
+    Respond(const std::string &payload)
+    {
+        std::string response;
+        if (payload == "QStartNoAckMode")
+        {
+            // The client is still in ack mode and waits for the ack.
+            Write("+");
+            response = "OK";
+        }
+        else if (payload.compare(0, 10, "qSupported") == 0)
+        {
+            response = "PacketSize=20000";
+            if (m_pipelined_packets)
+                response += ";PipelinedPackets+";
+        }
+        else if (payload[0] == 'p')
+        {
+            // Answer with the packet's number so the test can tell the
+            // responses apart.
+            response = ResponseFor(std::stoul(payload.substr(1), nullptr, 16));
+        }
+
+        uint8_t checksum = 0;
+        for (char c : response)
+            checksum += c;
+        char checksum_text[8];
+        ::snprintf(checksum_text, sizeof(checksum_text), "#%2.2x", checksum);
+        Write("$" + response + checksum_text);
+    }
+
+    void
+    Write(const std::string &bytes)
+    {
+        size_t written = 0;
+        while (written < bytes.size())
+        {
+            const ssize_t result = ::write(m_fd, bytes.data() + written, bytes.size() - written);
+            if (result <= 0)
+                return;
+            written += result;
+        }
+    }
+
+    int m_fd;
+    bool m_pipelined_packets;
+    std::atomic<size_t> m_max_in_flight;
+};
+
+class TestClient : public GDBRemoteCommunicationClient
+{
+public:
+    using GDBRemoteCommunicationClient::kMaxPacketsInFlight;
+};
+
+class GDBRemoteCommunicationClientTest : public testing::Test
+{
+public:
+    static void
+    SetUpTestCase()
+    {
+        HostInfo::Initialize();
+    }
+
+    void
+    TearDown() override
+    {
+        // Closing the client's end of the connection stops the server.
+        if (m_client.IsConnected())
+            m_client.Disconnect();
+        if (m_server_thread.joinable())
+            m_server_thread.join();
+    }
+
+protected:
+    void
+    Connect(bool pipelined_packets)
+    {
+        int fds[2];
+        ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+        m_server.reset(new MockServer(fds[1], pipelined_packets));
+        m_server_thread = std::thread(&MockServer::Run, m_server.get());
+
+        m_client.SetConnection(new ConnectionFileDescriptor(fds[0], true));
+        ASSERT_TRUE(m_client.QueryNoAckModeSupported());
+        ASSERT_FALSE(m_client.GetSendAcks());
+    }
+
+    void
+    SendBatch(size_t num_packets)
+    {
+        std::vector<std::string> payloads;
+        for (size_t i = 0; i < num_packets; ++i)
+        {
+            char payload[32];
+            ::snprintf(payload, sizeof(payload), "p%zx", i);
+            payloads.push_back(payload);
+        }
+
+        std::vector<StringExtractorGDBRemote> responses;
+        ASSERT_EQ(GDBRemoteCommunication::PacketResult::Success,
+                  m_client.SendPacketsAndWaitForResponses(payloads, responses));
+        ASSERT_EQ(num_packets, responses.size());
+        for (size_t i = 0; i < num_packets; ++i)
+            EXPECT_EQ(MockServer::ResponseFor(i), responses[i].GetStringRef()) << "packet " << i;
+    }
+
+    TestClient m_client;
+    std::unique_ptr<MockServer> m_server;
+    std::thread m_server_thread;
+};
+
+} // namespace
+
+TEST_F(GDBRemoteCommunicationClientTest, PipelinedBatchLargerThanWindow)
+{
+    Connect(true);
+    ASSERT_TRUE(m_client.GetPipelinedPacketsSupported());
+
+    SendBatch(100);
+    // The 33rd packet had to wait for the first response.
+    const size_t max_in_flight = TestClient::kMaxPacketsInFlight;
+    EXPECT_EQ(max_in_flight, m_server->GetMaxInFlight());
+}
+
+TEST_F(GDBRemoteCommunicationClientTest, PipelinedBatchSmallerThanWindow)
+{
+    Connect(true);
+
+    SendBatch(5);
+    EXPECT_EQ(5u, m_server->GetMaxInFlight());
+}
+
+TEST_F(GDBRemoteCommunicationClientTest, BatchWithoutPipelining)
+{
+    Connect(false);
+    ASSERT_FALSE(m_client.GetPipelinedPacketsSupported());
+
+    SendBatch(10);
+    EXPECT_EQ(1u, m_server->GetMaxInFlight());
+}
+
+#endif // LLDB_DISABLE_POSIX
@@ -0,0 +1,32 @@
+// Compile with "cc -O1 -fno-inline -o basic-eh-frame.elf basic-eh-frame.c"
+// on x86_64 Linux.  The linker emits an .eh_frame_hdr with a binary
+// search table for the FDEs in .eh_frame.
+//
+// basic-eh-frame-stripped.elf is "strip -s" of it, without a .symtab.
+
+int
+leaf(int x)
+{
+    return x * 3 + 1;
+}
+
+int
+middle(int x)
+{
+    volatile int buffer[16];
+    for (int i = 0; i < 16; ++i)
+        buffer[i] = leaf(x + i);
+    return buffer[x & 15];
+}
+
+int
+outer(int x)
+{
+    return middle(x) + middle(x + 1);
+}
+
+int
+main(int argc, char **argv)
+{
+    return outer(argc);
+}
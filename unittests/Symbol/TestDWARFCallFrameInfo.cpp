@@ -0,0 +1,229 @@
+//===-- TestDWARFCallFrameInfo.cpp ------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+#include "llvm/Support/Path.h"
+
+#include "lldb/Core/Module.h"
+#include "lldb/Core/Section.h"
+#include "lldb/Host/FileSpec.h"
+#include "lldb/Host/HostInfo.h"
+#include "lldb/Symbol/DWARFCallFrameInfo.h"
+#include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Symbol/Symbol.h"
+#include "lldb/Symbol/Symtab.h"
+#include "lldb/Symbol/UnwindPlan.h"
+
+#include "Plugins/ObjectFile/ELF/ObjectFileELF.h"
+
+extern const char *TestMainArgv0;
+
+using namespace lldb;
+using namespace lldb_private;
+
+class TestDWARFCallFrameInfo : public testing::Test
+{
+public:
+    static void
+    SetUpTestCase()
+    {
+        HostInfo::Initialize();
+        ObjectFileELF::Initialize();
+    }
+
+    static void
+    TearDownTestCase()
+    {
+        ObjectFileELF::Terminate();
+        HostInfo::Terminate();
+    }
+
+    void
+    SetUp() override
+    {
+        m_module_sp = LoadInput("basic-eh-frame.elf");
+        ASSERT_NE(nullptr, m_module_sp->GetObjectFile());
+        SectionList *sections = m_module_sp->GetSectionList();
+        ASSERT_NE(nullptr, sections);
+        m_eh_frame_sp = sections->FindSectionByType(eSectionTypeEHFrame, true);
+        ASSERT_NE(nullptr, m_eh_frame_sp.get());
+    }
+
+protected:
+    static ModuleSP
+    LoadInput(const char *name)
+    {
+        llvm::StringRef exe_folder = llvm::sys::path::parent_path(TestMainArgv0);
+        llvm::SmallString<128> input = exe_folder;
+        llvm::sys::path::append(input, "Inputs", name);
+
+        return std::make_shared<Module>(FileSpec(input.c_str(), false), ArchSpec("x86_64-pc-linux"));
+    }
+
+    struct FDEInfo
+    {
+        addr_t addr;
+        uint32_t size;
+        dw_offset_t offset;
+
+        bool
+        operator==(const FDEInfo &rhs) const
+        {
+            return addr == rhs.addr && size == rhs.size && offset == rhs.offset;
+        }
+    };
+
+    static std::vector<FDEInfo>
+    GetFDEs(DWARFCallFrameInfo &cfi)
+    {
+        std::vector<FDEInfo> fdes;
+        cfi.ForEachFDEEntries([&fdes](addr_t addr, uint32_t size, dw_offset_t offset) {
+            FDEInfo info = { addr, size, offset };
+            fdes.push_back(info);
+            return true;
+        });
+        return fdes;
+    }
+
+    Address
+    GetFunctionAddress(const char *name)
+    {
+        Symbol *symbol = m_module_sp->FindFirstSymbolWithNameAndType(ConstString(name), eSymbolTypeCode);
+        EXPECT_NE(nullptr, symbol);
+        return symbol ? symbol->GetAddressRef() : Address();
+    }
+
+    static void
+    ExpectSamePlan(const UnwindPlan &expected, const UnwindPlan &actual)
+    {
+        ASSERT_EQ(expected.GetRowCount(), actual.GetRowCount());
+        for (int i = 0; i < expected.GetRowCount(); ++i)
+            EXPECT_TRUE(*expected.GetRowAtIndex(i) == *actual.GetRowAtIndex(i));
+    }
+
+    ModuleSP m_module_sp;
+    SectionSP m_eh_frame_sp;
+};
+
+static const char *g_function_names[] = { "leaf", "middle", "outer", "main" };
+
+TEST_F(TestDWARFCallFrameInfo, PlansMatchBeforeAndAfterIndexing)
+{
+    DWARFCallFrameInfo cfi(*m_module_sp->GetObjectFile(), m_eh_frame_sp, eRegisterKindEHFrame, true);
+
+    // These are found through the .eh_frame_hdr search table and parse
+    // their CIE on demand.
+    std::vector<UnwindPlan> plans;
+    for (const char *name : g_function_names)
+    {
+        plans.emplace_back(eRegisterKindEHFrame);
+        ASSERT_TRUE(cfi.GetUnwindPlan(GetFunctionAddress(name), plans.back())) << name;
+        EXPECT_GT(plans.back().GetRowCount(), 0) << name;
+    }
+
+    // Building the full index scans every CIE again and must leave the
+    // ones parsed above in place.
+    DWARFCallFrameInfo::FunctionAddressAndSizeVector functions;
+    cfi.GetFunctionAddressAndSizeVector(functions);
+    EXPECT_GE(functions.GetSize(), sizeof(g_function_names) / sizeof(g_function_names[0]));
+
+    for (size_t i = 0; i < plans.size(); ++i)
+    {
+        UnwindPlan plan(eRegisterKindEHFrame);
+        ASSERT_TRUE(cfi.GetUnwindPlan(GetFunctionAddress(g_function_names[i]), plan)) << g_function_names[i];
+        ExpectSamePlan(plans[i], plan);
+    }
+}
+
+TEST_F(TestDWARFCallFrameInfo, ConcurrentLookupsWhileIndexing)
+{
+    DWARFCallFrameInfo reference_cfi(*m_module_sp->GetObjectFile(), m_eh_frame_sp, eRegisterKindEHFrame, true);
+    std::vector<UnwindPlan> expected;
+    for (const char *name : g_function_names)
+    {
+        expected.emplace_back(eRegisterKindEHFrame);
+        ASSERT_TRUE(reference_cfi.GetUnwindPlan(GetFunctionAddress(name), expected.back()));
+    }
+
+    std::vector<Address> addresses;
+    for (const char *name : g_function_names)
+        addresses.push_back(GetFunctionAddress(name));
+
+    for (int round = 0; round < 20; ++round)
+    {
+        DWARFCallFrameInfo cfi(*m_module_sp->GetObjectFile(), m_eh_frame_sp, eRegisterKindEHFrame, true);
+
+        std::vector<std::thread> threads;
+        std::vector<std::vector<UnwindPlan>> results(4);
+        for (size_t t = 0; t < results.size(); ++t)
+        {
+            threads.emplace_back([&cfi, &addresses, &results, t]() {
+                for (const Address &addr : addresses)
+                {
+                    results[t].emplace_back(eRegisterKindEHFrame);
+                    cfi.GetUnwindPlan(addr, results[t].back());
+                }
+            });
+        }
+        DWARFCallFrameInfo::FunctionAddressAndSizeVector functions;
+        cfi.GetFunctionAddressAndSizeVector(functions);
+        for (std::thread &thread : threads)
+            thread.join();
+
+        for (const std::vector<UnwindPlan> &plans : results)
+        {
+            ASSERT_EQ(expected.size(), plans.size());
+            for (size_t i = 0; i < plans.size(); ++i)
+                ExpectSamePlan(expected[i], plans[i]);
+        }
+    }
+}
+
+TEST_F(TestDWARFCallFrameInfo, ForEachFDEEntriesMatchesIndex)
+{
+    DWARFCallFrameInfo cfi(*m_module_sp->GetObjectFile(), m_eh_frame_sp, eRegisterKindEHFrame, true);
+
+    // Walks the .eh_frame_hdr search table.
+    std::vector<FDEInfo> from_table = GetFDEs(cfi);
+    EXPECT_GE(from_table.size(), sizeof(g_function_names) / sizeof(g_function_names[0]));
+
+    // Walks the full index once it is built.
+    DWARFCallFrameInfo::FunctionAddressAndSizeVector functions;
+    cfi.GetFunctionAddressAndSizeVector(functions);
+    std::vector<FDEInfo> from_index = GetFDEs(cfi);
+
+    EXPECT_TRUE(from_table == from_index);
+}
+
+TEST_F(TestDWARFCallFrameInfo, UnwindSymbolsOnlyForStrippedFiles)
+{
+    // Every function is in the full symbol table already.
+    Symtab *symtab = m_module_sp->GetObjectFile()->GetSymtab();
+    ASSERT_NE(nullptr, symtab);
+    for (size_t i = 0; i < symtab->GetNumSymbols(); ++i)
+        EXPECT_FALSE(symtab->SymbolAtIndex(i)->IsSynthetic()) << symtab->SymbolAtIndex(i)->GetName().AsCString("");
+
+    // Without it, the FDEs stand in for the functions.
+    ModuleSP stripped_module_sp = LoadInput("basic-eh-frame-stripped.elf");
+    ASSERT_NE(nullptr, stripped_module_sp->GetObjectFile());
+    Symtab *stripped_symtab = stripped_module_sp->GetObjectFile()->GetSymtab();
+    ASSERT_NE(nullptr, stripped_symtab);
+    for (const char *name : g_function_names)
+    {
+        const addr_t file_addr = GetFunctionAddress(name).GetFileAddress();
+        Symbol *symbol = stripped_symtab->FindSymbolAtFileAddress(file_addr);
+        ASSERT_NE(nullptr, symbol) << name;
+        EXPECT_TRUE(symbol->IsSynthetic()) << name;
+        EXPECT_EQ(eSymbolTypeCode, symbol->GetType()) << name;
+    }
+}
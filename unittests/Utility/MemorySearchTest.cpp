@@ -0,0 +1,313 @@
+//===-- MemorySearchTest.cpp ------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "lldb/lldb-defines.h"
+#include "lldb/Utility/MemorySearch.h"
+
+using namespace lldb_private;
+
+namespace
+{
+
+size_t
+NaiveFind(const std::vector<uint8_t> &data, const std::vector<uint8_t> &pattern)
+{
+    for (size_t pos = 0; pos + pattern.size() <= data.size(); ++pos)
+    {
+        if (memcmp(data.data() + pos, pattern.data(), pattern.size()) == 0)
+            return pos;
+    }
+    return MemorySearcher::npos;
+}
+
+// A pattern whose first and last bytes, and every byte of the filler,
+// differ, so it only matches where it was put.
+std::vector<uint8_t>
+MakePattern(size_t size)
+{
+    std::vector<uint8_t> pattern;
+    for (size_t i = 0; i < size; ++i)
+        pattern.push_back(0x80 + i);
+    return pattern;
+}
+
+std::vector<uint8_t>
+MakeData(size_t size)
+{
+    std::vector<uint8_t> data;
+    for (size_t i = 0; i < size; ++i)
+        data.push_back(i % 0x40);
+    return data;
+}
+
+// Process memory made of one buffer at kBaseAddr, with an optional hole
+// that can't be read.
+class FakeMemory
+{
+public:
+    static const lldb::addr_t kBaseAddr = 0x10000;
+
+    explicit FakeMemory(std::vector<uint8_t> bytes) :
+        m_bytes(bytes),
+        m_hole_start(LLDB_INVALID_ADDRESS),
+        m_hole_end(LLDB_INVALID_ADDRESS),
+        m_hole_end_known(true),
+        m_num_reads(0)
+    {
+    }
+
+    void
+    SetHole(lldb::addr_t start, lldb::addr_t end, bool end_known = true)
+    {
+        m_hole_start = start;
+        m_hole_end = end;
+        m_hole_end_known = end_known;
+    }
+
+    lldb::addr_t
+    GetEnd() const
+    {
+        return kBaseAddr + m_bytes.size();
+    }
+
+    size_t
+    GetNumReads() const
+    {
+        return m_num_reads;
+    }
+
+    bool
+    Find(const MemorySearcher &searcher, size_t chunk_size, lldb::addr_t &found_addr)
+    {
+        auto read = [this](lldb::addr_t addr, size_t size, size_t &bytes_read) -> const uint8_t *
+        {
+            ++m_num_reads;
+            lldb::addr_t end = std::min<lldb::addr_t>(addr + size, GetEnd());
+            if (addr < m_hole_end && end > m_hole_start)
+                end = std::max(addr, m_hole_start);
+            bytes_read = end - addr;
+            return m_bytes.data() + (addr - kBaseAddr);
+        };
+        auto skip_unreadable = [this](lldb::addr_t bad_addr, lldb::addr_t &next_addr) -> bool
+        {
+            if (!m_hole_end_known || bad_addr < m_hole_start || bad_addr >= m_hole_end)
+                return false;
+            next_addr = m_hole_end;
+            return true;
+        };
+        return searcher.FindInRange(kBaseAddr, GetEnd(), chunk_size, read, skip_unreadable, found_addr);
+    }
+
+private:
+    std::vector<uint8_t> m_bytes;
+    lldb::addr_t m_hole_start;
+    lldb::addr_t m_hole_end;
+    bool m_hole_end_known;
+    size_t m_num_reads;
+};
+
+} // namespace
+
+TEST(MemorySearchTest, EmptyPatternMatchesAtStart)
+{
+    const MemorySearcher searcher(nullptr, 0);
+    const std::vector<uint8_t> data = MakeData(8);
+    EXPECT_EQ(0u, searcher.Find(data.data(), data.size()));
+}
+
+TEST(MemorySearchTest, DataShorterThanPattern)
+{
+    const std::vector<uint8_t> pattern = MakePattern(4);
+    const MemorySearcher searcher(pattern.data(), pattern.size());
+    EXPECT_EQ(MemorySearcher::npos, searcher.Find(pattern.data(), 3));
+    EXPECT_EQ(MemorySearcher::npos, searcher.Find(nullptr, 0));
+}
+
+TEST(MemorySearchTest, OneBytePattern)
+{
+    const uint8_t pattern = 0xaa;
+    const MemorySearcher searcher(&pattern, 1);
+    for (size_t pos = 0; pos < 40; ++pos)
+    {
+        std::vector<uint8_t> data = MakeData(40);
+        data[pos] = pattern;
+        EXPECT_EQ(pos, searcher.Find(data.data(), data.size())) << "pattern at " << pos;
+    }
+    const std::vector<uint8_t> data = MakeData(40);
+    EXPECT_EQ(MemorySearcher::npos, searcher.Find(data.data(), data.size()));
+}
+
+TEST(MemorySearchTest, TwoBytePattern)
+{
+    // The first byte of the pattern is everywhere, so every position is a
+    // candidate for the first byte alone.
+    const uint8_t pattern[] = { 0xaa, 0xbb };
+    const MemorySearcher searcher(pattern, sizeof(pattern));
+    for (size_t pos = 0; pos + 1 < 64; ++pos)
+    {
+        std::vector<uint8_t> data(64, 0xaa);
+        data[pos + 1] = 0xbb;
+        EXPECT_EQ(pos, searcher.Find(data.data(), data.size())) << "pattern at " << pos;
+    }
+
+    // Only the first byte at the very end doesn't count.
+    std::vector<uint8_t> data(64, 0xaa);
+    EXPECT_EQ(MemorySearcher::npos, searcher.Find(data.data(), data.size()));
+}
+
+TEST(MemorySearchTest, MatchAroundVectorTail)
+{
+    // With SSE2 the first positions are checked 16 at a time, as long as a
+    // whole vector of candidates fits, and the rest with the skip table.
+    // Put the pattern at every position of data sizes around that
+    // boundary, so it falls in the last vector, the tail, and across both.
+    for (size_t pattern_size = 3; pattern_size <= 20; ++pattern_size)
+    {
+        const std::vector<uint8_t> pattern = MakePattern(pattern_size);
+        const MemorySearcher searcher(pattern.data(), pattern.size());
+        for (size_t data_size = pattern_size; data_size <= 16 * 3 + pattern_size; ++data_size)
+        {
+            for (size_t pos = 0; pos + pattern_size <= data_size; ++pos)
+            {
+                std::vector<uint8_t> data = MakeData(data_size);
+                std::copy(pattern.begin(), pattern.end(), data.begin() + pos);
+                ASSERT_EQ(pos, searcher.Find(data.data(), data.size()))
+                    << "pattern of " << pattern_size << " bytes at " << pos << " of " << data_size;
+            }
+        }
+    }
+}
+
+TEST(MemorySearchTest, PartialMatchAtEnd)
+{
+    const std::vector<uint8_t> pattern = MakePattern(8);
+    const MemorySearcher searcher(pattern.data(), pattern.size());
+    for (size_t data_size = 40; data_size < 56; ++data_size)
+    {
+        // All but the last byte of the pattern fit.
+        std::vector<uint8_t> data = MakeData(data_size);
+        std::copy(pattern.begin(), pattern.end() - 1, data.end() - (pattern.size() - 1));
+        EXPECT_EQ(MemorySearcher::npos, searcher.Find(data.data(), data.size())) << data_size << " bytes";
+    }
+}
+
+TEST(MemorySearchTest, FirstOfOverlappingMatches)
+{
+    const uint8_t pattern[] = { 'a', 'a', 'b', 'a', 'a' };
+    const MemorySearcher searcher(pattern, sizeof(pattern));
+    const char text[] = "xxaabaabaabaaxxxxxxxxxxxxxxxxxxxxxxx";
+    EXPECT_EQ(2u, searcher.Find(reinterpret_cast<const uint8_t *>(text), sizeof(text) - 1));
+}
+
+TEST(MemorySearchTest, MatchesNaiveSearch)
+{
+    // Few distinct bytes give lots of partial matches.
+    for (size_t pattern_size = 1; pattern_size <= 6; ++pattern_size)
+    {
+        for (unsigned seed = 0; seed < 64; ++seed)
+        {
+            std::vector<uint8_t> pattern;
+            for (size_t i = 0; i < pattern_size; ++i)
+                pattern.push_back((seed >> i) & 1);
+            std::vector<uint8_t> data;
+            for (size_t i = 0; i < 100; ++i)
+                data.push_back(((i * 7 + seed) % 11) < 5);
+
+            const MemorySearcher searcher(pattern.data(), pattern.size());
+            ASSERT_EQ(NaiveFind(data, pattern), searcher.Find(data.data(), data.size()))
+                << "pattern of " << pattern_size << " bytes, seed " << seed;
+        }
+    }
+}
+
+TEST(MemorySearchTest, FindInRangeAcrossChunks)
+{
+    // Chunks of 32 bytes overlap by 7 bytes for an 8 byte pattern, so put
+    // the pattern everywhere, including across every chunk boundary.
+    const std::vector<uint8_t> pattern = MakePattern(8);
+    const MemorySearcher searcher(pattern.data(), pattern.size());
+    for (size_t pos = 0; pos + pattern.size() <= 200; ++pos)
+    {
+        std::vector<uint8_t> bytes = MakeData(200);
+        std::copy(pattern.begin(), pattern.end(), bytes.begin() + pos);
+        FakeMemory memory(bytes);
+        lldb::addr_t found_addr = LLDB_INVALID_ADDRESS;
+        ASSERT_TRUE(memory.Find(searcher, 32, found_addr));
+        ASSERT_EQ(FakeMemory::kBaseAddr + pos, found_addr) << "pattern at " << pos;
+    }
+
+    FakeMemory memory(MakeData(200));
+    lldb::addr_t found_addr = 0;
+    EXPECT_TRUE(memory.Find(searcher, 32, found_addr));
+    EXPECT_EQ(LLDB_INVALID_ADDRESS, found_addr);
+    // Each chunk after the first moves 25 bytes forward.
+    EXPECT_EQ(8u, memory.GetNumReads());
+}
+
+TEST(MemorySearchTest, FindInRangeSmallChunks)
+{
+    // Chunks smaller than twice the pattern are grown so the search still
+    // moves forward.
+    const std::vector<uint8_t> pattern = MakePattern(8);
+    const MemorySearcher searcher(pattern.data(), pattern.size());
+    std::vector<uint8_t> bytes = MakeData(100);
+    std::copy(pattern.begin(), pattern.end(), bytes.begin() + 90);
+    FakeMemory memory(bytes);
+    lldb::addr_t found_addr = LLDB_INVALID_ADDRESS;
+    EXPECT_TRUE(memory.Find(searcher, 1, found_addr));
+    EXPECT_EQ(FakeMemory::kBaseAddr + 90, found_addr);
+}
+
+TEST(MemorySearchTest, FindInRangeSkipsUnreadable)
+{
+    const std::vector<uint8_t> pattern = MakePattern(8);
+    const MemorySearcher searcher(pattern.data(), pattern.size());
+    const lldb::addr_t hole_start = FakeMemory::kBaseAddr + 40;
+    const lldb::addr_t hole_end = FakeMemory::kBaseAddr + 100;
+
+    // A match after the hole is found.
+    std::vector<uint8_t> bytes = MakeData(200);
+    std::copy(pattern.begin(), pattern.end(), bytes.begin() + 150);
+    FakeMemory after_hole(bytes);
+    after_hole.SetHole(hole_start, hole_end);
+    lldb::addr_t found_addr = LLDB_INVALID_ADDRESS;
+    EXPECT_TRUE(after_hole.Find(searcher, 32, found_addr));
+    EXPECT_EQ(FakeMemory::kBaseAddr + 150, found_addr);
+
+    // A match that runs into the hole isn't.
+    bytes = MakeData(200);
+    std::copy(pattern.begin(), pattern.end(), bytes.begin() + 36);
+    FakeMemory into_hole(bytes);
+    into_hole.SetHole(hole_start, hole_end);
+    EXPECT_TRUE(into_hole.Find(searcher, 32, found_addr));
+    EXPECT_EQ(LLDB_INVALID_ADDRESS, found_addr);
+}
+
+TEST(MemorySearchTest, FindInRangeGivesUpOnUnknownHole)
+{
+    const std::vector<uint8_t> pattern = MakePattern(8);
+    const MemorySearcher searcher(pattern.data(), pattern.size());
+    std::vector<uint8_t> bytes = MakeData(200);
+    std::copy(pattern.begin(), pattern.end(), bytes.begin() + 150);
+
+    // Nothing says where the hole ends, so the search fails before it
+    // gets to the match.
+    FakeMemory memory(bytes);
+    memory.SetHole(FakeMemory::kBaseAddr + 40, FakeMemory::kBaseAddr + 100, false);
+    lldb::addr_t found_addr = 0;
+    EXPECT_FALSE(memory.Find(searcher, 32, found_addr));
+    EXPECT_EQ(LLDB_INVALID_ADDRESS, found_addr);
+}